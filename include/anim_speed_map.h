@@ -0,0 +1,59 @@
+/**
+ * @file anim_speed_map.h
+ * @brief Animation speed map: breakpoint interpolation and its lookup table
+ *
+ * Portable C11 (no Windows headers). The config loader fills the breakpoints
+ * from ANIMATION_SPEED_DEFAULT / ANIMATION_SPEED_MAP_<P>, then builds a
+ * Q16.16 table so the per-frame lookup is two loads and one multiply.
+ */
+
+#ifndef ANIM_SPEED_MAP_H
+#define ANIM_SPEED_MAP_H
+
+#include <stdint.h>
+
+/** @brief Largest number of breakpoints kept */
+#define ANIM_SPEED_MAP_MAX_POINTS 128
+
+/** @brief Table resolution: entry i holds the scale at metric i/10 % */
+#define ANIM_SPEED_LUT_STEPS_PER_PERCENT 10
+#define ANIM_SPEED_LUT_SIZE (100 * ANIM_SPEED_LUT_STEPS_PER_PERCENT + 1)
+#define ANIM_SPEED_FIXED_ONE 65536.0
+
+typedef struct {
+    int percent;         /**< Breakpoint percent (0-100) */
+    double scalePercent; /**< Scale percent at breakpoint */
+} AnimSpeedPoint;
+
+typedef struct {
+    double defaultScalePercent;     /**< Scale at 0%, and everywhere when there are no points */
+    AnimSpeedPoint points[ANIM_SPEED_MAP_MAX_POINTS];
+    int pointCount;
+    uint32_t lut[ANIM_SPEED_LUT_SIZE];  /**< Scale percent in Q16.16 */
+    int lutReady;                   /**< lut matches the current points */
+} AnimSpeedMap;
+
+/** @brief Drop all breakpoints and set the default scale */
+void AnimSpeedMap_Init(AnimSpeedMap* map, double defaultScalePercent);
+
+/**
+ * @brief Add one breakpoint (percent clamped to 0..100, scale <= 0 becomes 100)
+ * @return 0 if the map is full
+ */
+int AnimSpeedMap_AddPoint(AnimSpeedMap* map, int percent, double scalePercent);
+
+/** @brief Sort the breakpoints (the last one wins on equal percents) and sample the interpolator into the table */
+void AnimSpeedMap_Build(AnimSpeedMap* map);
+
+/**
+ * @brief Reference linear interpolation over the breakpoints
+ *
+ * Below the first breakpoint the scale runs from the default at 0%; above
+ * the last one it stays at the last scale.
+ */
+double AnimSpeedMap_Interpolate(const AnimSpeedMap* map, double percent);
+
+/** @brief Table lookup; falls back to the interpolator before the first build */
+double AnimSpeedMap_Lookup(const AnimSpeedMap* map, double percent);
+
+#endif
@@ -0,0 +1,88 @@
+/**
+ * @file anim_trace.h
+ * @brief Lock-free timing trace for the tray animation scheduler
+ *
+ * Portable C11 (no Windows headers): callers pass their own millisecond
+ * timestamps, so the ring and the summary math can be reused by tooling.
+ */
+
+#ifndef ANIM_TRACE_H
+#define ANIM_TRACE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/** @brief Ring capacity in events (power of two); oldest events are overwritten */
+#define ANIM_TRACE_CAPACITY 4096
+
+/** @brief Event kinds and the meaning of their a/b/value fields */
+typedef enum {
+    ANIM_TRACE_FRAME = 1,       /**< a = scheduled deadline ms, b = actual wake ms, value = frame index */
+    ANIM_TRACE_TRAY_UPDATE,     /**< a = posted ms (0 = direct call), b = Shell_NotifyIcon ms, value = success */
+    ANIM_TRACE_INTERVAL,        /**< a = old update spacing ms, b = new spacing ms */
+    ANIM_TRACE_SPEED,           /**< a = old speed scale, b = new speed scale */
+    ANIM_TRACE_UPDATE_FAILED,   /**< value = consecutive failures */
+    ANIM_TRACE_FALLBACK         /**< switched to the logo after repeated failures */
+} AnimTraceKind;
+
+typedef struct {
+    double timeMs;              /**< When the event was recorded */
+    double a;
+    double b;
+    int32_t value;
+    uint32_t kind;              /**< AnimTraceKind */
+} AnimTraceEvent;
+
+/**
+ * @brief Summary of a trace snapshot
+ *
+ * Lateness is actual wake minus scheduled deadline. Update latency is the
+ * time from posting an update to Shell_NotifyIcon returning.
+ */
+typedef struct {
+    size_t frames;
+    double latenessP50;
+    double latenessP95;
+    double latenessP99;
+    double latenessMax;
+    size_t trayUpdates;
+    size_t trayUpdateFailures;
+    double updateLatencyP50;
+    double updateLatencyP95;
+    double updateLatencyP99;
+    double shellCallP95;
+    size_t intervalChanges;
+    double throttledMs;         /**< Time spent with spacing above the base interval */
+    double spanMs;              /**< First to last event (or endMs) */
+    size_t fallbacks;
+    uint64_t overwritten;       /**< Events lost to ring wrap-around */
+} AnimTraceSummary;
+
+/** @brief Append an event (wait-free, any thread) */
+void AnimTrace_Record(AnimTraceKind kind, double timeMs, double a, double b, int32_t value);
+
+/**
+ * @brief Copy the committed events, oldest first
+ * @return Number of events written to out
+ */
+size_t AnimTrace_Snapshot(AnimTraceEvent* out, size_t capacity);
+
+/**
+ * @brief Summarize a snapshot
+ * @param baseIntervalMs Update spacing considered "not throttled"
+ * @param endMs Closes an open throttling period (0 = last event time)
+ */
+void AnimTrace_Summarize(const AnimTraceEvent* events, size_t count,
+                         double baseIntervalMs, double endMs, AnimTraceSummary* out);
+
+/**
+ * @brief Write summary comment lines followed by the events as CSV
+ * @return 0 on success, -1 on allocation or write failure
+ */
+int AnimTrace_WriteCsv(FILE* out, double baseIntervalMs, double endMs, AnimTraceSummary* summaryOut);
+
+/** @brief Drop all recorded events */
+void AnimTrace_Reset(void);
+
+#endif
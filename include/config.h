@@ -79,6 +79,7 @@ extern BOOL PREVIEW_SHOW_MILLISECONDS;
 
 AnimationSpeedMetric GetAnimationSpeedMetric(void);
 double GetAnimationSpeedScaleForPercent(double percent);
+UINT GetAnimationSpeedMapVersion(void);
 void ReloadAnimationSpeedFromConfig(void);
 
 void GetConfigPath(char* path, size_t size);
@@ -147,6 +148,28 @@ BOOL ReadIniBool(const char* section, const char* key, BOOL defaultValue,
 BOOL WriteIniInt(const char* section, const char* key, int value,
                const char* filePath);
 
+/**
+ * @brief 64-bit FNV-1a hash of a file's content
+ * @return FALSE if the file cannot be read
+ */
+BOOL HashConfigFileContent(const char* filePath, ULONGLONG* hash);
+
+/**
+ * @brief Hash of config.ini after this process's latest WriteIni* call or write batch
+ * @param generation Incremented on every recorded write (0 = none yet)
+ */
+void GetConfigSelfWriteState(ULONGLONG* hash, LONG* generation);
+
+/**
+ * @brief Group WriteIni* calls so config.ini is hashed once, when the batch ends
+ * Batches nest per thread; every Begin needs a matching End on the same thread.
+ */
+void BeginConfigWriteBatch(void);
+void EndConfigWriteBatch(void);
+
+/** @brief TRUE while any thread has a write batch open (the file may be half-written) */
+BOOL IsConfigWriteBatchOpen(void);
+
 BOOL IsFirstRun(void);
 void SetFirstRunCompleted(void);
 void SetFontLicenseAccepted(BOOL accepted);
@@ -165,4 +188,7 @@ void ReadPercentIconColorsConfig(void);
 COLORREF GetPercentIconTextColor(void);
 COLORREF GetPercentIconBgColor(void);
 
+void ReadSystemMonitorWatchConfig(void);
+void ReadSystemMonitorSamplingConfig(void);
+
 #endif
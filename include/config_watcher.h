@@ -1,14 +1,36 @@
-/**
- * @file config_watcher.h
- * @brief Configuration file change monitoring
- */
-
-#ifndef CONFIG_WATCHER_H
-#define CONFIG_WATCHER_H
-
-#include <windows.h>
-
-void ConfigWatcher_Start(HWND hwnd);
-void ConfigWatcher_Stop(void);
-
-#endif
+/**
+ * @file config_watcher.h
+ * @brief Configuration and resource folder change monitoring
+ *
+ * One thread watches config.ini and, recursively, the resources folder.
+ * Bursts of changes are coalesced; each affected area's generation is
+ * bumped once, so other modules can detect changes with a single load.
+ */
+
+#ifndef CONFIG_WATCHER_H
+#define CONFIG_WATCHER_H
+
+#include <windows.h>
+
+/** @brief Watched areas; bit (1 << area) in WM_APP_RESOURCES_CHANGED's wParam */
+typedef enum {
+    WATCH_AREA_CONFIG,          /**< config.ini */
+    WATCH_AREA_FONTS,           /**< resources\fonts */
+    WATCH_AREA_ANIMATIONS,      /**< resources\animations */
+    WATCH_AREA_AUDIO,           /**< resources\audio */
+    WATCH_AREA_COUNT
+} WatchArea;
+
+void ConfigWatcher_Start(HWND hwnd);
+void ConfigWatcher_Stop(void);
+
+/**
+ * @brief Change generation of an area (any thread, lock-free)
+ * @return Incremented after each coalesced burst of changes; starts at 0
+ */
+LONG ConfigWatcher_GetGeneration(WatchArea area);
+
+/** @brief Config change events dropped because the file matched our own latest write */
+LONG ConfigWatcher_GetSuppressedSelfWrites(void);
+
+#endif
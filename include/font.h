@@ -7,11 +7,16 @@
 #define FONT_H
 
 #include <windows.h>
+#include "font_cache.h"
 
 #define FONT_FOLDER_PREFIX "%LOCALAPPDATA%\\Catime\\resources\\fonts\\"
 #define MAX_FONT_NAME_LEN 256
 #define TTF_NAME_TABLE_TAG 0x656D616E
+#define TTF_OS2_TABLE_TAG 0x322F534F
 #define TTF_NAME_ID_FAMILY 1
+#define TTF_NAME_ID_SUBFAMILY 2
+#define TTF_OS2_FSTYPE_OFFSET 8
+#define TTF_NAME_TABLE_SIZE_LIMIT (256 * 1024)
 #define TTF_STRING_SAFETY_LIMIT 1024
 
 typedef struct {
@@ -44,6 +49,7 @@ BOOL LoadFontByName(HINSTANCE hInstance, const char* fontName);
 BOOL LoadFontByNameAndGetRealName(HINSTANCE hInstance, const char* fontFileName, 
                                   char* realFontName, size_t realFontNameSize);
 BOOL GetFontNameFromFile(const char* fontFilePath, char* fontName, size_t fontNameSize);
+BOOL GetFontMetadataFromFile(const char* fontFilePath, FontMetadata* metadata);
 void WriteConfigFont(const char* fontFileName, BOOL shouldReload);
 void ListAvailableFonts(void);
 BOOL PreviewFont(HINSTANCE hInstance, const char* fontName);
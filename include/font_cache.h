@@ -0,0 +1,42 @@
+/**
+ * @file font_cache.h
+ * @brief Persistent cache of font metadata keyed by path, size and mtime
+ *
+ * Family name, style and embedding flags are read from each TTF/OTF once
+ * and remembered in font_cache.tsv next to config.ini. An entry is used
+ * only while the file's size and last-write time still match, so fonts
+ * are opened again only when they change.
+ */
+
+#ifndef FONT_CACHE_H
+#define FONT_CACHE_H
+
+#include <windows.h>
+#include "font_cache_table.h"
+#include "resource_catalog.h"
+
+/**
+ * @brief Look up a font (any thread)
+ * @param key Path relative to the fonts folder, or absolute for fonts elsewhere
+ * @param size File size in bytes
+ * @param lastWrite File last-write time
+ * @return TRUE if a matching entry was found
+ */
+BOOL FontCache_Lookup(const char* key, ULONGLONG size, FILETIME lastWrite, FontMetadata* out);
+
+/** @brief Remember a font read from disk, replacing any older entry for the key (any thread) */
+void FontCache_Store(const char* key, ULONGLONG size, FILETIME lastWrite, const FontMetadata* metadata);
+
+/**
+ * @brief Drop entries whose font file is gone or has changed size or mtime
+ *
+ * Called once the fonts catalog is available. Fonts-folder entries are
+ * checked against the catalog; entries for fonts elsewhere (absolute
+ * keys) are checked on disk, without holding the cache lock.
+ */
+void FontCache_Validate(const ResourceCatalog* fontsCatalog);
+
+/** @brief Write the cache back if it changed since it was loaded */
+void FontCache_Save(void);
+
+#endif
@@ -0,0 +1,85 @@
+/**
+ * @file font_cache_table.h
+ * @brief Sorted font metadata table and its font_cache.tsv line format
+ *
+ * Portable C11 (no Windows headers): font_cache.c owns the lock, the file
+ * location and the checks against the fonts catalog; this part only keeps
+ * the entries in order and reads and writes them, so tests can run it.
+ */
+
+#ifndef FONT_CACHE_TABLE_H
+#define FONT_CACHE_TABLE_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+/** @brief First line of the file; anything else is discarded */
+#define FONT_CACHE_HEADER "catime-font-cache 1"
+
+/** @brief Longest line read back; longer ones are split and rejected */
+#define FONT_CACHE_LINE_MAX 1024
+
+/** @brief size, last-write, fsType, key, family, style */
+#define FONT_CACHE_FIELD_COUNT 6
+
+/** @brief What the rest of the app needs from a font file */
+typedef struct {
+    char family[100];           /**< Name ID 1 (UTF-8), matches FONT_INTERNAL_NAME */
+    char style[64];             /**< Name ID 2, e.g. "Regular" ("" if absent) */
+    uint16_t fsType;            /**< OS/2 embedding licensing flags (0 = installable) */
+} FontMetadata;
+
+typedef struct {
+    char* key;                  /**< Owned; relative to the fonts folder or absolute */
+    uint64_t size;
+    uint64_t lastWrite;         /**< FILETIME as one 64-bit value */
+    FontMetadata metadata;
+    int seen;                   /**< Scratch flag for FontCache_Validate */
+} FontCacheEntry;
+
+/** @brief Entries sorted by key, compared case-insensitively (ASCII) */
+typedef struct {
+    FontCacheEntry* entries;
+    int count;
+    int capacity;
+} FontCacheTable;
+
+/**
+ * @brief Binary search by key
+ * @param outIndex Receives the match, or the insertion point
+ * @return 1 if found
+ */
+int FontCacheTable_Find(const FontCacheTable* table, const char* key, int* outIndex);
+
+/**
+ * @brief Insert or replace an entry
+ *
+ * Tabs and line breaks in family and style become spaces so the line
+ * format holds.
+ * @return 0 on allocation failure (table unchanged)
+ */
+int FontCacheTable_Put(FontCacheTable* table, const char* key, uint64_t size, uint64_t lastWrite,
+                       const FontMetadata* metadata);
+
+/** @brief Remove the entry at index */
+void FontCacheTable_RemoveAt(FontCacheTable* table, int index);
+
+/** @brief Free every entry and the array */
+void FontCacheTable_Clear(FontCacheTable* table);
+
+/**
+ * @brief Split a line into tab-separated fields in place
+ * @return Number of fields found (at most maxFields; the last one keeps any extra tabs)
+ */
+int FontCacheTable_SplitFields(char* line, char** fields, int maxFields);
+
+/**
+ * @brief Add the entries of a cache file to the table
+ * @return Lines skipped as malformed, or -1 if the header is not ours (nothing read)
+ */
+int FontCacheTable_Read(FontCacheTable* table, FILE* file);
+
+/** @return 1 if the header and every entry were written */
+int FontCacheTable_Write(const FontCacheTable* table, FILE* file);
+
+#endif
@@ -0,0 +1,103 @@
+/**
+ * @file frame_arena.h
+ * @brief Size-class block allocator and frame-scoped scratch arenas
+ *
+ * Portable C11 (no Windows headers in the interface) so the same code
+ * serves the decode worker, the compositor and the host-side tests.
+ */
+
+#ifndef FRAME_ARENA_H
+#define FRAME_ARENA_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/** @brief Number of size classes (4 KB .. 16 MB, four steps per doubling) */
+#define FRAME_ARENA_CLASS_COUNT 49
+
+/** @brief Largest class; bigger requests go straight to malloc */
+#define FRAME_ARENA_MAX_CLASS_SIZE (16u * 1024u * 1024u)
+
+/** @brief Free blocks kept per size class before returning memory to the CRT */
+#define FRAME_ARENA_MAX_CACHED_PER_CLASS 16
+
+/** @brief Upper bound on bytes parked in free lists across all classes */
+#define FRAME_ARENA_MAX_CACHED_BYTES (32u * 1024u * 1024u)
+
+/** @brief Default chunk size for scratch arenas */
+#define SCRATCH_ARENA_DEFAULT_CHUNK (256u * 1024u)
+
+/**
+ * @brief Allocator statistics snapshot
+ *
+ * Fragmentation is internal waste: bytes reserved by size classes that the
+ * callers did not ask for, relative to bytes reserved.
+ */
+typedef struct {
+    uint64_t hits;            /**< Allocations served from a free list */
+    uint64_t misses;          /**< Allocations that needed the CRT (new block or oversize) */
+    uint64_t oversize;        /**< Allocations above the largest class */
+    uint64_t frees;           /**< Blocks returned */
+    size_t bytesInUse;        /**< Block bytes currently handed out */
+    size_t requestedInUse;    /**< Bytes callers asked for, currently handed out */
+    size_t peakBytesInUse;    /**< High-water mark of bytesInUse */
+    size_t bytesCached;       /**< Bytes parked in free lists */
+    double fragmentation;     /**< 1 - requestedInUse / bytesInUse, 0 when idle */
+} FrameArenaStats;
+
+/**
+ * @brief Allocate a block from the matching size class
+ * @param size Bytes required
+ * @return 16-byte aligned memory or NULL; release with FrameArena_Free
+ */
+void* FrameArena_Alloc(size_t size);
+
+/** @brief Allocate and zero a block */
+void* FrameArena_Calloc(size_t size);
+
+/**
+ * @brief Return a block (NULL is ignored)
+ *
+ * Like free(), only pointers from FrameArena_Alloc/Calloc may be passed;
+ * the block header in front of the pointer is trusted as is.
+ */
+void FrameArena_Free(void* ptr);
+
+/** @brief Usable size of a FrameArena block (its class size), 0 for NULL */
+size_t FrameArena_BlockSize(const void* ptr);
+
+/** @brief Release every cached free block back to the CRT */
+void FrameArena_Trim(void);
+
+/** @brief Copy current statistics */
+void FrameArena_GetStats(FrameArenaStats* out);
+
+/** @brief Reset hit/miss counters and peak (byte gauges are kept) */
+void FrameArena_ResetStats(void);
+
+/* ============================================================================
+ * Scratch arena: bump allocation with frame-scoped reset
+ * ============================================================================ */
+
+typedef struct ScratchChunk ScratchChunk;
+
+/**
+ * @brief Single-owner bump allocator backed by FrameArena blocks
+ *
+ * Intended for per-frame temporaries in decode loops: allocate freely, then
+ * ScratchArena_Reset() at the end of each frame. Not thread-safe; give each
+ * thread its own arena.
+ */
+typedef struct {
+    ScratchChunk* head;       /**< Current chunk, older chunks chained behind */
+    size_t chunkSize;         /**< Minimum chunk payload */
+    size_t usedThisScope;     /**< Bytes handed out since the last reset */
+    size_t highWater;         /**< Largest single scope seen, used to size the next chunk */
+} ScratchArena;
+
+void ScratchArena_Init(ScratchArena* arena, size_t chunkSize);
+void* ScratchArena_Alloc(ScratchArena* arena, size_t size);
+void ScratchArena_Reset(ScratchArena* arena);
+void ScratchArena_Release(ScratchArena* arena);
+
+#endif
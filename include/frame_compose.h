@@ -0,0 +1,91 @@
+/**
+ * @file frame_compose.h
+ * @brief Animated-image frame compositor with row-span blend kernels
+ *
+ * Portable C11 (no Windows headers). Pixels are 32bpp premultiplied BGRA,
+ * top-down, as produced by WIC's GUID_WICPixelFormat32bppPBGRA converter.
+ * GIF and WebP frames share the same kernels; only the mapping of their
+ * disposal/blend fields differs.
+ */
+
+#ifndef FRAME_COMPOSE_H
+#define FRAME_COMPOSE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/** @brief Sub-rectangle of the canvas covered by one frame */
+typedef struct {
+    uint32_t left;
+    uint32_t top;
+    uint32_t width;
+    uint32_t height;
+} FrameRect;
+
+/** @brief How a frame's pixels combine with the canvas */
+typedef enum {
+    FRAME_BLEND_OVER = 0,       /**< Source-over alpha blend (GIF, WebP blending bit clear) */
+    FRAME_BLEND_SOURCE          /**< Overwrite the rectangle (WebP "do not blend") */
+} FrameBlendMode;
+
+/** @brief What happens to a frame's rectangle before the next frame is drawn */
+typedef enum {
+    FRAME_DISPOSE_NONE = 0,     /**< Leave in place */
+    FRAME_DISPOSE_BACKGROUND,   /**< Clear to transparent */
+    FRAME_DISPOSE_PREVIOUS      /**< Restore what was there before (GIF disposal 3) */
+} FrameDisposeMode;
+
+/**
+ * @brief Composition state for one canvas
+ *
+ * The compositor only ever touches the rectangles of the frames it is given:
+ * disposal of the previous frame and drawing of the next one are both clipped
+ * to their own rectangles, never the full canvas.
+ */
+typedef struct {
+    uint8_t* canvas;            /**< Caller-owned width*height*4 buffer */
+    uint32_t width;
+    uint32_t height;
+    FrameRect pendingRect;      /**< Previous frame's clipped rectangle */
+    FrameDisposeMode pendingDispose;
+    uint8_t* saved;             /**< Backup of pendingRect for FRAME_DISPOSE_PREVIOUS */
+    size_t savedCapacity;
+    FrameRect dirty;            /**< Union of rectangles changed by the last Apply (0 size = none) */
+} FrameCompositor;
+
+/* ============================================================================
+ * Row-span kernels (premultiplied BGRA)
+ * ============================================================================ */
+
+/** @brief dst = src + dst * (1 - src.a) over a span of pixels */
+void FrameCompose_BlendRowOver(uint8_t* dst, const uint8_t* src, size_t pixels);
+
+/** @brief dst = src over a span of pixels */
+void FrameCompose_CopyRow(uint8_t* dst, const uint8_t* src, size_t pixels);
+
+/** @brief dst = transparent over a span of pixels */
+void FrameCompose_ClearRow(uint8_t* dst, size_t pixels);
+
+/* ============================================================================
+ * Compositor
+ * ============================================================================ */
+
+/** @brief Bind a compositor to a canvas; the canvas is cleared to transparent */
+void FrameCompositor_Init(FrameCompositor* comp, uint8_t* canvas, uint32_t width, uint32_t height);
+
+/**
+ * @brief Dispose the previous frame, then draw the next one
+ * @param src First pixel of the frame's own width*height image
+ * @param srcStride Bytes per source row
+ * @param rect Frame position on the canvas; clipped to the canvas
+ * @param dispose Disposal that applies to this frame once the next one arrives
+ * @return 0 on success, -1 if a FRAME_DISPOSE_PREVIOUS backup could not be allocated
+ *         (the frame is still drawn, and later disposal falls back to background)
+ */
+int FrameCompositor_Apply(FrameCompositor* comp, const uint8_t* src, size_t srcStride,
+                          FrameRect rect, FrameBlendMode blend, FrameDisposeMode dispose);
+
+/** @brief Free the disposal backup (the canvas stays with the caller) */
+void FrameCompositor_Release(FrameCompositor* comp);
+
+#endif
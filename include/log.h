@@ -1,6 +1,12 @@
 /**
  * @file log.h
  * @brief Logging system with file rotation
+ *
+ * WriteLog and the LOG_* macros skip argument evaluation entirely for
+ * disabled levels: levels below LOG_COMPILE_MIN_LEVEL compile to nothing,
+ * and the per-module runtime threshold is one inline load. A source file
+ * selects its module by defining LOG_MODULE before its first #include:
+ *   #define LOG_MODULE LOG_MODULE_ANIMATION
  */
 
 #ifndef LOG_H
@@ -21,6 +27,40 @@ typedef enum {
     LOG_LEVEL_FATAL
 } LogLevel;
 
+/**
+ * @brief Lowest level compiled in (numeric, usable in #if); release builds drop DEBUG
+ * Override with -DLOG_COMPILE_MIN_LEVEL=0 to keep debug logging in a release build.
+ */
+#ifndef LOG_COMPILE_MIN_LEVEL
+#ifdef NDEBUG
+#define LOG_COMPILE_MIN_LEVEL 1
+#else
+#define LOG_COMPILE_MIN_LEVEL 0
+#endif
+#endif
+
+/** @brief Source areas with their own runtime level ([Options] LOG_LEVEL_<MODULE>) */
+typedef enum {
+    LOG_MODULE_GENERAL,
+    LOG_MODULE_ANIMATION,
+    LOG_MODULE_CONFIG,
+    LOG_MODULE_TIMER,
+    LOG_MODULE_AUDIO,
+    LOG_MODULE_COUNT
+} LogModule;
+
+#ifndef LOG_MODULE
+#define LOG_MODULE LOG_MODULE_GENERAL
+#endif
+
+/** @brief Effective minimum level per module (max of global and module level) */
+extern volatile LONG g_logModuleThreshold[LOG_MODULE_COUNT];
+
+/** @brief Runtime level check, done before any log argument is evaluated */
+static inline BOOL IsLogEnabled(LogModule module, LogLevel level) {
+    return (LONG)level >= g_logModuleThreshold[module];
+}
+
 typedef struct {
     HANDLE hFile;
     CRITICAL_SECTION csLock;
@@ -40,9 +80,10 @@ typedef struct {
 } MemoryInfo;
 
 BOOL InitializeLogSystem(void);
-void WriteLog(LogLevel level, const char* format, ...);
+void WriteLogRecord(LogLevel level, const char* format, ...);
 void CleanupLogSystem(void);
 void SetMinimumLogLevel(LogLevel minLevel);
+void SetModuleLogLevel(LogModule module, LogLevel minLevel);
 void LogOSVersion(void);
 void LogCPUArchitecture(void);
 void LogMemoryInfo(void);
@@ -52,6 +93,13 @@ void GetLastErrorDescription(DWORD errorCode, char* buffer, int bufferSize);
 void FormatBytes(ULONGLONG bytes, char* buffer, size_t bufferSize);
 void SetupExceptionHandler(void);
 
+#define LOG_ENABLED(level) \
+    ((int)(level) >= LOG_COMPILE_MIN_LEVEL && IsLogEnabled(LOG_MODULE, (level)))
+
+#define WriteLog(level, ...) do { \
+    if (LOG_ENABLED(level)) WriteLogRecord((level), __VA_ARGS__); \
+} while(0)
+
 #define LOG_DEBUG(format, ...) WriteLog(LOG_LEVEL_DEBUG, format, ##__VA_ARGS__)
 #define LOG_INFO(format, ...) WriteLog(LOG_LEVEL_INFO, format, ##__VA_ARGS__)
 #define LOG_WARNING(format, ...) WriteLog(LOG_LEVEL_WARNING, format, ##__VA_ARGS__)
@@ -59,6 +107,7 @@ void SetupExceptionHandler(void);
 #define LOG_FATAL(format, ...) WriteLog(LOG_LEVEL_FATAL, format, ##__VA_ARGS__)
 
 #define LOG_WINDOWS_ERROR(format, ...) do { \
+    if (!LOG_ENABLED(LOG_LEVEL_ERROR)) break; \
     DWORD _err = GetLastError(); \
     char _errBuf[512]; \
     GetLastErrorDescription(_err, _errBuf, sizeof(_errBuf)); \
@@ -0,0 +1,110 @@
+/**
+ * @file log_binary.h
+ * @brief Binary log encoding: interned format strings plus raw arguments
+ *
+ * Portable C11 (no Windows headers), shared by the logger and the
+ * catime-logdump decoder. A binary log records the format-string ID, a
+ * timestamp and the argument values; printf formatting happens only when
+ * the log is decoded.
+ *
+ * File layout (all integers little-endian):
+ *   header  "CTIMELOG", u32 version, u32 reserved
+ *   chunks  u8 type, u32 payload length, payload
+ *     STRING  u32 id, format bytes (no terminator)
+ *     RECORD  u64 timestamp, u8 level, u32 format id, arguments
+ *     TEXT    u64 timestamp, u8 level, message bytes
+ *
+ * A STRING chunk precedes the first RECORD that uses its ID in the same
+ * file. Arguments follow the format's conversions in order: integers and
+ * pointers as 8 bytes, floating point as IEEE-754 double bits, strings
+ * (narrow and wide, both as UTF-8) as u32 length + bytes. Timestamps are
+ * FILETIME units (100 ns since 1601-01-01 UTC).
+ */
+
+#ifndef LOG_BINARY_H
+#define LOG_BINARY_H
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define LOG_BINARY_MAGIC "CTIMELOG"
+#define LOG_BINARY_VERSION 1
+#define LOG_BINARY_FILE_HEADER_SIZE 16
+#define LOG_BINARY_CHUNK_HEADER_SIZE 5
+
+/** @brief Most conversions (including '*' width/precision) in one format */
+#define LOG_BINARY_MAX_ARGS 16
+
+/** @brief Interned format strings per process; later formats are logged as text */
+#define LOG_BINARY_MAX_FORMATS 2048
+
+#define LOG_BINARY_ENCODE_FAILED ((size_t)-1)
+
+typedef enum {
+    LOG_BINARY_CHUNK_STRING = 1,
+    LOG_BINARY_CHUNK_RECORD = 2,
+    LOG_BINARY_CHUNK_TEXT = 3
+} LogBinaryChunkType;
+
+/** @brief How one argument is read from va_list and stored */
+typedef enum {
+    LOG_ARG_INT = 1,        /**< int (also %c, %hd, %hhd) */
+    LOG_ARG_UINT,           /**< unsigned int */
+    LOG_ARG_LONG,           /**< long (32-bit on Windows, 64-bit on Linux) */
+    LOG_ARG_ULONG,
+    LOG_ARG_LLONG,          /**< long long, %I64d, %jd */
+    LOG_ARG_ULLONG,
+    LOG_ARG_SIZE,           /**< size_t, ptrdiff_t */
+    LOG_ARG_DOUBLE,
+    LOG_ARG_LDOUBLE,        /**< long double, stored as double */
+    LOG_ARG_POINTER,
+    LOG_ARG_STRING,         /**< const char*, UTF-8 */
+    LOG_ARG_WSTRING         /**< const wchar_t* (%ls, %S), stored as UTF-8 */
+} LogArgKind;
+
+/**
+ * @brief Argument kinds of a printf format, in order
+ * @return Number of arguments, or -1 if the format cannot be encoded
+ *         (%n, too many arguments, unknown conversion)
+ */
+int LogBinary_ParseSignature(const char* format, uint8_t* kinds, int maxKinds);
+
+/**
+ * @brief Intern a format string by address (string literals only)
+ * @param outId Receives the format ID
+ * @param outKinds Receives the argument kinds (valid for the process lifetime)
+ * @return Argument count, or -1 if the format cannot be encoded or the table is full
+ */
+int LogBinary_Intern(const char* format, uint32_t* outId, const uint8_t** outKinds);
+
+/** @brief Format string for an interned ID, NULL if unknown */
+const char* LogBinary_FormatForId(uint32_t id);
+
+/**
+ * @brief Store the arguments described by kinds
+ * @return Bytes written, or LOG_BINARY_ENCODE_FAILED if they do not fit
+ *         (the va_list is then partially consumed)
+ */
+size_t LogBinary_EncodeArgs(uint8_t* out, size_t capacity, const uint8_t* kinds, int count, va_list args);
+
+/** @brief Write the file header (LOG_BINARY_FILE_HEADER_SIZE bytes) */
+size_t LogBinary_WriteFileHeader(uint8_t* out);
+
+/** @brief Write a chunk header (LOG_BINARY_CHUNK_HEADER_SIZE bytes) */
+size_t LogBinary_WriteChunkHeader(uint8_t* out, LogBinaryChunkType type, uint32_t payloadLength);
+
+void LogBinary_PutU32(uint8_t* out, uint32_t value);
+void LogBinary_PutU64(uint8_t* out, uint64_t value);
+uint32_t LogBinary_GetU32(const uint8_t* in);
+uint64_t LogBinary_GetU64(const uint8_t* in);
+
+/**
+ * @brief Render a RECORD's arguments through its format string
+ * @return Length of the text (truncated to outSize - 1), or -1 if the
+ *         arguments are malformed for the format
+ */
+int LogBinary_FormatRecord(const char* format, const uint8_t* args, size_t argsLength,
+                           char* out, size_t outSize);
+
+#endif
@@ -0,0 +1,75 @@
+/**
+ * @file log_ring.h
+ * @brief Bounded multi-producer, single-consumer ring of log records
+ *
+ * Portable C11 (no Windows headers). Any thread claims a slot, formats its
+ * record straight into it and commits; the log writer thread drains the
+ * ring in claim order. A full ring makes LogRing_BeginWrite fail instead of
+ * blocking, so the caller decides whether to drop or wait.
+ */
+
+#ifndef LOG_RING_H
+#define LOG_RING_H
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/** @brief Bytes of record payload per slot; longer messages are truncated */
+#define LOG_RING_PAYLOAD_MAX 1000
+
+typedef struct {
+    _Atomic size_t sequence;    /**< Vyukov sequence: position when free, position + 1 when committed */
+    uint64_t timestamp;         /**< Caller-defined clock (the logger uses FILETIME) */
+    uint32_t length;            /**< Payload bytes used */
+    uint16_t level;
+    uint16_t flags;             /**< Caller-defined */
+    char payload[LOG_RING_PAYLOAD_MAX];
+} LogRingSlot;
+
+typedef struct {
+    LogRingSlot* slots;
+    size_t mask;                        /**< Capacity - 1 (capacity is a power of two) */
+    _Atomic size_t enqueuePos;          /**< Next position producers claim */
+    size_t dequeuePos;                  /**< Next position the consumer reads */
+    _Atomic uint64_t dropped;           /**< Records refused because the ring was full */
+} LogRing;
+
+/**
+ * @brief Allocate the slots
+ * @param capacity Number of slots, rounded up to a power of two (at least 2)
+ * @return 1 on success
+ */
+int LogRing_Init(LogRing* ring, size_t capacity);
+
+void LogRing_Destroy(LogRing* ring);
+
+/**
+ * @brief Claim the next slot (any thread, lock-free)
+ * @param outPos Receives the claimed position, for LogRing_Commit
+ * @return Slot to fill, or NULL if the ring is full
+ */
+LogRingSlot* LogRing_BeginWrite(LogRing* ring, size_t* outPos);
+
+/** @brief Publish a filled slot to the consumer */
+void LogRing_Commit(LogRing* ring, LogRingSlot* slot, size_t pos);
+
+/** @brief Count one record that could not be queued */
+void LogRing_NoteDropped(LogRing* ring);
+
+/** @brief Take and reset the dropped-record count */
+uint64_t LogRing_TakeDropped(LogRing* ring);
+
+/**
+ * @brief Next committed slot, in claim order (single consumer)
+ * @return NULL if the next slot is not committed yet
+ */
+const LogRingSlot* LogRing_Peek(LogRing* ring);
+
+/** @brief Return the slot from LogRing_Peek to producers */
+void LogRing_Release(LogRing* ring);
+
+/** @brief Position of the next slot the consumer will read */
+size_t LogRing_ReadPosition(const LogRing* ring);
+
+#endif
@@ -0,0 +1,44 @@
+/**
+ * @file menu_id_map.h
+ * @brief Dense map from dynamic menu IDs to the items they were built for
+ *
+ * Portable C11 (no Windows headers). Items are numbered as a menu is
+ * filled: item i gets ID baseId + i, and resolving an ID is a bounds check
+ * and an index. IDs are handed out only up to baseId + maxItems, so a
+ * large tree can never spill into the next command range.
+ */
+
+#ifndef MENU_ID_MAP_H
+#define MENU_ID_MAP_H
+
+#include <stdint.h>
+
+typedef struct {
+    uint32_t baseId;            /**< ID of the first item */
+    uint32_t maxItems;          /**< IDs reserved for this map */
+    const void** items;
+    uint32_t count;             /**< IDs handed out since the last reset */
+    uint32_t capacity;
+    uint32_t truncated;         /**< Items refused since the last reset because the range was full */
+} MenuIdMap;
+
+#define MENU_ID_MAP_INIT(baseId, maxItems) {(baseId), (maxItems), NULL, 0, 0, 0}
+
+/** @brief Start a new numbering; the item array is kept for reuse */
+void MenuIdMap_Reset(MenuIdMap* map);
+
+/** @brief Free the item array */
+void MenuIdMap_Release(MenuIdMap* map);
+
+/**
+ * @brief Assign the next ID to an item
+ * @return Menu ID, or 0 once maxItems IDs have been handed out (the item is
+ *         then not added; truncated counts the refusals). If growing the
+ *         item array fails the item still gets its ID, only its lookup fails.
+ */
+uint32_t MenuIdMap_Record(MenuIdMap* map, const void* item);
+
+/** @brief Item recorded for an ID, NULL if the ID is not one of this map's items */
+const void* MenuIdMap_Lookup(const MenuIdMap* map, uint32_t menuId);
+
+#endif
@@ -0,0 +1,41 @@
+/**
+ * @file metric_history.h
+ * @brief Fixed-size history ring for sampled metric series
+ *
+ * Portable C11 (no Windows headers). One ring per series, written by the
+ * system monitor's sampler; readers copy the recent values out under the
+ * monitor's seqlock.
+ */
+
+#ifndef METRIC_HISTORY_H
+#define METRIC_HISTORY_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/** @brief Samples kept per series (64 s at the default 1 Hz rate) */
+#define METRIC_HISTORY_CAPACITY 64
+
+/** @brief Ring of the most recent samples, oldest overwritten first */
+typedef struct {
+    float values[METRIC_HISTORY_CAPACITY];
+    uint32_t head;      /**< Index the next sample is written to */
+    uint32_t count;     /**< Valid samples, at most METRIC_HISTORY_CAPACITY */
+} MetricHistory;
+
+/** @brief Drop all samples */
+void MetricHistory_Clear(MetricHistory* history);
+
+/** @brief Append one sample, overwriting the oldest once full */
+void MetricHistory_Push(MetricHistory* history, float value);
+
+/**
+ * @brief Copy up to max of the most recent samples, oldest first
+ * @return Number of samples written to out
+ */
+size_t MetricHistory_CopyRecent(const MetricHistory* history, float* out, size_t max);
+
+/** @brief Largest of the most recent window samples (0 if empty) */
+float MetricHistory_Peak(const MetricHistory* history, size_t window);
+
+#endif
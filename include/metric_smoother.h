@@ -0,0 +1,60 @@
+/**
+ * @file metric_smoother.h
+ * @brief Per-metric smoothing of sampled values (EWMA or moving window)
+ *
+ * Portable C11 (no Windows headers). The system monitor runs each raw
+ * reading through one smoother per metric before publishing it. EWMA is
+ * time-aware, so it keeps the same time constant when the sampling
+ * interval changes.
+ */
+
+#ifndef METRIC_SMOOTHER_H
+#define METRIC_SMOOTHER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/** @brief Largest moving-window length in samples */
+#define METRIC_SMOOTHER_MAX_WINDOW 32
+
+typedef enum {
+    METRIC_SMOOTHING_NONE = 0,      /**< Publish raw readings */
+    METRIC_SMOOTHING_EWMA,          /**< Exponential average, param = time constant in ms */
+    METRIC_SMOOTHING_WINDOW         /**< Mean of the last param samples */
+} MetricSmoothingMode;
+
+typedef struct {
+    MetricSmoothingMode mode;
+    uint32_t param;                 /**< Time constant (ms) or window length (samples) */
+    double value;                   /**< Last smoothed value */
+    uint64_t lastMs;                /**< Time of the last reading (EWMA) */
+    int primed;                     /**< A reading has been taken since configuration */
+    float window[METRIC_SMOOTHER_MAX_WINDOW];
+    uint32_t head;
+    uint32_t count;
+    double windowSum;
+} MetricSmoother;
+
+/**
+ * @brief Set the smoothing mode and drop accumulated state
+ * @param param EWMA time constant in ms, or window length (clamped to 1..METRIC_SMOOTHER_MAX_WINDOW)
+ */
+void MetricSmoother_Configure(MetricSmoother* smoother, MetricSmoothingMode mode, uint32_t param);
+
+/** @brief Drop accumulated state, keeping the configuration */
+void MetricSmoother_Reset(MetricSmoother* smoother);
+
+/**
+ * @brief Feed one raw reading
+ * @param nowMs Monotonic time of the reading in ms
+ * @return Smoothed value (the raw value itself for the first reading)
+ */
+float MetricSmoother_Apply(MetricSmoother* smoother, float raw, uint64_t nowMs);
+
+/**
+ * @brief Parse "none", "ewma:<ms>" or "window:<samples>"
+ * @return 1 on success; on failure mode/param are left untouched
+ */
+int MetricSmoother_Parse(const char* text, MetricSmoothingMode* mode, uint32_t* param);
+
+#endif
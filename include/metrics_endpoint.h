@@ -0,0 +1,36 @@
+/**
+ * @file metrics_endpoint.h
+ * @brief Optional local metrics endpoint (Prometheus text format)
+ *
+ * Disabled unless [Options] METRICS_ENDPOINT_PORT is set. The page is
+ * rebuilt on the UI thread once per sampling interval and served from that
+ * prebuilt buffer, so a scrape never touches timer or monitor state.
+ */
+
+#ifndef METRICS_ENDPOINT_H
+#define METRICS_ENDPOINT_H
+
+#include <windows.h>
+
+/** @brief Start listening on 127.0.0.1 if configured (no-op otherwise) */
+void MetricsEndpoint_Start(void);
+
+/** @brief Stop the listener and free the page */
+void MetricsEndpoint_Stop(void);
+
+/** @brief Rebuild the served page from current state (UI thread, ~1 Hz) */
+void MetricsEndpoint_Refresh(void);
+
+/** @brief Record one main-window paint duration (UI thread) */
+void MetricsEndpoint_ObservePaintMs(double ms);
+
+/** @brief Record one animation tray update (Shell_NotifyIcon) duration (UI thread) */
+void MetricsEndpoint_ObserveTrayUpdateMs(double ms);
+
+/** @brief Record one menu hover-to-preview dispatch duration (UI thread) */
+void MetricsEndpoint_ObserveMenuPreviewMs(double ms);
+
+/** @brief Record one tray click-to-menu-visible duration (UI thread) */
+void MetricsEndpoint_ObserveMenuOpenMs(double ms);
+
+#endif
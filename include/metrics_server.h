@@ -0,0 +1,102 @@
+/**
+ * @file metrics_server.h
+ * @brief Loopback HTTP server for a prebuilt Prometheus text page
+ *
+ * Portable C11 (sockets and threads behind small shims). The caller formats
+ * the page with the MetricsPage helpers and publishes it; the server thread
+ * only copies the last published response out under a short lock and sends
+ * it, so a scrape never touches application state.
+ *
+ * - GET (any path) gets the page: 200 with Content-Length
+ * - Any other method gets 405
+ * - A GET before the first publish gets 503
+ */
+
+#ifndef METRICS_SERVER_H
+#define METRICS_SERVER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/** @brief Largest response (headers + page) */
+#define METRICS_PAGE_CAPACITY 16384
+
+/** @brief Histogram bucket upper bounds in milliseconds (+Inf implied) */
+#define METRICS_LATENCY_BUCKET_COUNT 9
+extern const double kMetricsLatencyBucketsMs[METRICS_LATENCY_BUCKET_COUNT];
+
+/** @brief Text buffer being formatted */
+typedef struct {
+    char* data;
+    size_t length;
+    size_t capacity;
+    int overflow;               /**< Set once an append did not fit; later appends are ignored */
+} MetricsPage;
+
+/** @brief Cumulative latency histogram (single writer) */
+typedef struct {
+    uint64_t buckets[METRICS_LATENCY_BUCKET_COUNT];   /**< Observations <= bound, per bucket (not cumulative) */
+    uint64_t count;
+    double sumMs;
+} MetricsLatencyHistogram;
+
+/** @brief Fills the body of the page; called by MetricsServer_Publish */
+typedef void (*MetricsPageWriter)(MetricsPage* page, void* context);
+
+/* ============================================================================
+ * Page formatting
+ * ============================================================================ */
+
+/** @brief printf-style append; sets overflow instead of truncating */
+void MetricsPage_Append(MetricsPage* page, const char* format, ...);
+
+/** @brief One gauge family with a single unlabelled sample */
+void MetricsPage_AppendGauge(MetricsPage* page, const char* name, const char* help, double value);
+
+/** @brief One histogram family in seconds, as Prometheus expects */
+void MetricsPage_AppendHistogram(MetricsPage* page, const char* name, const char* help,
+                                 const MetricsLatencyHistogram* hist);
+
+/** @brief Record one observation (negative values count as 0) */
+void MetricsHistogram_Observe(MetricsLatencyHistogram* hist, double ms);
+
+/* ============================================================================
+ * Server
+ * ============================================================================ */
+
+/**
+ * @brief Listen on 127.0.0.1:port and start the server thread
+ * @param port TCP port; 0 picks a free one (see MetricsServer_GetPort)
+ * @param outError Receives the socket error code on failure (may be NULL)
+ * @return 1 on success (or already running), 0 on failure, including while
+ *         the thread of a timed-out stop is still running
+ */
+int MetricsServer_Start(int port, int* outError);
+
+/**
+ * @brief Stop the server thread and free the pages; safe when not running
+ *
+ * If the thread does not exit in time, the socket and pages stay with it
+ * and are released by the first Start after it has exited.
+ */
+void MetricsServer_Stop(void);
+
+/** @return Whether the server thread is running */
+int MetricsServer_IsRunning(void);
+
+/** @return Port actually bound, 0 when not running */
+int MetricsServer_GetPort(void);
+
+/**
+ * @brief Format a new page and make it the served response
+ *
+ * Single publisher; the server keeps serving the previous page while the
+ * writer runs.
+ * @return 1 if published, 0 if not running or the page did not fit
+ */
+int MetricsServer_Publish(MetricsPageWriter writer, void* context);
+
+/** @return Pages served (200 responses) since start */
+long MetricsServer_GetScrapes(void);
+
+#endif
@@ -0,0 +1,22 @@
+/**
+ * @file natural_sort.h
+ * @brief Natural-order string comparison shared by menus and frame loaders
+ */
+
+#ifndef NATURAL_SORT_H
+#define NATURAL_SORT_H
+
+#include <wchar.h>
+
+/**
+ * @brief Natural sort comparison for wide-char strings with numeric awareness
+ *
+ * Digit runs compare by leading-zero count first, more zeros sorting earlier
+ * ("007" < "07" < "7", and "09" < "2"), then by value ("2" < "10"). Other
+ * characters compare case-insensitively; a string that is a prefix of the
+ * other comes first.
+ * @return -1 if a<b, 0 if equal, 1 if a>b
+ */
+int NaturalCompareW(const wchar_t* a, const wchar_t* b);
+
+#endif
@@ -0,0 +1,68 @@
+/**
+ * @file net_rate.h
+ * @brief Byte-rate computation from per-interface 64-bit traffic counters
+ *
+ * Portable C11 (no Windows headers). The system monitor feeds it the
+ * counters it reads with GetIfEntry2; everything here is plain arithmetic
+ * so it behaves the same on any platform.
+ */
+
+#ifndef NET_RATE_H
+#define NET_RATE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Largest delta accepted as real traffic
+ *
+ * A 64-bit counter that wraps once yields a small modular delta. A counter
+ * that was reset (adapter restart, driver reload) yields an enormous one,
+ * which is treated as zero instead of a multi-exabyte burst.
+ */
+#define NET_RATE_MAX_PLAUSIBLE_DELTA (UINT64_C(1) << 62)
+
+/** @brief Counters of one interface at one instant */
+typedef struct {
+    uint32_t id;            /**< Stable interface identifier (interface index) */
+    uint64_t inOctets;      /**< Total bytes received */
+    uint64_t outOctets;     /**< Total bytes sent */
+} NetRateSample;
+
+/**
+ * @brief Previous sample set, matched by interface id
+ *
+ * Deltas are taken per interface, so an interface that appears or
+ * disappears between samples contributes nothing instead of making the
+ * aggregate jump.
+ */
+typedef struct {
+    NetRateSample* last;    /**< Previous counters; grows with the interface count */
+    size_t count;
+    size_t capacity;
+    uint64_t lastMs;        /**< Timestamp of the previous sample set */
+    int hasBaseline;
+} NetRateTracker;
+
+/** @brief Bytes moved between two readings of one counter, modulo 2^64 */
+uint64_t NetRate_CounterDelta(uint64_t previous, uint64_t current);
+
+/** @brief Forget the baseline; the next update only records counters */
+void NetRate_Reset(NetRateTracker* tracker);
+
+/** @brief Forget the baseline and free the counter buffer */
+void NetRate_Release(NetRateTracker* tracker);
+
+/**
+ * @brief Record a sample set and compute aggregate rates since the previous one
+ * @param samples Counters for the interfaces of interest
+ * @param nowMs Monotonic milliseconds
+ * @param outUpBps Receives bytes/sec sent (unchanged when 0 is returned)
+ * @param outDownBps Receives bytes/sec received (unchanged when 0 is returned)
+ * @return 1 if rates were computed, 0 if this call only established a baseline
+ *         or no time has passed since the previous sample
+ */
+int NetRate_Update(NetRateTracker* tracker, const NetRateSample* samples, size_t count,
+                   uint64_t nowMs, double* outUpBps, double* outDownBps);
+
+#endif
@@ -0,0 +1,45 @@
+/**
+ * @file portable_lock.h
+ * @brief Mutex shim for the portable modules
+ *
+ * SRWLOCK on Windows, a pthread mutex elsewhere. Both initialise
+ * statically and block instead of spinning, so a low-priority holder that
+ * gets preempted never leaves a higher-priority waiter burning its quantum.
+ */
+
+#ifndef PORTABLE_LOCK_H
+#define PORTABLE_LOCK_H
+
+#ifdef _WIN32
+
+#include <windows.h>
+
+typedef SRWLOCK PortableLock;
+#define PORTABLE_LOCK_INIT SRWLOCK_INIT
+
+static inline void PortableLock_Acquire(PortableLock* lock) {
+    AcquireSRWLockExclusive(lock);
+}
+
+static inline void PortableLock_Release(PortableLock* lock) {
+    ReleaseSRWLockExclusive(lock);
+}
+
+#else
+
+#include <pthread.h>
+
+typedef pthread_mutex_t PortableLock;
+#define PORTABLE_LOCK_INIT PTHREAD_MUTEX_INITIALIZER
+
+static inline void PortableLock_Acquire(PortableLock* lock) {
+    pthread_mutex_lock(lock);
+}
+
+static inline void PortableLock_Release(PortableLock* lock) {
+    pthread_mutex_unlock(lock);
+}
+
+#endif
+
+#endif
@@ -0,0 +1,101 @@
+/**
+ * @file portable_socket.h
+ * @brief BSD socket shim for the portable modules
+ *
+ * Winsock on Windows, POSIX sockets elsewhere. Only what a small blocking
+ * TCP server needs: startup, timeouts, half-close and close.
+ */
+
+#ifndef PORTABLE_SOCKET_H
+#define PORTABLE_SOCKET_H
+
+#ifdef _WIN32
+
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <windows.h>
+
+typedef SOCKET PortableSocket;
+#define PORTABLE_INVALID_SOCKET INVALID_SOCKET
+#define PORTABLE_SEND_FLAGS 0
+
+static inline int PortableSocket_Startup(void) {
+    WSADATA wsa;
+    return WSAStartup(MAKEWORD(2, 2), &wsa) == 0;
+}
+
+static inline void PortableSocket_Cleanup(void) {
+    WSACleanup();
+}
+
+static inline int PortableSocket_LastError(void) {
+    return WSAGetLastError();
+}
+
+static inline void PortableSocket_Close(PortableSocket s) {
+    closesocket(s);
+}
+
+static inline void PortableSocket_ShutdownSend(PortableSocket s) {
+    shutdown(s, SD_SEND);
+}
+
+/** @brief Refuse to share the port with another listener */
+static inline void PortableSocket_SetExclusive(PortableSocket s) {
+    BOOL exclusive = TRUE;
+    setsockopt(s, SOL_SOCKET, SO_EXCLUSIVEADDRUSE, (const char*)&exclusive, sizeof(exclusive));
+}
+
+static inline void PortableSocket_SetTimeouts(PortableSocket s, unsigned int ms) {
+    DWORD timeout = ms;
+    setsockopt(s, SOL_SOCKET, SO_RCVTIMEO, (const char*)&timeout, sizeof(timeout));
+    setsockopt(s, SOL_SOCKET, SO_SNDTIMEO, (const char*)&timeout, sizeof(timeout));
+}
+
+#else
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+typedef int PortableSocket;
+#define PORTABLE_INVALID_SOCKET (-1)
+#define PORTABLE_SEND_FLAGS MSG_NOSIGNAL    /**< A client that hangs up must not raise SIGPIPE */
+
+static inline int PortableSocket_Startup(void) {
+    return 1;
+}
+
+static inline void PortableSocket_Cleanup(void) {
+}
+
+static inline int PortableSocket_LastError(void) {
+    return errno;
+}
+
+static inline void PortableSocket_Close(PortableSocket s) {
+    close(s);
+}
+
+static inline void PortableSocket_ShutdownSend(PortableSocket s) {
+    shutdown(s, SHUT_WR);
+}
+
+/** @brief POSIX listeners are exclusive unless SO_REUSEPORT is set */
+static inline void PortableSocket_SetExclusive(PortableSocket s) {
+    (void)s;
+}
+
+static inline void PortableSocket_SetTimeouts(PortableSocket s, unsigned int ms) {
+    struct timeval tv = {(time_t)(ms / 1000), (suseconds_t)((ms % 1000) * 1000)};
+    setsockopt(s, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    setsockopt(s, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+}
+
+#endif
+
+#endif
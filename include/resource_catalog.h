@@ -0,0 +1,120 @@
+/**
+ * @file resource_catalog.h
+ * @brief In-memory index of the fonts, animations and audio folders
+ *
+ * Each resources subfolder is scanned once into an immutable, naturally
+ * sorted tree (directories first, then NaturalCompareW). Snapshots are
+ * built on a worker thread and replaced when the config watcher reports a
+ * change in their area; menus, previews, font lookup and the sound list
+ * all read the same snapshot instead of walking the disk themselves.
+ */
+
+#ifndef RESOURCE_CATALOG_H
+#define RESOURCE_CATALOG_H
+
+#include <windows.h>
+
+/** @brief Indexed resources subfolders */
+typedef enum {
+    CATALOG_ROOT_FONTS,             /**< resources\fonts */
+    CATALOG_ROOT_ANIMATIONS,        /**< resources\animations */
+    CATALOG_ROOT_AUDIO,             /**< resources\audio */
+    CATALOG_ROOT_COUNT
+} CatalogRoot;
+
+/** @brief Entry kinds; files with other extensions are not indexed */
+typedef enum {
+    CATALOG_ENTRY_DIRECTORY,
+    CATALOG_ENTRY_FONT,             /**< .ttf, .otf */
+    CATALOG_ENTRY_ANIMATED_IMAGE,   /**< .gif, .webp */
+    CATALOG_ENTRY_IMAGE,            /**< .ico, .png, .bmp, .jpg, .jpeg, .tif, .tiff */
+    CATALOG_ENTRY_AUDIO             /**< .flac, .mp3, .wav */
+} CatalogEntryType;
+
+/**
+ * @brief One file or directory in a snapshot
+ *
+ * Strings live in the snapshot's string pool; the names point into the
+ * tails of the relative paths. A directory's children are stored
+ * contiguously and already sorted.
+ */
+typedef struct {
+    const wchar_t* relPathW;        /**< Path relative to the root, '\\'-separated */
+    const char* relPathUtf8;
+    const wchar_t* nameW;           /**< Last path component */
+    const char* nameUtf8;
+    UINT id;                        /**< Stable across rebuilds while the path exists (never 0) */
+    UINT firstChild;                /**< Index of the first child (directories) */
+    UINT childCount;
+    CatalogEntryType type;
+    ULONGLONG size;                 /**< Bytes (0 for directories) */
+    FILETIME lastWrite;
+} CatalogEntry;
+
+/** @brief Immutable, reference-counted snapshot of one root */
+typedef struct ResourceCatalog ResourceCatalog;
+
+/** @brief Start the background builder; snapshots are built right away */
+void ResourceCatalog_Start(void);
+
+/** @brief Stop the builder and drop the current snapshots */
+void ResourceCatalog_Stop(void);
+
+/** @brief Wake the builder to rebuild snapshots whose area has changed (any thread) */
+void ResourceCatalog_Refresh(void);
+
+/**
+ * @brief Mark a root stale after writing to it ourselves
+ *
+ * The watcher reports changes only after its debounce delay; a caller that
+ * has just created files and wants to list them at once calls this first.
+ */
+void ResourceCatalog_Invalidate(CatalogRoot root);
+
+/**
+ * @brief Current snapshot of a root (any thread)
+ *
+ * If the snapshot is missing or older than the watcher's generation for its
+ * area, it is rebuilt on the calling thread (or awaited if the builder is
+ * already on it), so the result always reflects the last reported change.
+ * @return Snapshot to pass to ResourceCatalog_Release, or NULL if out of memory
+ */
+const ResourceCatalog* ResourceCatalog_Acquire(CatalogRoot root);
+
+/** @brief Release a snapshot from ResourceCatalog_Acquire (NULL is ignored) */
+void ResourceCatalog_Release(const ResourceCatalog* catalog);
+
+/** @brief Absolute path of the snapshot's root folder */
+const wchar_t* ResourceCatalog_GetRootPath(const ResourceCatalog* catalog);
+
+/**
+ * @brief Sorted children of a directory
+ * @param dir Directory entry, or NULL for the root
+ * @param outCount Receives the number of children
+ * @return First child (contiguous array), NULL when there are none
+ */
+const CatalogEntry* ResourceCatalog_GetChildren(const ResourceCatalog* catalog,
+                                                const CatalogEntry* dir, UINT* outCount);
+
+/**
+ * @brief Whether an animations folder is played as one frame sequence
+ *
+ * A folder without sub-folders or animated images is a leaf: the menus list
+ * it as a single item instead of a submenu.
+ */
+BOOL ResourceCatalog_IsAnimationLeaf(const ResourceCatalog* catalog, const CatalogEntry* folder);
+
+/**
+ * @brief First file with the given name, in menu order (case-insensitive)
+ * @return Entry or NULL
+ */
+const CatalogEntry* ResourceCatalog_FindFileByName(const ResourceCatalog* catalog, const wchar_t* nameW);
+
+/**
+ * @brief Absolute path of an entry
+ * @return TRUE on success, FALSE if the buffer is too small
+ */
+BOOL ResourceCatalog_GetFullPath(const ResourceCatalog* catalog, const CatalogEntry* entry,
+                                 wchar_t* outPath, size_t outSize);
+
+#endif
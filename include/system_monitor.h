@@ -8,10 +8,125 @@
 
 #include <windows.h>
 
+#include "metric_smoother.h"
+
+/** @brief Most processors reported per core (one processor group) */
+#define SYSTEM_MONITOR_MAX_CORES 64
+
+/** @brief History series for SystemMonitor_GetHistory */
+enum {
+    SYSTEM_SERIES_CPU = 0,          /**< Whole-system CPU */
+    SYSTEM_SERIES_MEMORY,           /**< Physical memory */
+    SYSTEM_SERIES_PROCESS,          /**< Watched process CPU */
+    SYSTEM_SERIES_CORE_FIRST        /**< Core n is SYSTEM_SERIES_CORE_FIRST + n */
+};
+
+/** @brief Metrics that are smoothed independently (SystemMonitor_SetSmoothing) */
+typedef enum {
+    SYSTEM_METRIC_CPU = 0,
+    SYSTEM_METRIC_MEMORY,
+    SYSTEM_METRIC_NETWORK,          /**< Upload and download rates */
+    SYSTEM_METRIC_PROCESS,
+    SYSTEM_METRIC_CORES,
+    SYSTEM_METRIC_COUNT
+} SystemMetricKind;
+
+/**
+ * @brief Consumers whose needs set the sampling rate (SystemMonitor_SetConsumer)
+ * 
+ * The most demanding active consumer wins: an animation whose speed follows
+ * CPU/memory samples at the fast rate, icons and the metrics endpoint at the
+ * update interval, and the tooltip alone at the idle rate, or not at all
+ * while the tray is not visible.
+ */
+typedef enum {
+    SYSTEM_CONSUMER_TOOLTIP   = 0x1,
+    SYSTEM_CONSUMER_ICON      = 0x2,
+    SYSTEM_CONSUMER_EXPORT    = 0x4,
+    SYSTEM_CONSUMER_ANIMATION = 0x8
+} SystemMonitorConsumer;
+
+/** @brief Cumulative sampling cost, for diagnostics */
+typedef struct {
+    ULONGLONG samples;          /**< Samples taken */
+    double sampleWallMs;        /**< Wall time spent sampling */
+    double samplerCpuMs;        /**< Sampler thread CPU time (kernel + user) */
+    ULONGLONG activeMs;         /**< Time the sampler thread has been running */
+    DWORD currentIntervalMs;    /**< Interval now in use, INFINITE while paused */
+} SystemSamplingStats;
+
+/**
+ * @brief One published sample of every metric
+ * 
+ * Produced by the sampler thread; getters return copies and never sample.
+ * Values are smoothed as configured; histories keep the raw readings.
+ */
+typedef struct {
+    float cpuPercent;           /**< CPU usage (0.0-100.0) */
+    float memPercent;           /**< Physical memory usage (0.0-100.0) */
+    float upBytesPerSec;        /**< Upload speed */
+    float downBytesPerSec;      /**< Download speed */
+    int coreCount;              /**< Valid corePercent entries, 0 until two samples exist */
+    float corePercent[SYSTEM_MONITOR_MAX_CORES];
+    float processPercent;       /**< Watched process, share of the whole machine */
+    BOOL processValid;          /**< A watched process is running and sampled */
+    ULONGLONG timestampMs;      /**< GetTickCount64() at sampling, 0 = no sample yet */
+} SystemMetricsSnapshot;
+
 void SystemMonitor_Init(void);
 void SystemMonitor_Shutdown(void);
+
+/**
+ * @brief Reference-counted interest in live metrics
+ * 
+ * The first Subscribe starts the sampler thread and the last Unsubscribe
+ * stops it, so nothing is sampled while no consumer is showing metrics.
+ */
+void SystemMonitor_Subscribe(void);
+void SystemMonitor_Unsubscribe(void);
+
 void SystemMonitor_SetUpdateIntervalMs(DWORD intervalMs);
+
+/** @brief Declare whether a consumer currently needs metrics */
+void SystemMonitor_SetConsumer(SystemMonitorConsumer consumer, BOOL active);
+
+/** @brief Whether the tray can be seen at all (display on); FALSE pauses tooltip-only sampling */
+void SystemMonitor_SetTrayVisible(BOOL visible);
+
+/**
+ * @brief Intervals for the fast (animation) and idle (tooltip only) rates
+ * @param fastMs 0 restores the default
+ * @param idleMs 0 restores the default
+ */
+void SystemMonitor_SetAdaptiveIntervals(DWORD fastMs, DWORD idleMs);
+DWORD SystemMonitor_GetFastIntervalMs(void);
+
+/** @brief Smoothing applied to one metric before it is published */
+void SystemMonitor_SetSmoothing(SystemMetricKind metric, MetricSmoothingMode mode, DWORD param);
+
+/** @brief Restore a metric's built-in smoothing (EWMA for CPU, none otherwise) */
+void SystemMonitor_ResetSmoothing(SystemMetricKind metric);
+
+BOOL SystemMonitor_GetSamplingStats(SystemSamplingStats* outStats);
+
+/** @brief Wake the sampler for a sample now; returns at once, later reads see the result */
 void SystemMonitor_ForceRefresh(void);
+BOOL SystemMonitor_GetSnapshot(SystemMetricsSnapshot* outSnapshot);
+
+/**
+ * @brief Watch one process by executable name (e.g. L"cl.exe"); NULL or "" stops
+ * 
+ * The first running match is sampled; when it exits the next match is
+ * picked up within a few seconds.
+ */
+void SystemMonitor_WatchProcess(const wchar_t* exeName);
+
+/**
+ * @brief Copy up to maxCount recent samples of a series, oldest first
+ * @param series SYSTEM_SERIES_* value (cores: SYSTEM_SERIES_CORE_FIRST + index)
+ * @return Number of samples written
+ */
+int SystemMonitor_GetHistory(int series, float* out, int maxCount);
 BOOL SystemMonitor_GetCpuUsage(float* outPercent);
 BOOL SystemMonitor_GetMemoryUsage(float* outPercent);
 BOOL SystemMonitor_GetUsage(float* outCpuPercent, float* outMemPercent);
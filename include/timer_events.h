@@ -12,7 +12,6 @@
 #define TIMER_ID_TOPMOST_RETRY 999
 #define TIMER_ID_VISIBILITY_RETRY 1000
 #define TIMER_ID_FORCE_REDRAW 1004
-#define TIMER_ID_FONT_VALIDATION 1006
 
 BOOL HandleTimerEvent(HWND hwnd, WPARAM wp);
 void ResetMillisecondAccumulator(void);
@@ -21,7 +21,11 @@ void ApplyAnimationPathValueNoPersist(const char* value);
 void TrayAnimation_SetBaseIntervalMs(UINT ms);
 void TrayAnimation_RecomputeTimerDelay(void);
 void TrayAnimation_UpdatePercentIconIfNeeded(void);
+void TrayAnimation_InvalidatePercentIconCache(void);
 void TrayAnimation_SetMinIntervalMs(UINT ms);
 BOOL TrayAnimation_HandleUpdateMessage(void);
+void TrayAnimation_HandleDpiChange(void);
+BOOL TrayAnimation_DumpTimingTrace(BOOL reveal);
+void TrayAnimation_PrefetchAnimations(const char* const* names, int count);
 
 #endif
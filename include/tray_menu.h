@@ -7,6 +7,7 @@
 #define CLOCK_TRAY_MENU_H
 
 #include <windows.h>
+#include "resource_catalog.h"
 
 #define CLOCK_IDM_SHOW_CURRENT_TIME 150
 #define CLOCK_IDM_24HOUR_FORMAT 151
@@ -70,7 +71,16 @@
 #define CLOCK_IDM_ANIMATIONS_USE_LOGO 2202
 #define CLOCK_IDM_ANIMATIONS_USE_CPU 2203
 #define CLOCK_IDM_ANIMATIONS_USE_MEM 2204
+#define CLOCK_IDM_ANIMATIONS_DUMP_TRACE 2205
+#define CLOCK_IDM_ANIMATIONS_USE_CPU_HISTORY 2206
+#define CLOCK_IDM_ANIMATIONS_USE_CPU_CORES 2207
+/** @brief Dynamic animation items: CLOCK_IDM_ANIMATIONS_BASE .. + MAX_ANIMATION_MENU_ITEMS - 1 */
 #define CLOCK_IDM_ANIMATIONS_BASE 3000
+#define MAX_ANIMATION_MENU_ITEMS 1000
+
+/** @brief Dynamic font items: CLOCK_IDM_FONTS_BASE .. + MAX_FONT_MENU_ITEMS - 1, past every fixed ID */
+#define CLOCK_IDM_FONTS_BASE 4000
+#define MAX_FONT_MENU_ITEMS 2000
 
 #define CLOCK_IDM_ANIM_SPEED_MEMORY 2210
 #define CLOCK_IDM_ANIM_SPEED_CPU 2211
@@ -80,4 +90,23 @@ void ShowContextMenu(HWND hwnd);
 void ShowColorMenu(HWND hwnd);
 BOOL HandleAnimationMenuCommand(HWND hwnd, UINT id);
 
+/**
+ * @brief Catalog entry behind a font / animation menu item (UI thread)
+ *
+ * Recorded as the menu is filled, so the lookup is an array index. The entry
+ * stays valid until the menu is rebuilt.
+ * @return Entry, or NULL if the ID is not a dynamic item of the last menu
+ */
+const CatalogEntry* TrayMenu_GetFontItem(UINT menuId);
+const CatalogEntry* TrayMenu_GetAnimationItem(UINT menuId);
+
+/**
+ * @brief Fill a submenu that was created empty (WM_INITMENUPOPUP)
+ * @return TRUE if the menu was waiting to be filled
+ */
+BOOL TrayMenu_HandleInitMenuPopup(HMENU menu);
+
+/** @brief First idle of the menu loop (WM_ENTERIDLE, MSGF_MENU); records the open latency */
+void TrayMenu_HandleMenuIdle(void);
+
 #endif
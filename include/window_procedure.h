@@ -10,6 +10,7 @@
 
 #define WM_APP_SHOW_CLI_HELP (WM_APP + 2)
 #define WM_APP_QUICK_COUNTDOWN_INDEX (WM_APP + 3)
+#define WM_APP_DUMP_ANIM_TRACE (WM_APP + 4)
 #define WM_APP_ANIM_PATH_CHANGED (WM_APP + 50)
 #define WM_APP_ANIM_SPEED_CHANGED (WM_APP + 51)
 #define WM_APP_DISPLAY_CHANGED (WM_APP + 52)
@@ -19,6 +20,7 @@
 #define WM_APP_HOTKEYS_CHANGED (WM_APP + 56)
 #define WM_APP_RECENTFILES_CHANGED (WM_APP + 57)
 #define WM_APP_COLORS_CHANGED (WM_APP + 58)
+#define WM_APP_RESOURCES_CHANGED (WM_APP + 59)   /**< wParam: changed WatchArea bits */
 
 #define COPYDATA_ID_CLI_TEXT 0x10010001
 
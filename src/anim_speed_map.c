@@ -0,0 +1,132 @@
+/**
+ * @file anim_speed_map.c
+ * @brief Animation speed map: breakpoint interpolation and its lookup table
+ */
+
+#include "../include/anim_speed_map.h"
+
+/* ============================================================================
+ * Helper Functions
+ * ============================================================================ */
+
+/**
+ * @brief Sort by percent, keeping config order among equal percents, then
+ * keep only the last point of each percent
+ *
+ * "MAP_50" and "MAP_050" both land on 50%; two scales at one percent would
+ * be a step the table cannot represent. At most 128 points, so insertion
+ * sort is enough and stable.
+ */
+static void SortAndDedupePoints(AnimSpeedMap* map) {
+    for (int i = 1; i < map->pointCount; ++i) {
+        AnimSpeedPoint point = map->points[i];
+        int j = i - 1;
+        while (j >= 0 && map->points[j].percent > point.percent) {
+            map->points[j + 1] = map->points[j];
+            j--;
+        }
+        map->points[j + 1] = point;
+    }
+
+    int kept = 0;
+    for (int i = 0; i < map->pointCount; ++i) {
+        if (kept > 0 && map->points[kept - 1].percent == map->points[i].percent) {
+            map->points[kept - 1] = map->points[i];
+        } else {
+            map->points[kept++] = map->points[i];
+        }
+    }
+    map->pointCount = kept;
+}
+
+static double ClampPercent(double percent) {
+    if (percent < 0.0) return 0.0;
+    if (percent > 100.0) return 100.0;
+    return percent;
+}
+
+/* ============================================================================
+ * Public API
+ * ============================================================================ */
+
+void AnimSpeedMap_Init(AnimSpeedMap* map, double defaultScalePercent) {
+    map->defaultScalePercent = defaultScalePercent;
+    map->pointCount = 0;
+    map->lutReady = 0;
+}
+
+int AnimSpeedMap_AddPoint(AnimSpeedMap* map, int percent, double scalePercent) {
+    if (map->pointCount >= ANIM_SPEED_MAP_MAX_POINTS) return 0;
+    if (percent < 0) percent = 0;
+    if (percent > 100) percent = 100;
+    if (scalePercent <= 0.0) scalePercent = 100.0;
+    map->points[map->pointCount].percent = percent;
+    map->points[map->pointCount].scalePercent = scalePercent;
+    map->pointCount++;
+    map->lutReady = 0;
+    return 1;
+}
+
+double AnimSpeedMap_Interpolate(const AnimSpeedMap* map, double percent) {
+    percent = ClampPercent(percent);
+
+    if (map->pointCount > 0) {
+        /** If below first breakpoint, interpolate from default to first */
+        if (percent <= (double)map->points[0].percent) {
+            double p0 = 0.0;
+            double s0 = map->defaultScalePercent;
+            double p1 = (double)map->points[0].percent;
+            double s1 = map->points[0].scalePercent;
+            if (p1 <= p0) return s1; /** guard divide-by-zero */
+            double t = (percent - p0) / (p1 - p0);
+            return s0 + (s1 - s0) * t;
+        }
+        /** Find segment [i, i+1] that contains percent */
+        for (int i = 0; i < map->pointCount - 1; ++i) {
+            double p0 = (double)map->points[i].percent;
+            double p1 = (double)map->points[i + 1].percent;
+            if (percent >= p0 && percent <= p1) {
+                double s0 = map->points[i].scalePercent;
+                double s1 = map->points[i + 1].scalePercent;
+                if (p1 <= p0) return s1;
+                double t = (percent - p0) / (p1 - p0);
+                return s0 + (s1 - s0) * t;
+            }
+        }
+        /** Above last breakpoint: clamp to last scale */
+        return map->points[map->pointCount - 1].scalePercent;
+    }
+
+    return map->defaultScalePercent;
+}
+
+void AnimSpeedMap_Build(AnimSpeedMap* map) {
+    SortAndDedupePoints(map);
+    for (int i = 0; i < ANIM_SPEED_LUT_SIZE; ++i) {
+        double scale = AnimSpeedMap_Interpolate(map, (double)i / ANIM_SPEED_LUT_STEPS_PER_PERCENT);
+        if (scale < 0.0) scale = 0.0;
+        if (scale > 65535.0) scale = 65535.0;
+        map->lut[i] = (uint32_t)(scale * ANIM_SPEED_FIXED_ONE + 0.5);
+    }
+    map->lutReady = 1;
+}
+
+double AnimSpeedMap_Lookup(const AnimSpeedMap* map, double percent) {
+    if (!map->lutReady) return AnimSpeedMap_Interpolate(map, percent);
+
+    percent = ClampPercent(percent);
+
+    /**
+     * Breakpoints sit on whole percents, so linear interpolation between
+     * adjacent 0.1% entries reproduces the map. Position is Q16 fixed point.
+     */
+    int64_t pos = (int64_t)(percent * ANIM_SPEED_LUT_STEPS_PER_PERCENT * ANIM_SPEED_FIXED_ONE + 0.5);
+    int64_t idx = pos >> 16;
+    if (idx >= ANIM_SPEED_LUT_SIZE - 1) {
+        return (double)map->lut[ANIM_SPEED_LUT_SIZE - 1] / ANIM_SPEED_FIXED_ONE;
+    }
+    int64_t a = map->lut[idx];
+    int64_t b = map->lut[idx + 1];
+    int64_t v = a + (((b - a) * (pos & 0xFFFF)) >> 16);
+    return (double)v / ANIM_SPEED_FIXED_ONE;
+}
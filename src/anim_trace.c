@@ -0,0 +1,215 @@
+/**
+ * @file anim_trace.c
+ * @brief Fixed-size multi-producer trace ring for animation timing
+ *
+ * Writers claim a slot with one atomic increment and publish it with a
+ * per-slot sequence number (odd while writing, even once committed), so the
+ * scheduler thread and the UI thread can both record without a lock and a
+ * reader can skip slots that were overwritten mid-copy.
+ */
+
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/anim_trace.h"
+
+#define TRACE_MASK (ANIM_TRACE_CAPACITY - 1)
+
+_Static_assert((ANIM_TRACE_CAPACITY & TRACE_MASK) == 0, "ANIM_TRACE_CAPACITY must be a power of two");
+
+typedef struct {
+    _Atomic uint64_t seq;       /**< 2*index+1 while writing, 2*index+2 when committed */
+    AnimTraceEvent event;
+} TraceSlot;
+
+/* ============================================================================
+ * Global State
+ * ============================================================================ */
+
+static TraceSlot g_slots[ANIM_TRACE_CAPACITY];
+static _Atomic uint64_t g_head = 0;     /**< Next index to claim */
+static _Atomic uint64_t g_start = 0;    /**< First index still reported after a reset */
+
+/* ============================================================================
+ * Helper Functions
+ * ============================================================================ */
+
+static int CompareDoubles(const void* a, const void* b) {
+    double da = *(const double*)a;
+    double db = *(const double*)b;
+    return (da > db) - (da < db);
+}
+
+/** @brief Nearest-rank percentile of a sorted array */
+static double Percentile(const double* sorted, size_t count, double pct) {
+    if (count == 0) return 0.0;
+    size_t rank = (size_t)(pct / 100.0 * (double)count + 0.999999);
+    if (rank < 1) rank = 1;
+    if (rank > count) rank = count;
+    return sorted[rank - 1];
+}
+
+static const char* KindName(uint32_t kind) {
+    switch (kind) {
+        case ANIM_TRACE_FRAME:         return "frame";
+        case ANIM_TRACE_TRAY_UPDATE:   return "tray_update";
+        case ANIM_TRACE_INTERVAL:      return "interval";
+        case ANIM_TRACE_SPEED:         return "speed";
+        case ANIM_TRACE_UPDATE_FAILED: return "update_failed";
+        case ANIM_TRACE_FALLBACK:      return "fallback";
+        default:                       return "unknown";
+    }
+}
+
+/* ============================================================================
+ * Public API
+ * ============================================================================ */
+
+void AnimTrace_Record(AnimTraceKind kind, double timeMs, double a, double b, int32_t value) {
+    uint64_t index = atomic_fetch_add_explicit(&g_head, 1, memory_order_relaxed);
+    TraceSlot* slot = &g_slots[index & TRACE_MASK];
+
+    atomic_store_explicit(&slot->seq, 2 * index + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    slot->event.timeMs = timeMs;
+    slot->event.a = a;
+    slot->event.b = b;
+    slot->event.value = value;
+    slot->event.kind = (uint32_t)kind;
+    atomic_store_explicit(&slot->seq, 2 * index + 2, memory_order_release);
+}
+
+size_t AnimTrace_Snapshot(AnimTraceEvent* out, size_t capacity) {
+    if (!out || capacity == 0) return 0;
+
+    uint64_t head = atomic_load_explicit(&g_head, memory_order_acquire);
+    uint64_t first = atomic_load_explicit(&g_start, memory_order_relaxed);
+    if (head - first > ANIM_TRACE_CAPACITY) first = head - ANIM_TRACE_CAPACITY;
+    if (head - first > capacity) first = head - capacity;
+
+    size_t written = 0;
+    for (uint64_t i = first; i < head; ++i) {
+        const TraceSlot* slot = &g_slots[i & TRACE_MASK];
+        uint64_t before = atomic_load_explicit(&slot->seq, memory_order_acquire);
+        if (before != 2 * i + 2) continue;  /** Still being written, or already reused */
+        AnimTraceEvent copy = slot->event;
+        atomic_thread_fence(memory_order_acquire);
+        uint64_t after = atomic_load_explicit(&slot->seq, memory_order_relaxed);
+        if (after != before) continue;
+        out[written++] = copy;
+    }
+    return written;
+}
+
+void AnimTrace_Summarize(const AnimTraceEvent* events, size_t count,
+                         double baseIntervalMs, double endMs, AnimTraceSummary* out) {
+    if (!out) return;
+    memset(out, 0, sizeof(*out));
+
+    uint64_t head = atomic_load_explicit(&g_head, memory_order_relaxed);
+    uint64_t start = atomic_load_explicit(&g_start, memory_order_relaxed);
+    out->overwritten = (head - start > ANIM_TRACE_CAPACITY) ? head - start - ANIM_TRACE_CAPACITY : 0;
+
+    if (!events || count == 0) return;
+
+    double* lateness = (double*)malloc(count * sizeof(double));
+    double* latency = (double*)malloc(count * sizeof(double));
+    double* shell = (double*)malloc(count * sizeof(double));
+    if (!lateness || !latency || !shell) {
+        free(lateness); free(latency); free(shell);
+        return;
+    }
+
+    size_t latencyCount = 0;
+    double throttleStart = -1.0;
+    for (size_t i = 0; i < count; ++i) {
+        const AnimTraceEvent* ev = &events[i];
+        switch (ev->kind) {
+            case ANIM_TRACE_FRAME: {
+                double late = ev->b - ev->a;
+                if (late < 0.0) late = 0.0;
+                lateness[out->frames++] = late;
+                if (late > out->latenessMax) out->latenessMax = late;
+                break;
+            }
+            case ANIM_TRACE_TRAY_UPDATE:
+                shell[out->trayUpdates++] = ev->b;
+                if (!ev->value) out->trayUpdateFailures++;
+                if (ev->a > 0.0) latency[latencyCount++] = ev->timeMs - ev->a;
+                break;
+            case ANIM_TRACE_INTERVAL:
+                out->intervalChanges++;
+                if (ev->b > baseIntervalMs && throttleStart < 0.0) {
+                    throttleStart = ev->timeMs;
+                } else if (ev->b <= baseIntervalMs && throttleStart >= 0.0) {
+                    out->throttledMs += ev->timeMs - throttleStart;
+                    throttleStart = -1.0;
+                }
+                break;
+            case ANIM_TRACE_FALLBACK:
+                out->fallbacks++;
+                break;
+            default:
+                break;
+        }
+    }
+
+    double last = (endMs > 0.0) ? endMs : events[count - 1].timeMs;
+    if (throttleStart >= 0.0 && last > throttleStart) {
+        out->throttledMs += last - throttleStart;
+    }
+    out->spanMs = last - events[0].timeMs;
+
+    qsort(lateness, out->frames, sizeof(double), CompareDoubles);
+    out->latenessP50 = Percentile(lateness, out->frames, 50.0);
+    out->latenessP95 = Percentile(lateness, out->frames, 95.0);
+    out->latenessP99 = Percentile(lateness, out->frames, 99.0);
+
+    qsort(latency, latencyCount, sizeof(double), CompareDoubles);
+    out->updateLatencyP50 = Percentile(latency, latencyCount, 50.0);
+    out->updateLatencyP95 = Percentile(latency, latencyCount, 95.0);
+    out->updateLatencyP99 = Percentile(latency, latencyCount, 99.0);
+
+    qsort(shell, out->trayUpdates, sizeof(double), CompareDoubles);
+    out->shellCallP95 = Percentile(shell, out->trayUpdates, 95.0);
+
+    free(lateness);
+    free(latency);
+    free(shell);
+}
+
+int AnimTrace_WriteCsv(FILE* out, double baseIntervalMs, double endMs, AnimTraceSummary* summaryOut) {
+    if (!out) return -1;
+
+    AnimTraceEvent* events = (AnimTraceEvent*)malloc(ANIM_TRACE_CAPACITY * sizeof(AnimTraceEvent));
+    if (!events) return -1;
+    size_t count = AnimTrace_Snapshot(events, ANIM_TRACE_CAPACITY);
+
+    AnimTraceSummary summary;
+    AnimTrace_Summarize(events, count, baseIntervalMs, endMs, &summary);
+    if (summaryOut) *summaryOut = summary;
+
+    fprintf(out, "# events=%zu span_ms=%.1f overwritten=%llu\n",
+            count, summary.spanMs, (unsigned long long)summary.overwritten);
+    fprintf(out, "# frames=%zu lateness_ms p50=%.2f p95=%.2f p99=%.2f max=%.2f\n",
+            summary.frames, summary.latenessP50, summary.latenessP95, summary.latenessP99, summary.latenessMax);
+    fprintf(out, "# tray_updates=%zu failures=%zu update_latency_ms p50=%.2f p95=%.2f p99=%.2f shell_call_p95_ms=%.2f\n",
+            summary.trayUpdates, summary.trayUpdateFailures, summary.updateLatencyP50,
+            summary.updateLatencyP95, summary.updateLatencyP99, summary.shellCallP95);
+    fprintf(out, "# interval_changes=%zu throttled_ms=%.1f fallbacks=%zu\n",
+            summary.intervalChanges, summary.throttledMs, summary.fallbacks);
+    fprintf(out, "time_ms,event,a,b,value\n");
+
+    for (size_t i = 0; i < count; ++i) {
+        const AnimTraceEvent* ev = &events[i];
+        fprintf(out, "%.3f,%s,%.3f,%.3f,%d\n", ev->timeMs, KindName(ev->kind), ev->a, ev->b, (int)ev->value);
+    }
+
+    free(events);
+    return ferror(out) ? -1 : 0;
+}
+
+void AnimTrace_Reset(void) {
+    atomic_store_explicit(&g_start, atomic_load_explicit(&g_head, memory_order_acquire), memory_order_release);
+}
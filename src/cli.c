@@ -36,6 +36,7 @@ extern void SetWindowTopmost(HWND hwnd, BOOL topmost);
 #define CMD_EDIT_MODE     "e"
 #define CMD_PAUSE_RESUME  "pr"
 #define CMD_RESTART       "r"
+#define CMD_DUMP_ANIM_TRACE "--dump-anim-trace"
 #define CMD_SHOW_TIME     's'
 #define CMD_COUNT_UP      'u'
 #define CMD_POMODORO      'p'
@@ -378,6 +379,15 @@ static BOOL HandleRestart(HWND hwnd, const char* input) {
     return TRUE;
 }
 
+/**
+ * @brief Handle animation timing trace export (--dump-anim-trace)
+ */
+static BOOL HandleDumpAnimTrace(HWND hwnd, const char* input) {
+    (void)input;
+    PostMessage(hwnd, WM_APP_DUMP_ANIM_TRACE, 0, 0);
+    return TRUE;
+}
+
 /**
  * @brief Handle pomodoro with index (p1, p2, ..., p9)
  */
@@ -417,6 +427,7 @@ static const CommandEntry g_commandTable[] = {
     {CMD_EDIT_MODE,    HandleEditMode},
     {CMD_PAUSE_RESUME, HandlePauseResume},
     {CMD_RESTART,      HandleRestart},
+    {CMD_DUMP_ANIM_TRACE, HandleDumpAnimTrace},
     {NULL,             NULL}
 };
 
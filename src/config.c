@@ -6,6 +6,8 @@
 #include "../include/language.h"
 #include "../resource/resource.h"
 #include "../include/tray_animation.h"
+#include "../include/system_monitor.h"
+#include "../include/anim_speed_map.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -263,25 +265,12 @@ static AnimationSpeedMetric g_animSpeedMetric = ANIMATION_SPEED_MEMORY;
  * New-style animation speed mapping via breakpoints and default.
  * ANIMATION_SPEED_DEFAULT defines the scale at 0%.
  * ANIMATION_SPEED_MAP_<P>=<S> defines a breakpoint at percent P with scale S.
- * At runtime, scales are linearly interpolated between adjacent breakpoints.
+ * At runtime, scales are read from the map's lookup table, rebuilt on every
+ * config load.
  */
-typedef struct {
-    int percent;         /** breakpoint percent (0-100) */
-    double scalePercent; /** scale percent at breakpoint */
-} AnimSpeedPoint;
-
-static AnimSpeedPoint g_animSpeedPoints[128];
-static int g_animSpeedPointCount = 0;
-static double g_animSpeedDefaultScalePercent = 100.0;
+static AnimSpeedMap g_animSpeedMap = { .defaultScalePercent = 100.0 };
 static int g_animMinIntervalMs = 0; /** 0 = disabled (use built-in default) */
-
-static int CmpAnimSpeedPoint(const void* a, const void* b) {
-    const AnimSpeedPoint* pa = (const AnimSpeedPoint*)a;
-    const AnimSpeedPoint* pb = (const AnimSpeedPoint*)b;
-    if (pa->percent < pb->percent) return -1;
-    if (pa->percent > pb->percent) return 1;
-    return 0;
-}
+static UINT g_animSpeedMapVersion = 0; /** bumped on every rebuild */
 
 /** Trim leading/trailing spaces in-place */
 static void TrimSpaces(char* s) {
@@ -339,20 +328,20 @@ static void ParseAnimationSpeedMap(const char* mapStr) {
 }
 
 /**
- * @brief Parse fixed-range animation speed keys from INI [Animation] section
- * Keys are of the form: ANIMATION_SPEED_MAP_LOW-HIGH = SCALE[%]
- * Example: ANIMATION_SPEED_MAP_0-10=100
+ * @brief Read animation speed breakpoints from INI [Animation] section
+ * Keys are of the form: ANIMATION_SPEED_MAP_<P> = SCALE[%]
+ * Example: ANIMATION_SPEED_MAP_50=150
  */
-static void ParseAnimationSpeedFixedKeys(const char* configPathUtf8) {
+static void ReadAnimationSpeedBreakpoints(const char* configPathUtf8) {
     g_animSpeedEntryCount = 0; /** legacy removed */
-    g_animSpeedPointCount = 0;
+    AnimSpeedMap_Init(&g_animSpeedMap, g_animSpeedMap.defaultScalePercent);
     if (!configPathUtf8 || !*configPathUtf8) return;
 
     /** Read default scale; fallback to 100 if missing/invalid */
     {
         int def = ReadIniInt("Animation", "ANIMATION_SPEED_DEFAULT", 100, configPathUtf8);
         if (def <= 0) def = 100;
-        g_animSpeedDefaultScalePercent = (double)def;
+        g_animSpeedMap.defaultScalePercent = (double)def;
     }
 
     wchar_t wSection[64];
@@ -396,28 +385,13 @@ static void ParseAnimationSpeedFixedKeys(const char* configPathUtf8) {
                     while (end > value && (end[-1] == L' ' || end[-1] == L'\t' || end[-1] == L'\r' || end[-1] == L'\n')) { *--end = L'\0'; }
                     if (end > value && end[-1] == L'%') { end[-1] = L'\0'; }
 
-                    double scale = _wtof(value);
-                    if (scale <= 0.0) scale = 100.0;
-
-                    int percent = _wtoi(token);
-                    if (percent < 0) percent = 0;
-                    if (percent > 100) percent = 100;
-                    if (g_animSpeedPointCount < (int)(sizeof(g_animSpeedPoints)/sizeof(g_animSpeedPoints[0]))) {
-                        g_animSpeedPoints[g_animSpeedPointCount].percent = percent;
-                        g_animSpeedPoints[g_animSpeedPointCount].scalePercent = scale;
-                        g_animSpeedPointCount++;
-                    }
+                    AnimSpeedMap_AddPoint(&g_animSpeedMap, _wtoi(token), _wtof(value));
                 }
             }
         }
         p += wcslen(p) + 1;
     }
 
-    /** Sort new-style breakpoints by percent ascending */
-    if (g_animSpeedPointCount > 1) {
-        qsort(g_animSpeedPoints, g_animSpeedPointCount, sizeof(AnimSpeedPoint), CmpAnimSpeedPoint);
-    }
-
     free(wbuf);
 }
 
@@ -425,40 +399,21 @@ AnimationSpeedMetric GetAnimationSpeedMetric(void) {
     return g_animSpeedMetric;
 }
 
-double GetAnimationSpeedScaleForPercent(double percent) {
-    if (percent < 0.0) percent = 0.0;
-    if (percent > 100.0) percent = 100.0;
-
-    /** New-style breakpoints with linear interpolation */
-    if (g_animSpeedPointCount > 0) {
-        /** If below first breakpoint, interpolate from default to first */
-        if (percent <= (double)g_animSpeedPoints[0].percent) {
-            double p0 = 0.0;
-            double s0 = g_animSpeedDefaultScalePercent;
-            double p1 = (double)g_animSpeedPoints[0].percent;
-            double s1 = g_animSpeedPoints[0].scalePercent;
-            if (p1 <= p0) return s1; /** guard divide-by-zero */
-            double t = (percent - p0) / (p1 - p0);
-            return s0 + (s1 - s0) * t;
-        }
-        /** Find segment [i, i+1] that contains percent */
-        for (int i = 0; i < g_animSpeedPointCount - 1; ++i) {
-            double p0 = (double)g_animSpeedPoints[i].percent;
-            double p1 = (double)g_animSpeedPoints[i + 1].percent;
-            if (percent >= p0 && percent <= p1) {
-                double s0 = g_animSpeedPoints[i].scalePercent;
-                double s1 = g_animSpeedPoints[i + 1].scalePercent;
-                if (p1 <= p0) return s1;
-                double t = (percent - p0) / (p1 - p0);
-                return s0 + (s1 - s0) * t;
-            }
-        }
-        /** Above last breakpoint: clamp to last scale */
-        return g_animSpeedPoints[g_animSpeedPointCount - 1].scalePercent;
-    }
+/**
+ * @brief Parse animation speed keys and rebuild the lookup table
+ */
+static void ParseAnimationSpeedFixedKeys(const char* configPathUtf8) {
+    ReadAnimationSpeedBreakpoints(configPathUtf8);
+    AnimSpeedMap_Build(&g_animSpeedMap);
+    g_animSpeedMapVersion++;
+}
 
-    /** No breakpoints: return default */
-    return g_animSpeedDefaultScalePercent;
+UINT GetAnimationSpeedMapVersion(void) {
+    return g_animSpeedMapVersion;
+}
+
+double GetAnimationSpeedScaleForPercent(double percent) {
+    return AnimSpeedMap_Lookup(&g_animSpeedMap, percent);
 }
 
 void ReloadAnimationSpeedFromConfig(void) {
@@ -613,6 +568,123 @@ DWORD ReadIniString(const char* section, const char* key, const char* defaultVal
 }
 
 
+/**
+ * ========================================================================
+ * Self-Write Tracking
+ * ========================================================================
+ * Every write through WriteIni* records the hash of the resulting file,
+ * so the config watcher can tell our own writes from external edits.
+ * Multi-key saves run inside a write batch and hash the file once at the end.
+ */
+
+/** @brief Hash of config.ini after our latest write, published with a generation */
+static volatile LONG64 g_selfWriteHash = 0;
+static volatile LONG g_selfWriteGeneration = 0;
+
+/** @brief Write batches open on this thread, and the file written inside them (empty = none yet) */
+static _Thread_local int g_selfWriteBatchDepth = 0;
+static _Thread_local char g_selfWriteBatchPath[MAX_PATH];
+
+/** @brief Outermost batches open across all threads, polled by the config watcher */
+static volatile LONG g_selfWriteBatchesOpen = 0;
+
+BOOL HashConfigFileContent(const char* filePath, ULONGLONG* hash) {
+    if (!filePath || !hash) return FALSE;
+    UTF8_TO_WIDE(filePath, wPath);
+
+    HANDLE file = CreateFileW(wPath, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                              NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (file == INVALID_HANDLE_VALUE) return FALSE;
+
+    /** FNV-1a, 64-bit */
+    ULONGLONG h = 0xcbf29ce484222325ULL;
+    BYTE buffer[4096];
+    DWORD bytesRead = 0;
+    BOOL ok = TRUE;
+    for (;;) {
+        if (!ReadFile(file, buffer, sizeof(buffer), &bytesRead, NULL)) {
+            ok = FALSE;
+            break;
+        }
+        if (bytesRead == 0) break;
+        for (DWORD i = 0; i < bytesRead; i++) {
+            h ^= buffer[i];
+            h *= 0x100000001b3ULL;
+        }
+    }
+    CloseHandle(file);
+
+    if (ok) *hash = h;
+    return ok;
+}
+
+/**
+ * @brief Record the file content produced by our own write
+ */
+static void RecordConfigSelfWrite(const char* filePath) {
+    ULONGLONG hash;
+    if (!HashConfigFileContent(filePath, &hash)) return;
+    InterlockedExchange64(&g_selfWriteHash, (LONG64)hash);
+    InterlockedIncrement(&g_selfWriteGeneration);
+}
+
+void GetConfigSelfWriteState(ULONGLONG* hash, LONG* generation) {
+    LONG before, after;
+    ULONGLONG value;
+    do {
+        before = g_selfWriteGeneration;
+        MemoryBarrier();
+        value = (ULONGLONG)InterlockedCompareExchange64(&g_selfWriteHash, 0, 0);
+        MemoryBarrier();
+        after = g_selfWriteGeneration;
+    } while (before != after);
+
+    if (hash) *hash = value;
+    if (generation) *generation = after;
+}
+
+void BeginConfigWriteBatch(void) {
+    if (g_selfWriteBatchDepth++ == 0) {
+        g_selfWriteBatchPath[0] = '\0';
+        InterlockedIncrement(&g_selfWriteBatchesOpen);
+    }
+}
+
+void EndConfigWriteBatch(void) {
+    if (g_selfWriteBatchDepth <= 0 || --g_selfWriteBatchDepth > 0) return;
+    if (g_selfWriteBatchPath[0]) {
+        RecordConfigSelfWrite(g_selfWriteBatchPath);
+        g_selfWriteBatchPath[0] = '\0';
+    }
+    InterlockedDecrement(&g_selfWriteBatchesOpen);
+}
+
+BOOL IsConfigWriteBatchOpen(void) {
+    return g_selfWriteBatchesOpen > 0;
+}
+
+/**
+ * @brief WritePrivateProfileStringW plus self-write recording
+ * Inside a batch only the path is remembered; the batch end hashes the file once.
+ */
+static BOOL WriteProfileStringTracked(const wchar_t* section, const wchar_t* key, const wchar_t* value,
+                                      const wchar_t* wfilePath, const char* filePath) {
+    BOOL result = WritePrivateProfileStringW(section, key, value, wfilePath);
+    if (!result) return result;
+
+    if (g_selfWriteBatchDepth == 0) {
+        RecordConfigSelfWrite(filePath);
+        return result;
+    }
+    if (g_selfWriteBatchPath[0] && _stricmp(g_selfWriteBatchPath, filePath) != 0) {
+        RecordConfigSelfWrite(g_selfWriteBatchPath);   /** Batch moved to another file */
+    }
+    strncpy(g_selfWriteBatchPath, filePath, MAX_PATH - 1);
+    g_selfWriteBatchPath[MAX_PATH - 1] = '\0';
+    return result;
+}
+
+
 /**
  * @brief Write string value to INI file with Unicode support
  * @param section INI section name
@@ -629,7 +701,7 @@ BOOL WriteIniString(const char* section, const char* key, const char* value,
     UTF8_TO_WIDE_N(value, wvalue, 1024);
     UTF8_TO_WIDE(filePath, wfilePath);
     
-    return WritePrivateProfileStringW(wsection, wkey, wvalue, wfilePath);
+    return WriteProfileStringTracked(wsection, wkey, wvalue, wfilePath, filePath);
 }
 
 
@@ -670,7 +742,7 @@ BOOL WriteIniInt(const char* section, const char* key, int value,
     UTF8_TO_WIDE_N(valueStr, wvalue, 32);
     UTF8_TO_WIDE(filePath, wfilePath);
     
-    return WritePrivateProfileStringW(wsection, wkey, wvalue, wfilePath);
+    return WriteProfileStringTracked(wsection, wkey, wvalue, wfilePath, filePath);
 }
 
 
@@ -691,7 +763,7 @@ BOOL WriteIniBool(const char* section, const char* key, BOOL value,
     UTF8_TO_WIDE_N(valueStr, wvalue, 8);
     UTF8_TO_WIDE(filePath, wfilePath);
     
-    return WritePrivateProfileStringW(wsection, wkey, wvalue, wfilePath);
+    return WriteProfileStringTracked(wsection, wkey, wvalue, wfilePath, filePath);
 }
 
 
@@ -937,6 +1009,7 @@ static void EnsureDefaultResourceSubfolders(void) {
  * Auto-detects system language and sets appropriate defaults
  */
 void CreateDefaultConfig(const char* config_path) {
+    BeginConfigWriteBatch();
     /** Detect system language for initial localization */
     LANGID systemLangID = GetUserDefaultUILanguage();
     int defaultLanguage = APP_LANG_ENGLISH;
@@ -1157,6 +1230,7 @@ void CreateDefaultConfig(const char* config_path) {
             fclose(f);
         }
     }
+    EndConfigWriteBatch();
 }
 
 
@@ -1952,6 +2026,7 @@ void WriteConfigTimeoutFile(const char* filePath) {
  * Writes all settings including language, display, timer, pomodoro, notifications, hotkeys, etc.
  */
 void WriteConfig(const char* config_path) {
+    BeginConfigWriteBatch();
     /** Optional: basic INI tail validation and self-heal for previous corruptions */
     {
         FOPEN_UTF8(config_path, L"r", rf);
@@ -2187,18 +2262,18 @@ void WriteConfig(const char* config_path) {
         WriteIniString("Animation", "ANIMATION_SPEED_METRIC", metricStr, config_path);
     {
         /** Prefer new-style points if available; otherwise, persist legacy ranges */
-        if (g_animSpeedPointCount > 0) {
-            WriteIniInt("Animation", "ANIMATION_SPEED_DEFAULT", (int)(g_animSpeedDefaultScalePercent + 0.5), config_path);
-            for (int i = 0; i < g_animSpeedPointCount; ++i) {
+        if (g_animSpeedMap.pointCount > 0) {
+            WriteIniInt("Animation", "ANIMATION_SPEED_DEFAULT", (int)(g_animSpeedMap.defaultScalePercent + 0.5), config_path);
+            for (int i = 0; i < g_animSpeedMap.pointCount; ++i) {
                 char key[64];
-                snprintf(key, sizeof(key), "ANIMATION_SPEED_MAP_%d", g_animSpeedPoints[i].percent);
+                snprintf(key, sizeof(key), "ANIMATION_SPEED_MAP_%d", g_animSpeedMap.points[i].percent);
                 char val[32];
-                snprintf(val, sizeof(val), "%g", g_animSpeedPoints[i].scalePercent);
+                snprintf(val, sizeof(val), "%g", g_animSpeedMap.points[i].scalePercent);
                 WriteIniString("Animation", key, val, config_path);
             }
         } else {
             /** No points available: ensure default is written at least */
-            WriteIniInt("Animation", "ANIMATION_SPEED_DEFAULT", (int)(g_animSpeedDefaultScalePercent + 0.5), config_path);
+            WriteIniInt("Animation", "ANIMATION_SPEED_DEFAULT", (int)(g_animSpeedMap.defaultScalePercent + 0.5), config_path);
         }
     }
     /** Persist advanced min interval floor for animations */
@@ -2217,6 +2292,7 @@ void WriteConfig(const char* config_path) {
         snprintf(buf, sizeof(buf), "#%02X%02X%02X", GetRValue(bc), GetGValue(bc), GetBValue(bc));
         WriteIniString("Animation", "PERCENT_ICON_BG_COLOR", buf, config_path);
     }
+    EndConfigWriteBatch();
 }
 
 
@@ -2276,9 +2352,11 @@ void WriteConfigNotificationMessages(const char* timeout_msg, const char* pomodo
     GetConfigPath(config_path, MAX_PATH);
     
     AcquireConfigWriteLock();
+    BeginConfigWriteBatch();
     WriteIniString(INI_SECTION_NOTIFICATION, "CLOCK_TIMEOUT_MESSAGE_TEXT", timeout_msg, config_path);
     WriteIniString(INI_SECTION_NOTIFICATION, "POMODORO_TIMEOUT_MESSAGE_TEXT", pomodoro_msg, config_path);
     WriteIniString(INI_SECTION_NOTIFICATION, "POMODORO_CYCLE_COMPLETE_TEXT", cycle_complete_msg, config_path);
+    EndConfigWriteBatch();
     ReleaseConfigWriteLock();
     
     /** Runtime will be updated by watcher */
@@ -3141,8 +3219,60 @@ void ReadPercentIconColorsConfig(void) {
     COLORREF val;
     if (ParseColorString(textBuf, &val)) g_percentTextColor = val;
     if (ParseColorString(bgBuf, &val)) g_percentBgColor = val;
+    TrayAnimation_InvalidatePercentIconCache();
 }
 
 COLORREF GetPercentIconTextColor(void) { return g_percentTextColor; }
 COLORREF GetPercentIconBgColor(void) { return g_percentBgColor; }
 
+/** @brief Apply [Animation] CPU_WATCH_PROCESS (executable name, empty = none) */
+void ReadSystemMonitorWatchConfig(void) {
+    char config_path[MAX_PATH] = {0};
+    GetConfigPath(config_path, MAX_PATH);
+    char nameBuf[MAX_PATH] = {0};
+    ReadIniString("Animation", "CPU_WATCH_PROCESS", "", nameBuf, sizeof(nameBuf), config_path);
+    wchar_t wName[MAX_PATH] = {0};
+    MultiByteToWideChar(CP_UTF8, 0, nameBuf, -1, wName, MAX_PATH);
+    SystemMonitor_WatchProcess(wName);
+}
+
+/**
+ * @brief Apply [Options] sampling settings
+ * 
+ * METRIC_SAMPLE_FAST_MS / METRIC_SAMPLE_IDLE_MS set the adaptive rates;
+ * METRIC_SMOOTHING_<CPU|MEMORY|NETWORK|PROCESS|CORES> take "none",
+ * "ewma:<ms>" or "window:<samples>". Missing or invalid keys restore the
+ * defaults, so removing a key on a config reload takes effect too.
+ */
+void ReadSystemMonitorSamplingConfig(void) {
+    char config_path[MAX_PATH] = {0};
+    GetConfigPath(config_path, MAX_PATH);
+
+    int fastMs = ReadIniInt(INI_SECTION_OPTIONS, "METRIC_SAMPLE_FAST_MS", 0, config_path);
+    int idleMs = ReadIniInt(INI_SECTION_OPTIONS, "METRIC_SAMPLE_IDLE_MS", 0, config_path);
+    SystemMonitor_SetAdaptiveIntervals(fastMs > 0 ? (DWORD)fastMs : 0, idleMs > 0 ? (DWORD)idleMs : 0);
+
+    static const struct {
+        SystemMetricKind metric;
+        const char* key;
+    } kSmoothingKeys[] = {
+        {SYSTEM_METRIC_CPU, "METRIC_SMOOTHING_CPU"},
+        {SYSTEM_METRIC_MEMORY, "METRIC_SMOOTHING_MEMORY"},
+        {SYSTEM_METRIC_NETWORK, "METRIC_SMOOTHING_NETWORK"},
+        {SYSTEM_METRIC_PROCESS, "METRIC_SMOOTHING_PROCESS"},
+        {SYSTEM_METRIC_CORES, "METRIC_SMOOTHING_CORES"},
+    };
+    for (size_t i = 0; i < sizeof(kSmoothingKeys) / sizeof(kSmoothingKeys[0]); ++i) {
+        char value[64] = {0};
+        ReadIniString(INI_SECTION_OPTIONS, kSmoothingKeys[i].key, "", value, sizeof(value), config_path);
+
+        MetricSmoothingMode mode;
+        uint32_t param;
+        if (value[0] && MetricSmoother_Parse(value, &mode, &param)) {
+            SystemMonitor_SetSmoothing(kSmoothingKeys[i].metric, mode, param);
+        } else {
+            SystemMonitor_ResetSmoothing(kSmoothingKeys[i].metric);
+        }
+    }
+}
+
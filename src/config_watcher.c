@@ -1,7 +1,18 @@
 /**
  * @file config_watcher.c
- * @brief Watch config.ini changes via ReadDirectoryChangesW and notify UI
- * @version 2.0 - Refactored for better modularity and maintainability
+ * @brief Watch config.ini and the resources folder via ReadDirectoryChangesW
+ * @version 3.0 - One thread for config and resources, with coalesced change generations
+ *
+ * The config directory is watched non-recursively (only config.ini
+ * matters); the resources root is watched recursively and events are
+ * classified by their top-level subfolder. Events are collected until the
+ * tree has been quiet for DEBOUNCE_DELAY_MS (at most DEBOUNCE_MAX_DELAY_MS
+ * after the first one), then each affected area is published once.
+ *
+ * Our own WriteIni* calls also change config.ini. Before reloading, the
+ * watcher hashes the file and compares it with the content we last knew
+ * about (our latest write, or the last external edit already reloaded);
+ * a match means there is nothing new and the event is suppressed.
  */
 
 #include <windows.h>
@@ -11,6 +22,7 @@
 
 #include "../include/config_watcher.h"
 #include "../include/config.h"
+#include "../include/resource_catalog.h"
 #include "../include/window_procedure.h"
 #include "../include/tray_animation.h"
 
@@ -18,14 +30,17 @@
  * Constants
  * ============================================================================ */
 
-/** @brief Buffer size for directory change notifications */
-#define WATCH_BUFFER_SIZE 8192
+/** @brief Buffer size for directory change notifications (per watched directory) */
+#define WATCH_BUFFER_SIZE 16384
 
-/** @brief Debounce delay to avoid processing rapid file changes */
+/** @brief Quiet period that ends a burst of changes */
 #define DEBOUNCE_DELAY_MS 200
 
-/** @brief Number of events to monitor (stop event + notification event) */
-#define WATCH_EVENT_COUNT 2
+/** @brief Longest a continuous burst is held back before publishing */
+#define DEBOUNCE_MAX_DELAY_MS 1000
+
+/** @brief Config directory + resources root */
+#define WATCH_DIRECTORY_COUNT 2
 
 /** @brief Custom messages for animation config hot-reload */
 #ifndef WM_APP_ANIM_PATH_CHANGED
@@ -35,6 +50,33 @@
 #define WM_APP_ANIM_SPEED_CHANGED (WM_APP + 51)
 #endif
 
+#define AREA_BIT(area) (1u << (area))
+#define RESOURCE_AREA_BITS (AREA_BIT(WATCH_AREA_FONTS) | AREA_BIT(WATCH_AREA_ANIMATIONS) | AREA_BIT(WATCH_AREA_AUDIO))
+
+/* ============================================================================
+ * Type Definitions
+ * ============================================================================ */
+
+/** @brief Maps a changed path to the areas it affects */
+typedef UINT (*ClassifyChangeFn)(const wchar_t* relativePath);
+
+/** @brief One directory with an outstanding ReadDirectoryChangesW */
+typedef struct {
+    HANDLE dir;
+    OVERLAPPED ov;
+    BOOL recursive;
+    DWORD filter;
+    ClassifyChangeFn classify;
+    UINT overflowAreas;                                 /**< Assumed changed when the buffer overflows */
+    DWORD buffer[WATCH_BUFFER_SIZE / sizeof(DWORD)];    /**< DWORD-aligned, as the API requires */
+} DirectoryWatch;
+
+/** @brief Top-level resources subfolders and their areas */
+typedef struct {
+    const wchar_t* folder;
+    WatchArea area;
+} ResourceFolderEntry;
+
 /* ============================================================================
  * Global state
  * ============================================================================ */
@@ -43,6 +85,31 @@ static HANDLE g_watcherThread = NULL;
 static HANDLE g_stopEvent = NULL;
 static HWND g_targetHwnd = NULL;
 
+/** @brief Published change generations, read lock-free by other modules */
+static volatile LONG g_generations[WATCH_AREA_COUNT] = {0};
+
+/** @brief config.ini file name, compared against config directory events */
+static wchar_t g_configFileName[MAX_PATH] = {0};
+
+/** @brief config.ini path (UTF-8), hashed to recognise our own writes */
+static char g_configPath[MAX_PATH] = {0};
+
+/** @brief Content the application already reflects, and the self-write generation it came from */
+static ULONGLONG g_knownConfigHash = 0;
+static BOOL g_knownConfigHashValid = FALSE;
+static LONG g_knownWriteGeneration = 0;
+
+/** @brief Config change events dropped because they only repeated our own writes */
+static volatile LONG g_suppressedSelfWrites = 0;
+
+static DirectoryWatch g_watches[WATCH_DIRECTORY_COUNT];
+
+static const ResourceFolderEntry RESOURCE_FOLDERS[] = {
+    {L"fonts",      WATCH_AREA_FONTS},
+    {L"animations", WATCH_AREA_ANIMATIONS},
+    {L"audio",      WATCH_AREA_AUDIO},
+};
+
 /* ============================================================================
  * Helper functions
  * ============================================================================ */
@@ -56,10 +123,10 @@ static HWND g_targetHwnd = NULL;
 static void ExtractDirectoryPath(const char* filePath, char* dirPath, size_t dirPathSize) {
     strncpy(dirPath, filePath, dirPathSize - 1);
     dirPath[dirPathSize - 1] = '\0';
-    
+
     char* lastSlash = strrchr(dirPath, '\\');
     if (!lastSlash) lastSlash = strrchr(dirPath, '/');
-    
+
     if (lastSlash) {
         *lastSlash = '\0';
     } else {
@@ -79,36 +146,54 @@ static const wchar_t* GetFileNameFromPath(const wchar_t* path) {
     return name ? (name + 1) : path;
 }
 
+/** @brief config.ini itself */
+static UINT ClassifyConfigChange(const wchar_t* relativePath) {
+    return (_wcsicmp(relativePath, g_configFileName) == 0) ? AREA_BIT(WATCH_AREA_CONFIG) : 0;
+}
+
+/** @brief Area of a path relative to the resources root, by its first component */
+static UINT ClassifyResourceChange(const wchar_t* relativePath) {
+    const wchar_t* sep = wcschr(relativePath, L'\\');
+    size_t len = sep ? (size_t)(sep - relativePath) : wcslen(relativePath);
+
+    for (size_t i = 0; i < sizeof(RESOURCE_FOLDERS) / sizeof(RESOURCE_FOLDERS[0]); i++) {
+        const wchar_t* folder = RESOURCE_FOLDERS[i].folder;
+        if (wcslen(folder) == len && _wcsnicmp(relativePath, folder, len) == 0) {
+            return AREA_BIT(RESOURCE_FOLDERS[i].area);
+        }
+    }
+    return 0;
+}
+
 /**
- * @brief Check if target file was changed in notification buffer
- * @param buffer Notification buffer from ReadDirectoryChangesW
+ * @brief Areas touched by the entries in a notification buffer
+ * @param watch Directory the buffer belongs to
  * @param bytes Number of bytes in buffer
- * @param targetFileName Filename to check for
- * @return TRUE if target file was changed, FALSE otherwise
+ * @return Bitmask of AREA_BIT values
  */
-static BOOL IsTargetFileChanged(const BYTE* buffer, DWORD bytes, const wchar_t* targetFileName) {
+static UINT CollectChangedAreas(const DirectoryWatch* watch, DWORD bytes) {
+    const BYTE* buffer = (const BYTE*)watch->buffer;
     const BYTE* ptr = buffer;
-    
+    UINT areas = 0;
+
     while (ptr < buffer + bytes) {
         const FILE_NOTIFY_INFORMATION* pinfo = (const FILE_NOTIFY_INFORMATION*)ptr;
-        
+
         if (pinfo->FileNameLength > 0) {
             size_t cch = pinfo->FileNameLength / sizeof(WCHAR);
             WCHAR nameBuf[MAX_PATH];
             size_t copy = (cch >= MAX_PATH) ? (MAX_PATH - 1) : cch;
             wcsncpy(nameBuf, pinfo->FileName, copy);
             nameBuf[copy] = L'\0';
-            
-            if (_wcsicmp(nameBuf, targetFileName) == 0) {
-                return TRUE;
-            }
+
+            areas |= watch->classify(nameBuf);
         }
-        
+
         if (pinfo->NextEntryOffset == 0) break;
         ptr += pinfo->NextEntryOffset;
     }
-    
-    return FALSE;
+
+    return areas;
 }
 
 /**
@@ -117,7 +202,7 @@ static BOOL IsTargetFileChanged(const BYTE* buffer, DWORD bytes, const wchar_t*
  */
 static void NotifyConfigChanges(HWND hwnd) {
     if (!hwnd || !IsWindow(hwnd)) return;
-    
+
     static const UINT configChangeMessages[] = {
         WM_APP_ANIM_SPEED_CHANGED,
         WM_APP_ANIM_PATH_CHANGED,
@@ -129,53 +214,159 @@ static void NotifyConfigChanges(HWND hwnd) {
         WM_APP_RECENTFILES_CHANGED,
         WM_APP_COLORS_CHANGED
     };
-    
+
     for (size_t i = 0; i < sizeof(configChangeMessages) / sizeof(UINT); i++) {
         PostMessage(hwnd, configChangeMessages[i], 0, 0);
     }
 }
 
 /**
- * @brief Setup directory monitoring handle
- * @param iniPath Full path to INI file
- * @param outDir Output buffer for directory path (wide char)
- * @param outDirSize Size of output buffer
- * @return Directory handle or INVALID_HANDLE_VALUE on failure
+ * @brief Check whether config.ini holds nothing the application has not seen
+ * @return TRUE if the change came from our own writes (or changed nothing)
  */
-static HANDLE SetupDirectoryWatch(const char* iniPath, wchar_t* outDir, size_t outDirSize) {
-    char dirPath[MAX_PATH];
-    ExtractDirectoryPath(iniPath, dirPath, sizeof(dirPath));
-    
-    MultiByteToWideChar(CP_UTF8, 0, dirPath, -1, outDir, (int)outDirSize);
-    
-    return CreateFileW(outDir, FILE_LIST_DIRECTORY,
-                      FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
-                      NULL, OPEN_EXISTING,
-                      FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED,
-                      NULL);
+static BOOL IsKnownConfigContent(void) {
+    ULONGLONG writeHash;
+    LONG writeGeneration;
+    GetConfigSelfWriteState(&writeHash, &writeGeneration);
+    if (writeGeneration != g_knownWriteGeneration) {
+        g_knownWriteGeneration = writeGeneration;
+        g_knownConfigHash = writeHash;
+        g_knownConfigHashValid = TRUE;
+    }
+
+    ULONGLONG current;
+    if (!HashConfigFileContent(g_configPath, &current)) {
+        return FALSE;   /** Unreadable (mid-replace): let the reload decide */
+    }
+    if (g_knownConfigHashValid && current == g_knownConfigHash) {
+        return TRUE;
+    }
+    g_knownConfigHash = current;    /** About to be reloaded */
+    g_knownConfigHashValid = TRUE;
+    return FALSE;
 }
 
 /**
- * @brief Initialize overlapped I/O events for directory watching
- * @param hEvents Output array for event handles
- * @param pOv Pointer to OVERLAPPED structure to initialize
+ * @brief Bump the generation of each changed area, then notify the UI
+ * @param areas Bitmask of AREA_BIT values
  */
-static void InitializeWatchEvents(HANDLE* hEvents, OVERLAPPED* pOv) {
-    hEvents[0] = g_stopEvent;
-    hEvents[1] = CreateEventW(NULL, TRUE, FALSE, NULL);
-    memset(pOv, 0, sizeof(OVERLAPPED));
-    pOv->hEvent = hEvents[1];
+static void PublishChanges(UINT areas) {
+    if ((areas & AREA_BIT(WATCH_AREA_CONFIG)) && IsKnownConfigContent()) {
+        areas &= ~AREA_BIT(WATCH_AREA_CONFIG);
+        InterlockedIncrement(&g_suppressedSelfWrites);
+    }
+
+    for (int i = 0; i < WATCH_AREA_COUNT; i++) {
+        if (areas & AREA_BIT(i)) {
+            InterlockedIncrement(&g_generations[i]);
+        }
+    }
+
+    if (areas & AREA_BIT(WATCH_AREA_CONFIG)) {
+        NotifyConfigChanges(g_targetHwnd);
+    }
+    if (areas & RESOURCE_AREA_BITS) {
+        /** Start re-indexing before the UI thread gets to look at the folders */
+        ResourceCatalog_Refresh();
+        if (g_targetHwnd && IsWindow(g_targetHwnd)) {
+            PostMessage(g_targetHwnd, WM_APP_RESOURCES_CHANGED, (WPARAM)areas, 0);
+        }
+    }
 }
 
 /**
- * @brief Cleanup watch events
- * @param hEvents Array of event handles
+ * @brief Open a directory for overlapped change notifications
+ * @return FALSE if the directory cannot be opened (it is then not watched)
  */
-static void CleanupWatchEvents(HANDLE* hEvents) {
-    if (hEvents[1]) {
-        CloseHandle(hEvents[1]);
-        hEvents[1] = NULL;
+static BOOL OpenDirectoryWatch(DirectoryWatch* watch, const wchar_t* dir, BOOL recursive,
+                               DWORD filter, ClassifyChangeFn classify, UINT overflowAreas) {
+    memset(watch, 0, sizeof(*watch));
+    watch->dir = CreateFileW(dir, FILE_LIST_DIRECTORY,
+                             FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                             NULL, OPEN_EXISTING,
+                             FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED,
+                             NULL);
+    if (watch->dir == INVALID_HANDLE_VALUE) {
+        watch->dir = NULL;
+        return FALSE;
     }
+    watch->ov.hEvent = CreateEventW(NULL, TRUE, FALSE, NULL);
+    if (!watch->ov.hEvent) {
+        CloseHandle(watch->dir);
+        watch->dir = NULL;
+        return FALSE;
+    }
+    watch->recursive = recursive;
+    watch->filter = filter;
+    watch->classify = classify;
+    watch->overflowAreas = overflowAreas;
+    return TRUE;
+}
+
+static void CloseDirectoryWatch(DirectoryWatch* watch) {
+    if (watch->dir) {
+        CancelIo(watch->dir);
+        CloseHandle(watch->dir);
+        watch->dir = NULL;
+    }
+    if (watch->ov.hEvent) {
+        CloseHandle(watch->ov.hEvent);
+        watch->ov.hEvent = NULL;
+    }
+}
+
+/**
+ * @brief Queue the next change notification for a directory
+ * @return FALSE if the directory can no longer be watched
+ */
+static BOOL IssueDirectoryRead(DirectoryWatch* watch) {
+    ResetEvent(watch->ov.hEvent);
+    return ReadDirectoryChangesW(watch->dir, watch->buffer, sizeof(watch->buffer), watch->recursive,
+                                 watch->filter, NULL, &watch->ov, NULL);
+}
+
+/**
+ * @brief Open the config directory and resources root watches
+ * @return Number of directories being watched
+ */
+static int SetupDirectoryWatches(void) {
+    char iniPath[MAX_PATH] = {0};
+    GetConfigPath(iniPath, sizeof(iniPath));
+    strncpy(g_configPath, iniPath, MAX_PATH - 1);
+
+    /** Baseline: the content loaded at startup */
+    GetConfigSelfWriteState(NULL, &g_knownWriteGeneration);
+    g_knownConfigHashValid = HashConfigFileContent(g_configPath, &g_knownConfigHash);
+
+    wchar_t wIni[MAX_PATH] = {0};
+    MultiByteToWideChar(CP_UTF8, 0, iniPath, -1, wIni, MAX_PATH);
+    wcsncpy(g_configFileName, GetFileNameFromPath(wIni), MAX_PATH - 1);
+
+    char dirPath[MAX_PATH];
+    ExtractDirectoryPath(iniPath, dirPath, sizeof(dirPath));
+    wchar_t wDir[MAX_PATH] = {0};
+    MultiByteToWideChar(CP_UTF8, 0, dirPath, -1, wDir, MAX_PATH);
+
+    wchar_t wResources[MAX_PATH] = {0};
+    _snwprintf_s(wResources, MAX_PATH, _TRUNCATE, L"%s\\resources", wDir);
+
+    int count = 0;
+    if (OpenDirectoryWatch(&g_watches[count], wDir, FALSE,
+                           FILE_NOTIFY_CHANGE_FILE_NAME |
+                           FILE_NOTIFY_CHANGE_LAST_WRITE |
+                           FILE_NOTIFY_CHANGE_SIZE,
+                           ClassifyConfigChange, AREA_BIT(WATCH_AREA_CONFIG))) {
+        count++;
+    }
+    if (OpenDirectoryWatch(&g_watches[count], wResources, TRUE,
+                           FILE_NOTIFY_CHANGE_FILE_NAME |
+                           FILE_NOTIFY_CHANGE_DIR_NAME |
+                           FILE_NOTIFY_CHANGE_LAST_WRITE |
+                           FILE_NOTIFY_CHANGE_SIZE,
+                           ClassifyResourceChange, RESOURCE_AREA_BITS)) {
+        count++;
+    }
+    return count;
 }
 
 /* ============================================================================
@@ -189,62 +380,86 @@ static void CleanupWatchEvents(HANDLE* hEvents) {
  */
 static DWORD WINAPI WatcherThreadProc(LPVOID lpParam) {
     (void)lpParam;
-    
-    // Get config file path
-    char iniPath[MAX_PATH] = {0};
-    GetConfigPath(iniPath, sizeof(iniPath));
-    
-    // Setup directory monitoring
-    wchar_t wDir[MAX_PATH] = {0};
-    HANDLE hDir = SetupDirectoryWatch(iniPath, wDir, MAX_PATH);
-    if (hDir == INVALID_HANDLE_VALUE) {
-        return 0;
+
+    int watchCount = SetupDirectoryWatches();
+    for (int i = 0; i < watchCount; i++) {
+        if (!IssueDirectoryRead(&g_watches[i])) {
+            CloseDirectoryWatch(&g_watches[i]);
+        }
     }
-    
-    // Initialize watch events
-    BYTE buffer[WATCH_BUFFER_SIZE];
-    DWORD bytesReturned = 0;
-    OVERLAPPED ov = {0};
-    HANDLE hEvents[WATCH_EVENT_COUNT];
-    InitializeWatchEvents(hEvents, &ov);
-    
-    // Get target filename for comparison
-    wchar_t wIni[MAX_PATH] = {0};
-    MultiByteToWideChar(CP_UTF8, 0, iniPath, -1, wIni, MAX_PATH);
-    const wchar_t* wFileName = GetFileNameFromPath(wIni);
-    
-    // Main watch loop
+
+    UINT pendingAreas = 0;
+    ULONGLONG burstStart = 0;
+    ULONGLONG lastChange = 0;
+
     for (;;) {
-        ResetEvent(hEvents[1]);
-        
-        if (!ReadDirectoryChangesW(hDir, buffer, sizeof(buffer), FALSE,
-                                   FILE_NOTIFY_CHANGE_FILE_NAME | 
-                                   FILE_NOTIFY_CHANGE_LAST_WRITE | 
-                                   FILE_NOTIFY_CHANGE_SIZE,
-                                   &bytesReturned, &ov, NULL)) {
-            break;
+        /** Wait set: stop event, then every directory still being watched */
+        HANDLE hEvents[1 + WATCH_DIRECTORY_COUNT];
+        DirectoryWatch* eventWatch[1 + WATCH_DIRECTORY_COUNT];
+        DWORD eventCount = 0;
+        hEvents[eventCount++] = g_stopEvent;
+        for (int i = 0; i < watchCount; i++) {
+            if (g_watches[i].dir) {
+                eventWatch[eventCount] = &g_watches[i];
+                hEvents[eventCount++] = g_watches[i].ov.hEvent;
+            }
         }
-        
-        DWORD wait = WaitForMultipleObjects(WATCH_EVENT_COUNT, hEvents, FALSE, INFINITE);
+
+        DWORD timeout = INFINITE;
+        if (pendingAreas) {
+            ULONGLONG now = GetTickCount64();
+            ULONGLONG deadline = lastChange + DEBOUNCE_DELAY_MS;
+            if (deadline > burstStart + DEBOUNCE_MAX_DELAY_MS) {
+                deadline = burstStart + DEBOUNCE_MAX_DELAY_MS;
+            }
+            timeout = (deadline > now) ? (DWORD)(deadline - now) : 0;
+        }
+
+        DWORD wait = WaitForMultipleObjects(eventCount, hEvents, FALSE, timeout);
         if (wait == WAIT_OBJECT_0) {
             break; // Stop event signaled
         }
-        
-        DWORD bytes = 0;
-        if (!GetOverlappedResult(hDir, &ov, &bytes, FALSE)) {
+        if (wait == WAIT_TIMEOUT) {
+            UINT ready = pendingAreas;
+            if ((ready & AREA_BIT(WATCH_AREA_CONFIG)) && IsConfigWriteBatchOpen()) {
+                /** Our own batch is mid-write: hold config until its end records the hash */
+                ready &= ~AREA_BIT(WATCH_AREA_CONFIG);
+                burstStart = lastChange = GetTickCount64();
+            }
+            if (ready) PublishChanges(ready);
+            pendingAreas &= ~ready;
             continue;
         }
-        
-        // Check if our config file was changed
-        if (IsTargetFileChanged(buffer, bytes, wFileName)) {
-            Sleep(DEBOUNCE_DELAY_MS);
-            NotifyConfigChanges(g_targetHwnd);
+        if (wait < WAIT_OBJECT_0 + 1 || wait >= WAIT_OBJECT_0 + eventCount) {
+            break;
+        }
+
+        DirectoryWatch* watch = eventWatch[wait - WAIT_OBJECT_0];
+        DWORD bytes = 0;
+        UINT areas = 0;
+        if (GetOverlappedResult(watch->dir, &watch->ov, &bytes, FALSE)) {
+            /** Zero bytes: the buffer overflowed and the individual changes were lost */
+            areas = (bytes == 0) ? watch->overflowAreas : CollectChangedAreas(watch, bytes);
+        } else if (GetLastError() == ERROR_NOTIFY_ENUM_DIR) {
+            areas = watch->overflowAreas;
+        }
+
+        if (!IssueDirectoryRead(watch)) {
+            CloseDirectoryWatch(watch);     /** Directory deleted or unreachable */
+        }
+
+        if (areas) {
+            ULONGLONG now = GetTickCount64();
+            if (!pendingAreas) burstStart = now;
+            pendingAreas |= areas;
+            lastChange = now;
         }
     }
-    
+
     // Cleanup
-    CloseHandle(hDir);
-    CleanupWatchEvents(hEvents);
+    for (int i = 0; i < watchCount; i++) {
+        CloseDirectoryWatch(&g_watches[i]);
+    }
     return 0;
 }
 
@@ -253,12 +468,12 @@ static DWORD WINAPI WatcherThreadProc(LPVOID lpParam) {
  * ============================================================================ */
 
 /**
- * @brief Start config file watcher thread
+ * @brief Start the config and resources watcher thread
  * @param hwnd Window handle to receive change notifications
  */
 void ConfigWatcher_Start(HWND hwnd) {
     if (g_watcherThread) return;
-    
+
     g_targetHwnd = hwnd;
     g_stopEvent = CreateEventW(NULL, TRUE, FALSE, NULL);
     g_watcherThread = CreateThread(NULL, 0, WatcherThreadProc, NULL, 0, NULL);
@@ -269,14 +484,23 @@ void ConfigWatcher_Start(HWND hwnd) {
  */
 void ConfigWatcher_Stop(void) {
     if (!g_watcherThread) return;
-    
+
     SetEvent(g_stopEvent);
     WaitForSingleObject(g_watcherThread, INFINITE);
     CloseHandle(g_watcherThread);
     g_watcherThread = NULL;
-    
+
     CloseHandle(g_stopEvent);
     g_stopEvent = NULL;
-    
+
     g_targetHwnd = NULL;
 }
+
+LONG ConfigWatcher_GetGeneration(WatchArea area) {
+    if (area < 0 || area >= WATCH_AREA_COUNT) return 0;
+    return g_generations[area];
+}
+
+LONG ConfigWatcher_GetSuppressedSelfWrites(void) {
+    return g_suppressedSelfWrites;
+}
@@ -23,6 +23,7 @@
 #include "../include/hotkey.h"
 #include "../include/dialog_language.h"
 #include "../include/markdown_parser.h"
+#include "../include/resource_catalog.h"
 
 /** @brief Draw color selection button with custom appearance */
 static void DrawColorSelectButton(HDC hdc, HWND hwnd);
@@ -1886,36 +1887,16 @@ static void PopulateSoundComboBox(HWND hwndDlg) {
     /** Add system beep option */
     SendMessageW(hwndCombo, CB_ADDSTRING, 0, (LPARAM)GetLocalizedString(L"System Beep", L"System Beep"));
 
-    /** Get audio files directory path */
-    char audio_path[MAX_PATH];
-    GetAudioFolderPath(audio_path, MAX_PATH);
-    
-    /** Convert to wide char for file operations */
-    wchar_t wAudioPath[MAX_PATH];
-    MultiByteToWideChar(CP_UTF8, 0, audio_path, -1, wAudioPath, MAX_PATH);
-
-    /** Create search pattern for all files */
-    wchar_t wSearchPath[MAX_PATH];
-    StringCbPrintfW(wSearchPath, sizeof(wSearchPath), L"%s\\*.*", wAudioPath);
-
-    /** Find and add supported audio files */
-    WIN32_FIND_DATAW find_data;
-    HANDLE hFind = FindFirstFileW(wSearchPath, &find_data);
-    if (hFind != INVALID_HANDLE_VALUE) {
-        do {
-            /** Check for supported audio file extensions */
-            wchar_t* ext = wcsrchr(find_data.cFileName, L'.');
-            if (ext && (
-                _wcsicmp(ext, L".flac") == 0 ||
-                _wcsicmp(ext, L".mp3") == 0 ||
-                _wcsicmp(ext, L".wav") == 0
-            )) {
-                /** Add supported audio file to combo box */
-                SendMessageW(hwndCombo, CB_ADDSTRING, 0, (LPARAM)find_data.cFileName);
-            }
-        } while (FindNextFileW(hFind, &find_data));
-        FindClose(hFind);
+    /** Add supported audio files from the top level of the audio folder */
+    const ResourceCatalog* catalog = ResourceCatalog_Acquire(CATALOG_ROOT_AUDIO);
+    UINT count = 0;
+    const CatalogEntry* entries = ResourceCatalog_GetChildren(catalog, NULL, &count);
+    for (UINT i = 0; i < count; i++) {
+        if (entries[i].type == CATALOG_ENTRY_AUDIO) {
+            SendMessageW(hwndCombo, CB_ADDSTRING, 0, (LPARAM)entries[i].nameW);
+        }
     }
+    ResourceCatalog_Release(catalog);
 
     /** Select current sound file if configured */
     if (NOTIFICATION_SOUND_FILE[0] != '\0') {
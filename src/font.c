@@ -17,6 +17,8 @@
 #include <shlobj.h>
 #include "../include/font.h"
 #include "../include/config.h"
+#include "../include/font_cache.h"
+#include "../include/resource_catalog.h"
 #include "../resource/resource.h"
 
 /* ============================================================================
@@ -320,58 +322,19 @@ static void UpdateFontConfig(const FontPathInfo* pathInfo, BOOL shouldSave) {
  * Font File Search
  * ============================================================================ */
 
-/**
- * @brief Recursive font search using wide-character Win32 APIs
- */
-static BOOL SearchFontRecursiveW(const wchar_t* folderPathW, const wchar_t* targetFileW, 
-                                 wchar_t* resultPathW, size_t resultCapacity) {
-    if (!folderPathW || !targetFileW || !resultPathW) return FALSE;
-
-    wchar_t searchPathW[MAX_PATH] = {0};
-    _snwprintf_s(searchPathW, MAX_PATH, _TRUNCATE, L"%s\\*", folderPathW);
-
-    WIN32_FIND_DATAW findDataW;
-    HANDLE hFind = FindFirstFileW(searchPathW, &findDataW);
-    if (hFind == INVALID_HANDLE_VALUE) return FALSE;
-
-    BOOL found = FALSE;
-    do {
-        if (wcscmp(findDataW.cFileName, L".") == 0 || wcscmp(findDataW.cFileName, L"..") == 0) {
-            continue;
-        }
-
-        wchar_t fullItemPathW[MAX_PATH] = {0};
-        _snwprintf_s(fullItemPathW, MAX_PATH, _TRUNCATE, L"%s\\%s", folderPathW, findDataW.cFileName);
-
-        if (!(findDataW.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)) {
-            if (_wcsicmp(findDataW.cFileName, targetFileW) == 0) {
-                wcsncpy(resultPathW, fullItemPathW, resultCapacity - 1);
-                resultPathW[resultCapacity - 1] = L'\0';
-                found = TRUE;
-                break;
-            }
-        } else {
-            if (SearchFontRecursiveW(fullItemPathW, targetFileW, resultPathW, resultCapacity)) {
-                found = TRUE;
-                break;
-            }
-        }
-    } while (FindNextFileW(hFind, &findDataW));
-    FindClose(hFind);
-    return found;
-}
-
 BOOL FindFontInFontsFolder(const char* fontFileName, char* foundPath, size_t foundPathSize) {
     if (!fontFileName || !foundPath || foundPathSize == 0) return FALSE;
 
-    wchar_t fontsFolderW[MAX_PATH] = {0};
-    if (!GetFontsFolderWide(fontsFolderW, MAX_PATH, TRUE)) return FALSE;
-
     wchar_t targetFileW[MAX_PATH] = {0};
     if (!Utf8ToWide(fontFileName, targetFileW, MAX_PATH)) return FALSE;
 
+    const ResourceCatalog* catalog = ResourceCatalog_Acquire(CATALOG_ROOT_FONTS);
+    const CatalogEntry* entry = ResourceCatalog_FindFileByName(catalog, targetFileW);
+
     wchar_t resultPathW[MAX_PATH] = {0};
-    if (!SearchFontRecursiveW(fontsFolderW, targetFileW, resultPathW, MAX_PATH)) return FALSE;
+    BOOL found = entry && ResourceCatalog_GetFullPath(catalog, entry, resultPathW, MAX_PATH);
+    ResourceCatalog_Release(catalog);
+    if (!found) return FALSE;
 
     return WideToUtf8(resultPathW, foundPath, foundPathSize);
 }
@@ -394,33 +357,54 @@ static inline DWORD SwapDWORD(DWORD value) {
  * ============================================================================ */
 
 /**
- * @brief Find TTF table by tag
- * @param hFile Font file handle
+ * @brief Locate the name and OS/2 tables in one pass over the table directory
+ * @param hFile Font file handle (positioned right after the directory header)
  * @param numTables Number of tables in font
- * @param targetTag Table tag to find
- * @param outOffset Output: table offset
- * @param outLength Output: table length
- * @return TRUE if table found
+ * @param nameTable Output: name table record, offset and length in host order
+ * @param os2Table Output: OS/2 table record (length 0 if the font has none)
+ * @return TRUE if the name table was found
  */
-static BOOL FindTTFTable(HANDLE hFile, WORD numTables, DWORD targetTag, 
-                         DWORD* outOffset, DWORD* outLength) {
-    if (hFile == INVALID_HANDLE_VALUE || !outOffset || !outLength) return FALSE;
-
-    for (WORD i = 0; i < numTables; i++) {
-        TableRecord tableRecord;
-        DWORD bytesRead;
-        if (!ReadFile(hFile, &tableRecord, sizeof(TableRecord), &bytesRead, NULL) ||
-            bytesRead != sizeof(TableRecord)) {
-            return FALSE;
-        }
+static BOOL FindTTFTables(HANDLE hFile, WORD numTables, TableRecord* nameTable, TableRecord* os2Table) {
+    if (hFile == INVALID_HANDLE_VALUE || numTables == 0 || !nameTable || !os2Table) return FALSE;
+
+    DWORD directorySize = numTables * (DWORD)sizeof(TableRecord);
+    TableRecord* records = (TableRecord*)malloc(directorySize);
+    if (!records) return FALSE;
 
-        if (tableRecord.tag == targetTag) {
-            *outOffset = SwapDWORD(tableRecord.offset);
-            *outLength = SwapDWORD(tableRecord.length);
-            return TRUE;
+    DWORD bytesRead;
+    BOOL success = ReadFile(hFile, records, directorySize, &bytesRead, NULL) && bytesRead == directorySize;
+    BOOL foundName = FALSE;
+    memset(os2Table, 0, sizeof(TableRecord));
+
+    for (WORD i = 0; success && i < numTables; i++) {
+        TableRecord* target = NULL;
+        if (records[i].tag == TTF_NAME_TABLE_TAG) {
+            target = nameTable;
+            foundName = TRUE;
+        } else if (records[i].tag == TTF_OS2_TABLE_TAG) {
+            target = os2Table;
+        }
+        if (target) {
+            target->tag = records[i].tag;
+            target->offset = SwapDWORD(records[i].offset);
+            target->length = SwapDWORD(records[i].length);
         }
     }
-    return FALSE;
+
+    free(records);
+    return success && foundName;
+}
+
+/**
+ * @brief Read a byte range of the font file
+ * @return TRUE if all bytes were read
+ */
+static BOOL ReadFontBytes(HANDLE hFile, DWORD offset, void* buffer, DWORD size) {
+    if (SetFilePointer(hFile, offset, NULL, FILE_BEGIN) == INVALID_SET_FILE_POINTER) {
+        return FALSE;
+    }
+    DWORD bytesRead;
+    return ReadFile(hFile, buffer, size, &bytesRead, NULL) && bytesRead == size;
 }
 
 /**
@@ -454,14 +438,64 @@ static void ParseFontName(const char* stringData, size_t dataLength, BOOL isUnic
 }
 
 /**
- * @brief Extract font name from opened TTF file
+ * @brief Find a name record in an in-memory name table and decode it
+ * @param table Name table data
+ * @param tableSize Bytes available in table
+ * @param nameID Name ID to look for (family, subfamily, ...)
+ * @param outName Output buffer (UTF-8)
+ * @param outNameSize Buffer size
+ * @return TRUE if the name was found
+ *
+ * Prefers the Windows Unicode BMP record; otherwise takes the first match.
+ */
+static BOOL FindNameString(const BYTE* table, DWORD tableSize, WORD nameID,
+                           char* outName, size_t outNameSize) {
+    if (!table || tableSize < sizeof(NameTableHeader) || !outName || outNameSize == 0) return FALSE;
+
+    const NameTableHeader* nameHeader = (const NameTableHeader*)table;
+    WORD count = SwapWORD(nameHeader->count);
+    DWORD stringOffset = SwapWORD(nameHeader->stringOffset);
+    if (sizeof(NameTableHeader) + (DWORD)count * sizeof(NameRecord) > tableSize) return FALSE;
+
+    const NameRecord* records = (const NameRecord*)(table + sizeof(NameTableHeader));
+    const NameRecord* found = NULL;
+    for (WORD i = 0; i < count; i++) {
+        if (SwapWORD(records[i].nameID) != nameID) continue;
+        if (SwapWORD(records[i].platformID) == 3 && SwapWORD(records[i].encodingID) == 1) {
+            found = &records[i];
+            break;
+        }
+        if (!found) found = &records[i];
+    }
+    if (!found) return FALSE;
+
+    WORD platformID = SwapWORD(found->platformID);
+    BOOL isUnicode = (platformID == 0 || platformID == 3);
+    DWORD nameLength = SwapWORD(found->length);
+    DWORD nameOffset = stringOffset + SwapWORD(found->offset);
+    if (nameOffset > tableSize || nameLength > tableSize - nameOffset) return FALSE;
+
+    if (nameLength > TTF_STRING_SAFETY_LIMIT) nameLength = TTF_STRING_SAFETY_LIMIT;
+    char* stringBuffer = (char*)malloc(nameLength + 2);
+    if (!stringBuffer) return FALSE;
+
+    memcpy(stringBuffer, table + nameOffset, nameLength);
+    ParseFontName(stringBuffer, nameLength, isUnicode, outName, outNameSize);
+    free(stringBuffer);
+    return TRUE;
+}
+
+/**
+ * @brief Extract family, style and embedding flags from an opened TTF file
  * @param hFile Font file handle (must be open and positioned at start)
- * @param fontName Output buffer for font name
- * @param fontNameSize Buffer size
- * @return TRUE if font name extracted successfully
+ * @param metadata Output metadata
+ * @return TRUE if at least the family name was extracted
+ *
+ * The name table is read in a single call and parsed from memory.
  */
-static BOOL ExtractFontNameFromHandle(HANDLE hFile, char* fontName, size_t fontNameSize) {
-    if (hFile == INVALID_HANDLE_VALUE || !fontName || fontNameSize == 0) return FALSE;
+static BOOL ExtractFontMetadataFromHandle(HANDLE hFile, FontMetadata* metadata) {
+    if (hFile == INVALID_HANDLE_VALUE || !metadata) return FALSE;
+    memset(metadata, 0, sizeof(FontMetadata));
 
     FontDirectoryHeader fontHeader;
     DWORD bytesRead;
@@ -472,93 +506,77 @@ static BOOL ExtractFontNameFromHandle(HANDLE hFile, char* fontName, size_t fontN
 
     fontHeader.numTables = SwapWORD(fontHeader.numTables);
 
-    DWORD nameTableOffset = 0, nameTableLength = 0;
-    if (!FindTTFTable(hFile, fontHeader.numTables, TTF_NAME_TABLE_TAG, 
-                     &nameTableOffset, &nameTableLength)) {
+    TableRecord nameTable, os2Table;
+    if (!FindTTFTables(hFile, fontHeader.numTables, &nameTable, &os2Table)) {
         return FALSE;
     }
 
-    if (SetFilePointer(hFile, nameTableOffset, NULL, FILE_BEGIN) == INVALID_SET_FILE_POINTER) {
-        return FALSE;
+    DWORD nameTableSize = nameTable.length;
+    if (nameTableSize > TTF_NAME_TABLE_SIZE_LIMIT) nameTableSize = TTF_NAME_TABLE_SIZE_LIMIT;
+    BYTE* nameData = (BYTE*)malloc(nameTableSize ? nameTableSize : 1);
+    if (!nameData) return FALSE;
+
+    BOOL success = ReadFontBytes(hFile, nameTable.offset, nameData, nameTableSize) &&
+                   FindNameString(nameData, nameTableSize, TTF_NAME_ID_FAMILY,
+                                  metadata->family, sizeof(metadata->family));
+    if (success) {
+        FindNameString(nameData, nameTableSize, TTF_NAME_ID_SUBFAMILY,
+                       metadata->style, sizeof(metadata->style));
     }
+    free(nameData);
 
-    NameTableHeader nameHeader;
-    if (!ReadFile(hFile, &nameHeader, sizeof(NameTableHeader), &bytesRead, NULL) ||
-        bytesRead != sizeof(NameTableHeader)) {
-        return FALSE;
+    if (success && os2Table.length >= TTF_OS2_FSTYPE_OFFSET + sizeof(WORD)) {
+        WORD fsType;
+        if (ReadFontBytes(hFile, os2Table.offset + TTF_OS2_FSTYPE_OFFSET, &fsType, sizeof(fsType))) {
+            metadata->fsType = SwapWORD(fsType);
+        }
     }
+    return success;
+}
 
-    nameHeader.count = SwapWORD(nameHeader.count);
-    nameHeader.stringOffset = SwapWORD(nameHeader.stringOffset);
+BOOL GetFontMetadataFromFile(const char* fontFilePath, FontMetadata* metadata) {
+    if (!fontFilePath || !metadata) return FALSE;
 
-    BOOL foundName = FALSE;
-    WORD nameLength = 0, nameOffset = 0;
-    BOOL isUnicode = FALSE;
+    wchar_t wFontPath[MAX_PATH];
+    if (!Utf8ToWide(fontFilePath, wFontPath, MAX_PATH)) return FALSE;
 
-    for (WORD i = 0; i < nameHeader.count; i++) {
-        NameRecord nameRecord;
-        if (!ReadFile(hFile, &nameRecord, sizeof(NameRecord), &bytesRead, NULL) ||
-            bytesRead != sizeof(NameRecord)) {
-            return FALSE;
-        }
+    /** Size and mtime come from the directory entry; the file is opened only on a cache miss */
+    WIN32_FILE_ATTRIBUTE_DATA attributes;
+    if (!GetFileAttributesExW(wFontPath, GetFileExInfoStandard, &attributes)) return FALSE;
+    ULONGLONG fileSize = ((ULONGLONG)attributes.nFileSizeHigh << 32) | attributes.nFileSizeLow;
 
-        nameRecord.platformID = SwapWORD(nameRecord.platformID);
-        nameRecord.encodingID = SwapWORD(nameRecord.encodingID);
-        nameRecord.nameID = SwapWORD(nameRecord.nameID);
-        nameRecord.length = SwapWORD(nameRecord.length);
-        nameRecord.offset = SwapWORD(nameRecord.offset);
-
-        if (nameRecord.nameID == TTF_NAME_ID_FAMILY) {
-            if (nameRecord.platformID == 3 && nameRecord.encodingID == 1) {
-                nameLength = nameRecord.length;
-                nameOffset = nameRecord.offset;
-                isUnicode = TRUE;
-                foundName = TRUE;
-                break;
-            } else if (!foundName) {
-                nameLength = nameRecord.length;
-                nameOffset = nameRecord.offset;
-                isUnicode = (nameRecord.platformID == 0);
-                foundName = TRUE;
-            }
-        }
+    char cacheKey[MAX_PATH];
+    if (!CalculateRelativePath(fontFilePath, cacheKey, sizeof(cacheKey))) {
+        strncpy(cacheKey, fontFilePath, sizeof(cacheKey) - 1);
+        cacheKey[sizeof(cacheKey) - 1] = '\0';
     }
 
-    if (!foundName) return FALSE;
-
-    DWORD stringDataOffset = nameTableOffset + sizeof(NameTableHeader) + 
-                            nameHeader.count * sizeof(NameRecord) + nameOffset;
-    if (SetFilePointer(hFile, stringDataOffset, NULL, FILE_BEGIN) == INVALID_SET_FILE_POINTER) {
-        return FALSE;
+    if (FontCache_Lookup(cacheKey, fileSize, attributes.ftLastWriteTime, metadata)) {
+        return TRUE;
     }
 
-    if (nameLength > TTF_STRING_SAFETY_LIMIT) nameLength = TTF_STRING_SAFETY_LIMIT;
-    char* stringBuffer = (char*)malloc(nameLength + 2);
-    if (!stringBuffer) return FALSE;
+    HANDLE hFile = CreateFileW(wFontPath, GENERIC_READ, FILE_SHARE_READ, NULL, 
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (hFile == INVALID_HANDLE_VALUE) return FALSE;
 
-    BOOL success = FALSE;
-    if (ReadFile(hFile, stringBuffer, nameLength, &bytesRead, NULL) && bytesRead == nameLength) {
-        ParseFontName(stringBuffer, nameLength, isUnicode, fontName, fontNameSize);
-        success = TRUE;
-    }
+    BOOL result = ExtractFontMetadataFromHandle(hFile, metadata);
+    CloseHandle(hFile);
 
-    free(stringBuffer);
-    return success;
+    if (result) {
+        FontCache_Store(cacheKey, fileSize, attributes.ftLastWriteTime, metadata);
+    }
+    return result;
 }
 
 BOOL GetFontNameFromFile(const char* fontFilePath, char* fontName, size_t fontNameSize) {
     if (!fontFilePath || !fontName || fontNameSize == 0) return FALSE;
 
-    wchar_t wFontPath[MAX_PATH];
-    if (!Utf8ToWide(fontFilePath, wFontPath, MAX_PATH)) return FALSE;
-
-    HANDLE hFile = CreateFileW(wFontPath, GENERIC_READ, FILE_SHARE_READ, NULL, 
-                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
-    if (hFile == INVALID_HANDLE_VALUE) return FALSE;
+    FontMetadata metadata;
+    if (!GetFontMetadataFromFile(fontFilePath, &metadata)) return FALSE;
 
-    BOOL result = ExtractFontNameFromHandle(hFile, fontName, fontNameSize);
-    CloseHandle(hFile);
-    return result;
+    strncpy(fontName, metadata.family, fontNameSize - 1);
+    fontName[fontNameSize - 1] = '\0';
+    return TRUE;
 }
 
 /* ============================================================================
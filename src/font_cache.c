@@ -0,0 +1,274 @@
+/**
+ * @file font_cache.c
+ * @brief Font metadata cache persisted as a small tab-separated file
+ *
+ * The entries and the line format live in font_cache_table.c; this file
+ * adds the lock, the file location and the staleness checks. The file is
+ * read on first use and written back only when an entry was added or
+ * dropped.
+ */
+
+#include <windows.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/font_cache.h"
+#include "../include/config.h"
+#include "../include/log.h"
+
+/* ============================================================================
+ * Constants
+ * ============================================================================ */
+
+#define FONT_CACHE_FILE_NAME L"font_cache.tsv"
+
+/* ============================================================================
+ * Type Definitions
+ * ============================================================================ */
+
+/** @brief Absolute-key entry copied out so its file can be checked without the lock */
+typedef struct {
+    char* key;                      /**< Owned copy */
+    ULONGLONG size;
+    ULONGLONG lastWrite;
+} AbsoluteEntryCheck;
+
+/* ============================================================================
+ * Global State
+ * ============================================================================ */
+
+static SRWLOCK g_cacheLock = SRWLOCK_INIT;
+static FontCacheTable g_table = {0};
+static BOOL g_loaded = FALSE;
+static BOOL g_dirty = FALSE;
+
+/* ============================================================================
+ * Helper Functions - Entries
+ * ============================================================================ */
+
+static ULONGLONG FileTimeToU64(FILETIME ft) {
+    return ((ULONGLONG)ft.dwHighDateTime << 32) | ft.dwLowDateTime;
+}
+
+/** @brief Keys outside the fonts folder are stored as absolute paths */
+static BOOL IsAbsoluteKey(const char* key) {
+    return (key[0] && key[1] == ':') || (key[0] == '\\' && key[1] == '\\');
+}
+
+/** @brief TRUE if the file behind an absolute key still has the cached size and last-write time */
+static BOOL AbsoluteFileMatches(const AbsoluteEntryCheck* check) {
+    wchar_t wPath[MAX_PATH];
+    if (!MultiByteToWideChar(CP_UTF8, 0, check->key, -1, wPath, MAX_PATH)) return FALSE;
+
+    WIN32_FILE_ATTRIBUTE_DATA data;
+    if (!GetFileAttributesExW(wPath, GetFileExInfoStandard, &data)) return FALSE;
+    ULONGLONG size = ((ULONGLONG)data.nFileSizeHigh << 32) | data.nFileSizeLow;
+    return size == check->size && FileTimeToU64(data.ftLastWriteTime) == check->lastWrite;
+}
+
+/* ============================================================================
+ * Helper Functions - Persistence
+ * ============================================================================ */
+
+/** @brief %LOCALAPPDATA%\Catime\font_cache.tsv (next to config.ini) */
+static BOOL GetCacheFilePath(wchar_t* out, size_t size) {
+    char configPathUtf8[MAX_PATH] = {0};
+    GetConfigPath(configPathUtf8, MAX_PATH);
+
+    wchar_t configPathW[MAX_PATH] = {0};
+    if (MultiByteToWideChar(CP_UTF8, 0, configPathUtf8, -1, configPathW, MAX_PATH) <= 0) return FALSE;
+
+    wchar_t* lastSep = wcsrchr(configPathW, L'\\');
+    if (!lastSep) return FALSE;
+    *lastSep = L'\0';
+
+    return _snwprintf_s(out, size, _TRUNCATE, L"%s\\%s", configPathW, FONT_CACHE_FILE_NAME) >= 0;
+}
+
+/** @brief Read the cache file once (lock held exclusively) */
+static void EnsureLoaded(void) {
+    if (g_loaded) return;
+    g_loaded = TRUE;
+
+    wchar_t path[MAX_PATH];
+    if (!GetCacheFilePath(path, MAX_PATH)) return;
+
+    FILE* file = _wfopen(path, L"rb");
+    if (!file) return;
+
+    /** Unknown format or dropped lines: replace the file on the next save */
+    int skipped = FontCacheTable_Read(&g_table, file);
+    fclose(file);
+    if (skipped != 0) {
+        g_dirty = TRUE;
+    }
+
+    LOG_INFO("Font cache: loaded %d entries", g_table.count);
+}
+
+/* ============================================================================
+ * Public API
+ * ============================================================================ */
+
+BOOL FontCache_Lookup(const char* key, ULONGLONG size, FILETIME lastWrite, FontMetadata* out) {
+    if (!key || !*key || !out) return FALSE;
+
+    AcquireSRWLockExclusive(&g_cacheLock);
+    EnsureLoaded();
+    int index;
+    BOOL hit = FontCacheTable_Find(&g_table, key, &index) &&
+               g_table.entries[index].size == size &&
+               g_table.entries[index].lastWrite == FileTimeToU64(lastWrite);
+    if (hit) {
+        *out = g_table.entries[index].metadata;
+    }
+    ReleaseSRWLockExclusive(&g_cacheLock);
+    return hit;
+}
+
+void FontCache_Store(const char* key, ULONGLONG size, FILETIME lastWrite, const FontMetadata* metadata) {
+    if (!key || !*key || !metadata) return;
+
+    AcquireSRWLockExclusive(&g_cacheLock);
+    EnsureLoaded();
+    if (FontCacheTable_Put(&g_table, key, size, FileTimeToU64(lastWrite), metadata)) {
+        g_dirty = TRUE;
+    }
+    ReleaseSRWLockExclusive(&g_cacheLock);
+}
+
+/** @brief Mark cache entries that match a font in the catalog (lock held) */
+static void MarkCatalogFonts(const ResourceCatalog* catalog, const CatalogEntry* folder) {
+    UINT count = 0;
+    const CatalogEntry* children = ResourceCatalog_GetChildren(catalog, folder, &count);
+    for (UINT i = 0; i < count; i++) {
+        const CatalogEntry* e = &children[i];
+        if (e->type == CATALOG_ENTRY_DIRECTORY) {
+            MarkCatalogFonts(catalog, e);
+        } else if (e->type == CATALOG_ENTRY_FONT) {
+            int index;
+            if (FontCacheTable_Find(&g_table, e->relPathUtf8, &index) && g_table.entries[index].size == e->size &&
+                g_table.entries[index].lastWrite == FileTimeToU64(e->lastWrite)) {
+                g_table.entries[index].seen = TRUE;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Drop absolute-key entries whose file is gone or has changed
+ *
+ * The keys are copied out and checked with the lock released, so a slow
+ * or unreachable network path never stalls lookups. An entry re-stored
+ * while the check ran no longer matches the copy and is kept.
+ */
+static void PruneAbsoluteEntries(void) {
+    AcquireSRWLockExclusive(&g_cacheLock);
+    int absoluteCount = 0;
+    for (int i = 0; i < g_table.count; i++) {
+        if (IsAbsoluteKey(g_table.entries[i].key)) absoluteCount++;
+    }
+    AbsoluteEntryCheck* checks = absoluteCount
+        ? (AbsoluteEntryCheck*)calloc(absoluteCount, sizeof(*checks)) : NULL;
+    int checkCount = 0;
+    for (int i = 0; checks && i < g_table.count; i++) {
+        if (!IsAbsoluteKey(g_table.entries[i].key)) continue;
+        char* key = _strdup(g_table.entries[i].key);
+        if (!key) continue;
+        checks[checkCount++] = (AbsoluteEntryCheck){key, g_table.entries[i].size, g_table.entries[i].lastWrite};
+    }
+    ReleaseSRWLockExclusive(&g_cacheLock);
+    if (checkCount == 0) {
+        free(checks);
+        return;
+    }
+
+    BOOL* stale = (BOOL*)calloc(checkCount, sizeof(BOOL));
+    for (int i = 0; stale && i < checkCount; i++) {
+        stale[i] = !AbsoluteFileMatches(&checks[i]);
+    }
+
+    int dropped = 0;
+    AcquireSRWLockExclusive(&g_cacheLock);
+    for (int i = 0; stale && i < checkCount; i++) {
+        int index;
+        if (stale[i] && FontCacheTable_Find(&g_table, checks[i].key, &index) &&
+            g_table.entries[index].size == checks[i].size && g_table.entries[index].lastWrite == checks[i].lastWrite) {
+            FontCacheTable_RemoveAt(&g_table, index);
+            dropped++;
+        }
+    }
+    if (dropped > 0) {
+        g_dirty = TRUE;
+    }
+    ReleaseSRWLockExclusive(&g_cacheLock);
+
+    if (dropped > 0) {
+        LOG_INFO("Font cache: dropped %d entries for moved or changed fonts outside the fonts folder", dropped);
+    }
+    for (int i = 0; i < checkCount; i++) free(checks[i].key);
+    free(checks);
+    free(stale);
+}
+
+void FontCache_Validate(const ResourceCatalog* fontsCatalog) {
+    if (!fontsCatalog) return;
+
+    AcquireSRWLockExclusive(&g_cacheLock);
+    EnsureLoaded();
+    for (int i = 0; i < g_table.count; i++) {
+        g_table.entries[i].seen = FALSE;
+    }
+    MarkCatalogFonts(fontsCatalog, NULL);
+
+    /** Absolute keys are outside the catalog; PruneAbsoluteEntries checks them on disk */
+    int kept = 0;
+    for (int i = 0; i < g_table.count; i++) {
+        if (g_table.entries[i].seen || IsAbsoluteKey(g_table.entries[i].key)) {
+            g_table.entries[kept++] = g_table.entries[i];
+        } else {
+            free(g_table.entries[i].key);
+        }
+    }
+    if (kept != g_table.count) {
+        LOG_INFO("Font cache: dropped %d stale entries", g_table.count - kept);
+        g_table.count = kept;
+        g_dirty = TRUE;
+    }
+    ReleaseSRWLockExclusive(&g_cacheLock);
+
+    PruneAbsoluteEntries();
+}
+
+void FontCache_Save(void) {
+    AcquireSRWLockExclusive(&g_cacheLock);
+    if (!g_dirty) {
+        ReleaseSRWLockExclusive(&g_cacheLock);
+        return;
+    }
+
+    wchar_t path[MAX_PATH];
+    wchar_t tempPath[MAX_PATH];
+    FILE* file = NULL;
+    if (GetCacheFilePath(path, MAX_PATH) &&
+        _snwprintf_s(tempPath, MAX_PATH, _TRUNCATE, L"%s.tmp", path) >= 0) {
+        file = _wfopen(tempPath, L"wb");
+    }
+    if (!file) {
+        ReleaseSRWLockExclusive(&g_cacheLock);
+        return;
+    }
+
+    BOOL ok = FontCacheTable_Write(&g_table, file);
+    ok = (fclose(file) == 0) && ok;
+
+    /** Replace the old file only once the new one is complete */
+    if (ok && MoveFileExW(tempPath, path, MOVEFILE_REPLACE_EXISTING)) {
+        g_dirty = FALSE;
+    } else {
+        DeleteFileW(tempPath);
+        LOG_WARNING("Font cache: could not write %d entries", g_table.count);
+    }
+    ReleaseSRWLockExclusive(&g_cacheLock);
+}
@@ -0,0 +1,176 @@
+/**
+ * @file font_cache_table.c
+ * @brief Sorted font metadata entries and the font_cache.tsv line format
+ *
+ * Entries are kept in one array sorted by key (case-insensitive), so a
+ * lookup is a binary search. After the header line, each line holds:
+ *
+ *   size <TAB> last-write (FILETIME as one 64-bit value) <TAB> fsType
+ *   <TAB> key <TAB> family <TAB> style
+ */
+
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/font_cache_table.h"
+
+/* ============================================================================
+ * Helper Functions
+ * ============================================================================ */
+
+/** @brief ASCII case-insensitive order, as _stricmp gives in the C locale */
+static int CompareKeys(const char* a, const char* b) {
+    const unsigned char* pa = (const unsigned char*)a;
+    const unsigned char* pb = (const unsigned char*)b;
+    while (*pa && tolower(*pa) == tolower(*pb)) {
+        pa++;
+        pb++;
+    }
+    return tolower(*pa) - tolower(*pb);
+}
+
+/** @brief Copy a field, turning separators into spaces so the line format holds */
+static void CopyField(char* out, size_t outSize, const char* text) {
+    snprintf(out, outSize, "%s", text ? text : "");
+    for (char* p = out; *p; p++) {
+        if (*p == '\t' || *p == '\r' || *p == '\n') *p = ' ';
+    }
+}
+
+static char* DuplicateKey(const char* key) {
+    size_t length = strlen(key) + 1;
+    char* copy = (char*)malloc(length);
+    if (copy) memcpy(copy, key, length);
+    return copy;
+}
+
+/* ============================================================================
+ * Public API - Entries
+ * ============================================================================ */
+
+int FontCacheTable_Find(const FontCacheTable* table, const char* key, int* outIndex) {
+    int lo = 0;
+    int hi = table->count;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        int cmp = CompareKeys(table->entries[mid].key, key);
+        if (cmp == 0) {
+            *outIndex = mid;
+            return 1;
+        }
+        if (cmp < 0) lo = mid + 1;
+        else hi = mid;
+    }
+    *outIndex = lo;
+    return 0;
+}
+
+int FontCacheTable_Put(FontCacheTable* table, const char* key, uint64_t size, uint64_t lastWrite,
+                       const FontMetadata* metadata) {
+    int index;
+    if (!FontCacheTable_Find(table, key, &index)) {
+        if (table->count == table->capacity) {
+            int capacity = table->capacity ? table->capacity * 2 : 64;
+            FontCacheEntry* grown = (FontCacheEntry*)realloc(table->entries, capacity * sizeof(*grown));
+            if (!grown) return 0;
+            table->entries = grown;
+            table->capacity = capacity;
+        }
+        char* ownedKey = DuplicateKey(key);
+        if (!ownedKey) return 0;
+        memmove(&table->entries[index + 1], &table->entries[index],
+                (table->count - index) * sizeof(*table->entries));
+        table->count++;
+        table->entries[index].key = ownedKey;
+    }
+
+    FontCacheEntry* entry = &table->entries[index];
+    entry->size = size;
+    entry->lastWrite = lastWrite;
+    entry->seen = 0;
+    CopyField(entry->metadata.family, sizeof(entry->metadata.family), metadata->family);
+    CopyField(entry->metadata.style, sizeof(entry->metadata.style), metadata->style);
+    entry->metadata.fsType = metadata->fsType;
+    return 1;
+}
+
+void FontCacheTable_RemoveAt(FontCacheTable* table, int index) {
+    free(table->entries[index].key);
+    memmove(&table->entries[index], &table->entries[index + 1],
+            (table->count - index - 1) * sizeof(*table->entries));
+    table->count--;
+}
+
+void FontCacheTable_Clear(FontCacheTable* table) {
+    for (int i = 0; i < table->count; i++) {
+        free(table->entries[i].key);
+    }
+    free(table->entries);
+    table->entries = NULL;
+    table->count = 0;
+    table->capacity = 0;
+}
+
+/* ============================================================================
+ * Public API - File format
+ * ============================================================================ */
+
+int FontCacheTable_SplitFields(char* line, char** fields, int maxFields) {
+    line[strcspn(line, "\r\n")] = '\0';
+    int count = 0;
+    char* p = line;
+    while (count < maxFields) {
+        fields[count++] = p;
+        char* tab = (count < maxFields) ? strchr(p, '\t') : NULL;
+        if (!tab) break;
+        *tab = '\0';
+        p = tab + 1;
+    }
+    return count;
+}
+
+int FontCacheTable_Read(FontCacheTable* table, FILE* file) {
+    char line[FONT_CACHE_LINE_MAX];
+    if (!fgets(line, sizeof(line), file) || strncmp(line, FONT_CACHE_HEADER, strlen(FONT_CACHE_HEADER)) != 0) {
+        return -1;
+    }
+
+    int skipped = 0;
+    while (fgets(line, sizeof(line), file)) {
+        /** An overlong line would come back in pieces: drop the whole line */
+        if (!strchr(line, '\n') && !feof(file)) {
+            int c;
+            while ((c = fgetc(file)) != EOF && c != '\n') {}
+            skipped++;
+            continue;
+        }
+
+        char* fields[FONT_CACHE_FIELD_COUNT];
+        if (FontCacheTable_SplitFields(line, fields, FONT_CACHE_FIELD_COUNT) != FONT_CACHE_FIELD_COUNT ||
+            !fields[3][0]) {
+            skipped++;
+            continue;
+        }
+        FontMetadata metadata = {0};
+        CopyField(metadata.family, sizeof(metadata.family), fields[4]);
+        CopyField(metadata.style, sizeof(metadata.style), fields[5]);
+        metadata.fsType = (uint16_t)strtoul(fields[2], NULL, 10);
+        if (!FontCacheTable_Put(table, fields[3], strtoull(fields[0], NULL, 10),
+                                strtoull(fields[1], NULL, 10), &metadata)) {
+            skipped++;
+        }
+    }
+    return skipped;
+}
+
+int FontCacheTable_Write(const FontCacheTable* table, FILE* file) {
+    int ok = fprintf(file, "%s\n", FONT_CACHE_HEADER) > 0;
+    for (int i = 0; ok && i < table->count; i++) {
+        const FontCacheEntry* e = &table->entries[i];
+        ok = fprintf(file, "%llu\t%llu\t%u\t%s\t%s\t%s\n",
+                     (unsigned long long)e->size, (unsigned long long)e->lastWrite,
+                     (unsigned)e->metadata.fsType, e->key, e->metadata.family, e->metadata.style) > 0;
+    }
+    return ok;
+}
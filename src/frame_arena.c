@@ -0,0 +1,327 @@
+/**
+ * @file frame_arena.c
+ * @brief Size-class block allocator with per-class free lists and scratch arenas
+ *
+ * Replaces the old single 256 KB MemoryPool buffer in tray_animation.c:
+ * - Quarter-step classes (4 KB, 5 KB, 6 KB, 7 KB, 8 KB, 10 KB .. 16 MB) cover
+ *   scaler temporaries, master frames, canvases and large GIF frame buffers
+ *   with at most 20% slack per block
+ * - Freed blocks park on their class free list and are reused without a CRT call
+ * - Oversize requests fall through to malloc and are counted separately
+ * - A blocking lock (SRWLOCK / pthread mutex) guards the lists, so decode
+ *   workers and the UI-thread compositor can share the allocator whatever
+ *   their thread priorities
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/frame_arena.h"
+#include "../include/portable_lock.h"
+
+/* ============================================================================
+ * Constants and Types
+ * ============================================================================ */
+
+/** @brief Bytes reserved in front of each payload; keeps payloads 16-byte aligned */
+#define BLOCK_HEADER_SIZE 32
+
+/** @brief Class index stored for oversize (malloc-backed) blocks */
+#define CLASS_OVERSIZE 0xFFFFu
+
+/** @brief Payload alignment for scratch allocations */
+#define SCRATCH_ALIGN 16
+
+/** @brief log2 of the smallest class (4 KB) */
+#define CLASS_MIN_SHIFT 12
+
+/** @brief Classes per doubling of the block size */
+#define CLASS_STEPS 4
+
+typedef struct BlockHeader {
+    struct BlockHeader* next;   /**< Free-list link while cached */
+    size_t requested;           /**< Caller's size while in use */
+    uint32_t sizeClass;         /**< Class index or CLASS_OVERSIZE */
+    size_t payloadSize;         /**< Class size, or exact size for oversize blocks */
+} BlockHeader;
+
+_Static_assert(sizeof(BlockHeader) <= BLOCK_HEADER_SIZE, "BlockHeader must fit its reserved space");
+
+typedef struct {
+    BlockHeader* head;
+    unsigned count;
+} FreeList;
+
+struct ScratchChunk {
+    ScratchChunk* next;
+    size_t capacity;            /**< Payload bytes after the chunk header */
+    size_t used;
+};
+
+#define SCRATCH_CHUNK_HEADER (((sizeof(ScratchChunk) + SCRATCH_ALIGN - 1) / SCRATCH_ALIGN) * SCRATCH_ALIGN)
+
+/* ============================================================================
+ * Global State
+ * ============================================================================ */
+
+static PortableLock g_lock = PORTABLE_LOCK_INIT;
+static FreeList g_freeLists[FRAME_ARENA_CLASS_COUNT];
+static FrameArenaStats g_stats;
+
+/* ============================================================================
+ * Helper Functions
+ * ============================================================================ */
+
+static inline void ArenaLock(void) {
+    PortableLock_Acquire(&g_lock);
+}
+
+static inline void ArenaUnlock(void) {
+    PortableLock_Release(&g_lock);
+}
+
+static inline BlockHeader* HeaderFromPayload(const void* ptr) {
+    return (BlockHeader*)((unsigned char*)ptr - BLOCK_HEADER_SIZE);
+}
+
+static inline void* PayloadFromHeader(BlockHeader* hdr) {
+    return (unsigned char*)hdr + BLOCK_HEADER_SIZE;
+}
+
+/**
+ * @brief Payload size of a class
+ *
+ * Class 0 is 4 KB; after it every power of two is split into four steps,
+ * so class 4k+1..4k+4 are 5/4, 6/4, 7/4 and 8/4 of 4 KB * 2^k.
+ */
+static size_t ClassSize(int cls) {
+    if (cls == 0) return (size_t)1 << CLASS_MIN_SHIFT;
+    int step = cls - 1;
+    int shift = CLASS_MIN_SHIFT + step / CLASS_STEPS;
+    size_t base = (size_t)1 << shift;
+    return base + (size_t)(step % CLASS_STEPS + 1) * (base / CLASS_STEPS);
+}
+
+/**
+ * @brief Smallest class that fits a request
+ * @return Class index, or -1 if the request is oversize
+ */
+static int ClassForSize(size_t size) {
+    if (size <= ((size_t)1 << CLASS_MIN_SHIFT)) return 0;
+    if (size > FRAME_ARENA_MAX_CLASS_SIZE) return -1;
+
+    /** Power of two just below the request, then which quarter above it */
+    size_t last = size - 1;
+    int shift = CLASS_MIN_SHIFT;
+    while ((last >> (shift + 1)) != 0) shift++;
+    size_t quarter = (last - ((size_t)1 << shift)) >> (shift - 2);
+    return (shift - CLASS_MIN_SHIFT) * CLASS_STEPS + (int)quarter + 1;
+}
+
+/** @brief Account a block handed out (lock held) */
+static void TrackAcquire(const BlockHeader* hdr) {
+    g_stats.bytesInUse += hdr->payloadSize;
+    g_stats.requestedInUse += hdr->requested;
+    if (g_stats.bytesInUse > g_stats.peakBytesInUse) {
+        g_stats.peakBytesInUse = g_stats.bytesInUse;
+    }
+}
+
+/* ============================================================================
+ * Public API - Block Allocator
+ * ============================================================================ */
+
+void* FrameArena_Alloc(size_t size) {
+    if (size == 0) size = 1;
+
+    int cls = ClassForSize(size);
+    BlockHeader* hdr = NULL;
+
+    if (cls >= 0) {
+        ArenaLock();
+        FreeList* list = &g_freeLists[cls];
+        if (list->head) {
+            hdr = list->head;
+            list->head = hdr->next;
+            list->count--;
+            g_stats.bytesCached -= hdr->payloadSize;
+            g_stats.hits++;
+            hdr->next = NULL;
+            hdr->requested = size;
+            TrackAcquire(hdr);
+        }
+        ArenaUnlock();
+        if (hdr) return PayloadFromHeader(hdr);
+    }
+
+    size_t payload = (cls >= 0) ? ClassSize(cls) : size;
+    if (payload > SIZE_MAX - BLOCK_HEADER_SIZE) return NULL;
+
+    hdr = (BlockHeader*)malloc(BLOCK_HEADER_SIZE + payload);
+    if (!hdr) return NULL;
+    hdr->next = NULL;
+    hdr->requested = size;
+    hdr->sizeClass = (cls >= 0) ? (uint32_t)cls : CLASS_OVERSIZE;
+    hdr->payloadSize = payload;
+
+    ArenaLock();
+    g_stats.misses++;
+    if (cls < 0) g_stats.oversize++;
+    TrackAcquire(hdr);
+    ArenaUnlock();
+
+    return PayloadFromHeader(hdr);
+}
+
+void* FrameArena_Calloc(size_t size) {
+    void* ptr = FrameArena_Alloc(size);
+    if (ptr) memset(ptr, 0, size);
+    return ptr;
+}
+
+void FrameArena_Free(void* ptr) {
+    if (!ptr) return;
+
+    BlockHeader* hdr = HeaderFromPayload(ptr);
+    int keep = 0;
+    ArenaLock();
+    g_stats.frees++;
+    g_stats.bytesInUse -= hdr->payloadSize;
+    g_stats.requestedInUse -= hdr->requested;
+    if (hdr->sizeClass != CLASS_OVERSIZE) {
+        FreeList* list = &g_freeLists[hdr->sizeClass];
+        if (list->count < FRAME_ARENA_MAX_CACHED_PER_CLASS &&
+            g_stats.bytesCached + hdr->payloadSize <= FRAME_ARENA_MAX_CACHED_BYTES) {
+            hdr->requested = 0;
+            hdr->next = list->head;
+            list->head = hdr;
+            list->count++;
+            g_stats.bytesCached += hdr->payloadSize;
+            keep = 1;
+        }
+    }
+    ArenaUnlock();
+
+    if (!keep) {
+        free(hdr);
+    }
+}
+
+size_t FrameArena_BlockSize(const void* ptr) {
+    if (!ptr) return 0;
+    return HeaderFromPayload(ptr)->payloadSize;
+}
+
+void FrameArena_Trim(void) {
+    BlockHeader* release = NULL;
+
+    ArenaLock();
+    for (int i = 0; i < FRAME_ARENA_CLASS_COUNT; ++i) {
+        BlockHeader* hdr = g_freeLists[i].head;
+        while (hdr) {
+            BlockHeader* next = hdr->next;
+            hdr->next = release;
+            release = hdr;
+            hdr = next;
+        }
+        g_freeLists[i].head = NULL;
+        g_freeLists[i].count = 0;
+    }
+    g_stats.bytesCached = 0;
+    ArenaUnlock();
+
+    while (release) {
+        BlockHeader* next = release->next;
+        free(release);
+        release = next;
+    }
+}
+
+void FrameArena_GetStats(FrameArenaStats* out) {
+    if (!out) return;
+    ArenaLock();
+    *out = g_stats;
+    ArenaUnlock();
+    out->fragmentation = (out->bytesInUse > 0)
+        ? 1.0 - (double)out->requestedInUse / (double)out->bytesInUse
+        : 0.0;
+}
+
+void FrameArena_ResetStats(void) {
+    ArenaLock();
+    g_stats.hits = 0;
+    g_stats.misses = 0;
+    g_stats.oversize = 0;
+    g_stats.frees = 0;
+    g_stats.peakBytesInUse = g_stats.bytesInUse;
+    ArenaUnlock();
+}
+
+/* ============================================================================
+ * Public API - Scratch Arena
+ * ============================================================================ */
+
+/** @brief Release every chunk of an arena */
+static void ScratchArena_FreeChunks(ScratchArena* arena) {
+    ScratchChunk* chunk = arena->head;
+    while (chunk) {
+        ScratchChunk* next = chunk->next;
+        FrameArena_Free(chunk);
+        chunk = next;
+    }
+    arena->head = NULL;
+}
+
+void ScratchArena_Init(ScratchArena* arena, size_t chunkSize) {
+    if (!arena) return;
+    memset(arena, 0, sizeof(*arena));
+    arena->chunkSize = chunkSize ? chunkSize : SCRATCH_ARENA_DEFAULT_CHUNK;
+}
+
+void* ScratchArena_Alloc(ScratchArena* arena, size_t size) {
+    if (!arena) return NULL;
+    if (size == 0) size = 1;
+    size = ((size + SCRATCH_ALIGN - 1) / SCRATCH_ALIGN) * SCRATCH_ALIGN;
+
+    ScratchChunk* chunk = arena->head;
+    if (!chunk || chunk->capacity - chunk->used < size) {
+        size_t want = arena->chunkSize;
+        if (arena->highWater > want) want = arena->highWater;
+        if (size > want) want = size;
+
+        chunk = (ScratchChunk*)FrameArena_Alloc(SCRATCH_CHUNK_HEADER + want);
+        if (!chunk) return NULL;
+        /** Use the whole class block, not just what was asked for */
+        chunk->capacity = FrameArena_BlockSize(chunk) - SCRATCH_CHUNK_HEADER;
+        chunk->used = 0;
+        chunk->next = arena->head;
+        arena->head = chunk;
+    }
+
+    void* ptr = (unsigned char*)chunk + SCRATCH_CHUNK_HEADER + chunk->used;
+    chunk->used += size;
+    arena->usedThisScope += size;
+    return ptr;
+}
+
+void ScratchArena_Reset(ScratchArena* arena) {
+    if (!arena) return;
+    if (arena->usedThisScope > arena->highWater) {
+        arena->highWater = arena->usedThisScope;
+    }
+    arena->usedThisScope = 0;
+
+    if (arena->head && arena->head->next) {
+        /** Scope spilled over several chunks: replace them with one sized to the high-water mark */
+        ScratchArena_FreeChunks(arena);
+    } else if (arena->head) {
+        arena->head->used = 0;
+    }
+}
+
+void ScratchArena_Release(ScratchArena* arena) {
+    if (!arena) return;
+    ScratchArena_FreeChunks(arena);
+    arena->usedThisScope = 0;
+    arena->highWater = 0;
+}
@@ -8,16 +8,28 @@
  * - Added log rotation to prevent disk space exhaustion
  * - Implemented configurable log level filtering
  * - Fixed race conditions in crash handlers using atomic operations
+ * - Asynchronous writes: callers format into a lock-free ring and a writer
+ *   thread batches records to disk; ERROR/FATAL wait until their record is
+ *   written, and the crash handler drains the ring itself
+ * - Rotation is driven by an in-memory byte count and swaps to a segment
+ *   pre-opened by the writer thread, which also renames and compresses
+ *   old segments; without a writer, logging callers do the same outside
+ *   the lock
+ * - Optional binary format (LOG_FORMAT=binary): callers store an interned
+ *   format ID and raw arguments; catime-logdump renders them later
  */
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdarg.h>
 #include <string.h>
-#include <time.h>
+#include <signal.h>
 #include <windows.h>
+#include <winioctl.h>
 #include <dbghelp.h>
 #include "../include/log.h"
+#include "../include/log_ring.h"
+#include "../include/log_binary.h"
 #include "../include/config.h"
 #include "../resource/resource.h"
 
@@ -25,12 +37,73 @@
 #define PROCESSOR_ARCHITECTURE_ARM64 12
 #endif
 
+/* ============================================================================
+ * Constants
+ * ============================================================================ */
+
+/** @brief Queued records; a full queue drops DEBUG-WARNING and makes ERROR/FATAL wait */
+#define LOG_QUEUE_CAPACITY 1024
+
+/** @brief How often the writer thread flushes queued records */
+#define LOG_FLUSH_INTERVAL_MS 200
+
+/** @brief Writer batch buffer; a fuller batch is written early */
+#define LOG_BATCH_BYTES (64 * 1024)
+
+/** @brief Longest an ERROR/FATAL caller waits for a free slot and for its record to reach disk */
+#define LOG_URGENT_WAIT_MS 1000
+
+/** @brief Longest the crash handler waits for the writer to hand over the queue */
+#define LOG_CRASH_DRAIN_WAIT_MS 500
+
+/** @brief Longest CleanupLogSystem waits for the writer to finish */
+#define LOG_WRITER_STOP_TIMEOUT_MS 2000
+
+/** @brief Log size at which the writer opens the next segment ahead of rotation */
+#define LOG_PREOPEN_THRESHOLD (LOG_MAX_FILE_SIZE / 10 * 9)
+
+/** @brief "[YYYY-MM-DD HH:MM:SS] [WARNING] " plus newline, or a TEXT chunk header */
+#define LOG_LINE_OVERHEAD 48
+
+/** @brief Slot flag: payload is a format ID plus encoded arguments */
+#define LOG_SLOT_BINARY 0x1
+
+/** @brief Longest format string written to a STRING chunk */
+#define LOG_FORMAT_TEXT_MAX 1024
+
+/* ============================================================================
+ * Type Definitions
+ * ============================================================================ */
+
+typedef struct {
+    DWORD major;
+    DWORD minor;
+    DWORD minBuild;
+    const char* name;
+} OSVersionEntry;
+
+typedef struct {
+    WORD archId;
+    const char* name;
+} CPUArchEntry;
+
+typedef struct {
+    int signal;
+    const char* description;
+} SignalEntry;
+
+/** @brief Last formatted timestamp, reused while the second is unchanged */
+typedef struct {
+    ULONGLONG second;           /**< FILETIME / 10^7 of the cached text, 0 = empty */
+    char text[24];
+} TimestampCache;
+
 /* ============================================================================
  * Static Data Tables - Table-Driven Design
  * ============================================================================ */
 
 /** @brief OS version mapping table - extends easily for future Windows versions */
-static const OSVersionInfo OS_VERSION_TABLE[] = {
+static const OSVersionEntry OS_VERSION_TABLE[] = {
     {10, 0, 22000, "Windows 11"},
     {10, 0, 0,     "Windows 10"},
     {6,  3, 0,     "Windows 8.1"},
@@ -43,7 +116,7 @@ static const OSVersionInfo OS_VERSION_TABLE[] = {
 };
 
 /** @brief CPU architecture mapping table */
-static const CPUArchInfo CPU_ARCH_TABLE[] = {
+static const CPUArchEntry CPU_ARCH_TABLE[] = {
     {PROCESSOR_ARCHITECTURE_AMD64, "x64 (AMD64)"},
     {PROCESSOR_ARCHITECTURE_INTEL, "x86 (Intel)"},
     {PROCESSOR_ARCHITECTURE_ARM,   "ARM"},
@@ -51,7 +124,7 @@ static const CPUArchInfo CPU_ARCH_TABLE[] = {
 };
 
 /** @brief Signal information mapping table */
-static const SignalInfo SIGNAL_TABLE[] = {
+static const SignalEntry SIGNAL_TABLE[] = {
     {SIGFPE,   "Floating point exception"},
     {SIGILL,   "Illegal instruction"},
     {SIGSEGV,  "Segmentation fault/memory access error"},
@@ -69,6 +142,15 @@ static const char* const LOG_LEVEL_STRINGS[] = {
     "FATAL"
 };
 
+/** @brief Config keys of the per-module levels, indexed by LogModule (NULL = not configurable) */
+static const char* const LOG_MODULE_LEVEL_KEYS[LOG_MODULE_COUNT] = {
+    NULL,
+    "LOG_LEVEL_ANIMATION",
+    "LOG_LEVEL_CONFIG",
+    "LOG_LEVEL_TIMER",
+    "LOG_LEVEL_AUDIO"
+};
+
 /* ============================================================================
  * Global State Variables
  * ============================================================================ */
@@ -76,21 +158,68 @@ static const char* const LOG_LEVEL_STRINGS[] = {
 /** @brief Log file path in the user's config directory */
 static wchar_t LOG_FILE_PATH[MAX_PATH] = {0};
 
-/** @brief File handle for log output, NULL when closed */
-static FILE* logFile = NULL;
+/** @brief Binary records instead of text lines, read once at startup */
+static BOOL binaryFormat = FALSE;
+
+/** @brief Format IDs whose STRING chunk is in the current file (drain owner only) */
+static uint8_t formatsWritten[LOG_BINARY_MAX_FORMATS / 8];
+
+/** @brief Log file handle, INVALID_HANDLE_VALUE when closed */
+static HANDLE logFile = INVALID_HANDLE_VALUE;
 
-/** @brief Critical section for thread-safe logging */
+/** @brief Segment opened ahead of rotation (writer thread, or logCS in synchronous mode) */
+static HANDLE nextLogFile = INVALID_HANDLE_VALUE;
+
+/** @brief Bytes in the current log file, counted as written (no size queries) */
+static ULONGLONG bytesWritten = 0;
+
+/** @brief Critical section for the synchronous path (no writer thread) */
 static CRITICAL_SECTION logCS;
 
 /** @brief Critical section initialization flag */
 static volatile LONG csInitialized = 0;
 
+/** @brief Synchronous mode: 1 while one caller pre-opens or renames segments outside logCS */
+static volatile LONG directMaintenance = 0;
+
+/** @brief Synchronous mode: swapped to the .next segment, renames not done yet (set under logCS) */
+static volatile LONG directRenamesPending = 0;
+
 /** @brief Minimum log level filter (default: DEBUG = log everything) */
 static LogLevel minLogLevel = LOG_LEVEL_DEBUG;
 
+/** @brief Configured per-module levels; DEBUG defers to minLogLevel */
+static LogLevel moduleLogLevel[LOG_MODULE_COUNT] = {LOG_LEVEL_DEBUG};
+
+/** @brief Read inline by IsLogEnabled on every log statement */
+volatile LONG g_logModuleThreshold[LOG_MODULE_COUNT] = {LOG_LEVEL_DEBUG};
+
 /** @brief Atomic flag for crash handler to prevent deadlock */
 static volatile LONG inCrashHandler = 0;
 
+/** @brief Records waiting for the writer thread */
+static LogRing logQueue;
+
+/** @brief Writer thread, NULL when logging synchronously */
+static HANDLE writerThread = NULL;
+static DWORD writerThreadId = 0;
+static HANDLE writerWake = NULL;            /**< Auto-reset: flush now (urgent record, stop) */
+static HANDLE writerFlushed = NULL;         /**< Auto-reset: set after each batch reaches the file */
+static volatile LONG writerStop = 0;
+
+/** @brief 1 while the writer or the crash handler is draining the queue */
+static volatile LONG drainOwner = 0;
+
+/** @brief Queue positions below this are written to the file */
+static volatile LONG64 flushedThrough = 0;
+
+/** @brief Batch buffer, used only by the drain owner */
+static char writeBatch[LOG_BATCH_BYTES];
+static size_t writeBatchLength = 0;
+
+/** @brief Writer-side timestamp cache (drain owner only) */
+static TimestampCache writerTimestamps = {0};
+
 /* ============================================================================
  * Helper Functions - Table Lookups
  * ============================================================================ */
@@ -106,7 +235,7 @@ static const char* GetOSVersionName(DWORD major, DWORD minor, DWORD build) {
     const size_t tableSize = sizeof(OS_VERSION_TABLE) / sizeof(OS_VERSION_TABLE[0]);
     
     for (size_t i = 0; i < tableSize; i++) {
-        const OSVersionInfo* entry = &OS_VERSION_TABLE[i];
+        const OSVersionEntry* entry = &OS_VERSION_TABLE[i];
         if (major == entry->major && 
             minor == entry->minor &&
             build >= entry->minBuild) {
@@ -151,6 +280,50 @@ static const char* GetSignalDescription(int signal) {
     return "Unknown signal";
 }
 
+/**
+ * @brief Parse a level name ("DEBUG" ... "FATAL", case-insensitive)
+ * @return TRUE if text names a level
+ */
+static BOOL ParseLogLevel(const char* text, LogLevel* level) {
+    for (int i = LOG_LEVEL_DEBUG; i <= LOG_LEVEL_FATAL; i++) {
+        if (_stricmp(text, LOG_LEVEL_STRINGS[i]) == 0) {
+            *level = (LogLevel)i;
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+/* ============================================================================
+ * Helper Functions - Level Thresholds
+ * ============================================================================ */
+
+/**
+ * @brief Publish each module's effective threshold for IsLogEnabled
+ */
+static void UpdateModuleThresholds(void) {
+    for (int i = 0; i < LOG_MODULE_COUNT; i++) {
+        LogLevel effective = moduleLogLevel[i] > minLogLevel ? moduleLogLevel[i] : minLogLevel;
+        InterlockedExchange(&g_logModuleThreshold[i], (LONG)effective);
+    }
+}
+
+/**
+ * @brief Read [Options] LOG_LEVEL_<MODULE>; unknown names keep the default
+ */
+static void ReadModuleLogLevels(const char* configPath) {
+    for (int i = 0; i < LOG_MODULE_COUNT; i++) {
+        if (!LOG_MODULE_LEVEL_KEYS[i]) continue;
+        char value[16] = {0};
+        ReadIniString(INI_SECTION_OPTIONS, LOG_MODULE_LEVEL_KEYS[i], "", value, sizeof(value), configPath);
+        LogLevel level;
+        if (value[0] && ParseLogLevel(value, &level)) {
+            moduleLogLevel[i] = level;
+        }
+    }
+    UpdateModuleThresholds();
+}
+
 /* ============================================================================
  * Helper Functions - OS Version Detection
  * ============================================================================ */
@@ -209,6 +382,7 @@ static BOOL GetOSVersionInfo(DWORD* major, DWORD* minor, DWORD* build) {
 static void GetLogFilePath(wchar_t* logPath, size_t size) {
     char configPath[MAX_PATH] = {0};
     GetConfigPath(configPath, MAX_PATH);
+    const wchar_t* fileName = binaryFormat ? L"Catime_Logs.clog" : L"Catime_Logs.log";
     
     wchar_t configPathW[MAX_PATH] = {0};
     MultiByteToWideChar(CP_UTF8, 0, configPath, -1, configPathW, MAX_PATH);
@@ -218,39 +392,101 @@ static void GetLogFilePath(wchar_t* logPath, size_t size) {
     if (lastSeparator) {
         size_t dirLen = lastSeparator - configPathW + 1;
         wcsncpy(logPath, configPathW, dirLen);
-        _snwprintf_s(logPath + dirLen, size - dirLen, _TRUNCATE, L"Catime_Logs.log");
+        _snwprintf_s(logPath + dirLen, size - dirLen, _TRUNCATE, L"%s", fileName);
     } else {
-        _snwprintf_s(logPath, size, _TRUNCATE, L"Catime_Logs.log");
+        _snwprintf_s(logPath, size, _TRUNCATE, L"%s", fileName);
     }
 }
 
 /**
- * @brief Get current log file size
- * @return File size in bytes, or 0 if file doesn't exist
+ * @brief Create (truncate) a log segment and write the UTF-8 BOM or binary header
+ * @return File handle, or INVALID_HANDLE_VALUE
  */
-static ULONGLONG GetLogFileSize(void) {
-    if (!LOG_FILE_PATH[0]) {
-        return 0;
+static HANDLE CreateLogSegment(const wchar_t* path) {
+    /** FILE_SHARE_DELETE lets rotation rename the segment while it is open */
+    HANDLE file = CreateFileW(path, GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_DELETE, NULL,
+                              CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        return INVALID_HANDLE_VALUE;
     }
-    
-    WIN32_FILE_ATTRIBUTE_DATA fileInfo;
-    if (GetFileAttributesExW(LOG_FILE_PATH, GetFileExInfoStandard, &fileInfo)) {
-        ULARGE_INTEGER size;
-        size.LowPart = fileInfo.nFileSizeLow;
-        size.HighPart = fileInfo.nFileSizeHigh;
-        return size.QuadPart;
+    DWORD written = 0;
+    if (binaryFormat) {
+        uint8_t header[LOG_BINARY_FILE_HEADER_SIZE];
+        LogBinary_WriteFileHeader(header);
+        WriteFile(file, header, sizeof(header), &written, NULL);
+    } else {
+        WriteFile(file, UTF8_BOM, 3, &written, NULL);
     }
-    
-    return 0;
+    return file;
+}
+
+/** @brief Bytes CreateLogSegment writes before the first record */
+static ULONGLONG SegmentHeaderSize(void) {
+    return binaryFormat ? LOG_BINARY_FILE_HEADER_SIZE : 3;
+}
+
+/** @brief Path of the pre-opened segment that becomes the log after rotation */
+static void GetNextSegmentPath(wchar_t* path, size_t size) {
+    _snwprintf_s(path, size, _TRUNCATE, L"%s.next", LOG_FILE_PATH);
+}
+
+/**
+ * @brief Create (truncate) the log file
+ * @return TRUE if the file is open
+ */
+static BOOL OpenLogFile(void) {
+    logFile = CreateLogSegment(LOG_FILE_PATH);
+    if (logFile == INVALID_HANDLE_VALUE) {
+        return FALSE;
+    }
+    bytesWritten = SegmentHeaderSize();
+    memset(formatsWritten, 0, sizeof(formatsWritten));     /** Each file carries its own string table */
+    return TRUE;
+}
+
+/**
+ * @brief Open the segment rotation will switch to, ahead of time (writer thread)
+ */
+static void PreopenNextSegment(void) {
+    if (nextLogFile != INVALID_HANDLE_VALUE) return;
+    wchar_t nextPath[MAX_PATH];
+    GetNextSegmentPath(nextPath, MAX_PATH);
+    nextLogFile = CreateLogSegment(nextPath);
+}
+
+/**
+ * @brief Set NTFS compression on a closed segment; ignored where unsupported
+ */
+static void CompressLogSegment(const wchar_t* path) {
+    HANDLE file = CreateFileW(path, GENERIC_READ | GENERIC_WRITE, 0, NULL,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) return;
+    USHORT format = COMPRESSION_FORMAT_DEFAULT;
+    DWORD returned = 0;
+    DeviceIoControl(file, FSCTL_SET_COMPRESSION, &format, sizeof(format), NULL, 0, &returned, NULL);
+    CloseHandle(file);
 }
 
 /**
- * @brief Rotate log files when size limit is reached
+ * @brief Make the pre-opened segment the current file and close the full one
+ */
+static void SwapToNextSegment(void) {
+    HANDLE previous = logFile;
+    logFile = nextLogFile;
+    nextLogFile = INVALID_HANDLE_VALUE;
+    bytesWritten = SegmentHeaderSize();
+    memset(formatsWritten, 0, sizeof(formatsWritten));
+    CloseHandle(previous);
+}
+
+/**
+ * @brief Shift the closed segments and move the new one into place after a swap
  * 
  * Rotation scheme: Catime_Logs.log -> Catime_Logs.log.1 -> ... -> Catime_Logs.log.3
- * Oldest log (*.log.3) is deleted when creating new rotation.
+ * Oldest log (*.log.3) is deleted. The current segment is open with
+ * FILE_SHARE_DELETE, so it is renamed while records keep going to it.
  */
-static void RotateLogFiles(void) {
+static void ShiftLogSegments(void) {
     wchar_t oldPath[MAX_PATH];
     wchar_t newPath[MAX_PATH];
     
@@ -265,38 +501,447 @@ static void RotateLogFiles(void) {
         MoveFileExW(oldPath, newPath, MOVEFILE_REPLACE_EXISTING);
     }
     
-    /** Move current log to .1 */
+    /** Move the finished log to .1 and the new segment into its place */
     _snwprintf_s(newPath, MAX_PATH, _TRUNCATE, L"%s.1", LOG_FILE_PATH);
     MoveFileExW(LOG_FILE_PATH, newPath, MOVEFILE_REPLACE_EXISTING);
+    GetNextSegmentPath(oldPath, MAX_PATH);
+    MoveFileExW(oldPath, LOG_FILE_PATH, MOVEFILE_REPLACE_EXISTING);
+    CompressLogSegment(newPath);
+}
+
+/**
+ * @brief Switch to the pre-opened segment, then shift old files (writer thread)
+ * 
+ * The swap happens first, so records are never refused while the renames run.
+ */
+static void RotateLogSegments(void) {
+    PreopenNextSegment();
+    if (nextLogFile == INVALID_HANDLE_VALUE) {
+        return;     /** Keep appending to the current file; retried after the next batch */
+    }
+
+    SwapToNextSegment();
+    ShiftLogSegments();
+
+    WriteLog(LOG_LEVEL_INFO, "Log file rotated (size exceeded %d MB)", 
+             LOG_MAX_FILE_SIZE / (1024 * 1024));
+}
+
+/**
+ * @brief Rotate or prepare the next segment based on the tracked size (writer thread)
+ */
+static void MaintainLogSegments(void) {
+    if (bytesWritten >= LOG_MAX_FILE_SIZE) {
+        RotateLogSegments();
+    } else if (bytesWritten >= LOG_PREOPEN_THRESHOLD) {
+        PreopenNextSegment();
+    }
+}
+
+/**
+ * @brief Close and delete an unused pre-opened segment
+ */
+static void DiscardNextSegment(void) {
+    if (nextLogFile == INVALID_HANDLE_VALUE) return;
+    CloseHandle(nextLogFile);
+    nextLogFile = INVALID_HANDLE_VALUE;
+    wchar_t nextPath[MAX_PATH];
+    GetNextSegmentPath(nextPath, MAX_PATH);
+    DeleteFileW(nextPath);
+}
+
+/* ============================================================================
+ * Helper Functions - Record Formatting
+ * ============================================================================ */
+
+static ULONGLONG CurrentFileTime(void) {
+    FILETIME ft;
+    GetSystemTimeAsFileTime(&ft);
+    ULARGE_INTEGER value;
+    value.LowPart = ft.dwLowDateTime;
+    value.HighPart = ft.dwHighDateTime;
+    return value.QuadPart;
+}
+
+/**
+ * @brief Local-time text for a UTC FILETIME, in LOG_TIMESTAMP_FORMAT layout
+ * @param cache Reused while the second is unchanged; NULL to always convert
+ */
+static const char* FormatTimestamp(ULONGLONG fileTime, TimestampCache* cache, char* scratch, size_t scratchSize) {
+    ULONGLONG second = fileTime / 10000000ULL;
+    if (cache && cache->second == second) {
+        return cache->text;
+    }
+
+    ULARGE_INTEGER value;
+    value.QuadPart = fileTime;
+    FILETIME utc = {value.LowPart, value.HighPart};
+    FILETIME local;
+    SYSTEMTIME st;
+    FileTimeToLocalFileTime(&utc, &local);
+    FileTimeToSystemTime(&local, &st);
+
+    char* out = cache ? cache->text : scratch;
+    size_t outSize = cache ? sizeof(cache->text) : scratchSize;
+    _snprintf_s(out, outSize, _TRUNCATE, "%04u-%02u-%02u %02u:%02u:%02u",
+                st.wYear, st.wMonth, st.wDay, st.wHour, st.wMinute, st.wSecond);
+    if (cache) cache->second = second;
+    return out;
+}
+
+/**
+ * @brief Format one line: "[timestamp] [LEVEL] message\n"
+ * @return Bytes written to out
+ */
+static size_t FormatLogLine(char* out, size_t outSize, ULONGLONG fileTime, LogLevel level,
+                            const char* message, size_t messageLength, TimestampCache* cache) {
+    char scratch[24];
+    const char* stamp = FormatTimestamp(fileTime, cache, scratch, sizeof(scratch));
+    int header = _snprintf_s(out, outSize, _TRUNCATE, "[%s] [%s] ", stamp, LOG_LEVEL_STRINGS[level]);
+    if (header < 0) return 0;
+
+    size_t length = (size_t)header;
+    if (messageLength > outSize - length - 1) messageLength = outSize - length - 1;
+    memcpy(out + length, message, messageLength);
+    length += messageLength;
+    out[length++] = '\n';
+    return length;
+}
+
+/**
+ * @brief Binary TEXT chunk holding an already formatted message
+ * @return Bytes written to out
+ */
+static size_t FormatTextChunk(uint8_t* out, size_t outSize, ULONGLONG fileTime, LogLevel level,
+                              const char* message, size_t messageLength) {
+    const size_t fixed = LOG_BINARY_CHUNK_HEADER_SIZE + 8 + 1;
+    if (outSize < fixed) return 0;
+    if (messageLength > outSize - fixed) messageLength = outSize - fixed;
+
+    LogBinary_WriteChunkHeader(out, LOG_BINARY_CHUNK_TEXT, (uint32_t)(8 + 1 + messageLength));
+    LogBinary_PutU64(out + LOG_BINARY_CHUNK_HEADER_SIZE, fileTime);
+    out[LOG_BINARY_CHUNK_HEADER_SIZE + 8] = (uint8_t)level;
+    memcpy(out + fixed, message, messageLength);
+    return fixed + messageLength;
+}
+
+/** @brief A formatted message in the active file format (line or TEXT chunk) */
+static size_t FormatOutputRecord(char* out, size_t outSize, ULONGLONG fileTime, LogLevel level,
+                                 const char* message, size_t messageLength, TimestampCache* cache) {
+    if (binaryFormat) {
+        return FormatTextChunk((uint8_t*)out, outSize, fileTime, level, message, messageLength);
+    }
+    return FormatLogLine(out, outSize, fileTime, level, message, messageLength, cache);
+}
+
+/* ============================================================================
+ * Helper Functions - Writer Thread
+ * ============================================================================ */
+
+static void WriteBatchToFile(void) {
+    if (writeBatchLength == 0) return;
+    if (logFile != INVALID_HANDLE_VALUE) {
+        DWORD written = 0;
+        WriteFile(logFile, writeBatch, (DWORD)writeBatchLength, &written, NULL);
+        bytesWritten += written;
+    }
+    writeBatchLength = 0;
+}
+
+static void EnsureBatchRoom(size_t bytes) {
+    if (LOG_BATCH_BYTES - writeBatchLength < bytes) {
+        WriteBatchToFile();
+    }
+}
+
+static void AppendBatchLine(ULONGLONG fileTime, LogLevel level, const char* message, size_t messageLength) {
+    EnsureBatchRoom(messageLength + LOG_LINE_OVERHEAD);
+    writeBatchLength += FormatOutputRecord(writeBatch + writeBatchLength, LOG_BATCH_BYTES - writeBatchLength,
+                                           fileTime, level, message, messageLength, &writerTimestamps);
+}
+
+/**
+ * @brief Append a binary record, preceded by its format's STRING chunk on first use in this file
+ */
+static void AppendBatchBinaryRecord(const LogRingSlot* slot) {
+    uint8_t* out;
+    uint32_t id = LogBinary_GetU32((const uint8_t*)slot->payload);
+    size_t argsLength = slot->length - 4;
+
+    if (!(formatsWritten[id / 8] & (1u << (id % 8)))) {
+        const char* format = LogBinary_FormatForId(id);
+        size_t formatLength = strnlen(format, LOG_FORMAT_TEXT_MAX);
+        EnsureBatchRoom(LOG_BINARY_CHUNK_HEADER_SIZE + 4 + formatLength);
+        out = (uint8_t*)writeBatch + writeBatchLength;
+        LogBinary_WriteChunkHeader(out, LOG_BINARY_CHUNK_STRING, (uint32_t)(4 + formatLength));
+        LogBinary_PutU32(out + LOG_BINARY_CHUNK_HEADER_SIZE, id);
+        memcpy(out + LOG_BINARY_CHUNK_HEADER_SIZE + 4, format, formatLength);
+        writeBatchLength += LOG_BINARY_CHUNK_HEADER_SIZE + 4 + formatLength;
+        formatsWritten[id / 8] |= (uint8_t)(1u << (id % 8));
+    }
+
+    const size_t fixed = LOG_BINARY_CHUNK_HEADER_SIZE + 8 + 1 + 4;
+    EnsureBatchRoom(fixed + argsLength);
+    out = (uint8_t*)writeBatch + writeBatchLength;
+    LogBinary_WriteChunkHeader(out, LOG_BINARY_CHUNK_RECORD, (uint32_t)(fixed - LOG_BINARY_CHUNK_HEADER_SIZE + argsLength));
+    LogBinary_PutU64(out + LOG_BINARY_CHUNK_HEADER_SIZE, slot->timestamp);
+    out[LOG_BINARY_CHUNK_HEADER_SIZE + 8] = (uint8_t)slot->level;
+    LogBinary_PutU32(out + LOG_BINARY_CHUNK_HEADER_SIZE + 9, id);
+    memcpy(out + fixed, slot->payload + 4, argsLength);
+    writeBatchLength += fixed + argsLength;
 }
 
 /**
- * @brief Check if log rotation is needed and perform it
+ * @brief Move every committed record to the file (caller owns drainOwner)
+ * @return Number of records written
  */
-static void CheckAndRotateLog(void) {
-    ULONGLONG fileSize = GetLogFileSize();
-    
-    if (fileSize >= LOG_MAX_FILE_SIZE) {
-        /** Close current log file */
-        if (logFile) {
-            fclose(logFile);
-            logFile = NULL;
+static int DrainQueueLocked(void) {
+    int count = 0;
+    const LogRingSlot* slot;
+    while ((slot = LogRing_Peek(&logQueue)) != NULL) {
+        if (slot->flags & LOG_SLOT_BINARY) {
+            AppendBatchBinaryRecord(slot);
+        } else {
+            AppendBatchLine(slot->timestamp, (LogLevel)slot->level, slot->payload, slot->length);
         }
-        
-        /** Rotate files */
-        RotateLogFiles();
-        
-        /** Reopen log file */
-        logFile = _wfopen(LOG_FILE_PATH, L"wb");
-        if (logFile) {
-            /** Write UTF-8 BOM */
-            fwrite(UTF8_BOM, 1, 3, logFile);
-            fflush(logFile);
-            
-            WriteLog(LOG_LEVEL_INFO, "Log file rotated (size exceeded %d MB)", 
-                     LOG_MAX_FILE_SIZE / (1024 * 1024));
+        LogRing_Release(&logQueue);
+        ++count;
+    }
+
+    uint64_t dropped = LogRing_TakeDropped(&logQueue);
+    if (dropped > 0) {
+        char note[96];
+        int n = _snprintf_s(note, sizeof(note), _TRUNCATE, "%llu log records dropped (queue full)",
+                            (unsigned long long)dropped);
+        if (n > 0) AppendBatchLine(CurrentFileTime(), LOG_LEVEL_WARNING, note, (size_t)n);
+    }
+
+    WriteBatchToFile();
+    InterlockedExchange64(&flushedThrough, (LONG64)LogRing_ReadPosition(&logQueue));
+    return count;
+}
+
+static BOOL TryAcquireDrain(DWORD timeoutMs) {
+    ULONGLONG deadline = GetTickCount64() + timeoutMs;
+    while (InterlockedCompareExchange(&drainOwner, 1, 0) != 0) {
+        if (GetTickCount64() >= deadline) return FALSE;
+        Sleep(1);
+    }
+    return TRUE;
+}
+
+static void ReleaseDrain(void) {
+    InterlockedExchange(&drainOwner, 0);
+}
+
+/**
+ * @brief Flush queued records every LOG_FLUSH_INTERVAL_MS, or at once when woken
+ */
+static DWORD WINAPI LogWriterThreadProc(LPVOID param) {
+    (void)param;
+    for (;;) {
+        WaitForSingleObject(writerWake, LOG_FLUSH_INTERVAL_MS);
+        BOOL stopping = writerStop != 0;
+
+        if (TryAcquireDrain(INFINITE)) {
+            DrainQueueLocked();
+            if (bytesWritten >= LOG_PREOPEN_THRESHOLD) {
+                MaintainLogSegments();
+                DrainQueueLocked();     /** The rotation notice */
+            }
+            ReleaseDrain();
+        }
+        SetEvent(writerFlushed);
+
+        if (stopping) break;
+    }
+    return 0;
+}
+
+static BOOL StartLogWriter(void) {
+    if (!LogRing_Init(&logQueue, LOG_QUEUE_CAPACITY)) {
+        return FALSE;
+    }
+    writerWake = CreateEventW(NULL, FALSE, FALSE, NULL);
+    writerFlushed = CreateEventW(NULL, FALSE, FALSE, NULL);
+    InterlockedExchange(&writerStop, 0);
+    InterlockedExchange64(&flushedThrough, 0);
+    if (writerWake && writerFlushed) {
+        writerThread = CreateThread(NULL, 0, LogWriterThreadProc, NULL, 0, &writerThreadId);
+    }
+    if (!writerThread) {
+        if (writerWake) CloseHandle(writerWake);
+        if (writerFlushed) CloseHandle(writerFlushed);
+        writerWake = writerFlushed = NULL;
+        LogRing_Destroy(&logQueue);
+        return FALSE;
+    }
+    return TRUE;
+}
+
+/**
+ * @brief Stop the writer after it has written everything queued
+ * @return FALSE if the writer did not exit in time (its resources are left alone)
+ */
+static BOOL StopLogWriter(void) {
+    if (!writerThread) return TRUE;
+
+    InterlockedExchange(&writerStop, 1);
+    SetEvent(writerWake);
+    if (WaitForSingleObject(writerThread, LOG_WRITER_STOP_TIMEOUT_MS) != WAIT_OBJECT_0) {
+        return FALSE;
+    }
+    CloseHandle(writerThread);
+    writerThread = NULL;
+    writerThreadId = 0;
+    CloseHandle(writerWake);
+    CloseHandle(writerFlushed);
+    writerWake = writerFlushed = NULL;
+    /** The queue itself stays allocated: a late caller may still be inside EnqueueRecord */
+    return TRUE;
+}
+
+/* ============================================================================
+ * Helper Functions - Logging Paths
+ * ============================================================================ */
+
+/**
+ * @brief Block until the record at pos is in the file, or LOG_URGENT_WAIT_MS passes
+ */
+static void WaitUntilWritten(size_t pos) {
+    if (GetCurrentThreadId() == writerThreadId) return;   /** Written with the current batch */
+
+    ULONGLONG deadline = GetTickCount64() + LOG_URGENT_WAIT_MS;
+    SetEvent(writerWake);
+    while ((ULONGLONG)InterlockedCompareExchange64(&flushedThrough, 0, 0) <= (ULONGLONG)pos) {
+        if (GetTickCount64() >= deadline) return;
+        WaitForSingleObject(writerFlushed, 10);
+    }
+}
+
+/**
+ * @brief Store the format ID and raw arguments in the slot instead of text
+ * @return FALSE if the format cannot be encoded (args is left untouched)
+ */
+static BOOL EncodeBinaryPayload(LogRingSlot* slot, const char* format, va_list args) {
+    uint32_t id = 0;
+    const uint8_t* kinds = NULL;
+    int count = LogBinary_Intern(format, &id, &kinds);
+    if (count < 0) return FALSE;
+
+    va_list copy;
+    va_copy(copy, args);
+    size_t length = LogBinary_EncodeArgs((uint8_t*)slot->payload + 4, LOG_RING_PAYLOAD_MAX - 4,
+                                         kinds, count, copy);
+    va_end(copy);
+    if (length == LOG_BINARY_ENCODE_FAILED) return FALSE;
+
+    LogBinary_PutU32((uint8_t*)slot->payload, id);
+    slot->length = (uint32_t)(4 + length);
+    slot->flags = LOG_SLOT_BINARY;
+    return TRUE;
+}
+
+/**
+ * @brief Queue a record for the writer; the caller only formats the message
+ *        (or, in binary mode, copies the arguments)
+ */
+static void EnqueueRecord(LogLevel level, const char* format, va_list args) {
+    BOOL urgent = level >= LOG_LEVEL_ERROR;
+    size_t pos = 0;
+    LogRingSlot* slot = LogRing_BeginWrite(&logQueue, &pos);
+
+    if (!slot && urgent) {
+        /** Errors are worth waiting for: let the writer make room */
+        ULONGLONG deadline = GetTickCount64() + LOG_URGENT_WAIT_MS;
+        while (!slot && GetTickCount64() < deadline) {
+            SetEvent(writerWake);
+            Sleep(1);
+            slot = LogRing_BeginWrite(&logQueue, &pos);
+        }
+    }
+    if (!slot) {
+        LogRing_NoteDropped(&logQueue);
+        return;
+    }
+
+    slot->timestamp = CurrentFileTime();
+    slot->level = (uint16_t)level;
+    if (!binaryFormat || !EncodeBinaryPayload(slot, format, args)) {
+        slot->flags = 0;
+        int n = vsnprintf(slot->payload, LOG_RING_PAYLOAD_MAX, format, args);
+        if (n < 0) n = 0;
+        if (n >= LOG_RING_PAYLOAD_MAX) n = LOG_RING_PAYLOAD_MAX - 1;   /** Truncated */
+        slot->length = (uint32_t)n;
+    }
+    LogRing_Commit(&logQueue, slot, pos);
+
+    if (urgent) {
+        WaitUntilWritten(pos);
+    }
+}
+
+/**
+ * @brief Segment upkeep for the synchronous path, outside logCS
+ * 
+ * One caller at a time (directMaintenance): finish the renames of a swap
+ * made under logCS, or pre-open the next segment once the file nears the
+ * limit. A caller that finds the slot taken leaves the work to a later
+ * record, so nobody waits on file renames.
+ */
+static void MaintainLogSegmentsDirect(ULONGLONG size) {
+    if (InterlockedCompareExchange(&directMaintenance, 1, 0) != 0) return;
+
+    BOOL rotated = FALSE;
+    if (InterlockedCompareExchange(&directRenamesPending, 0, 1) == 1) {
+        ShiftLogSegments();
+        rotated = TRUE;
+    } else if (size >= LOG_PREOPEN_THRESHOLD && nextLogFile == INVALID_HANDLE_VALUE) {
+        /** Only a swap clears nextLogFile, and none can happen before it is set here */
+        wchar_t nextPath[MAX_PATH];
+        GetNextSegmentPath(nextPath, MAX_PATH);
+        HANDLE next = CreateLogSegment(nextPath);
+        EnterCriticalSection(&logCS);
+        nextLogFile = next;
+        LeaveCriticalSection(&logCS);
+    }
+    InterlockedExchange(&directMaintenance, 0);
+
+    if (rotated) {
+        WriteLog(LOG_LEVEL_INFO, "Log file rotated (size exceeded %d MB)",
+                 LOG_MAX_FILE_SIZE / (1024 * 1024));
+    }
+}
+
+/**
+ * @brief Format and write one record on the calling thread (no writer running)
+ */
+static void WriteRecordDirect(LogLevel level, const char* format, va_list args) {
+    char message[LOG_RING_PAYLOAD_MAX];
+    int n = vsnprintf(message, sizeof(message), format, args);
+    if (n < 0) n = 0;
+    if (n >= (int)sizeof(message)) n = (int)sizeof(message) - 1;
+
+    char line[LOG_RING_PAYLOAD_MAX + LOG_LINE_OVERHEAD];
+    size_t length = FormatOutputRecord(line, sizeof(line), CurrentFileTime(), level, message, (size_t)n, NULL);
+
+    EnterCriticalSection(&logCS);
+    if (logFile != INVALID_HANDLE_VALUE) {
+        DWORD written = 0;
+        WriteFile(logFile, line, (DWORD)length, &written, NULL);
+        bytesWritten += written;
+        /** Same swap as the writer thread; the renames follow outside the lock */
+        if (bytesWritten >= LOG_MAX_FILE_SIZE && nextLogFile != INVALID_HANDLE_VALUE) {
+            SwapToNextSegment();
+            InterlockedExchange(&directRenamesPending, 1);
         }
     }
+    ULONGLONG size = bytesWritten;
+    LeaveCriticalSection(&logCS);
+
+    if (size >= LOG_PREOPEN_THRESHOLD || directRenamesPending) {
+        MaintainLogSegmentsDirect(size);
+    }
 }
 
 /* ============================================================================
@@ -382,9 +1027,16 @@ void LogAdminPrivileges(void) {
 BOOL InitializeLogSystem(void) {
     /** Initialize critical section with atomic flag check */
     if (InterlockedCompareExchange(&csInitialized, 1, 0) == 0) {
-    InitializeCriticalSection(&logCS);
+        InitializeCriticalSection(&logCS);
     }
     
+    char configPath[MAX_PATH] = {0};
+    char format[16] = {0};
+    GetConfigPath(configPath, MAX_PATH);
+    ReadIniString(INI_SECTION_OPTIONS, "LOG_FORMAT", "text", format, sizeof(format), configPath);
+    binaryFormat = (_stricmp(format, "binary") == 0);
+    ReadModuleLogLevels(configPath);
+    
     GetLogFilePath(LOG_FILE_PATH, MAX_PATH);
     
     /** Ensure directory exists */
@@ -399,15 +1051,13 @@ BOOL InitializeLogSystem(void) {
         }
     }
     
-    /** Create new log file with UTF-8 BOM */
-    logFile = _wfopen(LOG_FILE_PATH, L"wb");
-    if (!logFile) {
+    /** Create new log file with UTF-8 BOM (or the binary header) */
+    if (!OpenLogFile()) {
         return FALSE;
     }
     
-    /** Write UTF-8 BOM for proper encoding */
-    fwrite(UTF8_BOM, 1, 3, logFile);
-        fflush(logFile);
+    /** Without a writer thread every record is written synchronously */
+    StartLogWriter();
     
     /** Write startup header with system diagnostics */
     WriteLog(LOG_LEVEL_INFO, "==================================================");
@@ -421,13 +1071,14 @@ BOOL InitializeLogSystem(void) {
     LogAdminPrivileges();
     
     WriteLog(LOG_LEVEL_INFO, "----------------- Application Start -----------------");
-    WriteLog(LOG_LEVEL_INFO, "Log system initialized successfully");
+    WriteLog(LOG_LEVEL_INFO, "Log system initialized successfully%s",
+             writerThread ? "" : " (synchronous mode: writer thread unavailable)");
     
     return TRUE;
 }
 
-void WriteLog(LogLevel level, const char* format, ...) {
-    if (!logFile) {
+void WriteLogRecord(LogLevel level, const char* format, ...) {
+    if (logFile == INVALID_HANDLE_VALUE || inCrashHandler) {
         return;
     }
     
@@ -436,52 +1087,29 @@ void WriteLog(LogLevel level, const char* format, ...) {
         return;
     }
     
-    /** Thread-safe logging with critical section */
-    EnterCriticalSection(&logCS);
-    
-    /** Check if rotation is needed (every 100 log entries) */
-    static int logCounter = 0;
-    if (++logCounter >= 100) {
-        logCounter = 0;
-        CheckAndRotateLog();
-        if (!logFile) {
-            LeaveCriticalSection(&logCS);
-            return;
-        }
-    }
-    
-    /** Get current timestamp */
-    time_t now;
-    struct tm local_time;
-    char timeStr[32] = {0};
-    
-    time(&now);
-    localtime_s(&local_time, &now);
-    strftime(timeStr, sizeof(timeStr), LOG_TIMESTAMP_FORMAT, &local_time);
-    
-    /** Write log entry with level */
-    fprintf(logFile, "[%s] [%s] ", timeStr, LOG_LEVEL_STRINGS[level]);
-    
-    /** Write formatted message */
     va_list args;
     va_start(args, format);
-    vfprintf(logFile, format, args);
+    if (writerThread) {
+        EnqueueRecord(level, format, args);
+    } else {
+        WriteRecordDirect(level, format, args);
+    }
     va_end(args);
-    
-    fprintf(logFile, "\n");
-    
-    /** Force immediate write for crash resilience */
-    fflush(logFile);
-    
-    LeaveCriticalSection(&logCS);
 }
 
 void CleanupLogSystem(void) {
-    if (logFile) {
+    if (logFile != INVALID_HANDLE_VALUE) {
         WriteLog(LOG_LEVEL_INFO, "Catime exited normally");
         WriteLog(LOG_LEVEL_INFO, "==================================================");
-        fclose(logFile);
-        logFile = NULL;
+        if (!StopLogWriter()) {
+            return;     /** Writer stuck in I/O; the process is exiting anyway */
+        }
+        DiscardNextSegment();
+        CloseHandle(logFile);
+        logFile = INVALID_HANDLE_VALUE;
+        if (InterlockedCompareExchange(&directRenamesPending, 0, 1) == 1) {
+            ShiftLogSegments();     /** A synchronous swap whose renames never got their turn */
+        }
     }
     
     if (InterlockedCompareExchange(&csInitialized, 0, 1) == 1) {
@@ -491,6 +1119,15 @@ void CleanupLogSystem(void) {
 
 void SetMinimumLogLevel(LogLevel level) {
     minLogLevel = level;
+    UpdateModuleThresholds();
+}
+
+void SetModuleLogLevel(LogModule module, LogLevel level) {
+    if (module < 0 || module >= LOG_MODULE_COUNT) {
+        return;
+    }
+    moduleLogLevel[module] = level;
+    UpdateModuleThresholds();
 }
 
 LogLevel GetMinimumLogLevel(void) {
@@ -572,12 +1209,32 @@ static void SignalHandler(int signal) {
     const char* signalDesc = GetSignalDescription(signal);
     
     /** Emergency log write WITHOUT critical section to avoid deadlock */
-    if (logFile) {
-        fprintf(logFile, "[FATAL] Fatal signal occurred: %s (signal number: %d)\n", 
-                signalDesc, signal);
-        fflush(logFile);
-        fclose(logFile);
-        logFile = NULL;
+    if (logFile != INVALID_HANDLE_VALUE) {
+        /**
+         * Flush what is queued first. If the writer holds the queue (it may be
+         * the thread that crashed), give up on it after a short wait.
+         */
+        if (writerThread && TryAcquireDrain(LOG_CRASH_DRAIN_WAIT_MS)) {
+            DrainQueueLocked();
+        }
+        
+        char line[256];
+        int n;
+        if (binaryFormat) {
+            char message[200];
+            n = _snprintf_s(message, sizeof(message), _TRUNCATE,
+                            "Fatal signal occurred: %s (signal number: %d)", signalDesc, signal);
+            n = (n > 0) ? (int)FormatTextChunk((uint8_t*)line, sizeof(line), CurrentFileTime(),
+                                               LOG_LEVEL_FATAL, message, (size_t)n) : 0;
+        } else {
+            n = _snprintf_s(line, sizeof(line), _TRUNCATE,
+                            "[FATAL] Fatal signal occurred: %s (signal number: %d)\n", signalDesc, signal);
+        }
+        if (n > 0) {
+            DWORD written = 0;
+            WriteFile(logFile, line, (DWORD)n, &written, NULL);
+        }
+        FlushFileBuffers(logFile);
     }
     
     /** Show user notification */
@@ -0,0 +1,492 @@
+/**
+ * @file log_binary.c
+ * @brief Binary log encoding: interned format strings plus raw arguments
+ *
+ * Callers pay for one scan of the format the first time it is seen (the
+ * argument kinds are cached with the interned ID) and then only for
+ * copying argument values. Decoding re-runs printf per conversion with the
+ * original flags, width and precision.
+ */
+
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+#include <wchar.h>
+
+#include "../include/log_binary.h"
+
+#define INTERN_MASK (LOG_BINARY_MAX_FORMATS - 1)
+
+_Static_assert((LOG_BINARY_MAX_FORMATS & INTERN_MASK) == 0, "LOG_BINARY_MAX_FORMATS must be a power of two");
+
+/** @brief Longest string argument rendered by the decoder */
+#define DECODE_STRING_MAX 4096
+
+typedef enum {
+    ENTRY_FILLING = 0,      /**< Claimed, kinds not yet stored */
+    ENTRY_READY,
+    ENTRY_UNSUPPORTED
+} InternState;
+
+typedef struct {
+    _Atomic(const char*) format;    /**< Claimed by compare-and-swap from NULL */
+    _Atomic int state;              /**< InternState */
+    int count;
+    uint8_t kinds[LOG_BINARY_MAX_ARGS];
+} InternEntry;
+
+/** @brief One parsed conversion specification */
+typedef struct {
+    char flags[8];
+    int widthStar;
+    int precisionStar;
+    char width[12];
+    char precision[12];             /**< Including the leading '.' */
+    char length[4];
+    char conversion;
+    const char* end;                /**< First character after the specification */
+} ConversionSpec;
+
+/* ============================================================================
+ * Global State
+ * ============================================================================ */
+
+static InternEntry g_interned[LOG_BINARY_MAX_FORMATS];
+
+/* ============================================================================
+ * Helper Functions - Parsing
+ * ============================================================================ */
+
+/**
+ * @brief Parse the specification after a '%'
+ * @return 1 on success, 0 for an unterminated or oversized specification
+ */
+static int ParseConversion(const char* p, ConversionSpec* spec) {
+    memset(spec, 0, sizeof(*spec));
+
+    size_t n = 0;
+    while (*p && strchr("-+ #0'", *p)) {
+        if (n + 1 >= sizeof(spec->flags)) return 0;
+        spec->flags[n++] = *p++;
+    }
+
+    n = 0;
+    if (*p == '*') {
+        spec->widthStar = 1;
+        ++p;
+    } else {
+        while (*p >= '0' && *p <= '9') {
+            if (n + 1 >= sizeof(spec->width)) return 0;
+            spec->width[n++] = *p++;
+        }
+    }
+
+    if (*p == '.') {
+        ++p;
+        if (*p == '*') {
+            spec->precisionStar = 1;
+            ++p;
+        } else {
+            n = 0;
+            spec->precision[n++] = '.';
+            while (*p >= '0' && *p <= '9') {
+                if (n + 1 >= sizeof(spec->precision)) return 0;
+                spec->precision[n++] = *p++;
+            }
+        }
+    }
+
+    if (strncmp(p, "I64", 3) == 0) {
+        strcpy(spec->length, "ll");
+        p += 3;
+    } else if (strncmp(p, "I32", 3) == 0) {
+        p += 3;
+    } else if (p[0] == 'h' && p[1] == 'h') {
+        strcpy(spec->length, "hh");
+        p += 2;
+    } else if (p[0] == 'l' && p[1] == 'l') {
+        strcpy(spec->length, "ll");
+        p += 2;
+    } else if (*p && strchr("hlLzjtqIw", *p)) {
+        spec->length[0] = (*p == 'q') ? 'l' : *p;
+        if (*p == 'q') spec->length[1] = 'l';
+        ++p;
+    }
+
+    if (!*p) return 0;
+    spec->conversion = *p++;
+    spec->end = p;
+    return 1;
+}
+
+/** @brief Kind of the value a conversion consumes, 0 for none, -1 if unsupported */
+static int KindForConversion(const ConversionSpec* spec) {
+    const char* len = spec->length;
+    switch (spec->conversion) {
+        case '%':
+            return 0;
+        case 'd': case 'i':
+            if (!len[0] || strcmp(len, "h") == 0 || strcmp(len, "hh") == 0) return LOG_ARG_INT;
+            if (strcmp(len, "l") == 0) return LOG_ARG_LONG;
+            if (strcmp(len, "ll") == 0 || strcmp(len, "j") == 0 || strcmp(len, "t") == 0) return LOG_ARG_LLONG;
+            if (strcmp(len, "z") == 0 || strcmp(len, "I") == 0) return LOG_ARG_SIZE;
+            return -1;
+        case 'u': case 'o': case 'x': case 'X':
+            if (!len[0] || strcmp(len, "h") == 0 || strcmp(len, "hh") == 0) return LOG_ARG_UINT;
+            if (strcmp(len, "l") == 0) return LOG_ARG_ULONG;
+            if (strcmp(len, "ll") == 0 || strcmp(len, "j") == 0) return LOG_ARG_ULLONG;
+            if (strcmp(len, "z") == 0 || strcmp(len, "I") == 0 || strcmp(len, "t") == 0) return LOG_ARG_SIZE;
+            return -1;
+        case 'c': case 'C':
+            return LOG_ARG_INT;     /** Wide characters are promoted to int-sized wint_t */
+        case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+            return (strcmp(len, "L") == 0) ? LOG_ARG_LDOUBLE : LOG_ARG_DOUBLE;
+        case 'p':
+            return LOG_ARG_POINTER;
+        case 's':
+            return (strcmp(len, "l") == 0 || strcmp(len, "w") == 0) ? LOG_ARG_WSTRING : LOG_ARG_STRING;
+        case 'S':
+            return LOG_ARG_WSTRING;
+        default:
+            return -1;      /** Including %n */
+    }
+}
+
+/* ============================================================================
+ * Helper Functions - Encoding
+ * ============================================================================ */
+
+/** @brief UTF-8 encode one code point, returns bytes (0 if it does not fit) */
+static size_t PutUtf8(uint8_t* out, size_t room, uint32_t cp) {
+    if (cp < 0x80) {
+        if (room < 1) return 0;
+        out[0] = (uint8_t)cp;
+        return 1;
+    }
+    if (cp < 0x800) {
+        if (room < 2) return 0;
+        out[0] = (uint8_t)(0xC0 | (cp >> 6));
+        out[1] = (uint8_t)(0x80 | (cp & 0x3F));
+        return 2;
+    }
+    if (cp < 0x10000) {
+        if (room < 3) return 0;
+        out[0] = (uint8_t)(0xE0 | (cp >> 12));
+        out[1] = (uint8_t)(0x80 | ((cp >> 6) & 0x3F));
+        out[2] = (uint8_t)(0x80 | (cp & 0x3F));
+        return 3;
+    }
+    if (room < 4) return 0;
+    out[0] = (uint8_t)(0xF0 | (cp >> 18));
+    out[1] = (uint8_t)(0x80 | ((cp >> 12) & 0x3F));
+    out[2] = (uint8_t)(0x80 | ((cp >> 6) & 0x3F));
+    out[3] = (uint8_t)(0x80 | (cp & 0x3F));
+    return 4;
+}
+
+/** @brief Wide string to UTF-8, truncated at a character boundary to fit room */
+static size_t WideToUtf8(const wchar_t* text, uint8_t* out, size_t room) {
+    size_t used = 0;
+    for (size_t i = 0; text[i]; ++i) {
+        uint32_t cp = (uint32_t)text[i];
+        if (sizeof(wchar_t) == 2 && cp >= 0xD800 && cp <= 0xDBFF &&
+            (uint32_t)text[i + 1] >= 0xDC00 && (uint32_t)text[i + 1] <= 0xDFFF) {
+            cp = 0x10000 + ((cp - 0xD800) << 10) + ((uint32_t)text[i + 1] - 0xDC00);
+            ++i;
+        } else if (cp >= 0xD800 && cp <= 0xDFFF) {
+            cp = 0xFFFD;    /** Unpaired surrogate */
+        }
+        size_t n = PutUtf8(out + used, room - used, cp);
+        if (n == 0) break;
+        used += n;
+    }
+    return used;
+}
+
+/* ============================================================================
+ * Helper Functions - Decoding
+ * ============================================================================ */
+
+static int ReadU64(const uint8_t* args, size_t argsLength, size_t* pos, uint64_t* value) {
+    if (argsLength - *pos < 8) return 0;
+    *value = LogBinary_GetU64(args + *pos);
+    *pos += 8;
+    return 1;
+}
+
+/** @brief Append printf output for one conversion, keeping the original flags/width/precision */
+static size_t AppendConversion(char* out, size_t room, const ConversionSpec* spec, int width, int precision,
+                               const char* lengthOverride, char conversion, ...) {
+    char fmt[64];
+    char widthText[16] = "";
+    char precisionText[16] = "";
+    if (spec->widthStar) snprintf(widthText, sizeof(widthText), "%d", width);
+    if (spec->precisionStar) snprintf(precisionText, sizeof(precisionText), ".%d", precision);
+    snprintf(fmt, sizeof(fmt), "%%%s%s%s%s", spec->flags,
+             spec->widthStar ? widthText : spec->width,
+             spec->precisionStar ? precisionText : spec->precision,
+             lengthOverride);
+    size_t len = strlen(fmt);
+    fmt[len] = conversion;
+    fmt[len + 1] = '\0';
+
+    va_list args;
+    va_start(args, conversion);
+    int n = vsnprintf(out, room, fmt, args);
+    va_end(args);
+    if (n < 0) return 0;
+    return ((size_t)n < room) ? (size_t)n : (room > 0 ? room - 1 : 0);
+}
+
+/* ============================================================================
+ * Public API
+ * ============================================================================ */
+
+void LogBinary_PutU32(uint8_t* out, uint32_t value) {
+    for (int i = 0; i < 4; ++i) out[i] = (uint8_t)(value >> (8 * i));
+}
+
+void LogBinary_PutU64(uint8_t* out, uint64_t value) {
+    for (int i = 0; i < 8; ++i) out[i] = (uint8_t)(value >> (8 * i));
+}
+
+uint32_t LogBinary_GetU32(const uint8_t* in) {
+    uint32_t value = 0;
+    for (int i = 0; i < 4; ++i) value |= (uint32_t)in[i] << (8 * i);
+    return value;
+}
+
+uint64_t LogBinary_GetU64(const uint8_t* in) {
+    uint64_t value = 0;
+    for (int i = 0; i < 8; ++i) value |= (uint64_t)in[i] << (8 * i);
+    return value;
+}
+
+int LogBinary_ParseSignature(const char* format, uint8_t* kinds, int maxKinds) {
+    if (!format || !kinds) return -1;
+    int count = 0;
+    for (const char* p = format; *p; ) {
+        if (*p != '%') {
+            ++p;
+            continue;
+        }
+        ConversionSpec spec;
+        if (!ParseConversion(p + 1, &spec)) return -1;
+        p = spec.end;
+
+        int kind = KindForConversion(&spec);
+        if (kind < 0) return -1;
+        if (kind == 0) continue;
+
+        int needed = spec.widthStar + spec.precisionStar + 1;
+        if (count + needed > maxKinds) return -1;
+        if (spec.widthStar) kinds[count++] = LOG_ARG_INT;
+        if (spec.precisionStar) kinds[count++] = LOG_ARG_INT;
+        kinds[count++] = (uint8_t)kind;
+    }
+    return count;
+}
+
+int LogBinary_Intern(const char* format, uint32_t* outId, const uint8_t** outKinds) {
+    if (!format) return -1;
+
+    uintptr_t hash = ((uintptr_t)format >> 3) * (uintptr_t)0x9E3779B97F4A7C15ULL;
+    size_t start = (size_t)(hash >> 7) & INTERN_MASK;
+
+    for (size_t probe = 0; probe < LOG_BINARY_MAX_FORMATS; ++probe) {
+        size_t index = (start + probe) & INTERN_MASK;
+        InternEntry* entry = &g_interned[index];
+        const char* current = atomic_load_explicit(&entry->format, memory_order_acquire);
+
+        if (current == NULL) {
+            const char* expected = NULL;
+            if (atomic_compare_exchange_strong_explicit(&entry->format, &expected, format,
+                                                        memory_order_acq_rel, memory_order_acquire)) {
+                entry->count = LogBinary_ParseSignature(format, entry->kinds, LOG_BINARY_MAX_ARGS);
+                atomic_store_explicit(&entry->state, entry->count < 0 ? ENTRY_UNSUPPORTED : ENTRY_READY,
+                                      memory_order_release);
+                current = format;
+            } else {
+                current = expected;
+            }
+        }
+        if (current != format) continue;
+
+        int state = atomic_load_explicit(&entry->state, memory_order_acquire);
+        if (state == ENTRY_FILLING) {
+            /** Another thread is storing the kinds: parse into a thread-local copy meanwhile */
+            static _Thread_local uint8_t localKinds[LOG_BINARY_MAX_ARGS];
+            int count = LogBinary_ParseSignature(format, localKinds, LOG_BINARY_MAX_ARGS);
+            if (count < 0) return -1;
+            if (outId) *outId = (uint32_t)index;
+            if (outKinds) *outKinds = localKinds;
+            return count;
+        }
+        if (state == ENTRY_UNSUPPORTED) return -1;
+        if (outId) *outId = (uint32_t)index;
+        if (outKinds) *outKinds = entry->kinds;
+        return entry->count;
+    }
+    return -1;
+}
+
+const char* LogBinary_FormatForId(uint32_t id) {
+    if (id >= LOG_BINARY_MAX_FORMATS) return NULL;
+    return atomic_load_explicit(&g_interned[id].format, memory_order_acquire);
+}
+
+size_t LogBinary_EncodeArgs(uint8_t* out, size_t capacity, const uint8_t* kinds, int count, va_list args) {
+    size_t used = 0;
+    for (int i = 0; i < count; ++i) {
+        uint64_t value = 0;
+        switch (kinds[i]) {
+            case LOG_ARG_INT:     value = (uint64_t)(int64_t)va_arg(args, int); break;
+            case LOG_ARG_UINT:    value = (uint64_t)va_arg(args, unsigned int); break;
+            case LOG_ARG_LONG:    value = (uint64_t)(int64_t)va_arg(args, long); break;
+            case LOG_ARG_ULONG:   value = (uint64_t)va_arg(args, unsigned long); break;
+            case LOG_ARG_LLONG:   value = (uint64_t)va_arg(args, long long); break;
+            case LOG_ARG_ULLONG:  value = (uint64_t)va_arg(args, unsigned long long); break;
+            case LOG_ARG_SIZE:    value = (uint64_t)va_arg(args, size_t); break;
+            case LOG_ARG_POINTER: value = (uint64_t)(uintptr_t)va_arg(args, void*); break;
+            case LOG_ARG_DOUBLE:
+            case LOG_ARG_LDOUBLE: {
+                double d = (kinds[i] == LOG_ARG_DOUBLE) ? va_arg(args, double) : (double)va_arg(args, long double);
+                memcpy(&value, &d, sizeof(value));
+                break;
+            }
+            case LOG_ARG_STRING:
+            case LOG_ARG_WSTRING: {
+                if (capacity - used < 4) return LOG_BINARY_ENCODE_FAILED;
+                uint8_t* text = out + used + 4;
+                size_t room = capacity - used - 4;
+                size_t length;
+                if (kinds[i] == LOG_ARG_STRING) {
+                    const char* s = va_arg(args, const char*);
+                    if (!s) s = "(null)";
+                    length = strlen(s);
+                    if (length > room) length = room;      /** Truncated to fit the record */
+                    memcpy(text, s, length);
+                } else {
+                    const wchar_t* w = va_arg(args, const wchar_t*);
+                    length = w ? WideToUtf8(w, text, room) : 0;
+                    if (!w && room >= 6) {
+                        memcpy(text, "(null)", 6);
+                        length = 6;
+                    }
+                }
+                LogBinary_PutU32(out + used, (uint32_t)length);
+                used += 4 + length;
+                continue;
+            }
+            default:
+                return LOG_BINARY_ENCODE_FAILED;
+        }
+        if (capacity - used < 8) return LOG_BINARY_ENCODE_FAILED;
+        LogBinary_PutU64(out + used, value);
+        used += 8;
+    }
+    return used;
+}
+
+size_t LogBinary_WriteFileHeader(uint8_t* out) {
+    memcpy(out, LOG_BINARY_MAGIC, 8);
+    LogBinary_PutU32(out + 8, LOG_BINARY_VERSION);
+    LogBinary_PutU32(out + 12, 0);
+    return LOG_BINARY_FILE_HEADER_SIZE;
+}
+
+size_t LogBinary_WriteChunkHeader(uint8_t* out, LogBinaryChunkType type, uint32_t payloadLength) {
+    out[0] = (uint8_t)type;
+    LogBinary_PutU32(out + 1, payloadLength);
+    return LOG_BINARY_CHUNK_HEADER_SIZE;
+}
+
+int LogBinary_FormatRecord(const char* format, const uint8_t* args, size_t argsLength,
+                           char* out, size_t outSize) {
+    if (!format || !out || outSize == 0) return -1;
+
+    size_t used = 0;
+    size_t pos = 0;
+    out[0] = '\0';
+
+    for (const char* p = format; *p && used + 1 < outSize; ) {
+        if (*p != '%') {
+            out[used++] = *p++;
+            continue;
+        }
+        ConversionSpec spec;
+        if (!ParseConversion(p + 1, &spec)) return -1;
+        p = spec.end;
+
+        int kind = KindForConversion(&spec);
+        if (kind < 0) return -1;
+        if (kind == 0) {
+            out[used++] = '%';
+            continue;
+        }
+
+        int width = 0, precision = 0;
+        uint64_t raw;
+        if (spec.widthStar) {
+            if (!ReadU64(args, argsLength, &pos, &raw)) return -1;
+            width = (int)(int64_t)raw;
+        }
+        if (spec.precisionStar) {
+            if (!ReadU64(args, argsLength, &pos, &raw)) return -1;
+            precision = (int)(int64_t)raw;
+        }
+
+        char* dst = out + used;
+        size_t room = outSize - used;
+        char conv = spec.conversion;
+        switch (kind) {
+            case LOG_ARG_INT: case LOG_ARG_LONG: case LOG_ARG_LLONG:
+            case LOG_ARG_UINT: case LOG_ARG_ULONG: case LOG_ARG_ULLONG: case LOG_ARG_SIZE:
+                if (!ReadU64(args, argsLength, &pos, &raw)) return -1;
+                if (conv == 'c' || conv == 'C') {
+                    used += AppendConversion(dst, room, &spec, width, precision, "", 'c', (int)(raw & 0xFF));
+                } else if (conv == 'd' || conv == 'i') {
+                    long long value = (long long)(int64_t)raw;
+                    if (strcmp(spec.length, "hh") == 0) value = (signed char)value;
+                    else if (strcmp(spec.length, "h") == 0) value = (short)value;
+                    used += AppendConversion(dst, room, &spec, width, precision, "ll", conv, value);
+                } else {
+                    /** Narrow unsigned conversions keep their original bit pattern */
+                    if (strcmp(spec.length, "hh") == 0) raw &= 0xFFULL;
+                    else if (strcmp(spec.length, "h") == 0) raw &= 0xFFFFULL;
+                    else if (kind == LOG_ARG_UINT) raw &= 0xFFFFFFFFULL;
+                    used += AppendConversion(dst, room, &spec, width, precision, "ll", conv, (unsigned long long)raw);
+                }
+                break;
+            case LOG_ARG_DOUBLE: case LOG_ARG_LDOUBLE: {
+                if (!ReadU64(args, argsLength, &pos, &raw)) return -1;
+                double d;
+                memcpy(&d, &raw, sizeof(d));
+                used += AppendConversion(dst, room, &spec, width, precision, "", conv, d);
+                break;
+            }
+            case LOG_ARG_POINTER:
+                if (!ReadU64(args, argsLength, &pos, &raw)) return -1;
+                used += AppendConversion(dst, room, &spec, width, precision, "", 'p', (void*)(uintptr_t)raw);
+                break;
+            case LOG_ARG_STRING: case LOG_ARG_WSTRING: {
+                if (argsLength - pos < 4) return -1;
+                uint32_t length = LogBinary_GetU32(args + pos);
+                pos += 4;
+                if (argsLength - pos < length) return -1;
+                char text[DECODE_STRING_MAX];
+                size_t copy = length < sizeof(text) - 1 ? length : sizeof(text) - 1;
+                memcpy(text, args + pos, copy);
+                text[copy] = '\0';
+                pos += length;
+                used += AppendConversion(dst, room, &spec, width, precision, "", 's', text);
+                break;
+            }
+            default:
+                return -1;
+        }
+    }
+
+    out[used] = '\0';
+    return (int)used;
+}
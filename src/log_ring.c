@@ -0,0 +1,98 @@
+/**
+ * @file log_ring.c
+ * @brief Bounded multi-producer, single-consumer ring of log records
+ *
+ * Each slot carries a sequence number: equal to its position while free,
+ * position + 1 once committed, and position + capacity after the consumer
+ * releases it. Producers claim positions with a compare-and-swap on the
+ * enqueue counter, so claiming never blocks and a full ring is detected
+ * from the sequence alone.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/log_ring.h"
+
+/* ============================================================================
+ * Public API
+ * ============================================================================ */
+
+int LogRing_Init(LogRing* ring, size_t capacity) {
+    if (!ring) return 0;
+    memset(ring, 0, sizeof(*ring));
+
+    size_t size = 2;
+    while (size < capacity) size <<= 1;
+
+    ring->slots = (LogRingSlot*)calloc(size, sizeof(LogRingSlot));
+    if (!ring->slots) return 0;
+    ring->mask = size - 1;
+    for (size_t i = 0; i < size; ++i) {
+        atomic_init(&ring->slots[i].sequence, i);
+    }
+    atomic_init(&ring->enqueuePos, 0);
+    atomic_init(&ring->dropped, 0);
+    return 1;
+}
+
+void LogRing_Destroy(LogRing* ring) {
+    if (!ring) return;
+    free(ring->slots);
+    ring->slots = NULL;
+    ring->mask = 0;
+}
+
+LogRingSlot* LogRing_BeginWrite(LogRing* ring, size_t* outPos) {
+    if (!ring || !ring->slots) return NULL;
+
+    size_t pos = atomic_load_explicit(&ring->enqueuePos, memory_order_relaxed);
+    for (;;) {
+        LogRingSlot* slot = &ring->slots[pos & ring->mask];
+        size_t seq = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+        intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&ring->enqueuePos, &pos, pos + 1,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                if (outPos) *outPos = pos;
+                return slot;
+            }
+            /** Lost the race: pos now holds the current counter */
+        } else if (diff < 0) {
+            return NULL;    /** Slot still holds an unread record one lap behind */
+        } else {
+            pos = atomic_load_explicit(&ring->enqueuePos, memory_order_relaxed);
+        }
+    }
+}
+
+void LogRing_Commit(LogRing* ring, LogRingSlot* slot, size_t pos) {
+    (void)ring;
+    atomic_store_explicit(&slot->sequence, pos + 1, memory_order_release);
+}
+
+void LogRing_NoteDropped(LogRing* ring) {
+    if (ring) atomic_fetch_add_explicit(&ring->dropped, 1, memory_order_relaxed);
+}
+
+uint64_t LogRing_TakeDropped(LogRing* ring) {
+    if (!ring) return 0;
+    return atomic_exchange_explicit(&ring->dropped, 0, memory_order_relaxed);
+}
+
+const LogRingSlot* LogRing_Peek(LogRing* ring) {
+    if (!ring || !ring->slots) return NULL;
+    LogRingSlot* slot = &ring->slots[ring->dequeuePos & ring->mask];
+    size_t seq = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+    return (seq == ring->dequeuePos + 1) ? slot : NULL;
+}
+
+void LogRing_Release(LogRing* ring) {
+    LogRingSlot* slot = &ring->slots[ring->dequeuePos & ring->mask];
+    atomic_store_explicit(&slot->sequence, ring->dequeuePos + ring->mask + 1, memory_order_release);
+    ring->dequeuePos++;
+}
+
+size_t LogRing_ReadPosition(const LogRing* ring) {
+    return ring ? ring->dequeuePos : 0;
+}
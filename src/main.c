@@ -338,6 +338,12 @@ static BOOL TryForwardSimpleCliToExisting(HWND hwndExisting, const wchar_t* lpCm
     
     size_t len = wcslen(cmd);
     
+    /** Diagnostics: export the running instance's animation trace */
+    if (_wcsicmp(cmd, L"--dump-anim-trace") == 0) {
+        PostMessage(hwndExisting, WM_APP_DUMP_ANIM_TRACE, 0, 0);
+        return TRUE;
+    }
+    
     /** Route by command length */
     if (len == 1) {
         return RouteSingleCharCommand(hwndExisting, towlower(cmd[0]));
@@ -628,14 +634,6 @@ static BOOL SetupMainWindow(HINSTANCE hInstance, HWND hwnd, int nCmdShow) {
     extern void ResetTimerMilliseconds(void);
     ResetTimerMilliseconds();
     
-    /** Setup font path check timer */
-    LOG_INFO("Setting font path check timer...");
-    if (SetTimer(hwnd, TIMER_ID_FONT_VALIDATION, 2000, NULL) == 0) {
-        LOG_WARNING("Font path check timer creation failed, auto-fix will not work");
-    } else {
-        LOG_INFO("Font path check timer set successfully (2 second interval)");
-    }
-    
     /** Start automatic update check */
     LOG_INFO("Starting automatic update check at startup...");
     CheckForUpdateAsync(hwnd, TRUE);
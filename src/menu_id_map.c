@@ -0,0 +1,63 @@
+/**
+ * @file menu_id_map.c
+ * @brief Dense map from dynamic menu IDs to the items they were built for
+ */
+
+#include <stdlib.h>
+
+#include "../include/menu_id_map.h"
+
+/** @brief Allocator hook so tests can make growth fail */
+#ifndef MENU_ID_MAP_REALLOC
+#define MENU_ID_MAP_REALLOC realloc
+#else
+void* MENU_ID_MAP_REALLOC(void* block, size_t size);
+#endif
+
+/* ============================================================================
+ * Public API
+ * ============================================================================ */
+
+void MenuIdMap_Reset(MenuIdMap* map) {
+    if (!map) return;
+    map->count = 0;
+    map->truncated = 0;
+}
+
+void MenuIdMap_Release(MenuIdMap* map) {
+    if (!map) return;
+    free((void*)map->items);
+    map->items = NULL;
+    map->count = 0;
+    map->capacity = 0;
+    map->truncated = 0;
+}
+
+uint32_t MenuIdMap_Record(MenuIdMap* map, const void* item) {
+    if (!map) return 0;
+    if (map->count >= map->maxItems) {
+        map->truncated++;
+        return 0;
+    }
+    if (map->count == map->capacity) {
+        uint32_t capacity = map->capacity ? map->capacity * 2 : 64;
+        if (capacity > map->maxItems) capacity = map->maxItems;
+        const void** items = (const void**)MENU_ID_MAP_REALLOC((void*)map->items, capacity * sizeof(*items));
+        if (items) {
+            map->items = items;
+            map->capacity = capacity;
+        }
+    }
+    /** On allocation failure the item still gets its ID; only its lookup fails */
+    if (map->count < map->capacity) {
+        map->items[map->count] = item;
+    }
+    return map->baseId + map->count++;
+}
+
+const void* MenuIdMap_Lookup(const MenuIdMap* map, uint32_t menuId) {
+    if (!map || menuId < map->baseId) return NULL;
+    uint32_t index = menuId - map->baseId;
+    if (index >= map->count || index >= map->capacity) return NULL;
+    return map->items[index];
+}
@@ -0,0 +1,47 @@
+/**
+ * @file metric_history.c
+ * @brief Fixed-size history ring for sampled metric series
+ */
+
+#include <string.h>
+
+#include "../include/metric_history.h"
+
+/* ============================================================================
+ * Public API
+ * ============================================================================ */
+
+void MetricHistory_Clear(MetricHistory* history) {
+    if (!history) return;
+    memset(history, 0, sizeof(*history));
+}
+
+void MetricHistory_Push(MetricHistory* history, float value) {
+    if (!history) return;
+    history->values[history->head] = value;
+    history->head = (history->head + 1) % METRIC_HISTORY_CAPACITY;
+    if (history->count < METRIC_HISTORY_CAPACITY) history->count++;
+}
+
+size_t MetricHistory_CopyRecent(const MetricHistory* history, float* out, size_t max) {
+    if (!history || !out || max == 0) return 0;
+
+    size_t n = history->count < max ? history->count : max;
+    uint32_t start = (history->head + METRIC_HISTORY_CAPACITY - (uint32_t)n) % METRIC_HISTORY_CAPACITY;
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = history->values[(start + i) % METRIC_HISTORY_CAPACITY];
+    }
+    return n;
+}
+
+float MetricHistory_Peak(const MetricHistory* history, size_t window) {
+    if (!history || history->count == 0) return 0.0f;
+
+    size_t n = history->count < window ? history->count : window;
+    float peak = 0.0f;
+    for (size_t i = 1; i <= n; ++i) {
+        float v = history->values[(history->head + METRIC_HISTORY_CAPACITY - i) % METRIC_HISTORY_CAPACITY];
+        if (v > peak) peak = v;
+    }
+    return peak;
+}
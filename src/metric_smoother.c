@@ -0,0 +1,107 @@
+/**
+ * @file metric_smoother.c
+ * @brief Per-metric smoothing of sampled values (EWMA or moving window)
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/metric_smoother.h"
+
+/* ============================================================================
+ * Helper Functions
+ * ============================================================================ */
+
+static uint32_t ClampWindow(uint32_t length) {
+    if (length < 1) return 1;
+    if (length > METRIC_SMOOTHER_MAX_WINDOW) return METRIC_SMOOTHER_MAX_WINDOW;
+    return length;
+}
+
+static float ApplyEwma(MetricSmoother* s, float raw, uint64_t nowMs) {
+    if (!s->primed || nowMs < s->lastMs || s->param == 0) {
+        s->value = raw;
+    } else {
+        /** Weight from elapsed time, so a faster sampling rate does not shorten the time constant */
+        double dt = (double)(nowMs - s->lastMs);
+        double alpha = 1.0 - exp(-dt / (double)s->param);
+        s->value += alpha * ((double)raw - s->value);
+    }
+    s->lastMs = nowMs;
+    s->primed = 1;
+    return (float)s->value;
+}
+
+static float ApplyWindow(MetricSmoother* s, float raw) {
+    if (s->count == s->param) {
+        s->windowSum -= s->window[s->head];
+    } else {
+        s->count++;
+    }
+    s->window[s->head] = raw;
+    s->windowSum += raw;
+    s->head = (s->head + 1) % s->param;
+    s->primed = 1;
+    s->value = s->windowSum / (double)s->count;
+    return (float)s->value;
+}
+
+/* ============================================================================
+ * Public API
+ * ============================================================================ */
+
+void MetricSmoother_Configure(MetricSmoother* smoother, MetricSmoothingMode mode, uint32_t param) {
+    if (!smoother) return;
+    memset(smoother, 0, sizeof(*smoother));
+    smoother->mode = mode;
+    smoother->param = (mode == METRIC_SMOOTHING_WINDOW) ? ClampWindow(param) : param;
+}
+
+void MetricSmoother_Reset(MetricSmoother* smoother) {
+    if (!smoother) return;
+    MetricSmoother_Configure(smoother, smoother->mode, smoother->param);
+}
+
+float MetricSmoother_Apply(MetricSmoother* smoother, float raw, uint64_t nowMs) {
+    if (!smoother) return raw;
+    switch (smoother->mode) {
+        case METRIC_SMOOTHING_EWMA:
+            return ApplyEwma(smoother, raw, nowMs);
+        case METRIC_SMOOTHING_WINDOW:
+            return ApplyWindow(smoother, raw);
+        default:
+            return raw;
+    }
+}
+
+int MetricSmoother_Parse(const char* text, MetricSmoothingMode* mode, uint32_t* param) {
+    if (!text || !mode || !param) return 0;
+    while (*text == ' ' || *text == '\t') ++text;
+
+    if (*text == '\0' || strncmp(text, "none", 4) == 0) {
+        *mode = METRIC_SMOOTHING_NONE;
+        *param = 0;
+        return 1;
+    }
+
+    MetricSmoothingMode parsed;
+    const char* rest;
+    if (strncmp(text, "ewma:", 5) == 0) {
+        parsed = METRIC_SMOOTHING_EWMA;
+        rest = text + 5;
+    } else if (strncmp(text, "window:", 7) == 0) {
+        parsed = METRIC_SMOOTHING_WINDOW;
+        rest = text + 7;
+    } else {
+        return 0;
+    }
+
+    char* end = NULL;
+    unsigned long value = strtoul(rest, &end, 10);
+    if (end == rest || value == 0 || value > 600000UL) return 0;
+
+    *mode = parsed;
+    *param = (parsed == METRIC_SMOOTHING_WINDOW) ? ClampWindow((uint32_t)value) : (uint32_t)value;
+    return 1;
+}
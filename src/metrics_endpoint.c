@@ -0,0 +1,198 @@
+/**
+ * @file metrics_endpoint.c
+ * @brief Local-only Prometheus text endpoint for timer and system state
+ *
+ * - Listens on 127.0.0.1 only; the port comes from [Options]
+ *   METRICS_ENDPOINT_PORT (0 or missing = disabled)
+ * - The UI thread formats the page once per sampling interval and
+ *   publishes it to the metrics server, which serves that prebuilt
+ *   response (see metrics_server.c)
+ * - Latency histograms are cumulative, fed from the paint handler and the
+ *   animation tray update on the UI thread
+ */
+
+#include <windows.h>
+#include <string.h>
+
+#include "../include/metrics_endpoint.h"
+#include "../include/metrics_server.h"
+#include "../include/config.h"
+#include "../include/timer.h"
+#include "../include/pomodoro.h"
+#include "../include/system_monitor.h"
+#include "../include/config_watcher.h"
+#include "../include/log.h"
+
+/* ============================================================================
+ * Global State
+ * ============================================================================ */
+
+static MetricsLatencyHistogram g_paintLatency = {0};
+static MetricsLatencyHistogram g_trayUpdateLatency = {0};
+static MetricsLatencyHistogram g_menuPreviewLatency = {0};
+static MetricsLatencyHistogram g_menuOpenLatency = {0};
+
+/** @brief Previous refresh, for the animation frame rate */
+static ULONGLONG g_lastRefreshTick = 0;
+static ULONGLONG g_lastTrayUpdateCount = 0;
+
+/* ============================================================================
+ * Helper Functions - Formatting
+ * ============================================================================ */
+
+static void AppendSystemMetrics(MetricsPage* page) {
+    SystemMetricsSnapshot snap;
+    SystemMonitor_GetSnapshot(&snap);
+
+    MetricsPage_AppendGauge(page, "catime_cpu_usage_percent", "System CPU usage.", snap.cpuPercent);
+    if (snap.coreCount > 0) {
+        MetricsPage_Append(page, "# HELP catime_cpu_core_usage_percent Per-core CPU usage.\n"
+                         "# TYPE catime_cpu_core_usage_percent gauge\n");
+        for (int i = 0; i < snap.coreCount; ++i) {
+            MetricsPage_Append(page, "catime_cpu_core_usage_percent{core=\"%d\"} %.6g\n", i, snap.corePercent[i]);
+        }
+    }
+    if (snap.processValid) {
+        MetricsPage_AppendGauge(page, "catime_process_cpu_usage_percent",
+                    "CPU share of the watched process (CPU_WATCH_PROCESS).", snap.processPercent);
+    }
+    MetricsPage_AppendGauge(page, "catime_memory_usage_percent", "Physical memory in use.", snap.memPercent);
+    MetricsPage_AppendGauge(page, "catime_network_transmit_bytes_per_second", "Upload rate across non-loopback interfaces.",
+                snap.upBytesPerSec);
+    MetricsPage_AppendGauge(page, "catime_network_receive_bytes_per_second", "Download rate across non-loopback interfaces.",
+                snap.downBytesPerSec);
+
+    SystemSamplingStats stats;
+    if (SystemMonitor_GetSamplingStats(&stats)) {
+        double hours = (double)stats.activeMs / 3600000.0;
+        MetricsPage_Append(page, "# HELP catime_sampler_samples_total System metric samples taken.\n"
+                         "# TYPE catime_sampler_samples_total counter\n"
+                         "catime_sampler_samples_total %llu\n", stats.samples);
+        MetricsPage_Append(page, "# HELP catime_sampler_cpu_seconds_total CPU time used by the sampler thread.\n"
+                         "# TYPE catime_sampler_cpu_seconds_total counter\n"
+                         "catime_sampler_cpu_seconds_total %.6f\n", stats.samplerCpuMs / 1000.0);
+        MetricsPage_AppendGauge(page, "catime_sampler_cpu_ms_per_hour", "Sampler CPU cost per hour of sampling.",
+                    hours > 0.0 ? stats.samplerCpuMs / hours : 0.0);
+        MetricsPage_AppendGauge(page, "catime_sampler_interval_seconds", "Current sampling interval (-1 while paused).",
+                    stats.currentIntervalMs == INFINITE ? -1.0 : stats.currentIntervalMs / 1000.0);
+    }
+}
+
+static void AppendTimerMetrics(MetricsPage* page) {
+    const char* mode = "idle";
+    if (CLOCK_SHOW_CURRENT_TIME) mode = "clock";
+    else if (CLOCK_COUNT_UP) mode = "countup";
+    else if (CLOCK_TOTAL_TIME > 0) mode = "countdown";
+
+    static const char* const kModes[] = {"idle", "clock", "countup", "countdown"};
+    MetricsPage_Append(page, "# HELP catime_timer_mode Current timer mode (1 for the active mode).\n"
+                     "# TYPE catime_timer_mode gauge\n");
+    for (size_t i = 0; i < sizeof(kModes) / sizeof(kModes[0]); ++i) {
+        MetricsPage_Append(page, "catime_timer_mode{mode=\"%s\"} %d\n", kModes[i], strcmp(kModes[i], mode) == 0);
+    }
+
+    int remaining = 0;
+    if (!CLOCK_SHOW_CURRENT_TIME && !CLOCK_COUNT_UP && CLOCK_TOTAL_TIME > 0) {
+        remaining = CLOCK_TOTAL_TIME - countdown_elapsed_time;
+        if (remaining < 0) remaining = 0;
+    }
+    MetricsPage_AppendGauge(page, "catime_timer_remaining_seconds", "Seconds left on the countdown (0 otherwise).", remaining);
+    MetricsPage_AppendGauge(page, "catime_timer_elapsed_seconds", "Seconds elapsed on the count-up timer.",
+                CLOCK_COUNT_UP ? countup_elapsed_time : 0);
+    MetricsPage_AppendGauge(page, "catime_timer_paused", "1 while the timer is paused.", CLOCK_IS_PAUSED ? 1 : 0);
+
+    static const char* const kPhases[] = {"idle", "work", "break", "long_break"};
+    int phase = (int)current_pomodoro_phase;
+    MetricsPage_Append(page, "# HELP catime_pomodoro_phase Current pomodoro phase (1 for the active phase).\n"
+                     "# TYPE catime_pomodoro_phase gauge\n");
+    for (int i = 0; i < (int)(sizeof(kPhases) / sizeof(kPhases[0])); ++i) {
+        MetricsPage_Append(page, "catime_pomodoro_phase{phase=\"%s\"} %d\n", kPhases[i], i == phase);
+    }
+    MetricsPage_AppendGauge(page, "catime_pomodoro_completed_cycles", "Pomodoro cycles completed in this session.",
+                complete_pomodoro_cycles);
+}
+
+static void AppendAnimationMetrics(MetricsPage* page) {
+    ULONGLONG now = GetTickCount64();
+    double fps = 0.0;
+    if (g_lastRefreshTick != 0 && now > g_lastRefreshTick) {
+        fps = (double)(g_trayUpdateLatency.count - g_lastTrayUpdateCount) * 1000.0 /
+              (double)(now - g_lastRefreshTick);
+    }
+    g_lastRefreshTick = now;
+    g_lastTrayUpdateCount = g_trayUpdateLatency.count;
+
+    MetricsPage_AppendGauge(page, "catime_animation_fps", "Tray animation frames shown per second since the last refresh.", fps);
+    MetricsPage_AppendHistogram(page, "catime_paint_duration_seconds", "Main window WM_PAINT handling time.", &g_paintLatency);
+    MetricsPage_AppendHistogram(page, "catime_tray_update_duration_seconds", "Shell_NotifyIcon time per animation frame.",
+                    &g_trayUpdateLatency);
+    MetricsPage_AppendHistogram(page, "catime_menu_preview_duration_seconds", "Menu hover time from WM_MENUSELECT to preview started.",
+                    &g_menuPreviewLatency);
+    MetricsPage_AppendHistogram(page, "catime_menu_open_duration_seconds", "Tray menu time from click to the menu loop going idle.",
+                    &g_menuOpenLatency);
+    MetricsPage_Append(page, "# HELP catime_metrics_scrapes_total Requests served by this endpoint.\n"
+                     "# TYPE catime_metrics_scrapes_total counter\n"
+                     "catime_metrics_scrapes_total %ld\n", MetricsServer_GetScrapes());
+    MetricsPage_Append(page, "# HELP catime_config_self_writes_suppressed_total Config change events ignored as our own writes.\n"
+                     "# TYPE catime_config_self_writes_suppressed_total counter\n"
+                     "catime_config_self_writes_suppressed_total %ld\n", ConfigWatcher_GetSuppressedSelfWrites());
+}
+
+/** @brief Page writer for MetricsServer_Publish */
+static void WriteMetricsPage(MetricsPage* page, void* context) {
+    (void)context;
+    AppendSystemMetrics(page);
+    AppendTimerMetrics(page);
+    AppendAnimationMetrics(page);
+}
+
+/* ============================================================================
+ * Public API
+ * ============================================================================ */
+
+void MetricsEndpoint_Start(void) {
+    if (MetricsServer_IsRunning()) return;
+
+    char config_path[MAX_PATH] = {0};
+    GetConfigPath(config_path, MAX_PATH);
+    int port = ReadIniInt(INI_SECTION_OPTIONS, "METRICS_ENDPOINT_PORT", 0, config_path);
+    if (port <= 0 || port > 65535) return;
+
+    int error = 0;
+    if (!MetricsServer_Start(port, &error)) {
+        LOG_WARNING("Metrics endpoint: cannot listen on 127.0.0.1:%d (error %d)", port, error);
+        return;
+    }
+
+    LOG_INFO("Metrics endpoint listening on http://127.0.0.1:%d/metrics", port);
+    SystemMonitor_SetConsumer(SYSTEM_CONSUMER_EXPORT, TRUE);
+    MetricsEndpoint_Refresh();
+}
+
+void MetricsEndpoint_Stop(void) {
+    SystemMonitor_SetConsumer(SYSTEM_CONSUMER_EXPORT, FALSE);
+    MetricsServer_Stop();
+}
+
+void MetricsEndpoint_Refresh(void) {
+    if (!MetricsServer_IsRunning()) return;
+    if (!MetricsServer_Publish(WriteMetricsPage, NULL)) {
+        LOG_WARNING("Metrics endpoint: page exceeds %d bytes, keeping previous page", METRICS_PAGE_CAPACITY);
+    }
+}
+
+void MetricsEndpoint_ObservePaintMs(double ms) {
+    MetricsHistogram_Observe(&g_paintLatency, ms);
+}
+
+void MetricsEndpoint_ObserveTrayUpdateMs(double ms) {
+    MetricsHistogram_Observe(&g_trayUpdateLatency, ms);
+}
+
+void MetricsEndpoint_ObserveMenuPreviewMs(double ms) {
+    MetricsHistogram_Observe(&g_menuPreviewLatency, ms);
+}
+
+void MetricsEndpoint_ObserveMenuOpenMs(double ms) {
+    MetricsHistogram_Observe(&g_menuOpenLatency, ms);
+}
@@ -0,0 +1,402 @@
+/**
+ * @file metrics_server.c
+ * @brief Loopback HTTP server for a prebuilt Prometheus text page
+ *
+ * - Listens on 127.0.0.1 only
+ * - The publisher formats the whole HTTP response into a spare buffer and
+ *   swaps it in under a short lock; the server thread copies it out and
+ *   sends it, so a scrape costs one memcpy and one send
+ * - Sockets go through portable_socket.h and the one thread through the
+ *   shim below, so the same code runs in the host-side tests
+ */
+
+#include "../include/portable_socket.h"
+
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/metrics_server.h"
+#include "../include/portable_lock.h"
+
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+
+/* ============================================================================
+ * Constants
+ * ============================================================================ */
+
+/** @brief Bytes of request read before answering (only the request line matters) */
+#define METRICS_REQUEST_MAX 2048
+
+/** @brief Socket send/receive timeout for one client */
+#define METRICS_CLIENT_TIMEOUT_MS 1000
+
+/** @brief How often the accept loop checks for a stop request */
+#define METRICS_ACCEPT_POLL_MS 250
+
+/** @brief Longest MetricsServer_Stop waits for the server thread */
+#define METRICS_STOP_TIMEOUT_MS 2000
+
+/** @brief Room kept in front of the body for the response headers */
+#define METRICS_HEADER_RESERVE 160
+
+const double kMetricsLatencyBucketsMs[METRICS_LATENCY_BUCKET_COUNT] = {
+    1.0, 2.0, 4.0, 8.0, 16.0, 33.0, 66.0, 100.0, 250.0
+};
+
+/* ============================================================================
+ * Global State
+ * ============================================================================ */
+
+static int g_running = 0;
+static int g_abandoned = 0;     /**< Stop timed out; the thread still owns the socket and pages */
+static atomic_int g_stopServer;
+static PortableSocket g_listenSocket = PORTABLE_INVALID_SOCKET;
+static int g_boundPort = 0;
+
+/** @brief Published response, guarded by g_pageLock */
+static PortableLock g_pageLock = PORTABLE_LOCK_INIT;
+static char* g_page = NULL;
+static size_t g_pageLength = 0;
+
+/** @brief Publisher's formatting buffer, swapped with g_page on publish */
+static char* g_buildPage = NULL;
+
+static atomic_long g_scrapes;
+
+/* ============================================================================
+ * Thread shim
+ * ============================================================================ */
+
+static void ServerLoop(void);
+
+#ifdef _WIN32
+
+static HANDLE g_serverThread = NULL;
+
+static DWORD WINAPI ServerThreadMain(LPVOID param) {
+    (void)param;
+    ServerLoop();
+    return 0;
+}
+
+static int StartServerThread(void) {
+    g_serverThread = CreateThread(NULL, 0, ServerThreadMain, NULL, 0, NULL);
+    return g_serverThread != NULL;
+}
+
+/** @return 1 if the thread exited within the timeout; otherwise the handle is kept for a later join */
+static int JoinServerThread(unsigned int timeoutMs) {
+    if (WaitForSingleObject(g_serverThread, timeoutMs) != WAIT_OBJECT_0) return 0;
+    CloseHandle(g_serverThread);
+    g_serverThread = NULL;
+    return 1;
+}
+
+#else
+
+static pthread_t g_serverThread;
+
+static void* ServerThreadMain(void* param) {
+    (void)param;
+    ServerLoop();
+    return NULL;
+}
+
+static int StartServerThread(void) {
+    return pthread_create(&g_serverThread, NULL, ServerThreadMain, NULL) == 0;
+}
+
+/** @brief The loop polls the stop flag and clients time out, so the join is bounded */
+static int JoinServerThread(unsigned int timeoutMs) {
+    (void)timeoutMs;
+    return pthread_join(g_serverThread, NULL) == 0;
+}
+
+#endif
+
+/** @brief Tests define this to a predicate that simulates a join timeout */
+#ifdef METRICS_SERVER_JOIN_TIMEOUT
+int METRICS_SERVER_JOIN_TIMEOUT(void);
+#endif
+
+static int JoinServerThreadBounded(unsigned int timeoutMs) {
+#ifdef METRICS_SERVER_JOIN_TIMEOUT
+    if (METRICS_SERVER_JOIN_TIMEOUT()) return 0;
+#endif
+    return JoinServerThread(timeoutMs);
+}
+
+/* ============================================================================
+ * Helper Functions - Server
+ * ============================================================================ */
+
+static void SendAll(PortableSocket client, const char* data, size_t length) {
+    while (length > 0) {
+        int chunk = (length > 65536) ? 65536 : (int)length;
+        int sent = (int)send(client, data, chunk, PORTABLE_SEND_FLAGS);
+        if (sent <= 0) return;
+        data += sent;
+        length -= (size_t)sent;
+    }
+}
+
+/** @brief Answer one connection: any GET gets the page, anything else 405 */
+static void ServeClient(PortableSocket client, char* response) {
+    PortableSocket_SetTimeouts(client, METRICS_CLIENT_TIMEOUT_MS);
+
+    char request[METRICS_REQUEST_MAX];
+    int received = 0;
+    while (received < (int)sizeof(request) - 1) {
+        int n = (int)recv(client, request + received, (int)sizeof(request) - 1 - received, 0);
+        if (n <= 0) break;
+        received += n;
+        request[received] = '\0';
+        if (strstr(request, "\r\n\r\n")) break;
+    }
+    if (received < 4) return;
+
+    if (strncmp(request, "GET ", 4) != 0) {
+        static const char kNotAllowed[] =
+            "HTTP/1.0 405 Method Not Allowed\r\nAllow: GET\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+        SendAll(client, kNotAllowed, sizeof(kNotAllowed) - 1);
+        return;
+    }
+
+    size_t length = 0;
+    PortableLock_Acquire(&g_pageLock);
+    if (g_page && g_pageLength > 0) {
+        memcpy(response, g_page, g_pageLength);
+        length = g_pageLength;
+    }
+    PortableLock_Release(&g_pageLock);
+
+    if (length == 0) {
+        static const char kUnavailable[] =
+            "HTTP/1.0 503 Service Unavailable\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+        SendAll(client, kUnavailable, sizeof(kUnavailable) - 1);
+        return;
+    }
+    SendAll(client, response, length);
+    atomic_fetch_add(&g_scrapes, 1);
+}
+
+static void ServerLoop(void) {
+    char* response = (char*)malloc(METRICS_PAGE_CAPACITY);
+    if (!response) return;
+
+    while (!atomic_load(&g_stopServer)) {
+        fd_set readSet;
+        FD_ZERO(&readSet);
+        FD_SET(g_listenSocket, &readSet);
+        struct timeval tv = {0, METRICS_ACCEPT_POLL_MS * 1000};
+        int ready = select((int)g_listenSocket + 1, &readSet, NULL, NULL, &tv);
+        if (ready < 0) break;
+        if (ready == 0) continue;
+
+        PortableSocket client = accept(g_listenSocket, NULL, NULL);
+        if (client == PORTABLE_INVALID_SOCKET) continue;
+        ServeClient(client, response);
+        PortableSocket_ShutdownSend(client);
+        PortableSocket_Close(client);
+    }
+
+    free(response);
+}
+
+/** @brief Bind a listening socket to 127.0.0.1:port */
+static PortableSocket OpenLoopbackListener(int port) {
+    PortableSocket s = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (s == PORTABLE_INVALID_SOCKET) return PORTABLE_INVALID_SOCKET;
+
+    PortableSocket_SetExclusive(s);
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons((unsigned short)port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    if (bind(s, (struct sockaddr*)&addr, sizeof(addr)) != 0 || listen(s, SOMAXCONN) != 0) {
+        PortableSocket_Close(s);
+        return PORTABLE_INVALID_SOCKET;
+    }
+
+    socklen_t addrLength = sizeof(addr);
+    if (getsockname(s, (struct sockaddr*)&addr, &addrLength) == 0) {
+        g_boundPort = ntohs(addr.sin_port);
+    }
+    return s;
+}
+
+static void FreePages(void) {
+    PortableLock_Acquire(&g_pageLock);
+    free(g_page);
+    g_page = NULL;
+    g_pageLength = 0;
+    PortableLock_Release(&g_pageLock);
+    free(g_buildPage);
+    g_buildPage = NULL;
+}
+
+/** @brief Close the listener and free the pages once the thread has been joined */
+static void ReleaseServerResources(void) {
+    PortableSocket_Close(g_listenSocket);
+    g_listenSocket = PORTABLE_INVALID_SOCKET;
+    g_boundPort = 0;
+    PortableSocket_Cleanup();
+    FreePages();
+}
+
+/* ============================================================================
+ * Public API - Page formatting
+ * ============================================================================ */
+
+void MetricsPage_Append(MetricsPage* page, const char* format, ...) {
+    if (page->overflow) return;
+    va_list args;
+    va_start(args, format);
+    int written = vsnprintf(page->data + page->length, page->capacity - page->length, format, args);
+    va_end(args);
+    if (written < 0 || (size_t)written >= page->capacity - page->length) {
+        page->overflow = 1;
+        return;
+    }
+    page->length += (size_t)written;
+}
+
+void MetricsPage_AppendGauge(MetricsPage* page, const char* name, const char* help, double value) {
+    MetricsPage_Append(page, "# HELP %s %s\n# TYPE %s gauge\n%s %.6g\n", name, help, name, name, value);
+}
+
+void MetricsPage_AppendHistogram(MetricsPage* page, const char* name, const char* help,
+                                 const MetricsLatencyHistogram* hist) {
+    MetricsPage_Append(page, "# HELP %s %s\n# TYPE %s histogram\n", name, help, name);
+    unsigned long long cumulative = 0;
+    for (size_t i = 0; i < METRICS_LATENCY_BUCKET_COUNT; ++i) {
+        cumulative += hist->buckets[i];
+        MetricsPage_Append(page, "%s_bucket{le=\"%g\"} %llu\n", name, kMetricsLatencyBucketsMs[i] / 1000.0, cumulative);
+    }
+    MetricsPage_Append(page, "%s_bucket{le=\"+Inf\"} %llu\n", name, (unsigned long long)hist->count);
+    MetricsPage_Append(page, "%s_sum %.6f\n", name, hist->sumMs / 1000.0);
+    MetricsPage_Append(page, "%s_count %llu\n", name, (unsigned long long)hist->count);
+}
+
+void MetricsHistogram_Observe(MetricsLatencyHistogram* hist, double ms) {
+    if (ms < 0.0) ms = 0.0;
+    for (size_t i = 0; i < METRICS_LATENCY_BUCKET_COUNT; ++i) {
+        if (ms <= kMetricsLatencyBucketsMs[i]) {
+            hist->buckets[i]++;
+            break;
+        }
+    }
+    hist->count++;
+    hist->sumMs += ms;
+}
+
+/* ============================================================================
+ * Public API - Server
+ * ============================================================================ */
+
+int MetricsServer_Start(int port, int* outError) {
+    if (outError) *outError = 0;
+    if (g_running) return 1;
+    if (port < 0 || port > 65535) return 0;
+
+    /** A timed-out stop left the thread running: reuse nothing until it has exited */
+    if (g_abandoned) {
+        if (!JoinServerThreadBounded(0)) return 0;
+        g_abandoned = 0;
+        ReleaseServerResources();
+    }
+
+    g_page = (char*)malloc(METRICS_PAGE_CAPACITY);
+    g_buildPage = (char*)malloc(METRICS_PAGE_CAPACITY);
+    if (!g_page || !g_buildPage) {
+        FreePages();
+        return 0;
+    }
+    g_pageLength = 0;
+
+    if (!PortableSocket_Startup()) {
+        if (outError) *outError = PortableSocket_LastError();
+        FreePages();
+        return 0;
+    }
+    g_listenSocket = OpenLoopbackListener(port);
+    if (g_listenSocket == PORTABLE_INVALID_SOCKET) {
+        if (outError) *outError = PortableSocket_LastError();
+        PortableSocket_Cleanup();
+        FreePages();
+        return 0;
+    }
+
+    atomic_store(&g_stopServer, 0);
+    atomic_store(&g_scrapes, 0);
+    if (!StartServerThread()) {
+        ReleaseServerResources();
+        return 0;
+    }
+    g_running = 1;
+    return 1;
+}
+
+void MetricsServer_Stop(void) {
+    if (!g_running) return;
+    g_running = 0;
+
+    atomic_store(&g_stopServer, 1);
+    if (!JoinServerThreadBounded(METRICS_STOP_TIMEOUT_MS)) {
+        /** Stuck mid-send: leave the buffers and socket to it; Start reaps them once it exits */
+        g_abandoned = 1;
+        return;
+    }
+    ReleaseServerResources();
+}
+
+int MetricsServer_IsRunning(void) {
+    return g_running;
+}
+
+int MetricsServer_GetPort(void) {
+    return g_running ? g_boundPort : 0;
+}
+
+int MetricsServer_Publish(MetricsPageWriter writer, void* context) {
+    if (!g_running || !g_buildPage || !writer) return 0;
+
+    /** Body first, after room for the headers, so Content-Length is known */
+    MetricsPage body = {g_buildPage + METRICS_HEADER_RESERVE, 0, METRICS_PAGE_CAPACITY - METRICS_HEADER_RESERVE, 0};
+    writer(&body, context);
+    if (body.overflow) return 0;
+
+    char header[METRICS_HEADER_RESERVE];
+    int headerLength = snprintf(header, sizeof(header),
+                                "HTTP/1.0 200 OK\r\n"
+                                "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+                                "Content-Length: %zu\r\n"
+                                "Connection: close\r\n\r\n", body.length);
+    if (headerLength <= 0 || headerLength >= METRICS_HEADER_RESERVE) return 0;
+
+    /** Slide the headers in directly before the body */
+    char* start = g_buildPage + METRICS_HEADER_RESERVE - headerLength;
+    memcpy(start, header, (size_t)headerLength);
+    size_t total = (size_t)headerLength + body.length;
+    memmove(g_buildPage, start, total);
+
+    PortableLock_Acquire(&g_pageLock);
+    char* published = g_page;
+    g_page = g_buildPage;
+    g_pageLength = total;
+    PortableLock_Release(&g_pageLock);
+    g_buildPage = published;
+    return 1;
+}
+
+long MetricsServer_GetScrapes(void) {
+    return atomic_load(&g_scrapes);
+}
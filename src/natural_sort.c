@@ -0,0 +1,44 @@
+/**
+ * @file natural_sort.c
+ * @brief Natural-order string comparison
+ *
+ * Single implementation behind the animation/font menus, the menu-ID finders
+ * and the frame-folder loader, so every place that lists the same folder
+ * agrees on its order.
+ */
+
+#include <wctype.h>
+
+#include "../include/natural_sort.h"
+
+int NaturalCompareW(const wchar_t* a, const wchar_t* b) {
+    const wchar_t* pa = a;
+    const wchar_t* pb = b;
+    while (*pa && *pb) {
+        if (iswdigit(*pa) && iswdigit(*pb)) {
+            const wchar_t* za = pa; while (*za == L'0') za++;
+            const wchar_t* zb = pb; while (*zb == L'0') zb++;
+            /** Primary rule: numbers with more leading zeros come first */
+            size_t leadA = (size_t)(za - pa);
+            size_t leadB = (size_t)(zb - pb);
+            if (leadA != leadB) return (leadA > leadB) ? -1 : 1;
+            const wchar_t* ea = za; while (iswdigit(*ea)) ea++;
+            const wchar_t* eb = zb; while (iswdigit(*eb)) eb++;
+            size_t lena = (size_t)(ea - za);
+            size_t lenb = (size_t)(eb - zb);
+            if (lena != lenb) return (lena < lenb) ? -1 : 1;
+            int dcmp = wcsncmp(za, zb, lena);
+            if (dcmp != 0) return (dcmp < 0) ? -1 : 1;
+            pa = ea;
+            pb = eb;
+            continue;
+        }
+        wchar_t ca = towlower(*pa);
+        wchar_t cb = towlower(*pb);
+        if (ca != cb) return (ca < cb) ? -1 : 1;
+        pa++; pb++;
+    }
+    if (*pa) return 1;
+    if (*pb) return -1;
+    return 0;
+}
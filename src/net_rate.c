@@ -0,0 +1,94 @@
+/**
+ * @file net_rate.c
+ * @brief Byte-rate computation from per-interface 64-bit traffic counters
+ *
+ * Replaces the aggregate 32-bit arithmetic of the old GetIfTable sampler,
+ * whose overflow fix assumed at most one wrap per interval and miscounted
+ * whenever the set of interfaces changed.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/net_rate.h"
+
+/* ============================================================================
+ * Helper Functions
+ * ============================================================================ */
+
+static const NetRateSample* FindPrevious(const NetRateTracker* tracker, uint32_t id) {
+    for (size_t i = 0; i < tracker->count; ++i) {
+        if (tracker->last[i].id == id) return &tracker->last[i];
+    }
+    return NULL;
+}
+
+/** @return 0 if the buffer could not grow; the baseline is dropped then */
+static int StoreSamples(NetRateTracker* tracker, const NetRateSample* samples, size_t count, uint64_t nowMs) {
+    if (count > tracker->capacity) {
+        NetRateSample* grown = (NetRateSample*)realloc(tracker->last, count * sizeof(NetRateSample));
+        if (!grown) {
+            tracker->count = 0;
+            tracker->hasBaseline = 0;
+            return 0;
+        }
+        tracker->last = grown;
+        tracker->capacity = count;
+    }
+    if (count > 0) memcpy(tracker->last, samples, count * sizeof(NetRateSample));
+    tracker->count = count;
+    tracker->lastMs = nowMs;
+    tracker->hasBaseline = 1;
+    return 1;
+}
+
+/* ============================================================================
+ * Public API
+ * ============================================================================ */
+
+uint64_t NetRate_CounterDelta(uint64_t previous, uint64_t current) {
+    uint64_t delta = current - previous;    /** Unsigned: a single wrap comes out right */
+    return (delta > NET_RATE_MAX_PLAUSIBLE_DELTA) ? 0 : delta;
+}
+
+void NetRate_Reset(NetRateTracker* tracker) {
+    if (!tracker) return;
+    tracker->count = 0;
+    tracker->lastMs = 0;
+    tracker->hasBaseline = 0;
+}
+
+void NetRate_Release(NetRateTracker* tracker) {
+    if (!tracker) return;
+    free(tracker->last);
+    memset(tracker, 0, sizeof(*tracker));
+}
+
+int NetRate_Update(NetRateTracker* tracker, const NetRateSample* samples, size_t count,
+                   uint64_t nowMs, double* outUpBps, double* outDownBps) {
+    if (!tracker || (!samples && count > 0)) return 0;
+
+    if (!tracker->hasBaseline || nowMs < tracker->lastMs) {
+        StoreSamples(tracker, samples, count, nowMs);
+        return 0;
+    }
+
+    uint64_t elapsedMs = nowMs - tracker->lastMs;
+    if (elapsedMs == 0) return 0;
+
+    uint64_t inBytes = 0;
+    uint64_t outBytes = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const NetRateSample* prev = FindPrevious(tracker, samples[i].id);
+        if (!prev) continue;    /** New interface: baseline only */
+        inBytes += NetRate_CounterDelta(prev->inOctets, samples[i].inOctets);
+        outBytes += NetRate_CounterDelta(prev->outOctets, samples[i].outOctets);
+    }
+
+    StoreSamples(tracker, samples, count, nowMs);   /** On failure the next call starts a new baseline */
+
+    double seconds = (double)elapsedMs / 1000.0;
+    if (outDownBps) *outDownBps = (double)inBytes / seconds;
+    if (outUpBps) *outUpBps = (double)outBytes / seconds;
+    return 1;
+}
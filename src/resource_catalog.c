@@ -0,0 +1,574 @@
+/**
+ * @file resource_catalog.c
+ * @brief Indexed snapshots of the resources folders
+ *
+ * A snapshot is one flat array of entries. The root's children come first;
+ * every directory's children follow as one contiguous, sorted run, so a
+ * breadth-first scan fills the array in a single pass and a lookup inside a
+ * directory is a binary search. Paths are stored once in a chunked string
+ * pool, in both UTF-16 and UTF-8.
+ *
+ * Snapshots never change after publication. Readers hold a reference while
+ * they use one; a rebuild publishes a new snapshot and the old one is freed
+ * when its last reader lets go. IDs are carried over from the previous
+ * snapshot by path, so an entry keeps its ID until it is renamed or removed.
+ */
+
+#include <windows.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/resource_catalog.h"
+#include "../include/config_watcher.h"
+#include "../include/config.h"
+#include "../include/natural_sort.h"
+#include "../include/log.h"
+
+/* ============================================================================
+ * Constants
+ * ============================================================================ */
+
+/** @brief Bytes per string pool chunk (longer strings get their own chunk) */
+#define CATALOG_STRING_CHUNK_SIZE (64 * 1024)
+
+#define CATALOG_INITIAL_CAPACITY 256
+
+/** @brief Marks "no entry" in index fields */
+#define CATALOG_NO_INDEX ((UINT)-1)
+
+/** @brief Subfolder of the config directory and watcher area, per root */
+static const wchar_t* const kRootFolders[CATALOG_ROOT_COUNT] = {
+    L"resources\\fonts", L"resources\\animations", L"resources\\audio"
+};
+static const WatchArea kRootAreas[CATALOG_ROOT_COUNT] = {
+    WATCH_AREA_FONTS, WATCH_AREA_ANIMATIONS, WATCH_AREA_AUDIO
+};
+static const char* const kRootNames[CATALOG_ROOT_COUNT] = {"fonts", "animations", "audio"};
+
+/** @brief Indexed file extensions */
+static const struct {
+    const wchar_t* ext;
+    CatalogEntryType type;
+} kIndexedExtensions[] = {
+    {L".ttf",  CATALOG_ENTRY_FONT},
+    {L".otf",  CATALOG_ENTRY_FONT},
+    {L".gif",  CATALOG_ENTRY_ANIMATED_IMAGE},
+    {L".webp", CATALOG_ENTRY_ANIMATED_IMAGE},
+    {L".ico",  CATALOG_ENTRY_IMAGE},
+    {L".png",  CATALOG_ENTRY_IMAGE},
+    {L".bmp",  CATALOG_ENTRY_IMAGE},
+    {L".jpg",  CATALOG_ENTRY_IMAGE},
+    {L".jpeg", CATALOG_ENTRY_IMAGE},
+    {L".tif",  CATALOG_ENTRY_IMAGE},
+    {L".tiff", CATALOG_ENTRY_IMAGE},
+    {L".flac", CATALOG_ENTRY_AUDIO},
+    {L".mp3",  CATALOG_ENTRY_AUDIO},
+    {L".wav",  CATALOG_ENTRY_AUDIO}
+};
+
+/* ============================================================================
+ * Type Definitions
+ * ============================================================================ */
+
+/** @brief String pool chunk; strings are never moved once placed */
+typedef struct StringChunk {
+    struct StringChunk* next;
+    size_t used;
+    size_t capacity;
+    wchar_t data[];                 /**< wchar_t keeps UTF-16 strings aligned */
+} StringChunk;
+
+struct ResourceCatalog {
+    volatile LONG refs;
+    CatalogRoot root;
+    LONG generation;                /**< Watcher generation the scan started from */
+    volatile LONG invalidated;      /**< Set by ResourceCatalog_Invalidate */
+    UINT nextId;                    /**< Next ID for paths not in the previous snapshot */
+    wchar_t rootPathW[MAX_PATH];
+    CatalogEntry* entries;
+    UINT count;
+    UINT capacity;
+    UINT topCount;                  /**< entries[0 .. topCount) are the root's children */
+    StringChunk* strings;
+};
+
+/** @brief State of one rebuild */
+typedef struct {
+    ResourceCatalog* catalog;
+    const ResourceCatalog* previous;    /**< Source of carried-over IDs, may be NULL */
+    UINT* previousIndex;                /**< Per entry: same path in previous, or CATALOG_NO_INDEX */
+    BOOL cancellable;                   /**< Abort when the builder is stopping */
+} CatalogBuild;
+
+/* ============================================================================
+ * Global State
+ * ============================================================================ */
+
+/** @brief Published snapshots; the table holds one reference to each */
+static ResourceCatalog* g_snapshots[CATALOG_ROOT_COUNT];
+static SRWLOCK g_snapshotLock = SRWLOCK_INIT;
+
+/** @brief One rebuild per root at a time (zero-initialized == SRWLOCK_INIT) */
+static SRWLOCK g_buildLocks[CATALOG_ROOT_COUNT];
+
+static HANDLE g_builderThread = NULL;
+static HANDLE g_stopEvent = NULL;
+static HANDLE g_wakeEvent = NULL;
+static volatile LONG g_stopping = 0;
+
+/* ============================================================================
+ * Helper Functions - Snapshot Memory
+ * ============================================================================ */
+
+/** @brief Reserve pool space for a string (wchar_t-aligned, freed with the snapshot) */
+static void* PoolAlloc(ResourceCatalog* catalog, size_t bytes) {
+    size_t units = (bytes + sizeof(wchar_t) - 1) / sizeof(wchar_t);
+    StringChunk* chunk = catalog->strings;
+    if (!chunk || chunk->capacity - chunk->used < units) {
+        size_t capacity = CATALOG_STRING_CHUNK_SIZE / sizeof(wchar_t);
+        if (capacity < units) capacity = units;
+        chunk = (StringChunk*)malloc(sizeof(StringChunk) + capacity * sizeof(wchar_t));
+        if (!chunk) return NULL;
+        chunk->next = catalog->strings;
+        chunk->used = 0;
+        chunk->capacity = capacity;
+        catalog->strings = chunk;
+    }
+    void* result = chunk->data + chunk->used;
+    chunk->used += units;
+    return result;
+}
+
+static void FreeCatalog(ResourceCatalog* catalog) {
+    if (!catalog) return;
+    StringChunk* chunk = catalog->strings;
+    while (chunk) {
+        StringChunk* next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+    free(catalog->entries);
+    free(catalog);
+}
+
+static void AddRef(const ResourceCatalog* catalog) {
+    InterlockedIncrement(&((ResourceCatalog*)catalog)->refs);
+}
+
+/* ============================================================================
+ * Helper Functions - Scanning
+ * ============================================================================ */
+
+/** @brief Indexed type of a file name, or -1 if the file is not indexed */
+static int ClassifyFile(const wchar_t* name) {
+    const wchar_t* ext = wcsrchr(name, L'.');
+    if (!ext) return -1;
+    for (size_t i = 0; i < sizeof(kIndexedExtensions) / sizeof(kIndexedExtensions[0]); i++) {
+        if (_wcsicmp(ext, kIndexedExtensions[i].ext) == 0) return (int)kIndexedExtensions[i].type;
+    }
+    return -1;
+}
+
+/** @brief Menu order: directories first, then natural order by name */
+static int CompareEntries(const void* a, const void* b) {
+    const CatalogEntry* ea = (const CatalogEntry*)a;
+    const CatalogEntry* eb = (const CatalogEntry*)b;
+    BOOL dirA = (ea->type == CATALOG_ENTRY_DIRECTORY);
+    BOOL dirB = (eb->type == CATALOG_ENTRY_DIRECTORY);
+    if (dirA != dirB) return dirB - dirA;
+    return NaturalCompareW(ea->nameW, eb->nameW);
+}
+
+/**
+ * @brief Binary search a sorted child run
+ * @return Index of the entry with this kind and name, or CATALOG_NO_INDEX
+ */
+static UINT FindChildIndex(const ResourceCatalog* catalog, UINT first, UINT count,
+                           BOOL isDir, const wchar_t* nameW) {
+    UINT lo = first;
+    UINT hi = first + count;
+    while (lo < hi) {
+        UINT mid = lo + (hi - lo) / 2;
+        const CatalogEntry* e = &catalog->entries[mid];
+        BOOL midDir = (e->type == CATALOG_ENTRY_DIRECTORY);
+        int cmp = (midDir != isDir) ? (isDir ? 1 : -1) : NaturalCompareW(e->nameW, nameW);
+        if (cmp == 0) return mid;
+        if (cmp < 0) lo = mid + 1;
+        else hi = mid;
+    }
+    return CATALOG_NO_INDEX;
+}
+
+/** @brief Append an entry for a directory listing item */
+static BOOL AppendEntry(CatalogBuild* build, UINT parentIndex,
+                        const WIN32_FIND_DATAW* ffd, CatalogEntryType type) {
+    ResourceCatalog* catalog = build->catalog;
+    if (catalog->count == catalog->capacity) {
+        UINT capacity = catalog->capacity ? catalog->capacity * 2 : CATALOG_INITIAL_CAPACITY;
+        CatalogEntry* entries = (CatalogEntry*)realloc(catalog->entries, capacity * sizeof(CatalogEntry));
+        if (!entries) return FALSE;
+        catalog->entries = entries;
+        UINT* previousIndex = (UINT*)realloc(build->previousIndex, capacity * sizeof(UINT));
+        if (!previousIndex) return FALSE;
+        build->previousIndex = previousIndex;
+        catalog->capacity = capacity;
+    }
+
+    /** Resolved after growing: realloc may have moved the parent */
+    const CatalogEntry* parent = (parentIndex == CATALOG_NO_INDEX) ? NULL : &catalog->entries[parentIndex];
+    size_t parentLen = parent ? wcslen(parent->relPathW) + 1 : 0;
+    size_t nameLen = wcslen(ffd->cFileName);
+    wchar_t* relPathW = (wchar_t*)PoolAlloc(catalog, (parentLen + nameLen + 1) * sizeof(wchar_t));
+    if (!relPathW) return FALSE;
+    if (parent) {
+        memcpy(relPathW, parent->relPathW, (parentLen - 1) * sizeof(wchar_t));
+        relPathW[parentLen - 1] = L'\\';
+    }
+    memcpy(relPathW + parentLen, ffd->cFileName, (nameLen + 1) * sizeof(wchar_t));
+
+    int utf8Len = WideCharToMultiByte(CP_UTF8, 0, relPathW, -1, NULL, 0, NULL, NULL);
+    if (utf8Len <= 0) return FALSE;
+    char* relPathUtf8 = (char*)PoolAlloc(catalog, (size_t)utf8Len);
+    if (!relPathUtf8) return FALSE;
+    WideCharToMultiByte(CP_UTF8, 0, relPathW, -1, relPathUtf8, utf8Len, NULL, NULL);
+    const char* nameUtf8 = strrchr(relPathUtf8, '\\');
+
+    CatalogEntry* e = &catalog->entries[catalog->count];
+    e->relPathW = relPathW;
+    e->relPathUtf8 = relPathUtf8;
+    e->nameW = relPathW + parentLen;
+    e->nameUtf8 = nameUtf8 ? nameUtf8 + 1 : relPathUtf8;
+    e->id = 0;
+    e->firstChild = 0;
+    e->childCount = 0;
+    e->type = type;
+    e->size = (type == CATALOG_ENTRY_DIRECTORY) ? 0 :
+              ((ULONGLONG)ffd->nFileSizeHigh << 32) | ffd->nFileSizeLow;
+    e->lastWrite = ffd->ftLastWriteTime;
+    build->previousIndex[catalog->count] = CATALOG_NO_INDEX;
+    catalog->count++;
+    return TRUE;
+}
+
+/** @brief Give a new child run its IDs, reusing the previous snapshot's where the path matches */
+static void AssignIds(CatalogBuild* build, UINT parentIndex, UINT first, UINT count) {
+    ResourceCatalog* catalog = build->catalog;
+    const ResourceCatalog* previous = build->previous;
+
+    UINT prevFirst = 0, prevCount = 0;
+    if (previous) {
+        if (parentIndex == CATALOG_NO_INDEX) {
+            prevCount = previous->topCount;
+        } else if (build->previousIndex[parentIndex] != CATALOG_NO_INDEX) {
+            const CatalogEntry* prevParent = &previous->entries[build->previousIndex[parentIndex]];
+            prevFirst = prevParent->firstChild;
+            prevCount = prevParent->childCount;
+        }
+    }
+
+    for (UINT i = first; i < first + count; i++) {
+        CatalogEntry* e = &catalog->entries[i];
+        UINT match = prevCount ? FindChildIndex(previous, prevFirst, prevCount,
+                                                e->type == CATALOG_ENTRY_DIRECTORY, e->nameW)
+                               : CATALOG_NO_INDEX;
+        build->previousIndex[i] = match;
+        e->id = (match != CATALOG_NO_INDEX) ? previous->entries[match].id : catalog->nextId++;
+    }
+}
+
+/**
+ * @brief List one directory and append its indexed children as a sorted run
+ * @param parentIndex Directory entry, or CATALOG_NO_INDEX for the root
+ * @return FALSE on allocation failure (a missing folder is just empty)
+ */
+static BOOL ScanDirectory(CatalogBuild* build, UINT parentIndex) {
+    ResourceCatalog* catalog = build->catalog;
+
+    wchar_t search[MAX_PATH];
+    int len;
+    if (parentIndex == CATALOG_NO_INDEX) {
+        len = _snwprintf_s(search, MAX_PATH, _TRUNCATE, L"%s\\*", catalog->rootPathW);
+    } else {
+        len = _snwprintf_s(search, MAX_PATH, _TRUNCATE, L"%s\\%s\\*",
+                           catalog->rootPathW, catalog->entries[parentIndex].relPathW);
+    }
+    if (len < 0) return TRUE;     /** Too deep for MAX_PATH: index as empty */
+
+    UINT first = catalog->count;
+
+    /** Basic info skips the 8.3 name; large fetch batches the directory reads */
+    WIN32_FIND_DATAW ffd;
+    HANDLE hFind = FindFirstFileExW(search, FindExInfoBasic, &ffd, FindExSearchNameMatch,
+                                    NULL, FIND_FIRST_EX_LARGE_FETCH);
+    if (hFind != INVALID_HANDLE_VALUE) {
+        do {
+            if (wcscmp(ffd.cFileName, L".") == 0 || wcscmp(ffd.cFileName, L"..") == 0) continue;
+
+            int type = (ffd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+                           ? (int)CATALOG_ENTRY_DIRECTORY : ClassifyFile(ffd.cFileName);
+            if (type < 0) continue;
+
+            if (!AppendEntry(build, parentIndex, &ffd, (CatalogEntryType)type)) {
+                FindClose(hFind);
+                return FALSE;
+            }
+        } while (FindNextFileW(hFind, &ffd));
+        FindClose(hFind);
+    }
+
+    UINT count = catalog->count - first;
+    if (count > 1) {
+        qsort(&catalog->entries[first], count, sizeof(CatalogEntry), CompareEntries);
+    }
+
+    if (parentIndex == CATALOG_NO_INDEX) {
+        catalog->topCount = count;
+    } else {
+        catalog->entries[parentIndex].firstChild = first;
+        catalog->entries[parentIndex].childCount = count;
+    }
+    AssignIds(build, parentIndex, first, count);
+    return TRUE;
+}
+
+/** @brief Absolute path of a root folder (<config dir>\resources\<name>) */
+static BOOL GetRootFolderPath(CatalogRoot root, wchar_t* out, size_t size) {
+    char configPathUtf8[MAX_PATH] = {0};
+    GetConfigPath(configPathUtf8, MAX_PATH);
+
+    wchar_t configPathW[MAX_PATH] = {0};
+    if (MultiByteToWideChar(CP_UTF8, 0, configPathUtf8, -1, configPathW, MAX_PATH) <= 0) return FALSE;
+
+    wchar_t* lastSep = wcsrchr(configPathW, L'\\');
+    if (!lastSep) return FALSE;
+    *lastSep = L'\0';
+
+    return _snwprintf_s(out, size, _TRUNCATE, L"%s\\%s", configPathW, kRootFolders[root]) >= 0;
+}
+
+/**
+ * @brief Scan a root into a new snapshot
+ * @param previous Snapshot whose IDs are carried over, may be NULL
+ * @return Snapshot with one reference, or NULL on failure or cancellation
+ */
+static ResourceCatalog* BuildCatalog(CatalogRoot root, const ResourceCatalog* previous, BOOL cancellable) {
+    ResourceCatalog* catalog = (ResourceCatalog*)calloc(1, sizeof(ResourceCatalog));
+    if (!catalog) return NULL;
+    catalog->refs = 1;
+    catalog->root = root;
+    /** Read before scanning: a change during the scan leaves this snapshot stale */
+    catalog->generation = ConfigWatcher_GetGeneration(kRootAreas[root]);
+    catalog->nextId = previous ? previous->nextId : 1;
+
+    if (!GetRootFolderPath(root, catalog->rootPathW, MAX_PATH)) {
+        FreeCatalog(catalog);
+        return NULL;
+    }
+
+    CatalogBuild build = {catalog, previous, NULL, cancellable};
+    ULONGLONG start = GetTickCount64();
+
+    BOOL ok = ScanDirectory(&build, CATALOG_NO_INDEX);
+    /** Breadth-first: each scanned directory appends its children after everything seen so far */
+    for (UINT i = 0; ok && i < catalog->count; i++) {
+        if (catalog->entries[i].type != CATALOG_ENTRY_DIRECTORY) continue;
+        if (build.cancellable && g_stopping) {
+            ok = FALSE;
+            break;
+        }
+        ok = ScanDirectory(&build, i);
+    }
+    free(build.previousIndex);
+
+    if (!ok) {
+        FreeCatalog(catalog);
+        return NULL;
+    }
+
+    LOG_DEBUG("Resource catalog: indexed %u %s entries in %llu ms",
+              catalog->count, kRootNames[root], GetTickCount64() - start);
+    return catalog;
+}
+
+/* ============================================================================
+ * Helper Functions - Publication
+ * ============================================================================ */
+
+/** @brief Published snapshot with an added reference, or NULL */
+static ResourceCatalog* AcquirePublished(CatalogRoot root) {
+    AcquireSRWLockShared(&g_snapshotLock);
+    ResourceCatalog* catalog = g_snapshots[root];
+    if (catalog) AddRef(catalog);
+    ReleaseSRWLockShared(&g_snapshotLock);
+    return catalog;
+}
+
+/** @brief Replace a published snapshot (takes over the caller's reference) */
+static void Publish(CatalogRoot root, ResourceCatalog* catalog) {
+    AcquireSRWLockExclusive(&g_snapshotLock);
+    ResourceCatalog* old = g_snapshots[root];
+    g_snapshots[root] = catalog;
+    ReleaseSRWLockExclusive(&g_snapshotLock);
+    ResourceCatalog_Release(old);
+}
+
+static BOOL IsStale(const ResourceCatalog* catalog) {
+    return catalog->invalidated ||
+           catalog->generation != ConfigWatcher_GetGeneration(kRootAreas[catalog->root]);
+}
+
+/** @brief Rebuild a root if it is missing or stale; callers racing on one root wait for one scan */
+static void RefreshRoot(CatalogRoot root, BOOL cancellable) {
+    AcquireSRWLockExclusive(&g_buildLocks[root]);
+    ResourceCatalog* current = AcquirePublished(root);
+    if (!current || IsStale(current)) {
+        ResourceCatalog* fresh = BuildCatalog(root, current, cancellable);
+        if (fresh) Publish(root, fresh);
+    }
+    ResourceCatalog_Release(current);
+    ReleaseSRWLockExclusive(&g_buildLocks[root]);
+}
+
+/** @brief Builder thread: refresh every root each time it is woken */
+static DWORD WINAPI BuilderThreadProc(LPVOID lpParam) {
+    (void)lpParam;
+    HANDLE events[2] = {g_stopEvent, g_wakeEvent};
+    for (;;) {
+        DWORD wait = WaitForMultipleObjects(2, events, FALSE, INFINITE);
+        if (wait != WAIT_OBJECT_0 + 1) break;
+        for (int root = 0; root < CATALOG_ROOT_COUNT && !g_stopping; root++) {
+            RefreshRoot((CatalogRoot)root, TRUE);
+        }
+    }
+    return 0;
+}
+
+/* ============================================================================
+ * Public API
+ * ============================================================================ */
+
+void ResourceCatalog_Start(void) {
+    if (g_builderThread) return;
+
+    g_stopping = 0;
+    g_stopEvent = CreateEventW(NULL, TRUE, FALSE, NULL);
+    g_wakeEvent = CreateEventW(NULL, FALSE, TRUE, NULL);   /** Signaled: build everything at once */
+    if (!g_stopEvent || !g_wakeEvent) {
+        if (g_stopEvent) CloseHandle(g_stopEvent);
+        if (g_wakeEvent) CloseHandle(g_wakeEvent);
+        g_stopEvent = g_wakeEvent = NULL;
+        return;     /** Snapshots are then built on first use */
+    }
+    g_builderThread = CreateThread(NULL, 0, BuilderThreadProc, NULL, 0, NULL);
+    if (!g_builderThread) {
+        WriteLog(LOG_LEVEL_WARNING, "Resource catalog builder thread failed to start (error %lu)", GetLastError());
+    }
+}
+
+void ResourceCatalog_Stop(void) {
+    if (g_builderThread) {
+        InterlockedExchange(&g_stopping, 1);
+        SetEvent(g_stopEvent);
+        WaitForSingleObject(g_builderThread, INFINITE);
+        CloseHandle(g_builderThread);
+        g_builderThread = NULL;
+    }
+    if (g_stopEvent) CloseHandle(g_stopEvent);
+    if (g_wakeEvent) CloseHandle(g_wakeEvent);
+    g_stopEvent = g_wakeEvent = NULL;
+    InterlockedExchange(&g_stopping, 0);
+
+    for (int root = 0; root < CATALOG_ROOT_COUNT; root++) {
+        Publish((CatalogRoot)root, NULL);
+    }
+}
+
+void ResourceCatalog_Refresh(void) {
+    if (g_wakeEvent) SetEvent(g_wakeEvent);
+}
+
+void ResourceCatalog_Invalidate(CatalogRoot root) {
+    if (root < 0 || root >= CATALOG_ROOT_COUNT) return;
+    ResourceCatalog* catalog = AcquirePublished(root);
+    if (catalog) {
+        InterlockedExchange(&catalog->invalidated, 1);
+        ResourceCatalog_Release(catalog);
+    }
+}
+
+const ResourceCatalog* ResourceCatalog_Acquire(CatalogRoot root) {
+    if (root < 0 || root >= CATALOG_ROOT_COUNT) return NULL;
+
+    ResourceCatalog* catalog = AcquirePublished(root);
+    if (catalog && !IsStale(catalog)) return catalog;
+
+    ResourceCatalog_Release(catalog);
+    RefreshRoot(root, FALSE);
+    return AcquirePublished(root);
+}
+
+void ResourceCatalog_Release(const ResourceCatalog* catalog) {
+    if (!catalog) return;
+    ResourceCatalog* mutableCatalog = (ResourceCatalog*)catalog;
+    if (InterlockedDecrement(&mutableCatalog->refs) == 0) {
+        FreeCatalog(mutableCatalog);
+    }
+}
+
+const wchar_t* ResourceCatalog_GetRootPath(const ResourceCatalog* catalog) {
+    return catalog ? catalog->rootPathW : L"";
+}
+
+const CatalogEntry* ResourceCatalog_GetChildren(const ResourceCatalog* catalog,
+                                                const CatalogEntry* dir, UINT* outCount) {
+    UINT first = 0, count = 0;
+    if (catalog) {
+        if (!dir) {
+            count = catalog->topCount;
+        } else if (dir->type == CATALOG_ENTRY_DIRECTORY) {
+            first = dir->firstChild;
+            count = dir->childCount;
+        }
+    }
+    if (outCount) *outCount = count;
+    return count ? &catalog->entries[first] : NULL;
+}
+
+BOOL ResourceCatalog_IsAnimationLeaf(const ResourceCatalog* catalog, const CatalogEntry* folder) {
+    UINT count = 0;
+    const CatalogEntry* children = ResourceCatalog_GetChildren(catalog, folder, &count);
+    for (UINT i = 0; i < count; i++) {
+        if (children[i].type == CATALOG_ENTRY_DIRECTORY ||
+            children[i].type == CATALOG_ENTRY_ANIMATED_IMAGE) {
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+/** @brief Depth-first search of a child run in menu order */
+static const CatalogEntry* FindFileInRun(const ResourceCatalog* catalog, UINT first, UINT count,
+                                         const wchar_t* nameW) {
+    for (UINT i = first; i < first + count; i++) {
+        const CatalogEntry* e = &catalog->entries[i];
+        if (e->type == CATALOG_ENTRY_DIRECTORY) {
+            const CatalogEntry* found = FindFileInRun(catalog, e->firstChild, e->childCount, nameW);
+            if (found) return found;
+        } else if (_wcsicmp(e->nameW, nameW) == 0) {
+            return e;
+        }
+    }
+    return NULL;
+}
+
+const CatalogEntry* ResourceCatalog_FindFileByName(const ResourceCatalog* catalog, const wchar_t* nameW) {
+    if (!catalog || !nameW) return NULL;
+    return FindFileInRun(catalog, 0, catalog->topCount, nameW);
+}
+
+BOOL ResourceCatalog_GetFullPath(const ResourceCatalog* catalog, const CatalogEntry* entry,
+                                 wchar_t* outPath, size_t outSize) {
+    if (!catalog || !entry || !outPath || outSize == 0) return FALSE;
+    return _snwprintf_s(outPath, outSize, _TRUNCATE, L"%s\\%s", catalog->rootPathW, entry->relPathW) >= 0;
+}
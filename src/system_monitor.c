@@ -2,21 +2,33 @@
  * @file system_monitor.c
  * @brief Lightweight system performance monitoring with unified state management
  * 
- * Refactored implementation featuring:
+ * Implementation featuring:
  * - Consolidated state management in a single structure
- * - Eliminated code duplication through helper functions and macros
- * - Improved readability with named constants
- * - Enhanced maintainability through modular design
+ * - One sampler thread owns all sampling state and runs only while
+ *   someone is subscribed
+ * - Each sample is published as a snapshot behind a seqlock; getters copy
+ *   the snapshot and never sample or block
+ * - Per-core and watched-process CPU alongside the system totals, each
+ *   with a fixed-size history ring for short-spike graphs
+ * - Per-metric EWMA/window smoothing of published values, and a sampling
+ *   rate chosen by the most demanding active consumer
  * 
- * @version 2.0 - Major refactoring for code quality and maintainability
+ * @version 3.1 - Adaptive sampling rate and smoothing
  */
 
+#include <winsock2.h>
 #include <windows.h>
 #include <psapi.h>
 #include <iphlpapi.h>
+#include <tlhelp32.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 #include "../include/system_monitor.h"
+#include "../include/net_rate.h"
+#include "../include/metric_history.h"
+#include "../include/log.h"
 
 /* ============================================================================
  * Constants and Configuration
@@ -25,11 +37,35 @@
 /** @brief Default refresh interval in milliseconds */
 #define DEFAULT_UPDATE_INTERVAL_MS 1000
 
+/** @brief Default interval while an animation's speed follows CPU/memory */
+#define DEFAULT_FAST_INTERVAL_MS 250
+
+/** @brief Default interval while only the tooltip needs metrics */
+#define DEFAULT_IDLE_INTERVAL_MS 5000
+
+/** @brief Shortest accepted adaptive interval */
+#define MIN_ADAPTIVE_INTERVAL_MS 100
+
+/** @brief Default CPU smoothing: EWMA time constant in milliseconds */
+#define DEFAULT_CPU_SMOOTHING_MS 2000
+
 /** @brief Network interface type for software loopback (to be excluded) */
 #define IF_TYPE_SOFTWARE_LOOPBACK 24
 
-/** @brief Maximum value for 32-bit counter (for overflow handling) */
-#define COUNTER_MAX_32BIT 0x100000000ULL
+/** @brief Samples between re-enumerations when change notifications are unavailable */
+#define NETWORK_REENUMERATE_FALLBACK_SAMPLES 30
+
+/** @brief NtQuerySystemInformation class for per-processor idle/kernel/user times */
+#define SYSTEM_PROCESSOR_PERFORMANCE_INFO_CLASS 8
+
+/** @brief How often a watched process that is not running is looked up again */
+#define PROCESS_RESOLVE_INTERVAL_MS 5000
+
+/** @brief Number of history series: system CPU, memory, process, then one per core */
+#define SYSTEM_SERIES_COUNT (SYSTEM_SERIES_CORE_FIRST + SYSTEM_MONITOR_MAX_CORES)
+
+/** @brief Longest the last Unsubscribe waits for the sampler to exit */
+#define SAMPLER_JOIN_TIMEOUT_MS 2000
 
 /* ============================================================================
  * Type Definitions
@@ -45,45 +81,170 @@ typedef struct {
     BOOL hasBaseline;       /**< Whether baseline sample exists */
 } CpuTimesState;
 
+/**
+ * @brief Per-processor times as returned by NtQuerySystemInformation
+ * (SYSTEM_PROCESSOR_PERFORMANCE_INFORMATION); kernel time includes idle
+ */
+typedef struct {
+    LARGE_INTEGER idleTime;
+    LARGE_INTEGER kernelTime;
+    LARGE_INTEGER userTime;
+    LARGE_INTEGER dpcTime;
+    LARGE_INTEGER interruptTime;
+    ULONG interruptCount;
+} ProcessorPerformanceInfo;
+
+typedef LONG (WINAPI *NtQuerySystemInformationFn)(ULONG, PVOID, ULONG, PULONG);
+
+/**
+ * @brief Per-core sampling state
+ * 
+ * NtQuerySystemInformation reports the processors of the calling thread's
+ * group, so SYSTEM_MONITOR_MAX_CORES entries always suffice and both
+ * buffers are static.
+ */
+typedef struct {
+    NtQuerySystemInformationFn query;   /**< Resolved from ntdll, NULL if unavailable */
+    BOOL queryResolved;                 /**< Lookup attempted */
+    ProcessorPerformanceInfo current[SYSTEM_MONITOR_MAX_CORES];
+    ProcessorPerformanceInfo previous[SYSTEM_MONITOR_MAX_CORES];
+    int coreCount;                      /**< Entries in previous, 0 = no baseline */
+    float cachedPercent[SYSTEM_MONITOR_MAX_CORES];
+    int cachedCount;                    /**< Valid entries in cachedPercent */
+} CoreState;
+
+/**
+ * @brief Watched-process sampling state (sampler thread only)
+ */
+typedef struct {
+    wchar_t exeName[MAX_PATH];  /**< Executable to watch, empty = none */
+    LONG seenGeneration;        /**< Watch request generation exeName was copied from */
+    HANDLE handle;              /**< Open process, NULL while not found */
+    ULONGLONG lastCpuTime;      /**< Previous kernel+user time (100 ns) */
+    ULONGLONG lastWallMs;       /**< Previous sample time */
+    BOOL hasBaseline;
+    ULONGLONG lastResolveMs;    /**< Last process lookup, throttles Toolhelp snapshots */
+    float cachedPercent;        /**< Share of the whole machine (0-100) */
+    BOOL valid;                 /**< cachedPercent describes a running process */
+} ProcessState;
+
 /**
  * @brief Network monitoring state for speed calculation
+ * 
+ * The interface list is enumerated once with GetIfTable2 and then only
+ * when NotifyIpInterfaceChange reports a change; each sample reads the
+ * cached interfaces with GetIfEntry2 into the same row and sample buffers.
+ * The index and sample buffers are sized from the table and only grow.
  */
 typedef struct {
-    BOOL hasBaseline;           /**< Whether baseline sample exists */
-    ULONGLONG lastInOctets;     /**< Previous total bytes received */
-    ULONGLONG lastOutOctets;    /**< Previous total bytes sent */
-    DWORD lastTick;             /**< Previous sample timestamp */
+    NET_IFINDEX* indices;                           /**< Interfaces being summed */
+    int indexCount;                                 /**< Valid entries in indices */
+    ULONG capacity;                                 /**< Entries allocated in indices and samples */
+    BOOL enumerated;                                /**< indices reflect a completed enumeration */
+    volatile LONG interfacesChanged;                /**< Set by the change notification */
+    HANDLE changeNotify;                            /**< NotifyIpInterfaceChange handle, NULL if unavailable */
+    int samplesSinceEnumerate;                      /**< Drives the fallback re-enumeration */
+    MIB_IF_ROW2 row;                                /**< Reused GetIfEntry2 query row */
+    NetRateSample* samples;                         /**< Reused per-sample counter buffer */
+    NetRateTracker rate;                            /**< Previous counters for delta calculation */
     float cachedUpBps;          /**< Cached upload speed (bytes/sec) */
     float cachedDownBps;        /**< Cached download speed (bytes/sec) */
 } NetworkState;
 
 /**
- * @brief Unified system monitor state
+ * @brief Unified sampling state
  * 
- * Consolidates all monitoring state into a single structure for improved
- * organization and easier maintenance. Reduces global variable clutter
- * from 13 individual variables to 1 structured variable.
+ * Owned by the sampler thread while it runs; ForceRefresh samples inline
+ * only when no sampler is running, so there is never more than one writer.
  */
 typedef struct {
     /** CPU monitoring state */
     struct {
         CpuTimesState timesState;   /**< CPU time sampling state */
-        float cachedPercent;         /**< Cached CPU usage percentage */
+        float cachedPercent;         /**< Last valid CPU usage percentage */
     } cpu;
     
     /** Memory monitoring state */
     struct {
-        float cachedPercent;         /**< Cached memory usage percentage */
+        float cachedPercent;         /**< Last valid memory usage percentage */
     } memory;
     
     /** Network monitoring state */
     NetworkState network;            /**< Network traffic monitoring state */
+
+    /** Per-core and watched-process CPU */
+    CoreState cores;
+    ProcessState process;
+    
+    /** Smoothers and their last outputs (published values) */
+    struct {
+        LONG seenGeneration;         /**< g_demand.smoothingGeneration last applied */
+        MetricSmoother cpu;
+        MetricSmoother memory;
+        MetricSmoother up;
+        MetricSmoother down;
+        MetricSmoother process;
+        MetricSmoother cores[SYSTEM_MONITOR_MAX_CORES];
+        float cpuPercent;            /**< Last smoothed CPU, kept while CPU has no fresh reading */
+        float corePercent[SYSTEM_MONITOR_MAX_CORES];
+    } smoothing;
     
     /** Refresh control */
-    DWORD updateIntervalMs;          /**< Minimum milliseconds between refreshes */
-    DWORD lastUpdateTick;            /**< Timestamp of last cache update */
+    volatile LONG updateIntervalMs;  /**< Milliseconds between samples */
 } SystemMonitorState;
 
+/**
+ * @brief Sampler thread and snapshot publication
+ * 
+ * The snapshot is guarded by a seqlock: the sequence is odd while the
+ * sampler copies a new snapshot in and even otherwise. A reader retries
+ * only if it overlapped that copy, which is a handful of stores.
+ */
+typedef struct {
+    HANDLE thread;                   /**< Sampler thread, NULL when stopped */
+    HANDLE wakeEvent;                /**< Auto-reset: sample now (refresh, interval change, stop) */
+    volatile LONG stop;              /**< Asks the sampler to exit */
+    volatile LONG subscribers;       /**< Outstanding SystemMonitor_Subscribe calls */
+    volatile LONG sequence;          /**< Seqlock sequence, 0 = nothing published */
+    SystemMetricsSnapshot snapshot;  /**< Last published sample */
+    MetricHistory history[SYSTEM_SERIES_COUNT];  /**< Updated in the same seqlock window */
+    SystemSamplingStats stats;       /**< Updated in the same seqlock window */
+    volatile LONG currentIntervalMs; /**< Interval the sampler is waiting with */
+    ULONGLONG startedMs;             /**< When the running sampler started, 0 = stopped */
+    ULONGLONG activeMsBefore;        /**< Run time of earlier sampler threads */
+    double cpuMsBefore;              /**< CPU time of earlier sampler threads */
+} SamplerState;
+
+/**
+ * @brief Who needs metrics and how fast, set from the UI thread
+ * 
+ * Read by the sampler before each wait; every change wakes it so a new
+ * rate takes effect at once. Smoothing settings are copied by the sampler
+ * when it sees a new generation.
+ */
+typedef struct {
+    volatile LONG consumers;         /**< SYSTEM_CONSUMER_* bits */
+    volatile LONG trayVisible;       /**< Display on; tooltip-only sampling pauses otherwise */
+    volatile LONG fastIntervalMs;
+    volatile LONG idleIntervalMs;
+    volatile LONG smoothingMode[SYSTEM_METRIC_COUNT];
+    volatile LONG smoothingParam[SYSTEM_METRIC_COUNT];
+    volatile LONG smoothingGeneration;
+} DemandState;
+
+/**
+ * @brief Watched-process request from the UI thread
+ * 
+ * The sampler copies the name when it sees a new generation, so the lock
+ * is taken only when the request changes.
+ */
+typedef struct {
+    CRITICAL_SECTION lock;
+    BOOL lockInitialized;
+    wchar_t exeName[MAX_PATH];
+    volatile LONG generation;
+} WatchRequest;
+
 /* ============================================================================
  * Global State
  * ============================================================================ */
@@ -94,6 +255,22 @@ static volatile LONG g_initialized = 0;
 /** @brief Unified monitoring state structure */
 static SystemMonitorState g_state = {0};
 
+/** @brief Sampler thread and published snapshot */
+static SamplerState g_sampler = {0};
+
+/** @brief Process to watch, survives Shutdown/Init */
+static WatchRequest g_watch = {0};
+
+/** @brief Consumers, adaptive intervals and smoothing, survive Shutdown/Init */
+static DemandState g_demand = {
+    .trayVisible = 1,
+    .fastIntervalMs = DEFAULT_FAST_INTERVAL_MS,
+    .idleIntervalMs = DEFAULT_IDLE_INTERVAL_MS,
+    .smoothingMode = {[SYSTEM_METRIC_CPU] = METRIC_SMOOTHING_EWMA},
+    .smoothingParam = {[SYSTEM_METRIC_CPU] = DEFAULT_CPU_SMOOTHING_MS},
+    .smoothingGeneration = 1
+};
+
 /* ============================================================================
  * Helper Functions - Utility
  * ============================================================================ */
@@ -121,32 +298,6 @@ static inline float ClampPercent(double value) {
     return (float)value;
 }
 
-/**
- * @brief Calculate delta between two 32-bit counter values with overflow handling
- * 
- * Network interface counters are 32-bit and can overflow. This function
- * correctly handles the overflow case by detecting when current < previous.
- * 
- * @param current Current counter value
- * @param previous Previous counter value
- * @return Delta between samples, accounting for potential overflow
- */
-static inline ULONGLONG CalculateDelta64(ULONGLONG current, ULONGLONG previous) {
-    return (current >= previous) 
-        ? (current - previous)
-        : (COUNTER_MAX_32BIT - previous + current);
-}
-
-/**
- * @brief Check if cache refresh is needed based on time interval
- * @return TRUE if cache is stale and needs refresh
- */
-static inline BOOL ShouldRefresh(void) {
-    DWORD now = GetTickCount();
-    return (g_state.lastUpdateTick == 0) || 
-           ((now - g_state.lastUpdateTick) >= g_state.updateIntervalMs);
-}
-
 /* ============================================================================
  * Helper Functions - Sampling
  * ============================================================================ */
@@ -233,88 +384,396 @@ static BOOL SampleMemoryUsage(float* outPercent) {
 }
 
 /**
- * @brief Sample network interface counters and calculate speed
+ * @brief Sample per-core CPU usage from processor performance counters
  * 
- * Aggregates traffic across all non-loopback interfaces and calculates
- * upload/download speeds in bytes per second. First call establishes
- * baseline; subsequent calls return speed deltas.
+ * Same busy/total calculation as SampleCpuUsage, per processor. First call
+ * (or a change in processor count) establishes baseline and returns FALSE.
  */
-static void SampleNetworkSpeed(void) {
-    /** Query required buffer size */
-    DWORD size = 0;
-    DWORD ret = GetIfTable(NULL, &size, TRUE);
-    if (ret != ERROR_INSUFFICIENT_BUFFER) {
-        return;
+static BOOL SampleCoreUsage(void) {
+    CoreState* cores = &g_state.cores;
+    if (!cores->queryResolved) {
+        cores->queryResolved = TRUE;
+        HMODULE ntdll = GetModuleHandleW(L"ntdll.dll");
+        if (ntdll) {
+            cores->query = (NtQuerySystemInformationFn)(void*)GetProcAddress(ntdll, "NtQuerySystemInformation");
+        }
     }
-    
-    /** Allocate buffer and retrieve interface table */
-    MIB_IFTABLE* pTable = (MIB_IFTABLE*)malloc(size);
-    if (!pTable) return;
-    
-    ret = GetIfTable(pTable, &size, TRUE);
-    if (ret != NO_ERROR) {
-        goto cleanup;
+    if (!cores->query) return FALSE;
+
+    ULONG returned = 0;
+    LONG status = cores->query(SYSTEM_PROCESSOR_PERFORMANCE_INFO_CLASS, cores->current,
+                               (ULONG)sizeof(cores->current), &returned);
+    if (status < 0) return FALSE;
+
+    int count = (int)(returned / sizeof(ProcessorPerformanceInfo));
+    if (count <= 0) return FALSE;
+    if (count > SYSTEM_MONITOR_MAX_CORES) count = SYSTEM_MONITOR_MAX_CORES;
+
+    BOOL computed = FALSE;
+    if (cores->coreCount == count) {
+        for (int i = 0; i < count; ++i) {
+            const ProcessorPerformanceInfo* now = &cores->current[i];
+            const ProcessorPerformanceInfo* prev = &cores->previous[i];
+            ULONGLONG idleDelta = (ULONGLONG)(now->idleTime.QuadPart - prev->idleTime.QuadPart);
+            ULONGLONG totalDelta = (ULONGLONG)(now->kernelTime.QuadPart - prev->kernelTime.QuadPart) +
+                                   (ULONGLONG)(now->userTime.QuadPart - prev->userTime.QuadPart);
+            cores->cachedPercent[i] = (totalDelta == 0) ? 0.0f
+                : ClampPercent((double)(totalDelta - idleDelta) * 100.0 / (double)totalDelta);
+        }
+        cores->cachedCount = count;
+        computed = TRUE;
     }
 
-    /** Aggregate counters across all non-loopback interfaces */
-    ULONGLONG inSum = 0;
-    ULONGLONG outSum = 0;
-    for (DWORD i = 0; i < pTable->dwNumEntries; ++i) {
-        const MIB_IFROW* row = &pTable->table[i];
-        if (row->dwType == IF_TYPE_SOFTWARE_LOOPBACK) continue;
-        inSum += (ULONGLONG)row->dwInOctets;
-        outSum += (ULONGLONG)row->dwOutOctets;
+    memcpy(cores->previous, cores->current, (size_t)count * sizeof(ProcessorPerformanceInfo));
+    cores->coreCount = count;
+    return computed;
+}
+
+/** @brief Close the watched process handle and forget its baseline */
+static void CloseWatchedProcess(void) {
+    ProcessState* proc = &g_state.process;
+    if (proc->handle) {
+        CloseHandle(proc->handle);
+        proc->handle = NULL;
     }
+    proc->hasBaseline = FALSE;
+    proc->valid = FALSE;
+    proc->cachedPercent = 0.0f;
+}
 
-    DWORD now = GetTickCount();
-    
-    /** First sample: establish baseline */
-    if (!g_state.network.hasBaseline) {
-        g_state.network.lastInOctets = inSum;
-        g_state.network.lastOutOctets = outSum;
-        g_state.network.lastTick = now;
-        g_state.network.hasBaseline = TRUE;
-        goto cleanup;
+/**
+ * @brief Open the first running process whose executable matches exeName
+ * @return Handle with query rights, or NULL if none is running
+ */
+static HANDLE OpenProcessByExeName(const wchar_t* exeName) {
+    HANDLE snapshot = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
+    if (snapshot == INVALID_HANDLE_VALUE) return NULL;
+
+    HANDLE found = NULL;
+    PROCESSENTRY32W entry;
+    entry.dwSize = sizeof(entry);
+    if (Process32FirstW(snapshot, &entry)) {
+        do {
+            if (_wcsicmp(entry.szExeFile, exeName) == 0) {
+                found = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION | SYNCHRONIZE, FALSE, entry.th32ProcessID);
+                if (found) break;
+            }
+        } while (Process32NextW(snapshot, &entry));
     }
+    CloseHandle(snapshot);
+    return found;
+}
 
-    /** Calculate speed from delta */
-    DWORD elapsedMs = (now >= g_state.network.lastTick) ? 
-                      (now - g_state.network.lastTick) : 0;
-    
-    if (elapsedMs > 0) {
-        ULONGLONG din = CalculateDelta64(inSum, g_state.network.lastInOctets);
-        ULONGLONG dout = CalculateDelta64(outSum, g_state.network.lastOutOctets);
-        
-        double seconds = (double)elapsedMs / 1000.0;
-        g_state.network.cachedDownBps = (float)((double)din / seconds);
-        g_state.network.cachedUpBps = (float)((double)dout / seconds);
+/**
+ * @brief Sample the watched process's CPU share of the whole machine
+ * 
+ * Picks up a changed watch request, reopens the process when it exits (at
+ * most every PROCESS_RESOLVE_INTERVAL_MS) and computes kernel+user time
+ * over wall time across all processors.
+ */
+static void SampleProcessUsage(void) {
+    ProcessState* proc = &g_state.process;
+
+    LONG generation = g_watch.generation;
+    if (generation != proc->seenGeneration) {
+        proc->seenGeneration = generation;
+        EnterCriticalSection(&g_watch.lock);
+        wcsncpy_s(proc->exeName, MAX_PATH, g_watch.exeName, _TRUNCATE);
+        LeaveCriticalSection(&g_watch.lock);
+        CloseWatchedProcess();
+        proc->lastResolveMs = 0;
     }
+    if (!proc->exeName[0]) return;
 
-    /** Update baseline for next sample */
-    g_state.network.lastInOctets = inSum;
-    g_state.network.lastOutOctets = outSum;
-    g_state.network.lastTick = now;
+    ULONGLONG nowMs = GetTickCount64();
+    if (proc->handle && WaitForSingleObject(proc->handle, 0) == WAIT_OBJECT_0) {
+        CloseWatchedProcess();  /** Exited */
+    }
+    if (!proc->handle) {
+        if (proc->lastResolveMs != 0 && nowMs - proc->lastResolveMs < PROCESS_RESOLVE_INTERVAL_MS) return;
+        proc->lastResolveMs = nowMs;
+        proc->handle = OpenProcessByExeName(proc->exeName);
+        if (!proc->handle) return;
+    }
+
+    FILETIME created, exited, kernel, user;
+    if (!GetProcessTimes(proc->handle, &created, &exited, &kernel, &user)) {
+        CloseWatchedProcess();
+        return;
+    }
+    ULONGLONG cpuTime = FileTimeToUll(&kernel) + FileTimeToUll(&user);
 
-cleanup:
-    free(pTable);
+    if (proc->hasBaseline && nowMs > proc->lastWallMs) {
+        DWORD processors = (g_state.cores.coreCount > 0) ? (DWORD)g_state.cores.coreCount
+                                                        : GetActiveProcessorCount(ALL_PROCESSOR_GROUPS);
+        if (processors == 0) processors = 1;
+        double wall100ns = (double)(nowMs - proc->lastWallMs) * 10000.0 * processors;
+        proc->cachedPercent = ClampPercent((double)(cpuTime - proc->lastCpuTime) * 100.0 / wall100ns);
+        proc->valid = TRUE;
+    }
+    proc->lastCpuTime = cpuTime;
+    proc->lastWallMs = nowMs;
+    proc->hasBaseline = TRUE;
 }
 
 /**
- * @brief Refresh all cached metrics if refresh interval has elapsed
+ * @brief Whether an interface carries traffic worth counting
  * 
- * Checks if cache is stale and updates CPU, memory, and network metrics
- * if needed. This centralized refresh logic is called by all getter functions.
+ * Loopback is excluded. Filter interfaces (lightweight filters
+ * stacked on a physical adapter) are excluded too: GetIfTable2 lists them
+ * alongside the adapter and their counters would count the traffic twice.
+ * Interfaces that are not up carry no traffic; one that comes up later
+ * raises an interface change and is picked up then.
  */
-static void RefreshCacheIfNeeded(void) {
-    if (!ShouldRefresh()) {
+static BOOL IsCountedInterface(const MIB_IF_ROW2* row) {
+    if (row->Type == IF_TYPE_SOFTWARE_LOOPBACK) return FALSE;
+    if (row->InterfaceAndOperStatusFlags.FilterInterface) return FALSE;
+    if (row->OperStatus != IfOperStatusUp) return FALSE;
+    return TRUE;
+}
+
+/**
+ * @brief Interface change callback (runs on a system worker thread)
+ */
+static VOID WINAPI OnIpInterfaceChange(PVOID context, PMIB_IPINTERFACE_ROW row, MIB_NOTIFICATION_TYPE type) {
+    (void)context;
+    (void)row;
+    (void)type;
+    InterlockedExchange(&g_state.network.interfacesChanged, 1);
+}
+
+/** @brief Grow the index and sample buffers to hold count interfaces */
+static BOOL EnsureNetworkCapacity(NetworkState* net, ULONG count) {
+    if (count <= net->capacity) return TRUE;
+    NET_IFINDEX* indices = (NET_IFINDEX*)realloc(net->indices, count * sizeof(NET_IFINDEX));
+    if (!indices) return FALSE;
+    net->indices = indices;
+    NetRateSample* samples = (NetRateSample*)realloc(net->samples, count * sizeof(NetRateSample));
+    if (!samples) return FALSE;
+    net->samples = samples;
+    net->capacity = count;
+    return TRUE;
+}
+
+/** @brief Free the interface buffers and the rate baseline */
+static void ReleaseNetworkState(NetworkState* net) {
+    free(net->indices);
+    net->indices = NULL;
+    free(net->samples);
+    net->samples = NULL;
+    net->capacity = 0;
+    net->indexCount = 0;
+    net->enumerated = FALSE;
+    NetRate_Release(&net->rate);
+}
+
+/**
+ * @brief Rebuild the cached list of interfaces to sample
+ * 
+ * The only place the full interface table is fetched; ordinary samples
+ * query the cached indices one row at a time.
+ */
+static void EnumerateNetworkInterfaces(void) {
+    InterlockedExchange(&g_state.network.interfacesChanged, 0);
+    g_state.network.samplesSinceEnumerate = 0;
+    g_state.network.indexCount = 0;
+    g_state.network.enumerated = FALSE;
+
+    MIB_IF_TABLE2* table = NULL;
+    if (GetIfTable2(&table) != NO_ERROR || !table) {
         return;
     }
 
+    if (!EnsureNetworkCapacity(&g_state.network, table->NumEntries)) {
+        FreeMibTable(table);
+        return;
+    }
+
+    for (ULONG i = 0; i < table->NumEntries; ++i) {
+        const MIB_IF_ROW2* row = &table->Table[i];
+        if (!IsCountedInterface(row)) continue;
+        g_state.network.indices[g_state.network.indexCount++] = row->InterfaceIndex;
+    }
+    FreeMibTable(table);
+
+    g_state.network.enumerated = TRUE;
+}
+
+/** @brief Start listening for interface changes (sampler thread) */
+static void RegisterInterfaceChangeNotify(void) {
+    if (g_state.network.changeNotify) return;
+    HANDLE handle = NULL;
+    if (NotifyIpInterfaceChange(AF_UNSPEC, OnIpInterfaceChange, NULL, FALSE, &handle) == NO_ERROR) {
+        g_state.network.changeNotify = handle;
+    }
+}
+
+/** @brief Stop listening for interface changes; waits for a running callback */
+static void UnregisterInterfaceChangeNotify(void) {
+    if (!g_state.network.changeNotify) return;
+    CancelMibChangeNotify2(g_state.network.changeNotify);
+    g_state.network.changeNotify = NULL;
+}
+
+/**
+ * @brief Sample network interface counters and calculate speed
+ * 
+ * Reads the 64-bit counters of the cached interfaces and hands them to
+ * NetRate, which takes per-interface deltas; an interface that disappears
+ * or resets contributes nothing rather than a bogus spike. First call
+ * establishes baseline; subsequent calls return speed deltas.
+ */
+static void SampleNetworkSpeed(void) {
+    NetworkState* net = &g_state.network;
+
+    BOOL fallbackDue = !net->changeNotify &&
+                       ++net->samplesSinceEnumerate >= NETWORK_REENUMERATE_FALLBACK_SAMPLES;
+    if (!net->enumerated || net->interfacesChanged || fallbackDue) {
+        EnumerateNetworkInterfaces();
+        if (!net->enumerated) return;
+    }
+
+    size_t count = 0;
+    for (int i = 0; i < net->indexCount; ++i) {
+        ZeroMemory(&net->row, sizeof(net->row));
+        net->row.InterfaceIndex = net->indices[i];
+        if (GetIfEntry2(&net->row) != NO_ERROR) {
+            /** Interface went away between notifications: re-enumerate next time */
+            InterlockedExchange(&net->interfacesChanged, 1);
+            continue;
+        }
+        net->samples[count].id = (uint32_t)net->row.InterfaceIndex;
+        net->samples[count].inOctets = net->row.InOctets;
+        net->samples[count].outOctets = net->row.OutOctets;
+        ++count;
+    }
+
+    double up = 0.0, down = 0.0;
+    if (NetRate_Update(&net->rate, net->samples, count, GetTickCount64(), &up, &down)) {
+        net->cachedUpBps = (float)up;
+        net->cachedDownBps = (float)down;
+    }
+}
+
+/* ============================================================================
+ * Helper Functions - Publication
+ * ============================================================================ */
+
+/** @brief Kernel + user time of a thread in milliseconds */
+static double ThreadCpuMs(HANDLE thread) {
+    FILETIME created, exited, kernel, user;
+    if (!GetThreadTimes(thread, &created, &exited, &kernel, &user)) return 0.0;
+    ULARGE_INTEGER k, u;
+    k.LowPart = kernel.dwLowDateTime;
+    k.HighPart = kernel.dwHighDateTime;
+    u.LowPart = user.dwLowDateTime;
+    u.HighPart = user.dwHighDateTime;
+    return (double)(k.QuadPart + u.QuadPart) / 10000.0;
+}
+
+static void ConfigureSmoother(MetricSmoother* smoother, SystemMetricKind metric) {
+    MetricSmoother_Configure(smoother, (MetricSmoothingMode)g_demand.smoothingMode[metric],
+                             (uint32_t)g_demand.smoothingParam[metric]);
+}
+
+/** @brief Pick up a new smoothing configuration (sampler thread) */
+static void ApplySmoothingRequest(void) {
+    LONG generation = InterlockedCompareExchange(&g_demand.smoothingGeneration, 0, 0);
+    if (generation == g_state.smoothing.seenGeneration) return;
+    g_state.smoothing.seenGeneration = generation;
+
+    ConfigureSmoother(&g_state.smoothing.cpu, SYSTEM_METRIC_CPU);
+    ConfigureSmoother(&g_state.smoothing.memory, SYSTEM_METRIC_MEMORY);
+    ConfigureSmoother(&g_state.smoothing.up, SYSTEM_METRIC_NETWORK);
+    ConfigureSmoother(&g_state.smoothing.down, SYSTEM_METRIC_NETWORK);
+    ConfigureSmoother(&g_state.smoothing.process, SYSTEM_METRIC_PROCESS);
+    for (int i = 0; i < SYSTEM_MONITOR_MAX_CORES; ++i) {
+        ConfigureSmoother(&g_state.smoothing.cores[i], SYSTEM_METRIC_CORES);
+    }
+}
+
+/**
+ * @brief Replace raw readings in snap with smoothed values
+ * 
+ * CPU and cores only advance on fresh readings; otherwise the previous
+ * smoothed value is republished, as the raw path does with its cache.
+ */
+static void SmoothSnapshot(SystemMetricsSnapshot* snap, BOOL cpuFresh, BOOL coresFresh) {
+    ULONGLONG now = snap->timestampMs;
+    ApplySmoothingRequest();
+
+    if (cpuFresh) {
+        g_state.smoothing.cpuPercent = MetricSmoother_Apply(&g_state.smoothing.cpu, snap->cpuPercent, now);
+    }
+    snap->cpuPercent = g_state.smoothing.cpuPercent;
+
+    if (coresFresh) {
+        for (int i = 0; i < snap->coreCount; ++i) {
+            g_state.smoothing.corePercent[i] =
+                MetricSmoother_Apply(&g_state.smoothing.cores[i], snap->corePercent[i], now);
+        }
+    }
+    memcpy(snap->corePercent, g_state.smoothing.corePercent, sizeof(snap->corePercent));
+
+    snap->memPercent = MetricSmoother_Apply(&g_state.smoothing.memory, snap->memPercent, now);
+    snap->upBytesPerSec = MetricSmoother_Apply(&g_state.smoothing.up, snap->upBytesPerSec, now);
+    snap->downBytesPerSec = MetricSmoother_Apply(&g_state.smoothing.down, snap->downBytesPerSec, now);
+
+    if (snap->processValid) {
+        snap->processPercent = MetricSmoother_Apply(&g_state.smoothing.process, snap->processPercent, now);
+    } else {
+        MetricSmoother_Reset(&g_state.smoothing.process);   /** Next match is a different process */
+    }
+}
+
+/**
+ * @brief Publish a snapshot and extend the histories under the seqlock (single writer)
+ * @param snap Smoothed values, as getters return them
+ * @param raw Unsmoothed readings, which the histories keep so graphs still show spikes
+ * @param cpuFresh Whether snap carries a new CPU reading (not just a baseline)
+ * @param coresFresh Whether snap carries new per-core readings
+ * @param sampleMs Wall time the sample took
+ */
+static void PublishSnapshot(const SystemMetricsSnapshot* snap, const SystemMetricsSnapshot* raw,
+                            BOOL cpuFresh, BOOL coresFresh, double sampleMs) {
+    BOOL onSampler = g_sampler.thread && GetCurrentThreadId() == GetThreadId(g_sampler.thread);
+    double samplerCpuMs = g_sampler.cpuMsBefore + (onSampler ? ThreadCpuMs(GetCurrentThread()) : 0.0);
+
+    InterlockedIncrement(&g_sampler.sequence);      /** Odd: copy in progress */
+    g_sampler.snapshot = *snap;
+    if (cpuFresh) MetricHistory_Push(&g_sampler.history[SYSTEM_SERIES_CPU], raw->cpuPercent);
+    MetricHistory_Push(&g_sampler.history[SYSTEM_SERIES_MEMORY], raw->memPercent);
+    if (raw->processValid) MetricHistory_Push(&g_sampler.history[SYSTEM_SERIES_PROCESS], raw->processPercent);
+    if (coresFresh) {
+        for (int i = 0; i < raw->coreCount; ++i) {
+            MetricHistory_Push(&g_sampler.history[SYSTEM_SERIES_CORE_FIRST + i], raw->corePercent[i]);
+        }
+    }
+    g_sampler.stats.samples++;
+    g_sampler.stats.sampleWallMs += sampleMs;
+    if (onSampler) g_sampler.stats.samplerCpuMs = samplerCpuMs;
+    InterlockedIncrement(&g_sampler.sequence);      /** Even: snapshot stable */
+}
+
+/**
+ * @brief Take one sample of every metric and publish it
+ * 
+ * CPU (system, per-core, process) keeps its previous value while the first
+ * sample only establishes a baseline; memory is valid from the first sample.
+ */
+static void SampleAndPublish(void) {
+    LARGE_INTEGER freq, start, end;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&start);
+
     /** Sample CPU (may return FALSE on first call while establishing baseline) */
     float cpuTmp = 0.0f;
-    if (SampleCpuUsage(&cpuTmp)) {
+    BOOL cpuFresh = SampleCpuUsage(&cpuTmp);
+    if (cpuFresh) {
         g_state.cpu.cachedPercent = cpuTmp;
     }
+    BOOL coresFresh = SampleCoreUsage();
+    SampleProcessUsage();
 
     /** Sample memory */
     float memTmp = 0.0f;
@@ -325,31 +784,138 @@ static void RefreshCacheIfNeeded(void) {
     /** Sample network speed */
     SampleNetworkSpeed();
 
-    /** Update timestamp */
-    g_state.lastUpdateTick = GetTickCount();
+    SystemMetricsSnapshot snap;
+    snap.cpuPercent = g_state.cpu.cachedPercent;
+    snap.memPercent = g_state.memory.cachedPercent;
+    snap.upBytesPerSec = g_state.network.cachedUpBps;
+    snap.downBytesPerSec = g_state.network.cachedDownBps;
+    snap.coreCount = g_state.cores.cachedCount;
+    memcpy(snap.corePercent, g_state.cores.cachedPercent, sizeof(snap.corePercent));
+    snap.processPercent = g_state.process.cachedPercent;
+    snap.processValid = g_state.process.valid;
+    snap.timestampMs = GetTickCount64();
+
+    SystemMetricsSnapshot raw = snap;
+    SmoothSnapshot(&snap, cpuFresh, coresFresh);
+
+    QueryPerformanceCounter(&end);
+    double sampleMs = (double)(end.QuadPart - start.QuadPart) * 1000.0 / (double)freq.QuadPart;
+    PublishSnapshot(&snap, &raw, cpuFresh, coresFresh, sampleMs);
+}
+
+/**
+ * @brief Copy the latest snapshot; never blocks on the sampler
+ * @return FALSE if nothing has been published yet (out is then all zero)
+ */
+static BOOL ReadSnapshot(SystemMetricsSnapshot* out) {
+    for (;;) {
+        LONG before = InterlockedCompareExchange(&g_sampler.sequence, 0, 0);
+        if (before & 1) {
+            YieldProcessor();
+            continue;
+        }
+        *out = g_sampler.snapshot;
+        MemoryBarrier();
+        if (g_sampler.sequence == before) {
+            return before != 0;
+        }
+    }
 }
 
 /* ============================================================================
- * Parameter Validation Macro
+ * Helper Functions - Sampler Thread
  * ============================================================================ */
 
 /**
- * @brief Validate parameters and ensure module is initialized and refreshed
- * 
- * This macro eliminates code duplication across all getter functions by
- * consolidating:
- * 1. NULL pointer validation
- * 2. Automatic initialization if needed
- * 3. Cache refresh check
+ * @brief Interval for the most demanding active consumer
+ * @return Milliseconds, or INFINITE when only the tooltip needs metrics and
+ *         the tray cannot be seen
+ */
+static DWORD CurrentSamplingInterval(void) {
+    LONG consumers = g_demand.consumers;
+    if (consumers & SYSTEM_CONSUMER_ANIMATION) return (DWORD)g_demand.fastIntervalMs;
+    if (consumers & (SYSTEM_CONSUMER_ICON | SYSTEM_CONSUMER_EXPORT)) return (DWORD)g_state.updateIntervalMs;
+    if (consumers & SYSTEM_CONSUMER_TOOLTIP) {
+        return g_demand.trayVisible ? (DWORD)g_demand.idleIntervalMs : INFINITE;
+    }
+    return (DWORD)g_state.updateIntervalMs;     /** Subscribed without declaring a consumer */
+}
+
+/**
+ * @brief Sample, publish, then sleep for the current interval or until woken
  * 
- * Usage: VALIDATE_AND_REFRESH(param) at start of getter functions
+ * Any wake (refresh, consumer or interval change, stop) takes a sample, so
+ * a paused sampler answers ForceRefresh and resumes at once.
  */
-#define VALIDATE_AND_REFRESH(param) \
-    do { \
-        if (!(param)) return FALSE; \
-        if (g_initialized == 0) SystemMonitor_Init(); \
-        RefreshCacheIfNeeded(); \
-    } while(0)
+static DWORD WINAPI SamplerThreadProc(LPVOID param) {
+    (void)param;
+    RegisterInterfaceChangeNotify();
+    while (!g_sampler.stop) {
+        SampleAndPublish();
+        DWORD interval = CurrentSamplingInterval();
+        InterlockedExchange(&g_sampler.currentIntervalMs, (LONG)interval);
+        WaitForSingleObject(g_sampler.wakeEvent, interval);
+    }
+    UnregisterInterfaceChangeNotify();
+    return 0;
+}
+
+static void CloseSamplerEvents(void) {
+    if (g_sampler.wakeEvent) {
+        CloseHandle(g_sampler.wakeEvent);
+        g_sampler.wakeEvent = NULL;
+    }
+}
+
+/** @brief Start the sampler thread (first subscriber) */
+static void StartSampler(void) {
+    InterlockedExchange(&g_sampler.stop, 0);
+    if (g_sampler.thread) {
+        /** A previous stop timed out; that thread simply carries on */
+        SetEvent(g_sampler.wakeEvent);
+        return;
+    }
+
+    g_sampler.wakeEvent = CreateEventW(NULL, FALSE, FALSE, NULL);
+    if (g_sampler.wakeEvent) {
+        g_sampler.thread = CreateThread(NULL, 0, SamplerThreadProc, NULL, 0, NULL);
+    }
+    if (!g_sampler.thread) {
+        CloseSamplerEvents();
+        return;
+    }
+    g_sampler.startedMs = GetTickCount64();
+}
+
+/** @brief Log what sampling has cost so far, per hour of sampler run time */
+static void LogSamplingCost(void) {
+    SystemSamplingStats stats;
+    if (!SystemMonitor_GetSamplingStats(&stats) || stats.activeMs == 0) return;
+    double hours = (double)stats.activeMs / 3600000.0;
+    WriteLog(LOG_LEVEL_DEBUG, "System monitor: %llu samples in %.1f s, %.1f ms CPU (%.1f ms CPU/h, %.0f samples/h)",
+             stats.samples, stats.activeMs / 1000.0, stats.samplerCpuMs,
+             stats.samplerCpuMs / hours, (double)stats.samples / hours);
+}
+
+/** @brief Stop the sampler thread (last subscriber gone, or shutdown) */
+static void StopSampler(void) {
+    if (!g_sampler.thread) return;
+
+    InterlockedExchange(&g_sampler.stop, 1);
+    SetEvent(g_sampler.wakeEvent);
+    if (WaitForSingleObject(g_sampler.thread, SAMPLER_JOIN_TIMEOUT_MS) != WAIT_OBJECT_0) {
+        /** Stuck in a system call: keep the handles so it exits (or is reused) cleanly */
+        return;
+    }
+    g_sampler.cpuMsBefore += ThreadCpuMs(g_sampler.thread);
+    g_sampler.activeMsBefore += GetTickCount64() - g_sampler.startedMs;
+    g_sampler.startedMs = 0;
+    InterlockedExchange(&g_sampler.currentIntervalMs, 0);
+    LogSamplingCost();
+    CloseHandle(g_sampler.thread);
+    g_sampler.thread = NULL;
+    CloseSamplerEvents();
+}
 
 /* ============================================================================
  * Public API Implementation
@@ -369,45 +935,196 @@ void SystemMonitor_Init(void) {
 }
 
 void SystemMonitor_Shutdown(void) {
+    StopSampler();
+    if (g_sampler.thread) return;   /** Sampler stuck; leave its state alone */
+    CloseWatchedProcess();
+    InterlockedExchange(&g_sampler.subscribers, 0);
+    InterlockedExchange(&g_sampler.sequence, 0);
+    ZeroMemory(&g_sampler.snapshot, sizeof(g_sampler.snapshot));
+    ZeroMemory(g_sampler.history, sizeof(g_sampler.history));
+    ZeroMemory(&g_sampler.stats, sizeof(g_sampler.stats));
+    g_sampler.activeMsBefore = 0;
+    g_sampler.cpuMsBefore = 0.0;
     InterlockedExchange(&g_initialized, 0);
+    ReleaseNetworkState(&g_state.network);
     ZeroMemory(&g_state, sizeof(g_state));
 }
 
+void SystemMonitor_Subscribe(void) {
+    if (g_initialized == 0) SystemMonitor_Init();
+    if (InterlockedIncrement(&g_sampler.subscribers) == 1) {
+        StartSampler();
+    }
+}
+
+void SystemMonitor_Unsubscribe(void) {
+    LONG remaining = InterlockedDecrement(&g_sampler.subscribers);
+    if (remaining < 0) {
+        InterlockedExchange(&g_sampler.subscribers, 0);  /** Unbalanced call */
+        return;
+    }
+    if (remaining == 0) {
+        StopSampler();
+    }
+}
+
 void SystemMonitor_SetUpdateIntervalMs(DWORD intervalMs) {
-    g_state.updateIntervalMs = (intervalMs == 0) ? DEFAULT_UPDATE_INTERVAL_MS : intervalMs;
+    InterlockedExchange(&g_state.updateIntervalMs,
+                        (LONG)((intervalMs == 0) ? DEFAULT_UPDATE_INTERVAL_MS : intervalMs));
+    if (g_sampler.thread) SetEvent(g_sampler.wakeEvent);
+}
+
+/** @brief Wake the sampler so a changed rate or setting applies now */
+static void WakeSampler(void) {
+    if (g_sampler.thread) SetEvent(g_sampler.wakeEvent);
+}
+
+static LONG ClampAdaptiveInterval(DWORD ms) {
+    if (ms < MIN_ADAPTIVE_INTERVAL_MS) ms = MIN_ADAPTIVE_INTERVAL_MS;
+    if (ms > 600000) ms = 600000;
+    return (LONG)ms;
+}
+
+void SystemMonitor_SetConsumer(SystemMonitorConsumer consumer, BOOL active) {
+    LONG previous = active ? InterlockedOr(&g_demand.consumers, (LONG)consumer)
+                           : InterlockedAnd(&g_demand.consumers, ~(LONG)consumer);
+    BOOL wasActive = (previous & (LONG)consumer) != 0;
+    if (wasActive != (active != FALSE)) WakeSampler();
+}
+
+void SystemMonitor_SetTrayVisible(BOOL visible) {
+    if (InterlockedExchange(&g_demand.trayVisible, visible ? 1 : 0) != (visible ? 1 : 0)) {
+        WakeSampler();
+    }
+}
+
+void SystemMonitor_SetAdaptiveIntervals(DWORD fastMs, DWORD idleMs) {
+    LONG fast = fastMs ? ClampAdaptiveInterval(fastMs) : DEFAULT_FAST_INTERVAL_MS;
+    LONG idle = idleMs ? ClampAdaptiveInterval(idleMs) : DEFAULT_IDLE_INTERVAL_MS;
+    BOOL changed = InterlockedExchange(&g_demand.fastIntervalMs, fast) != fast;
+    changed |= InterlockedExchange(&g_demand.idleIntervalMs, idle) != idle;
+    if (changed) WakeSampler();
+}
+
+DWORD SystemMonitor_GetFastIntervalMs(void) {
+    return (DWORD)g_demand.fastIntervalMs;
+}
+
+void SystemMonitor_SetSmoothing(SystemMetricKind metric, MetricSmoothingMode mode, DWORD param) {
+    if ((int)metric < 0 || metric >= SYSTEM_METRIC_COUNT) return;
+    /** Unchanged settings keep the smoother's state (config reloads repeat them) */
+    if (g_demand.smoothingMode[metric] == (LONG)mode && g_demand.smoothingParam[metric] == (LONG)param) return;
+    InterlockedExchange(&g_demand.smoothingMode[metric], (LONG)mode);
+    InterlockedExchange(&g_demand.smoothingParam[metric], (LONG)param);
+    InterlockedIncrement(&g_demand.smoothingGeneration);
+}
+
+void SystemMonitor_ResetSmoothing(SystemMetricKind metric) {
+    if (metric == SYSTEM_METRIC_CPU) {
+        SystemMonitor_SetSmoothing(metric, METRIC_SMOOTHING_EWMA, DEFAULT_CPU_SMOOTHING_MS);
+    } else {
+        SystemMonitor_SetSmoothing(metric, METRIC_SMOOTHING_NONE, 0);
+    }
 }
 
 void SystemMonitor_ForceRefresh(void) {
-    g_state.lastUpdateTick = 0;
-    RefreshCacheIfNeeded();
+    if (g_initialized == 0) SystemMonitor_Init();
+
+    if (g_sampler.thread) {
+        /** Ask the sampler for a sample now; callers read it on their next pass */
+        SetEvent(g_sampler.wakeEvent);
+    } else {
+        /** No sampler running, so nothing else owns the sampling state */
+        SampleAndPublish();
+    }
+}
+
+void SystemMonitor_WatchProcess(const wchar_t* exeName) {
+    if (!g_watch.lockInitialized) {
+        InitializeCriticalSection(&g_watch.lock);
+        g_watch.lockInitialized = TRUE;
+    }
+    EnterCriticalSection(&g_watch.lock);
+    const wchar_t* name = exeName ? exeName : L"";
+    BOOL changed = _wcsicmp(g_watch.exeName, name) != 0;
+    if (changed) {
+        wcsncpy_s(g_watch.exeName, MAX_PATH, name, _TRUNCATE);
+    }
+    LeaveCriticalSection(&g_watch.lock);
+    /** Re-applying the same name (config reload) keeps the resolved process and its history */
+    if (changed) InterlockedIncrement(&g_watch.generation);
+}
+
+int SystemMonitor_GetHistory(int series, float* out, int maxCount) {
+    if (!out || maxCount <= 0 || series < 0 || series >= SYSTEM_SERIES_COUNT) return 0;
+    for (;;) {
+        LONG before = InterlockedCompareExchange(&g_sampler.sequence, 0, 0);
+        if (before & 1) {
+            YieldProcessor();
+            continue;
+        }
+        size_t n = MetricHistory_CopyRecent(&g_sampler.history[series], out, (size_t)maxCount);
+        MemoryBarrier();
+        if (g_sampler.sequence == before) {
+            return (int)n;
+        }
+    }
+}
+
+BOOL SystemMonitor_GetSamplingStats(SystemSamplingStats* outStats) {
+    if (!outStats) return FALSE;
+    for (;;) {
+        LONG before = InterlockedCompareExchange(&g_sampler.sequence, 0, 0);
+        if (before & 1) {
+            YieldProcessor();
+            continue;
+        }
+        *outStats = g_sampler.stats;
+        MemoryBarrier();
+        if (g_sampler.sequence == before) break;
+    }
+    outStats->activeMs = g_sampler.activeMsBefore +
+                         (g_sampler.startedMs ? GetTickCount64() - g_sampler.startedMs : 0);
+    outStats->currentIntervalMs = (DWORD)g_sampler.currentIntervalMs;
+    if (!g_sampler.startedMs) outStats->samplerCpuMs = g_sampler.cpuMsBefore;  /** Includes the final stretch */
+    return TRUE;
+}
+
+BOOL SystemMonitor_GetSnapshot(SystemMetricsSnapshot* outSnapshot) {
+    if (!outSnapshot) return FALSE;
+    return ReadSnapshot(outSnapshot);
 }
 
 BOOL SystemMonitor_GetCpuUsage(float* outPercent) {
-    VALIDATE_AND_REFRESH(outPercent);
-    *outPercent = g_state.cpu.cachedPercent;
+    if (!outPercent) return FALSE;
+    SystemMetricsSnapshot snap;
+    ReadSnapshot(&snap);
+    *outPercent = snap.cpuPercent;
     return TRUE;
 }
 
 BOOL SystemMonitor_GetMemoryUsage(float* outPercent) {
-    VALIDATE_AND_REFRESH(outPercent);
-    *outPercent = g_state.memory.cachedPercent;
+    if (!outPercent) return FALSE;
+    SystemMetricsSnapshot snap;
+    ReadSnapshot(&snap);
+    *outPercent = snap.memPercent;
     return TRUE;
 }
 
 BOOL SystemMonitor_GetUsage(float* outCpuPercent, float* outMemPercent) {
-    VALIDATE_AND_REFRESH(outCpuPercent);
-    if (!outMemPercent) return FALSE;
-    
-    *outCpuPercent = g_state.cpu.cachedPercent;
-    *outMemPercent = g_state.memory.cachedPercent;
+    if (!outCpuPercent || !outMemPercent) return FALSE;
+    SystemMetricsSnapshot snap;
+    ReadSnapshot(&snap);
+    *outCpuPercent = snap.cpuPercent;
+    *outMemPercent = snap.memPercent;
     return TRUE;
 }
 
 BOOL SystemMonitor_GetNetSpeed(float* outUpBytesPerSec, float* outDownBytesPerSec) {
-    VALIDATE_AND_REFRESH(outUpBytesPerSec);
-    if (!outDownBytesPerSec) return FALSE;
-    
-    *outUpBytesPerSec = g_state.network.cachedUpBps;
-    *outDownBytesPerSec = g_state.network.cachedDownBps;
+    if (!outUpBytesPerSec || !outDownBytesPerSec) return FALSE;
+    SystemMetricsSnapshot snap;
+    ReadSnapshot(&snap);
+    *outUpBytesPerSec = snap.upBytesPerSec;
+    *outDownBytesPerSec = snap.downBytesPerSec;
     return TRUE;
 }
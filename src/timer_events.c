@@ -43,9 +43,6 @@
 /** @brief Retry interval in milliseconds */
 #define RETRY_INTERVAL_MS 1500
 
-/** @brief Font validation interval in milliseconds */
-#define FONT_CHECK_INTERVAL_MS 2000
-
 /** @brief Tail segment threshold (last N seconds for faster updates) */
 #define TAIL_SEGMENT_THRESHOLD_SECONDS 2
 
@@ -304,20 +301,6 @@ static BOOL IsActivePomodoroTimer(void) {
  * Timer Handlers - Specialized Functions
  * ============================================================================ */
 
-/**
- * @brief Handle font validation timer
- */
-static BOOL HandleFontValidation(HWND hwnd) {
-    extern BOOL CheckAndFixFontPath(void);
-    
-    if (CheckAndFixFontPath()) {
-        InvalidateRect(hwnd, NULL, TRUE);
-    }
-    
-    SetTimer(hwnd, TIMER_ID_FONT_VALIDATION, FONT_CHECK_INTERVAL_MS, NULL);
-    return TRUE;
-}
-
 /**
  * @brief Handle force redraw timer
  */
@@ -605,9 +588,6 @@ BOOL HandleTimerEvent(HWND hwnd, WPARAM wp) {
         case TIMER_ID_EDIT_MODE_REFRESH:
             return HandleForceRedraw(hwnd);
             
-        case TIMER_ID_FONT_VALIDATION:
-            return HandleFontValidation(hwnd);
-            
         case TIMER_ID_MAIN:
             return HandleMainTimer(hwnd);
             
@@ -19,6 +19,7 @@
 #include "../include/tray_animation.h"
 #include "../include/system_monitor.h"
 #include "../include/config.h"
+#include "../include/metrics_endpoint.h"
 
 /* ============================================================================
  * Constants
@@ -30,9 +31,6 @@
 /** @brief Tooltip update interval in milliseconds */
 #define TOOLTIP_UPDATE_INTERVAL_MS 1000
 
-/** @brief Percent icon warm-up delay for accurate initial reading */
-#define PERCENT_ICON_WARMUP_MS 120
-
 /* ============================================================================
  * Global Variables
  * ============================================================================ */
@@ -60,7 +58,8 @@ typedef enum {
     ANIM_TYPE_CUSTOM,      /**< User-defined animation (GIF/WebP/folder) */
     ANIM_TYPE_LOGO,        /**< Built-in application logo */
     ANIM_TYPE_CPU,         /**< CPU usage percentage icon */
-    ANIM_TYPE_MEMORY       /**< Memory usage percentage icon */
+    ANIM_TYPE_MEMORY,      /**< Memory usage percentage icon */
+    ANIM_TYPE_CPU_GRAPH    /**< CPU history sparkline or per-core bars */
 } AnimationType;
 
 /** @brief Formatted byte value with appropriate unit */
@@ -102,6 +101,8 @@ static AnimationType GetAnimationType(const char* animName) {
     if (_stricmp(animName, "__logo__") == 0) return ANIM_TYPE_LOGO;
     if (_stricmp(animName, "__cpu__") == 0) return ANIM_TYPE_CPU;
     if (_stricmp(animName, "__mem__") == 0) return ANIM_TYPE_MEMORY;
+    if (_stricmp(animName, "__cpuhist__") == 0) return ANIM_TYPE_CPU_GRAPH;
+    if (_stricmp(animName, "__cores__") == 0) return ANIM_TYPE_CPU_GRAPH;
     return ANIM_TYPE_CUSTOM;
 }
 
@@ -117,7 +118,7 @@ static inline BOOL IsPercentIcon(AnimationType type) {
 /**
  * @brief Check if animation is a built-in icon type
  * @param type Animation type
- * @return TRUE for logo, CPU, or memory icons
+ * @return TRUE for logo, CPU, memory or CPU graph icons
  */
 static inline BOOL IsBuiltinIcon(AnimationType type) {
     return type != ANIM_TYPE_CUSTOM;
@@ -152,25 +153,6 @@ static BOOL IsStaticImageFile(const char* filename) {
  * Helper Functions - System Metrics
  * ============================================================================ */
 
-/**
- * @brief Get system metrics with zero-value warm-up for percent icons
- * @param cpu Output CPU usage percentage
- * @param mem Output memory usage percentage
- */
-static void GetSystemMetricsWithWarmup(float* cpu, float* mem) {
-    SystemMonitor_GetUsage(cpu, mem);
-    
-    /* Force refresh if percent icon shows zero at startup */
-    AnimationType type = GetAnimationType(GetCurrentAnimationName());
-    if (IsPercentIcon(type)) {
-        float chosen = (type == ANIM_TYPE_CPU) ? *cpu : *mem;
-        if ((int)(chosen + 0.5f) == 0) {
-            SystemMonitor_ForceRefresh();
-            SystemMonitor_GetUsage(cpu, mem);
-        }
-    }
-}
-
 /**
  * @brief Build basic tooltip with CPU, memory, and optional network info
  * @param tip Output buffer for tooltip text
@@ -193,6 +175,23 @@ static void BuildBasicTooltip(wchar_t* tip, size_t tipSize, float cpu, float mem
     }
 }
 
+/**
+ * @brief Append the watched process's CPU share to the tooltip
+ * @param tip Tooltip buffer to append to
+ * @param tipSize Size of tooltip buffer
+ * 
+ * Nothing is added unless CPU_WATCH_PROCESS names a running process.
+ */
+static void AppendWatchedProcessLine(wchar_t* tip, size_t tipSize) {
+    SystemMetricsSnapshot snap;
+    SystemMonitor_GetSnapshot(&snap);
+    if (!snap.processValid) return;
+    
+    wchar_t extra[48];
+    swprintf_s(extra, _countof(extra), L"\nProcess %.1f%%", snap.processPercent);
+    wcsncat_s(tip, tipSize, extra, _TRUNCATE);
+}
+
 /**
  * @brief Check if animation speed should be displayed
  * @param animName Current animation name
@@ -297,12 +296,13 @@ static void CALLBACK TrayTipTimerProc(HWND hwnd, UINT msg, UINT_PTR id, DWORD ti
     
     /* Gather system metrics */
     float cpu, mem, upBps, downBps;
-    GetSystemMetricsWithWarmup(&cpu, &mem);
+    SystemMonitor_GetUsage(&cpu, &mem);
     BOOL hasNet = SystemMonitor_GetNetSpeed(&upBps, &downBps);
     
     /* Build basic tooltip */
     wchar_t tip[256] = {0};
     BuildBasicTooltip(tip, _countof(tip), cpu, mem, upBps, downBps, hasNet);
+    AppendWatchedProcessLine(tip, _countof(tip));
     
     /* Append animation speed if applicable */
     const char* animName = GetCurrentAnimationName();
@@ -314,6 +314,12 @@ static void CALLBACK TrayTipTimerProc(HWND hwnd, UINT msg, UINT_PTR id, DWORD ti
     /* Update tray icon */
     UpdateTrayTooltip(tip);
     TrayAnimation_UpdatePercentIconIfNeeded();
+    
+    /* Re-scale animation deadlines if the speed metric moved */
+    TrayAnimation_RecomputeTimerDelay();
+    
+    /* Republish the metrics page (no-op unless the endpoint is enabled) */
+    MetricsEndpoint_Refresh();
 }
 
 /**
@@ -334,20 +340,17 @@ void RegisterTaskbarCreatedMessage() {
  * ============================================================================ */
 
 /**
- * @brief Get initial icon for percent-based animations with warm-up sampling
+ * @brief Get initial icon for percent-based animations
  * @param type Animation type
  * @return HICON for percent icon, or NULL for non-percent types
  * 
- * Takes two samples with delay to ensure accurate initial percentage reading.
+ * Uses whatever the sampler has published so far; the first tooltip tick
+ * replaces it with a settled reading, so start-up never waits on sampling.
  */
 static HICON GetInitialPercentIcon(AnimationType type) {
     if (!IsPercentIcon(type)) return NULL;
     
     float cpu = 0.0f, mem = 0.0f;
-    
-    /* Take two samples with delay to avoid initial 0% */
-    SystemMonitor_ForceRefresh();
-    Sleep(PERCENT_ICON_WARMUP_MS);
     SystemMonitor_ForceRefresh();
     SystemMonitor_GetUsage(&cpu, &mem);
     
@@ -374,6 +377,10 @@ void InitTrayIcon(HWND hwnd, HINSTANCE hInstance) {
     /* Initialize configuration and system monitoring */
     ReadPercentIconColorsConfig();
     SystemMonitor_Init();
+    ReadSystemMonitorWatchConfig();
+    ReadSystemMonitorSamplingConfig();
+    SystemMonitor_SetConsumer(SYSTEM_CONSUMER_TOOLTIP, TRUE);
+    SystemMonitor_Subscribe();
     PreloadAnimationFromConfig();
     
     /* Get initial icon based on animation type */
@@ -414,6 +421,8 @@ void RemoveTrayIcon(void) {
     if (nid.hWnd) {
         KillTimer(nid.hWnd, TRAY_TIP_TIMER_ID);
     }
+    SystemMonitor_SetConsumer(SYSTEM_CONSUMER_TOOLTIP, FALSE);
+    SystemMonitor_Unsubscribe();
     SystemMonitor_Shutdown();
     Shell_NotifyIconW(NIM_DELETE, &nid);
 }
@@ -3,13 +3,18 @@
  * @brief System tray icon animation implementation with high-precision timing
  * 
  * This implementation uses a combination of:
- * - Multimedia timer (timeSetEvent) for high precision (1ms resolution vs 15.6ms)
- * - Fixed tray update frequency (50ms) to avoid Windows Explorer throttling
+ * - Deadline scheduler: one waitable timer armed for the next frame change,
+ *   so a 6 fps animation wakes 6 times per second and a static icon never
+ * - Minimum tray update spacing (50ms) to avoid Windows Explorer throttling
  * - Adaptive frame rate to handle different system performance levels
  * 
- * This architecture eliminates flicker/stutter that occurs with fast animations.
+ * The speed scale is cached and only recomputed when the speed metric moves.
+ * Decoded frame sets are kept in a small LRU shared by tray and preview, and
+ * menu neighbours of a previewed animation are decoded ahead on a worker.
  */
 
+#define LOG_MODULE LOG_MODULE_ANIMATION
+
 #include <windows.h> 
 #include <shlobj.h>
 #include <shellapi.h>
@@ -22,9 +27,6 @@
 #include <wincodec.h>
 #include <propvarutil.h>
 #include <objbase.h>
-#include <mmsystem.h>
-
-#pragma comment(lib, "winmm.lib")
 
 #include "../include/tray.h"
 #include "../include/config.h"
@@ -32,79 +34,60 @@
 #include "../include/tray_menu.h"
 #include "../include/tray_animation.h"
 #include "../include/system_monitor.h"
+#include "../include/frame_arena.h"
+#include "../include/frame_compose.h"
+#include "../include/anim_trace.h"
+#include "../include/natural_sort.h"
+#include "../include/metrics_endpoint.h"
 #include "../include/log.h"
 
-/** @brief Represents a file or folder entry for sorting animation menus. */
-typedef struct {
-    wchar_t name[MAX_PATH];
-    char rel_path_utf8[MAX_PATH]; /** Relative path from animations root */
-    BOOL is_dir;
-} AnimationEntry;
-
-/** @brief Natural string compare for wide-char names: numbers compare by value. */
-static int NaturalCompareW(const wchar_t* a, const wchar_t* b) {
-    const wchar_t* pa = a;
-    const wchar_t* pb = b;
-    while (*pa && *pb) {
-        if (iswdigit(*pa) && iswdigit(*pb)) {
-            const wchar_t* za = pa; while (*za == L'0') za++;
-            const wchar_t* zb = pb; while (*zb == L'0') zb++;
-            /** Primary: more leading zeros first */
-            size_t leadA = (size_t)(za - pa);
-            size_t leadB = (size_t)(zb - pb);
-            if (leadA != leadB) return (leadA > leadB) ? -1 : 1;
-            const wchar_t* ea = za; while (iswdigit(*ea)) ea++;
-            const wchar_t* eb = zb; while (iswdigit(*eb)) eb++;
-            size_t lena = (size_t)(ea - za);
-            size_t lenb = (size_t)(eb - zb);
-            if (lena != lenb) return (lena < lenb) ? -1 : 1;
-            int dcmp = wcsncmp(za, zb, lena);
-            if (dcmp != 0) return (dcmp < 0) ? -1 : 1;
-            pa = ea;
-            pb = eb;
-            continue;
-        }
-        wchar_t ca = towlower(*pa);
-        wchar_t cb = towlower(*pb);
-        if (ca != cb) return (ca < cb) ? -1 : 1;
-        pa++; pb++;
-    }
-    if (*pa) return 1;
-    if (*pb) return -1;
-    return 0;
-}
-
-/** @brief qsort comparator for AnimationEntry, directories first, then natural order. */
-static int CompareAnimationEntries(const void* a, const void* b) {
-    const AnimationEntry* entryA = (const AnimationEntry*)a;
-    const AnimationEntry* entryB = (const AnimationEntry*)b;
-    if (entryA->is_dir != entryB->is_dir) {
-        return entryB->is_dir - entryA->is_dir; // Directories first
-    }
-    return NaturalCompareW(entryA->name, entryB->name);
-}
-
 /** Forward declarations */
-static void CALLBACK HighPrecisionTimerCallback(UINT uTimerID, UINT uMsg, DWORD_PTR dwUser, DWORD_PTR dw1, DWORD_PTR dw2);
 static void CALLBACK FallbackTimerProc(HWND hwnd, UINT msg, UINT_PTR id, DWORD time);
+static void WakeAnimationScheduler(BOOL resetDeadline);
+static BOOL ShowPercentIcon(int percent, BOOL force);
+static void ClearPercentIconCache(void);
+static BOOL ShowGraphIcon(BOOL force);
+static HICON CreateGraphIconCopy(const char* name);
+static void ClearGraphIconCache(void);
 
 /**
- * @brief High-precision animation timing configuration
+ * @brief Animation scheduling configuration
  */
-#define INTERNAL_TICK_INTERVAL_MS 10        /** Internal animation logic runs at 100Hz */
-#define TRAY_UPDATE_INTERVAL_MS 50          /** Actual tray updates at 20Hz (optimal for Windows Explorer) */
-#define TRAY_ANIM_TIMER_ID 42420            /** Fallback timer ID if multimedia timer fails */
+#define TRAY_UPDATE_INTERVAL_MS 50          /** Minimum spacing between tray updates (20Hz cap for Windows Explorer) */
+#define TRAY_ANIM_TIMER_ID 42420            /** Fallback timer ID if the scheduler thread cannot start */
+#define TRAY_SPEED_TIMER_ID 42422           /** Re-reads the speed metric at the fast sampling rate */
 #define WM_TRAY_UPDATE_ICON (WM_USER + 100) /** Custom message for thread-safe tray updates */
+#define SCHEDULER_MIN_FRAME_MS 10.0         /** Shortest scaled frame delay the scheduler will honour */
+#define SCHEDULER_MAX_CATCHUP_FRAMES 64     /** Frames skipped after a stall before resyncing to "now" */
+#define PERCENT_ICON_CACHE_SIZE 101         /** One cached percent icon per value 0..100 */
+#define GRAPH_ICON_MAX_EDGE 64              /** Largest icon edge the graph renderer draws */
+#define GRAPH_ICON_HOT_PERCENT 80.0f        /** Bars at or above this use the hot colour */
+#define GRAPH_ICON_HOT_COLOR RGB(232, 64, 64)
+
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
 
 /** @brief User-configurable minimum interval (0 = no floor) loaded from config */
 static UINT g_userMinIntervalMs = 0;
 
 /**
- * @brief High-precision timer state
+ * @brief Deadline scheduler state
  */
-static MMRESULT g_mmTimerId = 0;                    /** Multimedia timer handle */
-static BOOL g_useHighPrecisionTimer = TRUE;         /** Whether high-precision timer is available */
-static UINT g_internalAccumulator = 0;              /** Accumulator for fixed tray update interval */
+static HANDLE g_schedThread = NULL;                 /** Scheduler worker thread */
+static HANDLE g_schedTimer = NULL;                  /** Waitable timer armed for the next deadline */
+static HANDLE g_schedWakeEvent = NULL;              /** Signalled when animation state or speed changes */
+static volatile LONG g_schedStop = 0;               /** Asks the worker to exit */
+static volatile LONG g_schedResetDeadline = 1;      /** Restart timing from the current frame on next pass */
+static volatile LONG g_schedWakeups = 0;            /** Worker wakeups since start (diagnostics) */
+static BOOL g_useFallbackTimer = FALSE;             /** Scheduler runs on UI-thread SetTimer instead */
+static double g_schedStartMs = 0.0;                 /** When the scheduler was started */
+static double g_frameDeadlineMs = 0.0;              /** Absolute time of the next frame change, 0 = unarmed */
+static double g_deadlineScale = 1.0;                /** Speed scale the current deadline was computed with */
+static double g_lastPostMs = 0.0;                   /** When the last tray update was posted */
+static BOOL g_framePostPending = FALSE;             /** Frame advanced but update held back by spacing */
+static double g_updatePostedMs = 0.0;               /** When the pending WM_TRAY_UPDATE_ICON was posted */
+static double g_speedScale = 1.0;                   /** Cached speed scale (1.0 = native speed) */
 static UINT g_currentEffectiveInterval = TRAY_UPDATE_INTERVAL_MS;  /** Current effective update interval */
 static BOOL g_pendingTrayUpdate = FALSE;            /** Flag indicating tray update is pending */
 static CRITICAL_SECTION g_animCriticalSection;      /** Critical section for thread-safe state access */
@@ -113,10 +96,72 @@ static BOOL g_criticalSectionInitialized = FALSE;   /** Whether critical section
 /**
  * @brief Adaptive frame rate monitoring
  */
-static DWORD g_lastTrayUpdateTime = 0;              /** Last time tray was actually updated */
 static UINT g_consecutiveLateUpdates = 0;           /** Count of updates that were too slow */
-static UINT g_targetInternalInterval = INTERNAL_TICK_INTERVAL_MS;  /** Target internal tick interval */
-static double g_internalFramePosition = 0.0;        /** Sub-frame position for smooth animation */
+
+/** @brief Monotonic milliseconds from the performance counter */
+static double SchedulerNowMs(void) {
+    static LARGE_INTEGER freq = {0};
+    if (freq.QuadPart == 0) QueryPerformanceFrequency(&freq);
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+    return (double)now.QuadPart * 1000.0 / (double)freq.QuadPart;
+}
+
+/**
+ * @brief Pre-rendered percent icons for the __cpu__/__mem__ tray modes
+ *
+ * Filled lazily, one slot per value 0..100. Slots are only valid for the key
+ * they were rendered with; a key change (colors, icon edge, DPI) or an
+ * explicit invalidation drops all of them.
+ */
+typedef struct {
+    HICON icons[PERCENT_ICON_CACHE_SIZE];
+    COLORREF textColor;
+    COLORREF bgColor;
+    int edge;                   /** 0 = key not computed yet */
+    UINT dpi;
+    HICON shownIcon;            /** Icon last passed to NIM_MODIFY, NULL = unknown */
+} PercentIconCache;
+
+static PercentIconCache g_percentIconCache = {0};
+
+/**
+ * @brief Bar/sparkline icons for the __cpuhist__/__cores__ tray modes
+ *
+ * The column atlas holds every bar height pre-rendered (normal and hot
+ * variants), and the colour DIB and mask survive across updates, so a
+ * refresh copies columns and makes a single CreateIconIndirect call instead
+ * of creating brushes, DCs and bitmaps every second. Keyed like the percent
+ * cache on colours, icon edge and DPI.
+ */
+typedef struct {
+    int edge;                   /** 0 = not built */
+    UINT dpi;
+    COLORREF barColor;
+    COLORREF bgColor;
+    DWORD* atlas;               /** [hot][height 0..edge][y] opaque PBGRA pixels */
+    HBITMAP hbmColor;           /** Persistent edge x edge 32bpp DIB */
+    DWORD* colorBits;
+    HBITMAP hbmMask;            /** Persistent all-opaque mask */
+    BYTE columns[GRAPH_ICON_MAX_EDGE];  /** Bar heights last drawn, hot flag in bit 7 */
+    BOOL hasShown;              /** columns describe the icon currently in the tray */
+    HICON shownIcon;            /** Icon last passed to NIM_MODIFY */
+} GraphIconCache;
+
+static GraphIconCache g_graphIconCache = {0};
+
+/** @brief Tray modes drawn from system monitor data rather than frames */
+static BOOL IsPercentIconName(const char* name) {
+    return _stricmp(name, "__cpu__") == 0 || _stricmp(name, "__mem__") == 0;
+}
+
+static BOOL IsGraphIconName(const char* name) {
+    return _stricmp(name, "__cpuhist__") == 0 || _stricmp(name, "__cores__") == 0;
+}
+
+static BOOL IsMetricIconName(const char* name) {
+    return IsPercentIconName(name) || IsGraphIconName(name);
+}
 
 /** @brief Loaded icon frames and state */
 static HICON g_trayIcons[MAX_TRAY_FRAMES];
@@ -141,15 +186,6 @@ static UINT g_animCanvasHeight = 0;
 static BYTE* g_animCanvas = NULL;  /** 32bpp PBGRA canvas for frame composition */
 static BYTE* g_previewAnimCanvas = NULL;  /** 32bpp PBGRA canvas for preview composition */
 
-/**
- * @brief Simple memory pool for reducing malloc/free overhead
- * Pre-allocates common buffer sizes to avoid repeated allocations
- */
-#define MEMORY_POOL_BUFFER_SIZE (256 * 1024)  /** 256KB default buffer */
-static BYTE* g_memoryPoolBuffer = NULL;
-static SIZE_T g_memoryPoolSize = 0;
-static BOOL g_memoryPoolInUse = FALSE;
-
 /**
  * @brief Error recovery state tracking
  */
@@ -158,6 +194,43 @@ static DWORD g_lastSuccessfulUpdateTime = 0;
 #define MAX_CONSECUTIVE_FAILURES 5
 #define UPDATE_TIMEOUT_MS 5000  /** 5 seconds without update = fallback */
 
+/**
+ * @brief Multi-resolution frame store
+ *
+ * Besides the active icon array, each target keeps one small PBGRA master per
+ * frame plus a few previously built icon sizes. A DPI or icon-size change then
+ * switches to a cached set, or rebuilds icons from the masters, without
+ * touching the source files again.
+ */
+#define FRAME_MASTER_SIZE 64               /** Edge of retained master frames */
+#define FRAME_STORE_MAX_SIZES 4            /** Inactive icon sizes kept per target */
+#define FRAME_SET_IDLE_EVICT_MS 300000     /** Drop inactive sizes unused for 5 minutes */
+#define FRAME_SET_EVICT_CHECK_MS 10000     /** How often tray updates look for idle sizes */
+
+/** @brief Icon set built for one edge size, parked while another size is active */
+typedef struct {
+    int edge;                              /** Icon edge in pixels, 0 = empty slot */
+    HICON icons[MAX_TRAY_FRAMES];
+    int count;
+    DWORD lastUsedTick;
+} FrameSizeSet;
+
+typedef struct AnimCacheEntry AnimCacheEntry;
+
+typedef struct {
+    BYTE* masters[MAX_TRAY_FRAMES];        /** masterEdge^2 PBGRA per frame, NULL if not rebuildable */
+    int masterEdge;
+    int activeEdge;                        /** Edge of the icons in the target's active array */
+    AnimCacheEntry* cacheEntry;            /** Cache entry the masters are borrowed from, NULL if owned */
+    FrameSizeSet parked[FRAME_STORE_MAX_SIZES];
+} FrameStore;
+
+static FrameStore g_trayStore = {0};
+static FrameStore g_previewStore = {0};
+static DWORD g_lastEvictCheckTick = 0;
+
+static void FrameStore_EvictIdle(FrameStore* store, DWORD now);
+
 /** @brief Context for directing decoded animation frames to tray or preview targets */
 typedef struct {
     HICON* icons;
@@ -166,61 +239,158 @@ typedef struct {
     UINT*  delays;
     BOOL*  isAnimatedFlag;
     BYTE** canvas;
+    FrameStore* store;
+    int edge;             /** Icon edge to build, from GetTrayIconEdge() */
+    BOOL mastersOnly;     /** Prefetch: keep masters, build no icons */
 } DecodeTarget;
 
 /**
- * @brief Allocate memory from pool or fallback to malloc
- * @param size Size in bytes to allocate
- * @return Pointer to allocated memory, or NULL on failure
+ * @brief Long-lived WIC imaging state owned by one decode thread
+ *
+ * COM apartment, WIC factory and scratch buffers are set up once per thread
+ * instead of once per image file. WIC scalers and converters are single-shot
+ * (Initialize can only be called once), so those are still created per frame
+ * from the cached factory.
  */
-static void* MemoryPool_Alloc(SIZE_T size) {
-    /** Try to use memory pool for common sizes */
-    if (!g_memoryPoolInUse && size <= MEMORY_POOL_BUFFER_SIZE) {
-        if (!g_memoryPoolBuffer) {
-            g_memoryPoolBuffer = (BYTE*)malloc(MEMORY_POOL_BUFFER_SIZE);
-            if (g_memoryPoolBuffer) {
-                g_memoryPoolSize = MEMORY_POOL_BUFFER_SIZE;
-            }
-        }
-        
-        if (g_memoryPoolBuffer && size <= g_memoryPoolSize) {
-            g_memoryPoolInUse = TRUE;
-            return g_memoryPoolBuffer;
-        }
-    }
-    
-    /** Fallback to regular malloc for large allocations or when pool is in use */
-    return malloc(size);
+typedef struct {
+    IWICImagingFactory* factory;
+    BOOL comInitialized;      /** CoInitializeEx succeeded and must be balanced */
+    BYTE* scratch;            /** Scaled-pixel staging buffer */
+    SIZE_T scratchSize;
+    BYTE* maskBits;           /** 1bpp AND-mask staging buffer */
+    SIZE_T maskSize;
+    LARGE_INTEGER qpcFrequency;
+} ImagingContext;
+
+/** @brief Per-thread imaging context, created lazily by AcquireImagingContext */
+static _Thread_local ImagingContext* t_imagingContext = NULL;
+
+/** @brief Log frame allocator statistics after a load or on shutdown */
+static void LogFrameArenaStats(const char* when) {
+    if (!LOG_ENABLED(LOG_LEVEL_DEBUG)) return;
+    FrameArenaStats st;
+    FrameArena_GetStats(&st);
+    WriteLog(LOG_LEVEL_DEBUG,
+             "Frame arena (%s): hits=%llu misses=%llu oversize=%llu inUse=%zu peak=%zu cached=%zu frag=%.1f%%",
+             when, (unsigned long long)st.hits, (unsigned long long)st.misses,
+             (unsigned long long)st.oversize, st.bytesInUse, st.peakBytesInUse,
+             st.bytesCached, st.fragmentation * 100.0);
 }
 
 /**
- * @brief Free memory back to pool or call free
- * @param ptr Pointer to memory to free
+ * @brief Get the calling thread's imaging context, creating it on first use
+ * @return Context with a valid factory, or NULL if WIC is unavailable
  */
-static void MemoryPool_Free(void* ptr) {
-    if (!ptr) return;
-    
-    /** Check if this is from our pool */
-    if (ptr == g_memoryPoolBuffer) {
-        g_memoryPoolInUse = FALSE;
-        /** Don't actually free, keep for reuse */
-        return;
+static ImagingContext* AcquireImagingContext(void) {
+    if (t_imagingContext) return t_imagingContext;
+
+    ImagingContext* ctx = (ImagingContext*)calloc(1, sizeof(ImagingContext));
+    if (!ctx) return NULL;
+
+    HRESULT hrInit = CoInitializeEx(NULL, COINIT_APARTMENTTHREADED);
+    ctx->comInitialized = SUCCEEDED(hrInit);
+
+    HRESULT hr = CoCreateInstance(&CLSID_WICImagingFactory, NULL, CLSCTX_INPROC_SERVER,
+                                  &IID_IWICImagingFactory, (void**)&ctx->factory);
+    if (FAILED(hr) || !ctx->factory) {
+        WriteLog(LOG_LEVEL_WARNING, "WIC imaging factory unavailable (hr=0x%08lX)", (unsigned long)hr);
+        if (ctx->comInitialized) CoUninitialize();
+        free(ctx);
+        return NULL;
     }
-    
-    /** Regular malloc'd memory */
-    free(ptr);
+
+    QueryPerformanceFrequency(&ctx->qpcFrequency);
+    t_imagingContext = ctx;
+    return ctx;
+}
+
+/**
+ * @brief Release the calling thread's imaging context (factory, buffers, COM)
+ * Must be called on the same thread that acquired it.
+ */
+static void ReleaseImagingContext(void) {
+    ImagingContext* ctx = t_imagingContext;
+    if (!ctx) return;
+    t_imagingContext = NULL;
+
+    if (ctx->factory) ctx->factory->lpVtbl->Release(ctx->factory);
+    FrameArena_Free(ctx->scratch);
+    FrameArena_Free(ctx->maskBits);
+    if (ctx->comInitialized) CoUninitialize();
+    free(ctx);
+}
+
+/**
+ * @brief Grow a context-owned buffer to at least the requested size
+ * Contents are not preserved; callers always overwrite the whole buffer.
+ * @return Buffer pointer, or NULL on allocation failure
+ */
+static BYTE* EnsureImagingBuffer(BYTE** buffer, SIZE_T* capacity, SIZE_T size) {
+    if (*buffer && *capacity >= size) return *buffer;
+    FrameArena_Free(*buffer);
+    *buffer = (BYTE*)FrameArena_Alloc(size);
+    *capacity = *buffer ? FrameArena_BlockSize(*buffer) : 0;
+    return *buffer;
+}
+
+/** @brief Milliseconds elapsed since a QueryPerformanceCounter start value */
+static double ImagingElapsedMs(const ImagingContext* ctx, LARGE_INTEGER start) {
+    if (!ctx || ctx->qpcFrequency.QuadPart == 0) return 0.0;
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+    return (double)(now.QuadPart - start.QuadPart) * 1000.0 / (double)ctx->qpcFrequency.QuadPart;
 }
 
 /**
- * @brief Clean up memory pool (call on shutdown)
+ * @brief Build an HICON from top-down 32bpp PBGRA pixels without any DC work
+ *
+ * The AND mask is derived straight from the alpha channel (bit set = transparent),
+ * replacing the screen-DC + three BitBlt mask passes.
  */
-static void MemoryPool_Cleanup(void) {
-    if (g_memoryPoolBuffer) {
-        free(g_memoryPoolBuffer);
-        g_memoryPoolBuffer = NULL;
-        g_memoryPoolSize = 0;
-        g_memoryPoolInUse = FALSE;
+static HICON CreateIconFromPixels(ImagingContext* ctx, const BYTE* pixels, int cx, int cy) {
+    BITMAPINFO bi; ZeroMemory(&bi, sizeof(bi));
+    bi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+    bi.bmiHeader.biWidth = cx;
+    bi.bmiHeader.biHeight = -cy; /** top-down */
+    bi.bmiHeader.biPlanes = 1;
+    bi.bmiHeader.biBitCount = 32;
+    bi.bmiHeader.biCompression = BI_RGB;
+
+    VOID* pvBits = NULL;
+    HBITMAP hbmColor = CreateDIBSection(NULL, &bi, DIB_RGB_COLORS, &pvBits, NULL, 0);
+    if (!hbmColor || !pvBits) {
+        if (hbmColor) DeleteObject(hbmColor);
+        return NULL;
+    }
+    memcpy(pvBits, pixels, (SIZE_T)cx * (SIZE_T)cy * 4);
+
+    /** Monochrome bitmap rows are WORD aligned */
+    SIZE_T maskStride = (SIZE_T)((cx + 15) / 16) * 2;
+    BYTE* mask = EnsureImagingBuffer(&ctx->maskBits, &ctx->maskSize, maskStride * (SIZE_T)cy);
+    if (!mask) {
+        DeleteObject(hbmColor);
+        return NULL;
     }
+    ZeroMemory(mask, maskStride * (SIZE_T)cy);
+    for (int y = 0; y < cy; ++y) {
+        const BYTE* src = pixels + (SIZE_T)y * (SIZE_T)cx * 4;
+        BYTE* dst = mask + (SIZE_T)y * maskStride;
+        for (int x = 0; x < cx; ++x) {
+            if (src[x * 4 + 3] == 0) {
+                dst[x >> 3] |= (BYTE)(0x80 >> (x & 7));
+            }
+        }
+    }
+
+    ICONINFO ii; ZeroMemory(&ii, sizeof(ii));
+    ii.fIcon = TRUE;
+    ii.hbmColor = hbmColor;
+    ii.hbmMask = CreateBitmap(cx, cy, 1, 1, mask);
+
+    HICON hIcon = ii.hbmMask ? CreateIconIndirect(&ii) : NULL;
+    if (ii.hbmMask) DeleteObject(ii.hbmMask);
+    DeleteObject(hbmColor);
+    return hIcon;
 }
 
 /**
@@ -237,6 +407,7 @@ static void RecordSuccessfulUpdate(void) {
  */
 static BOOL RecordFailedUpdate(void) {
     g_consecutiveUpdateFailures++;
+    AnimTrace_Record(ANIM_TRACE_UPDATE_FAILED, SchedulerNowMs(), 0.0, 0.0, g_consecutiveUpdateFailures);
     
     /** Check for too many consecutive failures */
     if (g_consecutiveUpdateFailures >= MAX_CONSECUTIVE_FAILURES) {
@@ -265,6 +436,7 @@ static BOOL RecordFailedUpdate(void) {
  */
 static void FallbackToLogoIcon(void) {
     WriteLog(LOG_LEVEL_INFO, "Falling back to logo icon due to animation errors");
+    AnimTrace_Record(ANIM_TRACE_FALLBACK, SchedulerNowMs(), 0.0, 0.0, 0);
     
     /** Reset counters */
     g_consecutiveUpdateFailures = 0;
@@ -289,6 +461,63 @@ static void NormalizeAnimConfigValue(char* s) {
 }
 
 
+/**
+ * @brief Small-icon edge the taskbar currently asks for
+ *
+ * Uses the DPI of the monitor hosting the taskbar when per-monitor APIs are
+ * available (Windows 10 1607+ / 8.1+), otherwise the system small-icon metric.
+ * @param dpiOut Optional; receives the DPI the edge was computed for
+ */
+static int GetTrayIconMetrics(UINT* dpiOut) {
+    typedef int (WINAPI* GetSystemMetricsForDpiFunc)(int, UINT);
+    typedef HRESULT (WINAPI* GetDpiForMonitorFunc)(HMONITOR, int, UINT*, UINT*);
+    static GetSystemMetricsForDpiFunc pGetSystemMetricsForDpi = NULL;
+    static GetDpiForMonitorFunc pGetDpiForMonitor = NULL;
+    static BOOL resolved = FALSE;
+
+    if (!resolved) {
+        HMODULE hUser32 = GetModuleHandleW(L"user32.dll");
+        if (hUser32) {
+            pGetSystemMetricsForDpi = (GetSystemMetricsForDpiFunc)GetProcAddress(hUser32, "GetSystemMetricsForDpi");
+        }
+        HMODULE hShcore = LoadLibraryW(L"shcore.dll");
+        if (hShcore) {
+            pGetDpiForMonitor = (GetDpiForMonitorFunc)GetProcAddress(hShcore, "GetDpiForMonitor");
+        }
+        resolved = TRUE;
+    }
+
+    int edge = 0;
+    UINT dpi = 0;
+    if (pGetSystemMetricsForDpi && pGetDpiForMonitor) {
+        HWND hTaskbar = FindWindowW(L"Shell_TrayWnd", NULL);
+        HMONITOR hMon = hTaskbar ? MonitorFromWindow(hTaskbar, MONITOR_DEFAULTTOPRIMARY)
+                                 : MonitorFromPoint((POINT){0, 0}, MONITOR_DEFAULTTOPRIMARY);
+        UINT dpiX = 0, dpiY = 0;
+        if (hMon && SUCCEEDED(pGetDpiForMonitor(hMon, 0 /* MDT_EFFECTIVE_DPI */, &dpiX, &dpiY)) && dpiX > 0) {
+            edge = pGetSystemMetricsForDpi(SM_CXSMICON, dpiX);
+            dpi = dpiX;
+        }
+    }
+    if (edge <= 0) {
+        edge = GetSystemMetrics(SM_CXSMICON);
+        dpi = 0;
+    }
+    if (edge <= 0) edge = 16;
+    if (dpi == 0) {
+        HDC hdc = GetDC(NULL);
+        dpi = hdc ? (UINT)GetDeviceCaps(hdc, LOGPIXELSX) : 96;
+        if (hdc) ReleaseDC(NULL, hdc);
+    }
+    if (dpiOut) *dpiOut = dpi;
+    return edge;
+}
+
+/** @brief Small-icon edge only, see GetTrayIconMetrics */
+static int GetTrayIconEdge(void) {
+    return GetTrayIconMetrics(NULL);
+}
+
 /** @brief Selects the appropriate icon set (tray or preview) for an operation */
 static DecodeTarget GetDecodeTarget(BOOL isPreview) {
     if (isPreview) {
@@ -298,7 +527,9 @@ static DecodeTarget GetDecodeTarget(BOOL isPreview) {
             .index = &g_previewIndex,
             .delays = g_previewFrameDelaysMs,
             .isAnimatedFlag = &g_isPreviewAnimated,
-            .canvas = &g_previewAnimCanvas
+            .canvas = &g_previewAnimCanvas,
+            .store = &g_previewStore,
+            .edge = GetTrayIconEdge()
         };
     }
     return (DecodeTarget){
@@ -307,36 +538,48 @@ static DecodeTarget GetDecodeTarget(BOOL isPreview) {
         .index = &g_trayIconIndex,
         .delays = g_frameDelaysMs,
         .isAnimatedFlag = &g_isAnimated,
-        .canvas = &g_animCanvas
+        .canvas = &g_animCanvas,
+        .store = &g_trayStore,
+        .edge = GetTrayIconEdge()
     };
 }
 
 /**
- * @brief Compute scaled delay according to current animation speed metric and mapping
- * @param baseDelay Base delay in milliseconds
- * @return Scaled delay in milliseconds (lower bound 10ms)
+ * @brief Speed metric reading the cached scale was derived from
  */
-static UINT ComputeScaledDelay(UINT baseDelay) {
-    if (baseDelay == 0) baseDelay = g_trayInterval > 0 ? g_trayInterval : 150;
+typedef struct {
+    BOOL valid;
+    AnimationSpeedMetric metric;
+    int percentTenths;          /** Metric in 0.1% units, matching the speed-map table resolution */
+    UINT mapVersion;            /** GetAnimationSpeedMapVersion() at the time */
+} SpeedMetricSnapshot;
 
+static SpeedMetricSnapshot g_speedSnapshot = {0};
+
+/** @brief TRAY_SPEED_TIMER_ID is armed (speed follows CPU/memory while animating) */
+static BOOL g_speedTimerActive = FALSE;
+
+/**
+ * @brief Read the current speed metric from already-sampled state
+ * @return Metric in 0.1% units; unscaled cases (clock mode, count-up, finished) read as 0
+ *
+ * CPU/MEM come from the system monitor's published (smoothed) snapshot;
+ * nothing here triggers a new sample.
+ */
+static int ReadSpeedMetricTenths(AnimationSpeedMetric metric) {
     double percent = 0.0;
-    AnimationSpeedMetric metric = GetAnimationSpeedMetric();
     if (metric == ANIMATION_SPEED_CPU) {
         float cpu = 0.0f, mem = 0.0f;
         SystemMonitor_GetUsage(&cpu, &mem);
         percent = cpu;
     } else if (metric == ANIMATION_SPEED_TIMER) {
         /* Note: Timer state variables now in timer.h */
-        if (!CLOCK_SHOW_CURRENT_TIME) {
-            if (!CLOCK_COUNT_UP && CLOCK_TOTAL_TIME > 0) {
-                double p = (double)countdown_elapsed_time / (double)CLOCK_TOTAL_TIME;
-                if (p < 0.0) p = 0.0; if (p > 1.0) p = 1.0;
-                percent = p * 100.0;
-            } else {
-                percent = 0.0;
-            }
-        } else {
-            percent = 0.0;
+        if (!CLOCK_SHOW_CURRENT_TIME && !CLOCK_COUNT_UP && CLOCK_TOTAL_TIME > 0) {
+            double p = (double)countdown_elapsed_time / (double)CLOCK_TOTAL_TIME;
+            if (p < 0.0) p = 0.0; if (p > 1.0) p = 1.0;
+            percent = p * 100.0;
+            /** Finished countdown restores the default speed */
+            if (percent >= 100.0) percent = 0.0;
         }
     } else {
         float cpu = 0.0f, mem = 0.0f;
@@ -344,52 +587,60 @@ static UINT ComputeScaledDelay(UINT baseDelay) {
         percent = mem;
     }
 
-    BOOL applyScaling = TRUE;
-    if (metric == ANIMATION_SPEED_TIMER) {
-        extern BOOL CLOCK_COUNT_UP;
-        extern BOOL CLOCK_SHOW_CURRENT_TIME;
-        extern int CLOCK_TOTAL_TIME;
-        if (CLOCK_SHOW_CURRENT_TIME || CLOCK_COUNT_UP || CLOCK_TOTAL_TIME <= 0) {
-            applyScaling = FALSE;
-        }
-        if (percent >= 100.0) {
-            applyScaling = FALSE;
-        }
-    }
+    if (percent < 0.0) percent = 0.0;
+    if (percent > 100.0) percent = 100.0;
+    return (int)(percent * 10.0 + 0.5);
+}
 
-    double scalePercent = 100.0;
-    if (applyScaling) {
-        scalePercent = GetAnimationSpeedScaleForPercent(percent);
-        if (scalePercent <= 0.0) scalePercent = 100.0;
-    } else {
-        scalePercent = GetAnimationSpeedScaleForPercent(0.0);
-        if (scalePercent <= 0.0) scalePercent = 100.0;
-    }
+/**
+ * @brief Speed scale for a metric reading via the precomputed speed map
+ * @return Multiplier applied to frame rate (1.0 = native, lower bound 0.1)
+ */
+static double SpeedScaleForTenths(int percentTenths) {
+    double scalePercent = GetAnimationSpeedScaleForPercent(percentTenths / 10.0);
+    if (scalePercent <= 0.0) scalePercent = 100.0;
     double scale = scalePercent / 100.0;
     if (scale < 0.1) scale = 0.1;
-    UINT scaledDelay = (UINT)(baseDelay / scale);
-    UINT floorMs = (g_userMinIntervalMs > 0) ? g_userMinIntervalMs : 0;
+    return scale;
+}
+
+/**
+ * @brief Take a fresh metric snapshot and return the matching speed scale
+ */
+static double ComputeSpeedScale(void) {
+    g_speedSnapshot.metric = GetAnimationSpeedMetric();
+    g_speedSnapshot.percentTenths = ReadSpeedMetricTenths(g_speedSnapshot.metric);
+    g_speedSnapshot.mapVersion = GetAnimationSpeedMapVersion();
+    g_speedSnapshot.valid = TRUE;
+    return SpeedScaleForTenths(g_speedSnapshot.percentTenths);
+}
+
+/**
+ * @brief Scaled on-screen duration of a frame using the cached speed scale
+ * @param baseDelay Frame delay in milliseconds (0 = folder interval)
+ * @return Scaled delay in milliseconds (lower bound SCHEDULER_MIN_FRAME_MS or user floor)
+ */
+static double ComputeScaledDelay(UINT baseDelay) {
+    if (baseDelay == 0) baseDelay = g_trayInterval > 0 ? g_trayInterval : 150;
+    double scaledDelay = (double)baseDelay / g_speedScale;
+    double floorMs = (g_userMinIntervalMs > 0) ? (double)g_userMinIntervalMs : SCHEDULER_MIN_FRAME_MS;
     if (scaledDelay < floorMs) scaledDelay = floorMs;
     return scaledDelay;
 }
 
 /**
  * @brief Adaptive frame rate monitoring and adjustment
- * Monitors actual update performance and adjusts internal timing if system is struggling
+ * @param serviceMs Time from posting the update to Shell_NotifyIconW returning
+ *
+ * Updates are no longer periodic, so the wall-clock gap between updates says
+ * nothing about load. How long the UI thread took to service a posted update
+ * does: if that eats into the spacing budget, widen the spacing.
  */
-static void AdaptiveFrameRateUpdate(void) {
-    DWORD currentTime = GetTickCount();
-    
-    if (g_lastTrayUpdateTime == 0) {
-        g_lastTrayUpdateTime = currentTime;
-        return;
-    }
-    
-    DWORD actualElapsed = currentTime - g_lastTrayUpdateTime;
-    g_lastTrayUpdateTime = currentTime;
-    
-    /** If actual interval is significantly longer than target, system is struggling */
-    if (actualElapsed > g_currentEffectiveInterval * 3 / 2) {  /** >150% of target */
+static void AdaptiveFrameRateUpdate(double serviceMs) {
+    UINT previousInterval = g_currentEffectiveInterval;
+
+    /** If servicing takes more than half the spacing, system is struggling */
+    if (serviceMs > g_currentEffectiveInterval / 2.0) {
         g_consecutiveLateUpdates++;
         
         /** After 3 consecutive late updates, slow down to give system breathing room */
@@ -399,7 +650,7 @@ static void AdaptiveFrameRateUpdate(void) {
             }
             g_consecutiveLateUpdates = 0;
         }
-    } else if (actualElapsed < g_currentEffectiveInterval * 4 / 5) {  /** <80% of target, performing well */
+    } else if (serviceMs < g_currentEffectiveInterval / 5.0) {  /** Well within budget, performing well */
         g_consecutiveLateUpdates = 0;
         
         /** Gradually speed back up to target rate if we slowed down */
@@ -413,41 +664,111 @@ static void AdaptiveFrameRateUpdate(void) {
         /** Normal timing, reset consecutive counter */
         g_consecutiveLateUpdates = 0;
     }
+
+    if (g_currentEffectiveInterval != previousInterval) {
+        AnimTrace_Record(ANIM_TRACE_INTERVAL, SchedulerNowMs(),
+                         (double)previousInterval, (double)g_currentEffectiveInterval, 0);
+    }
 }
 
 /**
- * @brief Advance internal frame position based on animation speed
- * @return TRUE if we should advance to next visual frame
+ * @brief Scaled delay of the frame currently on screen (lock held)
  */
-static BOOL AdvanceInternalFramePosition(void) {
-    /** Check if we have frames to animate (preview or normal) */
-    int frameCount = g_isPreviewActive ? g_previewCount : g_trayIconCount;
-    if (frameCount <= 0) return FALSE;
-    
-    /** Calculate frame advancement speed */
+static double CurrentFrameDelayMs(void) {
     UINT baseDelay;
     if (g_isPreviewActive) {
         baseDelay = g_isPreviewAnimated ? g_previewFrameDelaysMs[g_previewIndex] : g_trayInterval;
     } else {
         baseDelay = g_isAnimated ? g_frameDelaysMs[g_trayIconIndex] : g_trayInterval;
     }
-    if (baseDelay == 0) baseDelay = g_trayInterval > 0 ? g_trayInterval : 150;
-    
-    /** Apply speed scaling */
-    UINT scaledDelay = ComputeScaledDelay(baseDelay);
-    if (scaledDelay == 0) scaledDelay = 50;
-    
-    /** Advance by the fraction of a frame that elapsed */
-    double frameAdvancement = (double)g_targetInternalInterval / (double)scaledDelay;
-    g_internalFramePosition += frameAdvancement;
-    
-    /** Check if we've accumulated enough to advance to next frame */
-    if (g_internalFramePosition >= 1.0) {
-        g_internalFramePosition -= 1.0;
-        return TRUE;
+    return ComputeScaledDelay(baseDelay);
+}
+
+/**
+ * @brief Whether there is anything for the scheduler to step (lock held)
+ * Metric icons (__cpu__, __mem__, __cpuhist__, __cores__) are driven by the periodic
+ * updater unless previewing.
+ */
+static BOOL SchedulerHasFrames(void) {
+    if (g_isPreviewActive) return g_previewCount > 1;
+    if (IsMetricIconName(g_animationName)) return FALSE;
+    return g_trayIconCount > 1;
+}
+
+/**
+ * @brief Advance frames whose deadlines have passed and work out the next wake time
+ * @param now Current time from SchedulerNowMs
+ * @param postUpdate Receives TRUE if a tray update should be posted now
+ * @return Milliseconds until the next wake, or INFINITE when idle
+ *
+ * Deadlines are absolute: the next one is the previous deadline plus the
+ * scaled delay of the frame just shown, so timer slack never accumulates.
+ * When the speed scale changes mid-frame, the time left on the current
+ * frame is stretched by old/new scale instead of restarting the frame.
+ */
+static DWORD SchedulerStep(double now, BOOL* postUpdate) {
+    *postUpdate = FALSE;
+
+    if (g_criticalSectionInitialized) {
+        EnterCriticalSection(&g_animCriticalSection);
     }
-    
-    return FALSE;
+
+    DWORD waitMs = INFINITE;
+    if (!SchedulerHasFrames()) {
+        g_frameDeadlineMs = 0.0;
+        g_framePostPending = FALSE;
+    } else {
+        if (InterlockedExchange(&g_schedResetDeadline, 0) || g_frameDeadlineMs <= 0.0) {
+            g_frameDeadlineMs = now + CurrentFrameDelayMs();
+            g_deadlineScale = g_speedScale;
+        } else if (g_deadlineScale != g_speedScale) {
+            double remaining = g_frameDeadlineMs - now;
+            if (remaining > 0.0) {
+                g_frameDeadlineMs = now + remaining * g_deadlineScale / g_speedScale;
+            }
+            g_deadlineScale = g_speedScale;
+        }
+
+        int advanced = 0;
+        while (now >= g_frameDeadlineMs && advanced < SCHEDULER_MAX_CATCHUP_FRAMES) {
+            int shown;
+            if (g_isPreviewActive) {
+                g_previewIndex = (g_previewIndex + 1) % g_previewCount;
+                shown = g_previewIndex;
+            } else {
+                g_trayIconIndex = (g_trayIconIndex + 1) % g_trayIconCount;
+                shown = g_trayIconIndex;
+            }
+            AnimTrace_Record(ANIM_TRACE_FRAME, now, g_frameDeadlineMs, now, shown);
+            g_frameDeadlineMs += CurrentFrameDelayMs();
+            advanced++;
+        }
+        if (now >= g_frameDeadlineMs) {
+            /** Stalled for longer than a full catch-up (sleep, debugger): resync */
+            g_frameDeadlineMs = now + CurrentFrameDelayMs();
+        }
+        if (advanced > 0) g_framePostPending = TRUE;
+
+        double nextWake = g_frameDeadlineMs;
+        if (g_framePostPending) {
+            double earliestPost = g_lastPostMs + (double)g_currentEffectiveInterval;
+            if (now >= earliestPost) {
+                g_framePostPending = FALSE;
+                g_lastPostMs = now;
+                *postUpdate = TRUE;
+            } else if (earliestPost < nextWake) {
+                nextWake = earliestPost;
+            }
+        }
+
+        double delta = nextWake - now;
+        waitMs = (delta <= 0.0) ? 0 : (DWORD)(delta + 0.5);
+    }
+
+    if (g_criticalSectionInitialized) {
+        LeaveCriticalSection(&g_animCriticalSection);
+    }
+    return waitMs;
 }
 
 /**
@@ -461,9 +782,11 @@ static void RequestTrayIconUpdate(void) {
     if (g_criticalSectionInitialized) {
         EnterCriticalSection(&g_animCriticalSection);
         g_pendingTrayUpdate = TRUE;
+        g_updatePostedMs = SchedulerNowMs();
         LeaveCriticalSection(&g_animCriticalSection);
     } else {
         g_pendingTrayUpdate = TRUE;
+        g_updatePostedMs = SchedulerNowMs();
     }
     
     /** Post message to main UI thread to do actual update */
@@ -478,12 +801,17 @@ static void UpdateTrayIconToCurrentFrame(void) {
     if (!g_trayHwnd || !IsWindow(g_trayHwnd)) return;
     
     /** Clear pending flag */
+    double postedMs;
     if (g_criticalSectionInitialized) {
         EnterCriticalSection(&g_animCriticalSection);
         g_pendingTrayUpdate = FALSE;
+        postedMs = g_updatePostedMs;
+        g_updatePostedMs = 0.0;
         LeaveCriticalSection(&g_animCriticalSection);
     } else {
         g_pendingTrayUpdate = FALSE;
+        postedMs = g_updatePostedMs;
+        g_updatePostedMs = 0.0;
     }
     
     int count = g_isPreviewActive ? g_previewCount : g_trayIconCount;
@@ -494,23 +822,20 @@ static void UpdateTrayIconToCurrentFrame(void) {
             g_isPreviewActive = FALSE;
             return;
         }
-        /** For main animation: if it's percent icon, update it directly; otherwise fallback */
-        if (_stricmp(g_animationName, "__cpu__") == 0 || _stricmp(g_animationName, "__mem__") == 0) {
+        /** For main animation: if it's a metric icon, update it directly; otherwise fallback */
+        if (IsGraphIconName(g_animationName)) {
+            if (ShowGraphIcon(TRUE)) {
+                RecordSuccessfulUpdate();
+            }
+            return;
+        }
+        if (IsPercentIconName(g_animationName)) {
             /** Percent icons are handled by periodic updater, trigger an update */
             float cpu = 0.0f, mem = 0.0f;
             SystemMonitor_GetUsage(&cpu, &mem);
             int p = (_stricmp(g_animationName, "__cpu__") == 0) ? (int)(cpu + 0.5f) : (int)(mem + 0.5f);
             if (p < 0) p = 0; if (p > 100) p = 100;
-            HICON hIcon = CreatePercentIcon16(p);
-            if (hIcon) {
-                NOTIFYICONDATAW nid = {0};
-                nid.cbSize = sizeof(nid);
-                nid.hWnd = g_trayHwnd;
-                nid.uID = CLOCK_ID_TRAY_APP_ICON;
-                nid.uFlags = NIF_ICON;
-                nid.hIcon = hIcon;
-                Shell_NotifyIconW(NIM_MODIFY, &nid);
-                DestroyIcon(hIcon);
+            if (ShowPercentIcon(p, TRUE)) {
                 RecordSuccessfulUpdate();
             }
             return;
@@ -556,10 +881,23 @@ static void UpdateTrayIconToCurrentFrame(void) {
     nid.uFlags = NIF_ICON;
     nid.hIcon = hIcon;
     
+    double shellStart = SchedulerNowMs();
     BOOL success = Shell_NotifyIconW(NIM_MODIFY, &nid);
+    double shellEnd = SchedulerNowMs();
+    g_percentIconCache.shownIcon = NULL;
+    g_graphIconCache.hasShown = FALSE;
+    AnimTrace_Record(ANIM_TRACE_TRAY_UPDATE, shellEnd, postedMs, shellEnd - shellStart, success ? 1 : 0);
+    MetricsEndpoint_ObserveTrayUpdateMs(shellEnd - shellStart);
     
     if (success) {
         RecordSuccessfulUpdate();
+
+        DWORD now = GetTickCount();
+        if (now - g_lastEvictCheckTick >= FRAME_SET_EVICT_CHECK_MS) {
+            g_lastEvictCheckTick = now;
+            FrameStore_EvictIdle(&g_trayStore, now);
+            FrameStore_EvictIdle(&g_previewStore, now);
+        }
     } else {
         WriteLog(LOG_LEVEL_WARNING, "Shell_NotifyIconW failed to update tray icon");
         
@@ -569,83 +907,73 @@ static void UpdateTrayIconToCurrentFrame(void) {
         return;
     }
     
-    /** Update adaptive monitoring */
-    AdaptiveFrameRateUpdate();
+    /** Update adaptive monitoring (only for updates the scheduler posted) */
+    if (postedMs > 0.0) {
+        AdaptiveFrameRateUpdate(SchedulerNowMs() - postedMs);
+    }
 }
 
 /**
- * @brief High-precision timer callback (runs at 100Hz internally)
- * This is the core of the new timing system
+ * @brief Deadline scheduler worker
+ * Sleeps on the waitable timer until the next frame change (or the wake event
+ * when state changes), steps frames, and posts WM_TRAY_UPDATE_ICON.
  * IMPORTANT: This runs in a WORKER THREAD, not the main UI thread!
  * DO NOT call Windows UI functions directly from here.
  */
-static void CALLBACK HighPrecisionTimerCallback(UINT uTimerID, UINT uMsg, DWORD_PTR dwUser, DWORD_PTR dw1, DWORD_PTR dw2) {
-    (void)uTimerID; (void)uMsg; (void)dwUser; (void)dw1; (void)dw2;
-    
-    /** For percent-based animations (__cpu__, __mem__), skip frame logic UNLESS previewing */
-    if ((_stricmp(g_animationName, "__cpu__") == 0 || _stricmp(g_animationName, "__mem__") == 0) && !g_isPreviewActive) {
-        g_internalAccumulator += g_targetInternalInterval;
-        if (g_internalAccumulator >= g_currentEffectiveInterval) {
-            g_internalAccumulator = 0;
-            /** Percent icons are updated by the periodic updater, just reset accumulator */
+static DWORD WINAPI AnimationSchedulerThread(LPVOID param) {
+    (void)param;
+    HANDLE waits[2] = { g_schedWakeEvent, g_schedTimer };
+
+    while (!g_schedStop) {
+        BOOL postUpdate = FALSE;
+        DWORD waitMs = SchedulerStep(SchedulerNowMs(), &postUpdate);
+
+        if (postUpdate) {
+            /** Request update via message (thread-safe) instead of calling Shell API directly */
+            RequestTrayIconUpdate();
         }
-        return;
-    }
-    
-    /** Thread-safe access to animation state */
-    if (g_criticalSectionInitialized) {
-        EnterCriticalSection(&g_animCriticalSection);
-    }
-    
-    /** Advance internal frame logic */
-    BOOL shouldAdvanceFrame = AdvanceInternalFramePosition();
-    
-    if (shouldAdvanceFrame) {
-        /** Move to next frame */
-        if (g_isPreviewActive) {
-            if (g_previewCount > 0) {
-                g_previewIndex = (g_previewIndex + 1) % g_previewCount;
-            }
-        } else {
-            if (g_trayIconCount > 0) {
-                g_trayIconIndex = (g_trayIconIndex + 1) % g_trayIconCount;
+
+        DWORD count = 1;
+        if (waitMs != INFINITE) {
+            /** Negative due time is relative, in 100ns units */
+            LARGE_INTEGER due;
+            due.QuadPart = -(LONGLONG)waitMs * 10000LL;
+            if (due.QuadPart == 0) due.QuadPart = -1;
+            if (SetWaitableTimer(g_schedTimer, &due, 0, NULL, NULL, FALSE)) {
+                count = 2;
             }
         }
+
+        WaitForMultipleObjects(count, waits, FALSE, INFINITE);
+        InterlockedIncrement(&g_schedWakeups);
     }
-    
-    /** Accumulate time for fixed tray update interval */
-    g_internalAccumulator += g_targetInternalInterval;
-    
-    /** Only request tray icon update at fixed interval (e.g., every 50ms) */
-    if (g_internalAccumulator >= g_currentEffectiveInterval) {
-        g_internalAccumulator = 0;
-        
-        if (g_criticalSectionInitialized) {
-            LeaveCriticalSection(&g_animCriticalSection);
-        }
-        
-        /** Request update via message (thread-safe) instead of calling Shell API directly */
-        RequestTrayIconUpdate();
-        return;
-    }
-    
-    if (g_criticalSectionInitialized) {
-        LeaveCriticalSection(&g_animCriticalSection);
-    }
+    return 0;
 }
 
 /**
- * @brief Fallback timer callback for systems where multimedia timer fails
+ * @brief Fallback timer callback for systems where the scheduler thread fails
+ * Same stepping on the UI thread; SetTimer is re-armed as a one-shot per deadline.
  */
 static void CALLBACK FallbackTimerProc(HWND hwnd, UINT msg, UINT_PTR id, DWORD time) {
-    (void)hwnd; (void)msg; (void)id; (void)time;
+    (void)msg; (void)id; (void)time;
+    
+    BOOL postUpdate = FALSE;
+    DWORD waitMs = SchedulerStep(SchedulerNowMs(), &postUpdate);
+    InterlockedIncrement(&g_schedWakeups);
+
+    if (postUpdate) {
+        RequestTrayIconUpdate();
+    }
     
-    /** Use same logic as high-precision callback */
-    HighPrecisionTimerCallback(0, 0, 0, 0, 0);
+    if (waitMs == INFINITE) {
+        KillTimer(hwnd, TRAY_ANIM_TIMER_ID);
+    } else {
+        SetTimer(hwnd, TRAY_ANIM_TIMER_ID, waitMs > USER_TIMER_MINIMUM ? waitMs : USER_TIMER_MINIMUM, FallbackTimerProc);
+    }
 }
 
 /**
- * @brief Initialize high-precision multimedia timer for animations
+ * @brief Start the deadline scheduler thread
  * @return TRUE if successful, FALSE if need to fallback to SetTimer
  */
 static BOOL InitializeAnimationTimer(void) {
@@ -655,50 +983,63 @@ static BOOL InitializeAnimationTimer(void) {
         g_criticalSectionInitialized = TRUE;
     }
     
-    /** Request 1ms timer resolution */
-    MMRESULT mmRes = timeBeginPeriod(1);
-    if (mmRes != TIMERR_NOERROR) {
-        /** If we can't get 1ms, try 2ms */
-        mmRes = timeBeginPeriod(2);
-        if (mmRes != TIMERR_NOERROR) {
-            g_useHighPrecisionTimer = FALSE;
-            return FALSE;
-        }
+    g_schedStop = 0;
+    g_schedWakeups = 0;
+    g_schedStartMs = SchedulerNowMs();
+    g_schedResetDeadline = 1;
+    g_useFallbackTimer = FALSE;
+
+    /** High-resolution waitable timers (Windows 10 1803+) are precise without timeBeginPeriod */
+    g_schedTimer = CreateWaitableTimerExW(NULL, NULL, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+    if (!g_schedTimer) {
+        g_schedTimer = CreateWaitableTimerW(NULL, FALSE, NULL);
+    }
+    g_schedWakeEvent = CreateEventW(NULL, FALSE, FALSE, NULL);
+    if (g_schedTimer && g_schedWakeEvent) {
+        g_schedThread = CreateThread(NULL, 0, AnimationSchedulerThread, NULL, 0, NULL);
     }
     
-    /** Create multimedia timer */
-    g_mmTimerId = timeSetEvent(
-        g_targetInternalInterval,           /** Interval */
-        1,                                   /** Resolution (1ms) */
-        HighPrecisionTimerCallback,          /** Callback */
-        0,                                   /** User data */
-        TIME_PERIODIC | TIME_KILL_SYNCHRONOUS  /** Periodic and synchronous cleanup */
-    );
-    
-    if (g_mmTimerId == 0) {
-        /** Failed to create multimedia timer */
-        timeEndPeriod(1);
-        g_useHighPrecisionTimer = FALSE;
+    if (!g_schedThread) {
+        WriteLog(LOG_LEVEL_WARNING, "Animation scheduler thread unavailable (error %lu), using SetTimer", GetLastError());
+        if (g_schedTimer) { CloseHandle(g_schedTimer); g_schedTimer = NULL; }
+        if (g_schedWakeEvent) { CloseHandle(g_schedWakeEvent); g_schedWakeEvent = NULL; }
+        g_useFallbackTimer = TRUE;
         return FALSE;
     }
     
-    g_useHighPrecisionTimer = TRUE;
     return TRUE;
 }
 
 /**
- * @brief Cleanup high-precision timer system
+ * @brief Stop the scheduler and report its wakeup rate
  */
 static void CleanupHighPrecisionTimer(void) {
-    if (g_mmTimerId != 0) {
-        timeKillEvent(g_mmTimerId);
-        g_mmTimerId = 0;
+    if (g_schedThread) {
+        InterlockedExchange(&g_schedStop, 1);
+        SetEvent(g_schedWakeEvent);
+        WaitForSingleObject(g_schedThread, 2000);
+        CloseHandle(g_schedThread);
+        g_schedThread = NULL;
     }
-    
-    if (g_useHighPrecisionTimer) {
-        timeEndPeriod(1);
-        g_useHighPrecisionTimer = FALSE;
+    if (g_schedTimer) {
+        CancelWaitableTimer(g_schedTimer);
+        CloseHandle(g_schedTimer);
+        g_schedTimer = NULL;
+    }
+    if (g_schedWakeEvent) {
+        CloseHandle(g_schedWakeEvent);
+        g_schedWakeEvent = NULL;
+    }
+
+    if (g_schedStartMs > 0.0) {
+        double seconds = (SchedulerNowMs() - g_schedStartMs) / 1000.0;
+        LONG wakeups = g_schedWakeups;
+        WriteLog(LOG_LEVEL_DEBUG, "Animation scheduler: %ld wakeups in %.1f s (%.2f/s)%s",
+                 wakeups, seconds, seconds > 0.0 ? wakeups / seconds : 0.0,
+                 g_useFallbackTimer ? " [SetTimer fallback]" : "");
+        g_schedStartMs = 0.0;
     }
+    g_useFallbackTimer = FALSE;
     
     /** Cleanup critical section */
     if (g_criticalSectionInitialized) {
@@ -707,6 +1048,21 @@ static void CleanupHighPrecisionTimer(void) {
     }
 }
 
+/**
+ * @brief Tell the scheduler that frames, preview state or speed changed
+ * @param resetDeadline TRUE to restart timing of the current frame from now
+ */
+static void WakeAnimationScheduler(BOOL resetDeadline) {
+    if (resetDeadline) {
+        InterlockedExchange(&g_schedResetDeadline, 1);
+    }
+    if (g_schedWakeEvent) {
+        SetEvent(g_schedWakeEvent);
+    } else if (g_useFallbackTimer && g_trayHwnd) {
+        SetTimer(g_trayHwnd, TRAY_ANIM_TIMER_ID, USER_TIMER_MINIMUM, FallbackTimerProc);
+    }
+}
+
 /** @brief Update tray icon tooltip with current playback speed info (English only) */
 
 /** @brief Build animation folder path under %LOCALAPPDATA%\Catime\resources\animations */
@@ -721,23 +1077,311 @@ static void BuildAnimationFolder(const char* name, char* path, size_t size) {
     }
 }
 
-/** @brief Free a set of icon resources, including the composition canvas */
-static void FreeIconSet(HICON icons[], int* count, int* index, BOOL* isAnimated, BYTE** canvas, BOOL resetCanvasSize) {
-    for (int i = 0; i < *count; ++i) {
-        if (icons[i]) {
-            DestroyIcon(icons[i]);
-            icons[i] = NULL;
-        }
-    }
-    *count = 0;
-    *index = 0;
-    *isAnimated = FALSE;
-    
-    if (*canvas) {
-        free(*canvas);
-        *canvas = NULL;
+/**
+ * @brief Decoded animation cache
+ *
+ * Recently decoded master sets, keyed by animation name and the source's
+ * last-write stamp. Tray and preview loads share it, and the prefetch worker
+ * fills it ahead of the pointer. A frame store built from an entry pins it and
+ * borrows its masters instead of owning copies. Eviction is least recently
+ * used within ANIM_CACHE_MAX_BYTES and never touches pinned entries.
+ */
+#define ANIM_CACHE_MAX_ENTRIES 16              /** Cached animations (tray, preview and prefetched neighbours) */
+#define ANIM_CACHE_MAX_BYTES (16u * 1024u * 1024u) /** Master bytes kept across all entries */
+#define ANIM_PREFETCH_QUEUE_SIZE 4             /** Pending neighbour names; a new hover replaces the queue */
+#define ANIM_PREFETCH_JOIN_TIMEOUT_MS 3000     /** Longest a load waits for the worker decoding the same name */
+
+/** @brief Identifies the on-disk state an entry was decoded from */
+typedef struct {
+    FILETIME lastWrite;         /** File time, or folder time (changes when frames are added/removed/renamed) */
+    ULONGLONG size;             /** File size, 0 for folders */
+} AnimSourceStamp;
+
+struct AnimCacheEntry {
+    char name[MAX_PATH];
+    AnimSourceStamp stamp;
+    int masterEdge;
+    int count;
+    BOOL isAnimated;
+    BYTE* masters[MAX_TRAY_FRAMES];
+    UINT delays[MAX_TRAY_FRAMES];
+    SIZE_T bytes;               /** Arena bytes held by the masters */
+    LONG pins;                  /** Frame stores borrowing the masters */
+    BOOL detached;              /** Dropped from the table while pinned; freed on last release */
+    ULONGLONG lastUse;          /** LRU clock value of the last hit or insert */
+};
+
+static AnimCacheEntry* g_animCache[ANIM_CACHE_MAX_ENTRIES];
+static SIZE_T g_animCacheBytes = 0;
+static ULONGLONG g_animCacheClock = 0;
+static UINT g_animCacheHits = 0;
+static UINT g_animCacheMisses = 0;
+static CRITICAL_SECTION g_animCacheLock;            /** Guards the table, pins and the prefetch queue */
+static BOOL g_animCacheLockInitialized = FALSE;
+
+/** @brief Create the cache lock; UI thread only, before the prefetch worker can exist */
+static void AnimCache_EnsureLock(void) {
+    if (!g_animCacheLockInitialized) {
+        InitializeCriticalSection(&g_animCacheLock);
+        g_animCacheLockInitialized = TRUE;
     }
-    if (resetCanvasSize) {
+}
+
+/** @brief Read the last-write stamp of an animation file or folder */
+static BOOL ReadAnimationSourceStamp(const char* utf8Path, AnimSourceStamp* out) {
+    wchar_t wPath[MAX_PATH] = {0};
+    MultiByteToWideChar(CP_UTF8, 0, utf8Path, -1, wPath, MAX_PATH);
+    WIN32_FILE_ATTRIBUTE_DATA data;
+    if (!GetFileAttributesExW(wPath, GetFileExInfoStandard, &data)) return FALSE;
+    out->lastWrite = data.ftLastWriteTime;
+    out->size = (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+        ? 0 : (((ULONGLONG)data.nFileSizeHigh << 32) | data.nFileSizeLow);
+    return TRUE;
+}
+
+static BOOL SameSourceStamp(const AnimSourceStamp* a, const AnimSourceStamp* b) {
+    return CompareFileTime(&a->lastWrite, &b->lastWrite) == 0 && a->size == b->size;
+}
+
+static void AnimCacheEntry_Free(AnimCacheEntry* entry) {
+    for (int i = 0; i < entry->count; ++i) {
+        FrameArena_Free(entry->masters[i]);
+    }
+    free(entry);
+}
+
+/**
+ * @brief Remove a table slot (lock held)
+ * @return Entry the caller must free after unlocking, NULL if still pinned
+ */
+static AnimCacheEntry* AnimCache_UnlinkLocked(int slot) {
+    AnimCacheEntry* entry = g_animCache[slot];
+    g_animCache[slot] = NULL;
+    g_animCacheBytes -= entry->bytes;
+    if (entry->pins > 0) {
+        entry->detached = TRUE;
+        return NULL;
+    }
+    return entry;
+}
+
+static int AnimCache_FindLocked(const char* name) {
+    for (int i = 0; i < ANIM_CACHE_MAX_ENTRIES; ++i) {
+        if (g_animCache[i] && _stricmp(g_animCache[i]->name, name) == 0) return i;
+    }
+    return -1;
+}
+
+/** @brief Least recently used unpinned slot other than keep, -1 if none */
+static int AnimCache_VictimLocked(const AnimCacheEntry* keep) {
+    int victim = -1;
+    for (int i = 0; i < ANIM_CACHE_MAX_ENTRIES; ++i) {
+        AnimCacheEntry* e = g_animCache[i];
+        if (!e || e == keep || e->pins > 0) continue;
+        if (victim < 0 || e->lastUse < g_animCache[victim]->lastUse) victim = i;
+    }
+    return victim;
+}
+
+/**
+ * @brief Pin the entry for a name if it matches the source and is sharp enough
+ * @param minMasterEdge Smallest master edge the caller can build its icons from
+ * @return Pinned entry (release with AnimCache_Release), or NULL on a miss
+ */
+static AnimCacheEntry* AnimCache_Acquire(const char* name, const AnimSourceStamp* stamp, int minMasterEdge) {
+    AnimCacheEntry* entry = NULL;
+    AnimCacheEntry* stale = NULL;
+
+    EnterCriticalSection(&g_animCacheLock);
+    int slot = AnimCache_FindLocked(name);
+    if (slot >= 0) {
+        AnimCacheEntry* e = g_animCache[slot];
+        if (!SameSourceStamp(&e->stamp, stamp)) {
+            stale = AnimCache_UnlinkLocked(slot);
+        } else if (e->masterEdge >= minMasterEdge) {
+            e->pins++;
+            e->lastUse = ++g_animCacheClock;
+            entry = e;
+        }
+    }
+    LeaveCriticalSection(&g_animCacheLock);
+
+    if (stale) AnimCacheEntry_Free(stale);
+    return entry;
+}
+
+/** @brief Drop a pin taken by AnimCache_Acquire or AnimCache_AdoptStore */
+static void AnimCache_Release(AnimCacheEntry* entry) {
+    if (!entry) return;
+    BOOL freeNow = FALSE;
+    EnterCriticalSection(&g_animCacheLock);
+    entry->pins--;
+    freeNow = (entry->pins <= 0 && entry->detached);
+    LeaveCriticalSection(&g_animCacheLock);
+    if (freeNow) AnimCacheEntry_Free(entry);
+}
+
+/**
+ * @brief Hand a freshly decoded store's masters to the cache
+ *
+ * On success the store keeps the same master pointers but borrows them: it
+ * holds one pin and FrameStore_Clear releases it instead of freeing. Sets with
+ * a frame that has no master (.ico files) are not cached.
+ * @return TRUE if the masters now belong to a cache entry
+ */
+static BOOL AnimCache_AdoptStore(const char* name, const AnimSourceStamp* stamp, DecodeTarget* target) {
+    FrameStore* store = target->store;
+    int count = *(target->count);
+    if (count <= 0 || store->cacheEntry) return FALSE;
+
+    SIZE_T bytes = 0;
+    for (int i = 0; i < count; ++i) {
+        if (!store->masters[i]) return FALSE;
+        bytes += FrameArena_BlockSize(store->masters[i]);
+    }
+    if (bytes > ANIM_CACHE_MAX_BYTES) return FALSE;
+
+    AnimCacheEntry* entry = (AnimCacheEntry*)calloc(1, sizeof(AnimCacheEntry));
+    if (!entry) return FALSE;
+    strncpy_s(entry->name, sizeof(entry->name), name, _TRUNCATE);
+    entry->stamp = *stamp;
+    entry->masterEdge = store->masterEdge;
+    entry->count = count;
+    entry->isAnimated = *(target->isAnimatedFlag);
+    memcpy(entry->masters, store->masters, sizeof(BYTE*) * (size_t)count);
+    memcpy(entry->delays, target->delays, sizeof(UINT) * (size_t)count);
+    entry->bytes = bytes;
+    entry->pins = 1;
+
+    AnimCacheEntry* release[ANIM_CACHE_MAX_ENTRIES + 1];
+    int releaseCount = 0;
+
+    EnterCriticalSection(&g_animCacheLock);
+    int slot = AnimCache_FindLocked(name);
+    if (slot >= 0) {
+        release[releaseCount] = AnimCache_UnlinkLocked(slot);
+        if (release[releaseCount]) releaseCount++;
+    } else {
+        for (int i = 0; i < ANIM_CACHE_MAX_ENTRIES; ++i) {
+            if (!g_animCache[i]) { slot = i; break; }
+        }
+        if (slot < 0) {
+            slot = AnimCache_VictimLocked(NULL);
+            if (slot >= 0) {
+                release[releaseCount] = AnimCache_UnlinkLocked(slot);
+                if (release[releaseCount]) releaseCount++;
+            }
+        }
+    }
+    if (slot >= 0) {
+        entry->lastUse = ++g_animCacheClock;
+        g_animCache[slot] = entry;
+        g_animCacheBytes += bytes;
+        while (g_animCacheBytes > ANIM_CACHE_MAX_BYTES) {
+            int victim = AnimCache_VictimLocked(entry);
+            if (victim < 0) break;
+            release[releaseCount] = AnimCache_UnlinkLocked(victim);
+            if (release[releaseCount]) releaseCount++;
+        }
+    }
+    LeaveCriticalSection(&g_animCacheLock);
+
+    for (int i = 0; i < releaseCount; ++i) {
+        AnimCacheEntry_Free(release[i]);
+    }
+    if (slot < 0) {
+        /** Every slot pinned; the store keeps owning its masters */
+        free(entry);
+        return FALSE;
+    }
+    store->cacheEntry = entry;
+    return TRUE;
+}
+
+/** @brief Free every unpinned entry and report hit rate; pinned entries are freed on release */
+static void AnimCache_Clear(void) {
+    if (!g_animCacheLockInitialized) return;
+
+    AnimCacheEntry* release[ANIM_CACHE_MAX_ENTRIES];
+    int releaseCount = 0;
+    EnterCriticalSection(&g_animCacheLock);
+    for (int i = 0; i < ANIM_CACHE_MAX_ENTRIES; ++i) {
+        if (!g_animCache[i]) continue;
+        release[releaseCount] = AnimCache_UnlinkLocked(i);
+        if (release[releaseCount]) releaseCount++;
+    }
+    LeaveCriticalSection(&g_animCacheLock);
+
+    for (int i = 0; i < releaseCount; ++i) {
+        AnimCacheEntry_Free(release[i]);
+    }
+    if (g_animCacheHits + g_animCacheMisses > 0) {
+        WriteLog(LOG_LEVEL_DEBUG, "Animation cache: %u hits, %u misses", g_animCacheHits, g_animCacheMisses);
+    }
+    g_animCacheHits = 0;
+    g_animCacheMisses = 0;
+}
+
+/** @brief Destroy the icons held by a parked size set and mark the slot empty */
+static void FrameSizeSet_Clear(FrameSizeSet* set) {
+    for (int i = 0; i < set->count; ++i) {
+        if (set->icons[i]) {
+            DestroyIcon(set->icons[i]);
+            set->icons[i] = NULL;
+        }
+    }
+    set->count = 0;
+    set->edge = 0;
+    set->lastUsedTick = 0;
+}
+
+/** @brief Release all masters (or the borrowed cache entry) and parked size sets of a frame store */
+static void FrameStore_Clear(FrameStore* store) {
+    if (!store) return;
+    for (int i = 0; i < MAX_TRAY_FRAMES; ++i) {
+        if (!store->cacheEntry) FrameArena_Free(store->masters[i]);
+        store->masters[i] = NULL;
+    }
+    if (store->cacheEntry) {
+        AnimCache_Release(store->cacheEntry);
+        store->cacheEntry = NULL;
+    }
+    for (int i = 0; i < FRAME_STORE_MAX_SIZES; ++i) {
+        FrameSizeSet_Clear(&store->parked[i]);
+    }
+    store->masterEdge = 0;
+    store->activeEdge = 0;
+}
+
+/** @brief Drop parked sizes that have not been active for FRAME_SET_IDLE_EVICT_MS */
+static void FrameStore_EvictIdle(FrameStore* store, DWORD now) {
+    for (int i = 0; i < FRAME_STORE_MAX_SIZES; ++i) {
+        FrameSizeSet* set = &store->parked[i];
+        if (set->edge != 0 && (now - set->lastUsedTick) >= FRAME_SET_IDLE_EVICT_MS) {
+            WriteLog(LOG_LEVEL_DEBUG, "Evicting idle %dpx animation frame set", set->edge);
+            FrameSizeSet_Clear(set);
+        }
+    }
+}
+
+/** @brief Free a set of icon resources, including the composition canvas and frame store */
+static void FreeIconSet(HICON icons[], int* count, int* index, BOOL* isAnimated, BYTE** canvas, FrameStore* store, BOOL resetCanvasSize) {
+    FrameStore_Clear(store);
+    for (int i = 0; i < *count; ++i) {
+        if (icons[i]) {
+            DestroyIcon(icons[i]);
+            icons[i] = NULL;
+        }
+    }
+    *count = 0;
+    *index = 0;
+    *isAnimated = FALSE;
+    
+    if (*canvas) {
+        FrameArena_Free(*canvas);
+        *canvas = NULL;
+    }
+    if (resetCanvasSize) {
         g_animCanvasWidth = 0;
         g_animCanvasHeight = 0;
     }
@@ -773,75 +1417,22 @@ static BOOL IsStaticImageSelection(const char* name) {
            EndsWithIgnoreCase(name, ".tiff");
 }
 
-/** @brief Alpha blend pixel onto canvas with proper compositing */
-static void BlendPixel(BYTE* canvas, UINT canvasStride, UINT x, UINT y, BYTE r, BYTE g, BYTE b, BYTE a) {
-    if (a == 0) return; /** fully transparent, no change */
-    
-    BYTE* pixel = canvas + (y * canvasStride) + (x * 4);
-    if (a == 255) {
-        /** fully opaque, direct copy */
-        pixel[0] = b; /** B */
-        pixel[1] = g; /** G */
-        pixel[2] = r; /** R */
-        pixel[3] = a; /** A */
-    } else {
-        /** alpha blend with existing pixel */
-        UINT srcAlpha = a;
-        UINT dstAlpha = pixel[3];
-        
-        if (dstAlpha == 0) {
-            /** destination is transparent, just copy source */
-            pixel[0] = b;
-            pixel[1] = g;
-            pixel[2] = r;
-            pixel[3] = a;
-        } else {
-            /** proper alpha compositing: src over dst */
-            UINT invSrcAlpha = 255 - srcAlpha;
-            UINT newAlpha = srcAlpha + (dstAlpha * invSrcAlpha) / 255;
-            
-            if (newAlpha > 0) {
-                pixel[0] = (BYTE)((b * srcAlpha + pixel[0] * dstAlpha * invSrcAlpha / 255) / newAlpha);
-                pixel[1] = (BYTE)((g * srcAlpha + pixel[1] * dstAlpha * invSrcAlpha / 255) / newAlpha);
-                pixel[2] = (BYTE)((r * srcAlpha + pixel[2] * dstAlpha * invSrcAlpha / 255) / newAlpha);
-                pixel[3] = (BYTE)newAlpha;
-            }
-        }
-    }
-}
-
-/** @brief Clear rectangle on canvas with background color (supports transparency) */
-static void ClearCanvasRect(BYTE* canvas, UINT canvasWidth, UINT canvasHeight, 
-                           UINT left, UINT top, UINT width, UINT height, 
-                           BYTE bgR, BYTE bgG, BYTE bgB, BYTE bgA) {
-    UINT canvasStride = canvasWidth * 4;
-    UINT right = left + width;
-    UINT bottom = top + height;
-    
-    /** Clamp to canvas bounds */
-    if (left >= canvasWidth || top >= canvasHeight) return;
-    if (right > canvasWidth) right = canvasWidth;
-    if (bottom > canvasHeight) bottom = canvasHeight;
-    
-    for (UINT y = top; y < bottom; y++) {
-        for (UINT x = left; x < right; x++) {
-            BYTE* pixel = canvas + (y * canvasStride) + (x * 4);
-            pixel[0] = bgB; /** B */
-            pixel[1] = bgG; /** G */
-            pixel[2] = bgR; /** R */
-            pixel[3] = bgA; /** A */
-        }
-    }
-}
-
-/** @brief Create an HICON from any IWICBitmapSource by scaling to (cx, cy) */
-static HICON CreateIconFromWICSource(IWICImagingFactory* pFactory,
-                                     IWICBitmapSource* source,
-                                     int cx,
-                                     int cy) {
-    if (!pFactory || !source || cx <= 0 || cy <= 0) return NULL;
+/**
+ * @brief Scale any IWICBitmapSource into a (cx, cy) top-down PBGRA buffer
+ *
+ * Aspect ratio is preserved; the image is centered on a transparent background.
+ * @param outPixels Buffer of at least cx * cy * 4 bytes
+ * @return TRUE if pixels were written
+ */
+static BOOL ScaleSourceToPixels(ImagingContext* ctx,
+                                IWICBitmapSource* source,
+                                int cx,
+                                int cy,
+                                BYTE* outPixels) {
+    if (!ctx || !ctx->factory || !source || !outPixels || cx <= 0 || cy <= 0) return FALSE;
 
-    HICON hIcon = NULL;
+    IWICImagingFactory* pFactory = ctx->factory;
+    BOOL ok = FALSE;
 
     IWICBitmapScaler* pScaler = NULL;
     HRESULT hr = pFactory->lpVtbl->CreateBitmapScaler(pFactory, &pScaler);
@@ -862,6 +1453,8 @@ static HICON CreateIconFromWICSource(IWICImagingFactory* pFactory,
         UINT dstH = (UINT)((double)srcH * scale + 0.5);
         if (dstW == 0) dstW = 1;
         if (dstH == 0) dstH = 1;
+        if (dstW > (UINT)cx) dstW = (UINT)cx;
+        if (dstH > (UINT)cy) dstH = (UINT)cy;
 
         hr = pScaler->lpVtbl->Initialize(pScaler, source, dstW, dstH, WICBitmapInterpolationModeFant);
         if (SUCCEEDED(hr)) {
@@ -876,64 +1469,21 @@ static HICON CreateIconFromWICSource(IWICImagingFactory* pFactory,
                                                     0.0,
                                                     WICBitmapPaletteTypeCustom);
                 if (SUCCEEDED(hr)) {
-                    BITMAPINFO bi; ZeroMemory(&bi, sizeof(bi));
-                    bi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
-                    bi.bmiHeader.biWidth = cx;
-                    bi.bmiHeader.biHeight = -cy; /** top-down */
-                    bi.bmiHeader.biPlanes = 1;
-                    bi.bmiHeader.biBitCount = 32;
-                    bi.bmiHeader.biCompression = BI_RGB;
-                    VOID* pvBits = NULL;
-                    HBITMAP hbmColor = CreateDIBSection(NULL, &bi, DIB_RGB_COLORS, &pvBits, NULL, 0);
-                    if (hbmColor && pvBits) {
-                        /** Clear background to transparent */
-                        ZeroMemory(pvBits, (SIZE_T)(cy * (cx * 4)));
-
-                        /** Copy scaled pixels into centered position */
-                        UINT scaledStride = dstW * 4;
-                        UINT scaledSize = dstH * scaledStride;
-                        /** Use memory pool for temporary buffer */
-                        BYTE* tmp = (BYTE*)MemoryPool_Alloc(scaledSize);
-                        if (tmp) {
-                            if (SUCCEEDED(pConverter->lpVtbl->CopyPixels(pConverter, NULL, scaledStride, scaledSize, tmp))) {
-                                int xoff = (cx - (int)dstW) / 2;
-                                int yoff = (cy - (int)dstH) / 2;
-                                if (xoff < 0) xoff = 0;
-                                if (yoff < 0) yoff = 0;
-                                for (UINT y = 0; y < dstH; ++y) {
-                                    BYTE* dstRow = (BYTE*)pvBits + ((yoff + (int)y) * cx + xoff) * 4;
-                                    BYTE* srcRow = tmp + y * scaledStride;
-                                    memcpy(dstRow, srcRow, scaledStride);
-                                }
+                    UINT outStride = (UINT)cx * 4;
+                    UINT scaledStride = dstW * 4;
+                    UINT scaledSize = dstH * scaledStride;
+                    BYTE* scaled = EnsureImagingBuffer(&ctx->scratch, &ctx->scratchSize, scaledSize);
+                    if (scaled) {
+                        ZeroMemory(outPixels, (SIZE_T)cy * outStride);
+                        if (SUCCEEDED(pConverter->lpVtbl->CopyPixels(pConverter, NULL, scaledStride, scaledSize, scaled))) {
+                            UINT xoff = ((UINT)cx - dstW) / 2;
+                            UINT yoff = ((UINT)cy - dstH) / 2;
+                            for (UINT y = 0; y < dstH; ++y) {
+                                memcpy(outPixels + (yoff + y) * outStride + xoff * 4,
+                                       scaled + y * scaledStride, scaledStride);
                             }
-                            MemoryPool_Free(tmp);
-                        }
-
-                        ICONINFO ii; ZeroMemory(&ii, sizeof(ii));
-                        ii.fIcon = TRUE;
-                        ii.hbmColor = hbmColor;
-
-                        ii.hbmMask = CreateBitmap(cx, cy, 1, 1, NULL);
-                        if (ii.hbmMask) {
-                            HDC hdcMem = GetDC(NULL);
-                            HDC hdcColor = CreateCompatibleDC(hdcMem);
-                            HDC hdcMask = CreateCompatibleDC(hdcMem);
-                            SelectObject(hdcColor, hbmColor);
-                            SelectObject(hdcMask, ii.hbmMask);
-
-                            BitBlt(hdcMask, 0, 0, cx, cy, NULL, 0, 0, BLACKNESS);
-                            SetBkColor(hdcColor, RGB(0,0,0));
-                            BitBlt(hdcMask, 0, 0, cx, cy, hdcColor, 0, 0, SRCCOPY);
-                            BitBlt(hdcMask, 0, 0, cx, cy, NULL, 0, 0, DSTINVERT);
-
-                            DeleteDC(hdcColor);
-                            DeleteDC(hdcMask);
-                            ReleaseDC(NULL, hdcMem);
+                            ok = TRUE;
                         }
-
-                        hIcon = CreateIconIndirect(&ii);
-                        if (ii.hbmMask) DeleteObject(ii.hbmMask);
-                        DeleteObject(hbmColor);
                     }
                 }
                 pConverter->lpVtbl->Release(pConverter);
@@ -942,33 +1492,261 @@ static HICON CreateIconFromWICSource(IWICImagingFactory* pFactory,
         pScaler->lpVtbl->Release(pScaler);
     }
 
-    return hIcon;
+    return ok;
 }
 
-/** @brief Create an HICON from a 32bpp PBGRA memory canvas by scaling to (cx, cy) */
-static HICON CreateIconFromPBGRA(IWICImagingFactory* pFactory,
-                                 const BYTE* canvasPixels,
-                                 UINT canvasWidth,
-                                 UINT canvasHeight,
-                                 int cx,
-                                 int cy) {
-    if (!pFactory || !canvasPixels || canvasWidth == 0 || canvasHeight == 0 || cx <= 0 || cy <= 0) return NULL;
-
-    HICON hIcon = NULL;
+/** @brief Scale a 32bpp PBGRA memory image into a (cx, cy) PBGRA buffer */
+static BOOL ScalePBGRAToPixels(ImagingContext* ctx,
+                               const BYTE* srcPixels,
+                               UINT srcWidth,
+                               UINT srcHeight,
+                               int cx,
+                               int cy,
+                               BYTE* outPixels) {
+    if (!ctx || !ctx->factory || !srcPixels || srcWidth == 0 || srcHeight == 0) return FALSE;
+
+    IWICImagingFactory* pFactory = ctx->factory;
     IWICBitmap* pBitmap = NULL;
+    const UINT stride = srcWidth * 4;
+    const UINT size = srcHeight * stride;
 
-    const UINT stride = canvasWidth * 4;
-    const UINT size = canvasHeight * stride;
-
-    HRESULT hr = pFactory->lpVtbl->CreateBitmapFromMemory(pFactory, canvasWidth, canvasHeight, &GUID_WICPixelFormat32bppPBGRA, stride, size, (BYTE*)canvasPixels, &pBitmap);
+    BOOL ok = FALSE;
+    HRESULT hr = pFactory->lpVtbl->CreateBitmapFromMemory(pFactory, srcWidth, srcHeight, &GUID_WICPixelFormat32bppPBGRA, stride, size, (BYTE*)srcPixels, &pBitmap);
     if (SUCCEEDED(hr) && pBitmap) {
-        hIcon = CreateIconFromWICSource(pFactory, (IWICBitmapSource*)pBitmap, cx, cy);
+        ok = ScaleSourceToPixels(ctx, (IWICBitmapSource*)pBitmap, cx, cy, outPixels);
         pBitmap->lpVtbl->Release(pBitmap);
     }
+    return ok;
+}
 
+/** @brief Create a (cx, cy) HICON from a square PBGRA master, scaling only when sizes differ */
+static HICON CreateIconFromMaster(ImagingContext* ctx, const BYTE* master, int masterEdge, int cx, int cy) {
+    if (!ctx || !master || masterEdge <= 0) return NULL;
+    if (cx == masterEdge && cy == masterEdge) {
+        return CreateIconFromPixels(ctx, master, cx, cy);
+    }
+    BYTE* iconPixels = (BYTE*)FrameArena_Alloc((SIZE_T)cx * (SIZE_T)cy * 4);
+    if (!iconPixels) return NULL;
+    HICON hIcon = NULL;
+    if (ScalePBGRAToPixels(ctx, master, (UINT)masterEdge, (UINT)masterEdge, cx, cy, iconPixels)) {
+        hIcon = CreateIconFromPixels(ctx, iconPixels, cx, cy);
+    }
+    FrameArena_Free(iconPixels);
     return hIcon;
 }
 
+/** @brief Master edge for a target: never below the icon size being built */
+static int FrameStore_MasterEdge(const DecodeTarget* target) {
+    return target->edge > FRAME_MASTER_SIZE ? target->edge : FRAME_MASTER_SIZE;
+}
+
+/**
+ * @brief Append one decoded frame to a target
+ *
+ * Keeps the master in the frame store (ownership transferred) and builds the
+ * active-size icon from it. A NULL master marks the frame as not rebuildable.
+ * @return TRUE if the frame was appended
+ */
+static BOOL AppendDecodedFrame(ImagingContext* ctx, DecodeTarget* target, BYTE* master, HICON preloaded, UINT delayMs) {
+    int slot = *(target->count);
+    if (slot >= MAX_TRAY_FRAMES) {
+        FrameArena_Free(master);
+        if (preloaded) DestroyIcon(preloaded);
+        return FALSE;
+    }
+
+    if (target->mastersOnly) {
+        /** Prefetch keeps masters only; a NULL master leaves the set uncacheable */
+        if (preloaded) DestroyIcon(preloaded);
+        target->icons[slot] = NULL;
+        target->delays[slot] = delayMs;
+        target->store->masters[slot] = master;
+        (*(target->count))++;
+        return master != NULL;
+    }
+
+    HICON hIcon = preloaded;
+    if (!hIcon && master) {
+        hIcon = CreateIconFromMaster(ctx, master, target->store->masterEdge, target->edge, target->edge);
+    }
+    if (!hIcon) {
+        FrameArena_Free(master);
+        return FALSE;
+    }
+
+    target->icons[slot] = hIcon;
+    target->delays[slot] = delayMs;
+    target->store->masters[slot] = master;
+    target->store->activeEdge = target->edge;
+    (*(target->count))++;
+    return TRUE;
+}
+
+/** @brief Decode an image file's first frame into a new master of the store's edge */
+static BYTE* DecodeFileToMaster(ImagingContext* ctx, const wchar_t* wPath, int masterEdge) {
+    if (!ctx) return NULL;
+
+    BYTE* master = NULL;
+    IWICImagingFactory* pFactory = ctx->factory;
+    IWICBitmapDecoder* pDecoder = NULL;
+    if (SUCCEEDED(pFactory->lpVtbl->CreateDecoderFromFilename(pFactory, wPath, NULL, GENERIC_READ, WICDecodeMetadataCacheOnDemand, &pDecoder)) && pDecoder) {
+        IWICBitmapFrameDecode* pFrame = NULL;
+        if (SUCCEEDED(pDecoder->lpVtbl->GetFrame(pDecoder, 0, &pFrame)) && pFrame) {
+            master = (BYTE*)FrameArena_Alloc((SIZE_T)masterEdge * (SIZE_T)masterEdge * 4);
+            if (master && !ScaleSourceToPixels(ctx, (IWICBitmapSource*)pFrame, masterEdge, masterEdge, master)) {
+                FrameArena_Free(master);
+                master = NULL;
+            }
+            pFrame->lpVtbl->Release(pFrame);
+        }
+        pDecoder->lpVtbl->Release(pDecoder);
+    }
+    return master;
+}
+
+/**
+ * @brief Decode a single static image file (or .ico) as one frame of a target
+ * .ico files go through LoadImageW at the requested size and keep no master.
+ */
+static BOOL AppendImageFileFrame(ImagingContext* ctx, DecodeTarget* target, const wchar_t* wPath) {
+    const wchar_t* ext = wcsrchr(wPath, L'.');
+    if (ext && _wcsicmp(ext, L".ico") == 0) {
+        if (target->mastersOnly) return AppendDecodedFrame(ctx, target, NULL, NULL, 0);
+        HICON hIcon = (HICON)LoadImageW(NULL, wPath, IMAGE_ICON, target->edge, target->edge, LR_LOADFROMFILE);
+        return hIcon ? AppendDecodedFrame(ctx, target, NULL, hIcon, 0) : FALSE;
+    }
+    BYTE* master = DecodeFileToMaster(ctx, wPath, target->store->masterEdge);
+    return master ? AppendDecodedFrame(ctx, target, master, NULL, 0) : FALSE;
+}
+
+/**
+ * @brief Switch a target's active icons to another edge size without decoding
+ *
+ * The current set is parked (evicting the least recently used slot if needed),
+ * then a parked set of the new size is reactivated or rebuilt from masters.
+ * @return FALSE if the target has frames without masters and must be reloaded
+ */
+static BOOL FrameStore_SwitchEdge(DecodeTarget* target, int newEdge) {
+    FrameStore* store = target->store;
+    int count = *(target->count);
+    if (count <= 0 || store->activeEdge == newEdge) return TRUE;
+
+    for (int i = 0; i < count; ++i) {
+        if (!store->masters[i]) return FALSE;
+    }
+
+    DWORD now = GetTickCount();
+    FrameStore_EvictIdle(store, now);
+
+    /** Reuse a parked set for the requested size if we have one */
+    FrameSizeSet* reuse = NULL;
+    for (int i = 0; i < FRAME_STORE_MAX_SIZES; ++i) {
+        if (store->parked[i].edge == newEdge && store->parked[i].count == count) {
+            reuse = &store->parked[i];
+            break;
+        }
+    }
+
+    HICON built[MAX_TRAY_FRAMES] = {0};
+    if (reuse) {
+        memcpy(built, reuse->icons, sizeof(HICON) * (size_t)count);
+        reuse->count = 0;
+        FrameSizeSet_Clear(reuse);
+    } else {
+        ImagingContext* ctx = AcquireImagingContext();
+        if (!ctx) return FALSE;
+        for (int i = 0; i < count; ++i) {
+            built[i] = CreateIconFromMaster(ctx, store->masters[i], store->masterEdge, newEdge, newEdge);
+            if (!built[i]) {
+                for (int j = 0; j < i; ++j) DestroyIcon(built[j]);
+                return FALSE;
+            }
+        }
+    }
+
+    /** Park the outgoing set in a free slot, else the least recently used one */
+    FrameSizeSet* slot = &store->parked[0];
+    for (int i = 0; i < FRAME_STORE_MAX_SIZES; ++i) {
+        FrameSizeSet* candidate = &store->parked[i];
+        if (candidate->edge == 0) { slot = candidate; break; }
+        if ((now - candidate->lastUsedTick) > (now - slot->lastUsedTick)) slot = candidate;
+    }
+    FrameSizeSet_Clear(slot);
+
+    if (g_criticalSectionInitialized) EnterCriticalSection(&g_animCriticalSection);
+    memcpy(slot->icons, target->icons, sizeof(HICON) * (size_t)count);
+    memcpy(target->icons, built, sizeof(HICON) * (size_t)count);
+    if (g_criticalSectionInitialized) LeaveCriticalSection(&g_animCriticalSection);
+
+    slot->count = count;
+    slot->edge = store->activeEdge;
+    slot->lastUsedTick = now;
+    WriteLog(LOG_LEVEL_INFO, "Animation frames switched from %dpx to %dpx (%s)",
+             store->activeEdge, newEdge, reuse ? "cached" : "rebuilt from masters");
+    store->activeEdge = newEdge;
+    return TRUE;
+}
+
+/** @brief Position, timing and compositing flags of one WebP ANMF frame */
+typedef struct {
+    FrameRect rect;
+    UINT durationMs;
+    FrameBlendMode blend;
+    FrameDisposeMode dispose;
+} WebPFrameLayout;
+
+static UINT ReadLE24(const BYTE* p) {
+    return (UINT)p[0] | ((UINT)p[1] << 8) | ((UINT)p[2] << 16);
+}
+
+/**
+ * @brief Read the canvas size and ANMF frame headers of an animated WebP
+ *
+ * WIC's WebP codec only exposes the frame duration as ANMF metadata, so the
+ * offsets, blending and disposal bits are read from the RIFF chunk headers.
+ * Frame payloads are skipped, not read.
+ * @return Number of ANMF frames found (0 if not an animated WebP)
+ */
+static UINT ReadWebPFrameLayout(const wchar_t* wPath, WebPFrameLayout* frames, UINT maxFrames,
+                                UINT* canvasWidth, UINT* canvasHeight) {
+    FILE* file = _wfopen(wPath, L"rb");
+    if (!file) return 0;
+
+    UINT count = 0;
+    BYTE header[12];
+    if (fread(header, 1, 12, file) == 12 &&
+        memcmp(header, "RIFF", 4) == 0 && memcmp(header + 8, "WEBP", 4) == 0) {
+        BYTE chunk[8];
+        while (count < maxFrames && fread(chunk, 1, 8, file) == 8) {
+            DWORD size = (DWORD)chunk[4] | ((DWORD)chunk[5] << 8) | ((DWORD)chunk[6] << 16) | ((DWORD)chunk[7] << 24);
+            long skip = (long)(size + (size & 1));
+
+            if (memcmp(chunk, "VP8X", 4) == 0 && size >= 10) {
+                BYTE vp8x[10];
+                if (fread(vp8x, 1, 10, file) != 10) break;
+                *canvasWidth = ReadLE24(vp8x + 4) + 1;
+                *canvasHeight = ReadLE24(vp8x + 7) + 1;
+                skip -= 10;
+            } else if (memcmp(chunk, "ANMF", 4) == 0 && size >= 16) {
+                BYTE anmf[16];
+                if (fread(anmf, 1, 16, file) != 16) break;
+                WebPFrameLayout* f = &frames[count++];
+                f->rect.left = ReadLE24(anmf) * 2;
+                f->rect.top = ReadLE24(anmf + 3) * 2;
+                f->rect.width = ReadLE24(anmf + 6) + 1;
+                f->rect.height = ReadLE24(anmf + 9) + 1;
+                f->durationMs = ReadLE24(anmf + 12);
+                f->blend = (anmf[15] & 0x02) ? FRAME_BLEND_SOURCE : FRAME_BLEND_OVER;
+                f->dispose = (anmf[15] & 0x01) ? FRAME_DISPOSE_BACKGROUND : FRAME_DISPOSE_NONE;
+                skip -= 16;
+            }
+            if (skip > 0 && fseek(file, skip, SEEK_CUR) != 0) break;
+        }
+    }
+    fclose(file);
+    return count;
+}
+
 /**
  * @brief Generic animated image decoding routine for GIF and WebP
  * 
@@ -979,11 +1757,14 @@ static HICON CreateIconFromPBGRA(IWICImagingFactory* pFactory,
  * 1. NO RUNTIME BLENDING: During playback, we simply switch between pre-rendered HICONs.
  *    There is ZERO per-frame alpha blending or pixel manipulation at runtime.
  * 
- * 2. MEMORY POOL: Uses a reusable memory pool for temporary buffers, eliminating
- *    malloc/free overhead during the frame processing loop.
+ * 2. FRAME ARENA: Canvas and masters come from the size-class frame arena, and
+ *    per-frame decode buffers from a scratch arena reset after every frame, so
+ *    the processing loop does no CRT allocation after the first frame.
  * 
  * 3. ONE-TIME COST: All expensive operations (WIC decoding, format conversion,
  *    disposal handling, pixel compositing, icon creation) happen once at load time.
+ *    Compositing goes through FrameCompositor, which only touches each frame's
+ *    own rectangle (GIF image descriptor, WebP ANMF header).
  * 
  * This approach trades memory (storing pre-rendered frames) for speed (no runtime work),
  * which is ideal for tray icon animations where smooth, low-latency updates are critical.
@@ -994,22 +1775,18 @@ static void LoadAnimatedImage(const char* utf8Path, DecodeTarget* target) {
     wchar_t wPath[MAX_PATH] = {0};
     MultiByteToWideChar(CP_UTF8, 0, utf8Path, -1, wPath, MAX_PATH);
 
-    int cx = GetSystemMetrics(SM_CXSMICON);
-    int cy = GetSystemMetrics(SM_CYSMICON);
+    ImagingContext* ctx = AcquireImagingContext();
+    if (!ctx) return;
+    IWICImagingFactory* pFactory = ctx->factory;
+    target->store->masterEdge = FrameStore_MasterEdge(target);
+    const int masterEdge = target->store->masterEdge;
 
-    HRESULT hrInit = CoInitializeEx(NULL, COINIT_APARTMENTTHREADED);
-    IWICImagingFactory* pFactory = NULL;
-    HRESULT hr = CoCreateInstance(&CLSID_WICImagingFactory, NULL, CLSCTX_INPROC_SERVER, &IID_IWICImagingFactory, (void**)&pFactory);
-    if (FAILED(hr) || !pFactory) {
-        if (SUCCEEDED(hrInit)) CoUninitialize();
-        return;
-    }
+    LARGE_INTEGER loadStart;
+    QueryPerformanceCounter(&loadStart);
 
     IWICBitmapDecoder* pDecoder = NULL;
-    hr = pFactory->lpVtbl->CreateDecoderFromFilename(pFactory, wPath, NULL, GENERIC_READ, WICDecodeMetadataCacheOnLoad, &pDecoder);
+    HRESULT hr = pFactory->lpVtbl->CreateDecoderFromFilename(pFactory, wPath, NULL, GENERIC_READ, WICDecodeMetadataCacheOnLoad, &pDecoder);
     if (FAILED(hr) || !pDecoder) {
-        if (pFactory) pFactory->lpVtbl->Release(pFactory);
-        if (SUCCEEDED(hrInit)) CoUninitialize();
         return;
     }
 
@@ -1022,6 +1799,12 @@ static void LoadAnimatedImage(const char* utf8Path, DecodeTarget* target) {
     }
 
     UINT canvasWidth = 0, canvasHeight = 0;
+    WebPFrameLayout webpFrames[MAX_TRAY_FRAMES];
+    UINT webpFrameCount = 0;
+    if (!isGif) {
+        webpFrameCount = ReadWebPFrameLayout(wPath, webpFrames, MAX_TRAY_FRAMES, &canvasWidth, &canvasHeight);
+        if (webpFrameCount == 0) canvasWidth = canvasHeight = 0;
+    }
 
     /** Format-specific: Get canvas size */
     if (isGif) {
@@ -1056,44 +1839,33 @@ static void LoadAnimatedImage(const char* utf8Path, DecodeTarget* target) {
 
     if (canvasWidth == 0 || canvasHeight == 0) {
         pDecoder->lpVtbl->Release(pDecoder);
-        if (pFactory) pFactory->lpVtbl->Release(pFactory);
-        if (SUCCEEDED(hrInit)) CoUninitialize();
         return;
     }
 
-    g_animCanvasWidth = canvasWidth;
-    g_animCanvasHeight = canvasHeight;
+    if (!target->mastersOnly) {
+        g_animCanvasWidth = canvasWidth;
+        g_animCanvasHeight = canvasHeight;
+    }
 
-    UINT canvasStride = canvasWidth * 4;
-    UINT canvasSize = canvasHeight * canvasStride;
-    *(target->canvas) = (BYTE*)malloc(canvasSize);
+    UINT canvasSize = canvasHeight * canvasWidth * 4;
+    *(target->canvas) = (BYTE*)FrameArena_Alloc(canvasSize);
     if (!*(target->canvas)) {
         pDecoder->lpVtbl->Release(pDecoder);
-        if (pFactory) pFactory->lpVtbl->Release(pFactory);
-        if (SUCCEEDED(hrInit)) CoUninitialize();
         return;
     }
-    memset(*(target->canvas), 0, canvasSize);
+
+    FrameCompositor compositor;
+    FrameCompositor_Init(&compositor, *(target->canvas), canvasWidth, canvasHeight);
+
+    ScratchArena frameScratch;
+    ScratchArena_Init(&frameScratch, 0);
 
     UINT frameCount = 0;
     if (SUCCEEDED(pDecoder->lpVtbl->GetFrameCount(pDecoder, &frameCount))) {
-        UINT prevDisposal = 0;
-        UINT prevLeft = 0, prevTop = 0, prevWidth = 0, prevHeight = 0;
-
         for (UINT i = 0; i < frameCount && *(target->count) < MAX_TRAY_FRAMES; ++i) {
             IWICBitmapFrameDecode* pFrame = NULL;
             if (FAILED(pDecoder->lpVtbl->GetFrame(pDecoder, i, &pFrame)) || !pFrame) continue;
 
-            /** GIF-specific disposal for previous frame */
-            if (isGif && i > 0) {
-                if (prevDisposal == 2) { /** Restore background */
-                    ClearCanvasRect(*(target->canvas), canvasWidth, canvasHeight, prevLeft, prevTop, prevWidth, prevHeight, 0, 0, 0, 0);
-                }
-            } else if (!isGif) {
-                /** WebP simple implementation: clear canvas for each frame */
-                 memset(*(target->canvas), 0, canvasSize);
-            }
-
             UINT delayMs = 100;
             UINT disposal = 0;
             UINT frameLeft = 0, frameTop = 0, frameWidth = 0, frameHeight = 0;
@@ -1140,7 +1912,8 @@ static void LoadAnimatedImage(const char* utf8Path, DecodeTarget* target) {
                     PropVariantClear(&var);
                 } else { /** Assume WebP */
                     PropVariantInit(&var);
-                    if (SUCCEEDED(pMeta->lpVtbl->GetMetadataByName(pMeta, L"/webp/delay", &var))) {
+                    if (SUCCEEDED(pMeta->lpVtbl->GetMetadataByName(pMeta, L"/ANMF/FrameDuration", &var)) ||
+                        SUCCEEDED(pMeta->lpVtbl->GetMetadataByName(pMeta, L"/webp/delay", &var))) {
                         if (var.vt == VT_UI4) delayMs = var.ulVal;
                     }
                     PropVariantClear(&var);
@@ -1150,164 +1923,522 @@ static void LoadAnimatedImage(const char* utf8Path, DecodeTarget* target) {
 
             pFrame->lpVtbl->GetSize(pFrame, &frameWidth, &frameHeight);
 
+            /** Where the frame goes and how it combines with the canvas */
+            FrameRect rect = { frameLeft, frameTop, frameWidth, frameHeight };
+            FrameBlendMode blend = FRAME_BLEND_OVER;
+            FrameDisposeMode dispose = FRAME_DISPOSE_NONE;
+            if (isGif) {
+                if (disposal == 2) dispose = FRAME_DISPOSE_BACKGROUND;
+                else if (disposal == 3) dispose = FRAME_DISPOSE_PREVIOUS;
+            } else if (i < webpFrameCount &&
+                       frameWidth == webpFrames[i].rect.width && frameHeight == webpFrames[i].rect.height) {
+                /** Raw ANMF sub-frame: honour its offset, blending and disposal */
+                rect = webpFrames[i].rect;
+                blend = webpFrames[i].blend;
+                dispose = webpFrames[i].dispose;
+                if (webpFrames[i].durationMs > 0) delayMs = webpFrames[i].durationMs;
+            } else if (frameWidth == canvasWidth && frameHeight == canvasHeight) {
+                /** Codec already composed the full canvas */
+                blend = FRAME_BLEND_SOURCE;
+            } else {
+                /** Unknown layout (e.g. still WebP): centre, as before */
+                rect.left = (canvasWidth > frameWidth) ? (canvasWidth - frameWidth) / 2 : 0;
+                rect.top = (canvasHeight > frameHeight) ? (canvasHeight - frameHeight) / 2 : 0;
+                blend = FRAME_BLEND_SOURCE;
+                dispose = FRAME_DISPOSE_BACKGROUND;
+            }
+
             IWICFormatConverter* pConverter = NULL;
             if (SUCCEEDED(pFactory->lpVtbl->CreateFormatConverter(pFactory, &pConverter)) && pConverter) {
                 if (SUCCEEDED(pConverter->lpVtbl->Initialize(pConverter, (IWICBitmapSource*)pFrame, &GUID_WICPixelFormat32bppPBGRA, WICBitmapDitherTypeNone, NULL, 0.0, WICBitmapPaletteTypeCustom))) {
                     UINT frameStride = frameWidth * 4;
                     UINT frameBufferSize = frameHeight * frameStride;
-                    /** Use memory pool to reduce malloc/free overhead in loop */
-                    BYTE* frameBuffer = (BYTE*)MemoryPool_Alloc(frameBufferSize);
+                    /** Frame-scoped scratch: released in bulk at the end of this iteration */
+                    BYTE* frameBuffer = (BYTE*)ScratchArena_Alloc(&frameScratch, frameBufferSize);
                     if (frameBuffer) {
                         if (SUCCEEDED(pConverter->lpVtbl->CopyPixels(pConverter, NULL, frameStride, frameBufferSize, frameBuffer))) {
-                            if (isGif) {
-                                for (UINT y = 0; y < frameHeight; y++) {
-                                    for (UINT x = 0; x < frameWidth; x++) {
-                                        if (frameLeft + x < canvasWidth && frameTop + y < canvasHeight) {
-                                            BYTE* srcPixel = frameBuffer + (y * frameStride) + (x * 4);
-                                            BlendPixel(*(target->canvas), canvasStride, frameLeft + x, frameTop + y, srcPixel[2], srcPixel[1], srcPixel[0], srcPixel[3]);
-                                        }
-                                    }
-                                }
-                            } else { /** Assume WebP */
-                                if (frameWidth == canvasWidth && frameHeight == canvasHeight) {
-                                    memcpy(*(target->canvas), frameBuffer, canvasSize);
-                                } else {
-                                    UINT offsetX = (canvasWidth > frameWidth) ? (canvasWidth - frameWidth) / 2 : 0;
-                                    UINT offsetY = (canvasHeight > frameHeight) ? (canvasHeight - frameHeight) / 2 : 0;
-                                    for (UINT y = 0; y < frameHeight && (offsetY + y) < canvasHeight; y++) {
-                                        memcpy(*(target->canvas) + ((offsetY + y) * canvasStride) + (offsetX * 4), frameBuffer + (y * frameStride), frameStride);
-                                    }
-                                }
-                            }
+                            FrameCompositor_Apply(&compositor, frameBuffer, frameStride, rect, blend, dispose);
                         }
-                        MemoryPool_Free(frameBuffer);
                     }
                 }
                 pConverter->lpVtbl->Release(pConverter);
             }
             
-            HICON hIcon = CreateIconFromPBGRA(pFactory, *(target->canvas), canvasWidth, canvasHeight, cx, cy);
-            if (hIcon) {
-                target->icons[*(target->count)] = hIcon;
-                target->delays[*(target->count)] = delayMs;
-                (*(target->count))++;
-            }
-
-            if (isGif) {
-                prevDisposal = disposal;
-                prevLeft = frameLeft;
-                prevTop = frameTop;
-                prevWidth = frameWidth;
-                prevHeight = frameHeight;
+            /** Keep a small master of the composited frame so other icon sizes need no re-decode */
+            SIZE_T masterBytes = (SIZE_T)masterEdge * (SIZE_T)masterEdge * 4;
+            BYTE* master = (BYTE*)FrameArena_Alloc(masterBytes);
+            int prevSlot = *(target->count) - 1;
+            if (master && compositor.dirty.width == 0 && prevSlot >= 0 && target->store->masters[prevSlot]) {
+                /** Nothing changed on the canvas: reuse the previous master instead of rescaling */
+                memcpy(master, target->store->masters[prevSlot], masterBytes);
+                AppendDecodedFrame(ctx, target, master, NULL, delayMs);
+            } else if (master && ScalePBGRAToPixels(ctx, *(target->canvas), canvasWidth, canvasHeight, masterEdge, masterEdge, master)) {
+                AppendDecodedFrame(ctx, target, master, NULL, delayMs);
+            } else {
+                FrameArena_Free(master);
             }
+            ScratchArena_Reset(&frameScratch);
             pFrame->lpVtbl->Release(pFrame);
         }
     }
 
+    FrameCompositor_Release(&compositor);
+    ScratchArena_Release(&frameScratch);
     pDecoder->lpVtbl->Release(pDecoder);
-    if (pFactory) pFactory->lpVtbl->Release(pFactory);
-    if (SUCCEEDED(hrInit)) CoUninitialize();
 
     if (*(target->count) > 0) {
         *(target->isAnimatedFlag) = TRUE;
         *(target->index) = 0;
+        double totalMs = ImagingElapsedMs(ctx, loadStart);
+        WriteLog(LOG_LEVEL_DEBUG, "Decoded %d frames in %.2f ms (%.3f ms/frame): %s",
+                 *(target->count), totalMs, totalMs / (double)*(target->count), utf8Path);
+        LogFrameArenaStats("after decode");
+    }
+}
+
+/**
+ * @brief Frame-folder loading configuration
+ */
+#define FOLDER_SCAN_MAX_FILES 1024          /** Image files considered per folder (first MAX_TRAY_FRAMES after sorting are used) */
+#define FOLDER_DECODE_MAX_WORKERS 4         /** Extra decode threads besides the caller */
+#define FOLDER_DECODE_FILES_PER_WORKER 4    /** Frames per extra thread; small folders decode inline */
+
+/** @brief One image file of a frame folder */
+typedef struct {
+    const wchar_t* path;        /** Full path, allocated from the listing's scratch arena */
+    const wchar_t* name;        /** File name part of path, used for sorting */
+    BOOL isIco;                 /** Loaded via LoadImageW, no master */
+} FolderFrameFile;
+
+static const wchar_t* FOLDER_FRAME_EXTS[] = {
+    L".ico", L".png", L".bmp", L".jpg", L".jpeg", L".webp", L".tif", L".tiff"
+};
+
+/** @brief Classify a file name by extension; TRUE if it can be a folder frame */
+static BOOL ClassifyFolderFrameFile(const wchar_t* fileName, BOOL* isIco) {
+    const wchar_t* dot = wcsrchr(fileName, L'.');
+    if (!dot || dot == fileName) return FALSE;
+    for (size_t i = 0; i < sizeof(FOLDER_FRAME_EXTS) / sizeof(FOLDER_FRAME_EXTS[0]); ++i) {
+        if (_wcsicmp(dot, FOLDER_FRAME_EXTS[i]) == 0) {
+            *isIco = (i == 0);
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+/** @brief qsort comparator for FolderFrameFile: natural order of file names */
+static int CompareFolderFrameFiles(const void* a, const void* b) {
+    return NaturalCompareW(((const FolderFrameFile*)a)->name, ((const FolderFrameFile*)b)->name);
+}
+
+/**
+ * @brief List a folder's frame files in one FindFirstFileW pass, naturally sorted
+ * @param arena Owns the returned array and paths until reset/released
+ * @return Number of files (0 if none or on allocation failure)
+ */
+static int ListFolderFrameFiles(const wchar_t* wFolder, ScratchArena* arena, FolderFrameFile** filesOut) {
+    FolderFrameFile* files = (FolderFrameFile*)ScratchArena_Alloc(arena, sizeof(FolderFrameFile) * FOLDER_SCAN_MAX_FILES);
+    if (!files) return 0;
+
+    wchar_t wSearch[MAX_PATH] = {0};
+    _snwprintf_s(wSearch, MAX_PATH, _TRUNCATE, L"%s\\*", wFolder);
+
+    int count = 0;
+    size_t folderLen = wcslen(wFolder);
+    WIN32_FIND_DATAW ffd;
+    HANDLE hFind = FindFirstFileW(wSearch, &ffd);
+    if (hFind == INVALID_HANDLE_VALUE) return 0;
+    do {
+        if (ffd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) continue;
+        BOOL isIco = FALSE;
+        if (!ClassifyFolderFrameFile(ffd.cFileName, &isIco)) continue;
+
+        size_t nameLen = wcslen(ffd.cFileName);
+        if (folderLen + 1 + nameLen >= MAX_PATH) continue;
+        wchar_t* path = (wchar_t*)ScratchArena_Alloc(arena, (folderLen + nameLen + 2) * sizeof(wchar_t));
+        if (!path) break;
+        memcpy(path, wFolder, folderLen * sizeof(wchar_t));
+        path[folderLen] = L'\\';
+        memcpy(path + folderLen + 1, ffd.cFileName, (nameLen + 1) * sizeof(wchar_t));
+
+        files[count].path = path;
+        files[count].name = path + folderLen + 1;
+        files[count].isIco = isIco;
+        count++;
+    } while (count < FOLDER_SCAN_MAX_FILES && FindNextFileW(hFind, &ffd));
+    FindClose(hFind);
+
+    qsort(files, (size_t)count, sizeof(FolderFrameFile), CompareFolderFrameFiles);
+    *filesOut = files;
+    return count;
+}
+
+/**
+ * @brief Shared state of one parallel folder decode
+ * Workers claim indices with an interlocked counter and write only their own
+ * slots, so results land in input order without further synchronization.
+ */
+typedef struct {
+    const FolderFrameFile* files;
+    int count;
+    int masterEdge;
+    int edge;
+    BOOL mastersOnly;
+    volatile LONG next;
+    BYTE* masters[MAX_TRAY_FRAMES];
+    HICON icons[MAX_TRAY_FRAMES];
+} FolderDecodeJob;
+
+/**
+ * @brief Priority of the prefetch worker and its folder helpers
+ *
+ * Below normal while it only runs ahead of the pointer; a load waiting for
+ * the name in flight raises it to the loader's priority until the decode
+ * ends, so the wait is no longer than decoding on the UI thread would be.
+ */
+static volatile LONG g_prefetchPriority = THREAD_PRIORITY_BELOW_NORMAL;
+
+/** @brief Move a prefetch thread to the current prefetch priority */
+static void FollowPrefetchPriority(void) {
+    int priority = (int)InterlockedCompareExchange(&g_prefetchPriority, 0, 0);
+    if (GetThreadPriority(GetCurrentThread()) != priority) {
+        SetThreadPriority(GetCurrentThread(), priority);
     }
 }
 
-/** @brief Generic routine to load sequential icon frames from a folder */
-static void LoadIconsFromFolder(const char* utf8Folder, HICON* icons, int* count) {
+/** @brief Decode claimed frames until the job runs out, on the calling thread's imaging context */
+static void DecodeFolderFrames(FolderDecodeJob* job) {
+    ImagingContext* ctx = AcquireImagingContext();
+    for (;;) {
+        LONG i = InterlockedIncrement(&job->next) - 1;
+        if (i >= job->count) break;
+        if (job->mastersOnly) FollowPrefetchPriority();
+
+        const FolderFrameFile* file = &job->files[i];
+        if (file->isIco) {
+            if (!job->mastersOnly) {
+                job->icons[i] = (HICON)LoadImageW(NULL, file->path, IMAGE_ICON, job->edge, job->edge, LR_LOADFROMFILE);
+            }
+        } else if (ctx) {
+            job->masters[i] = DecodeFileToMaster(ctx, file->path, job->masterEdge);
+            if (job->masters[i] && !job->mastersOnly) {
+                job->icons[i] = CreateIconFromMaster(ctx, job->masters[i], job->masterEdge, job->edge, job->edge);
+            }
+        }
+    }
+}
+
+/** @brief Folder decode worker; owns (and releases) its own imaging context */
+static DWORD WINAPI FolderDecodeThread(LPVOID param) {
+    DecodeFolderFrames((FolderDecodeJob*)param);
+    ReleaseImagingContext();
+    return 0;
+}
+
+/**
+ * @brief Load sequential icon frames from a folder
+ *
+ * One directory pass collects and classifies the image files, which are then
+ * decoded by the caller plus a few worker threads and appended in sorted order.
+ */
+static void LoadIconsFromFolder(const char* utf8Folder, DecodeTarget* target) {
     wchar_t wFolder[MAX_PATH] = {0};
     MultiByteToWideChar(CP_UTF8, 0, utf8Folder, -1, wFolder, MAX_PATH);
 
-    typedef struct { int hasNum; int num; wchar_t name[MAX_PATH]; wchar_t path[MAX_PATH]; } AnimFile;
-    AnimFile files[MAX_TRAY_FRAMES];
-    int fileCount = 0;
-
-    void AddFilesWithPattern(const wchar_t* pattern) {
-        WIN32_FIND_DATAW ffd;
-        HANDLE hFind = FindFirstFileW(pattern, &ffd);
-        if (hFind != INVALID_HANDLE_VALUE) {
-            do {
-                if (ffd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) continue;
-                wchar_t* dot = wcsrchr(ffd.cFileName, L'.');
-                if (!dot) continue;
-                size_t nameLen = (size_t)(dot - ffd.cFileName);
-                if (nameLen == 0 || nameLen >= MAX_PATH) continue;
-
-                int hasNum = 0, numVal = 0;
-                for (size_t i = 0; i < nameLen; ++i) {
-                    if (iswdigit(ffd.cFileName[i])) {
-                        hasNum = 1;
-                        numVal = 0;
-                        while (i < nameLen && iswdigit(ffd.cFileName[i])) {
-                            numVal = numVal * 10 + (ffd.cFileName[i] - L'0');
-                            i++;
-                        }
-                        break;
-                    }
-                }
+    LARGE_INTEGER loadStart;
+    QueryPerformanceCounter(&loadStart);
 
-                if (fileCount < MAX_TRAY_FRAMES) {
-                    files[fileCount].hasNum = hasNum;
-                    files[fileCount].num = numVal;
-                    wcsncpy(files[fileCount].name, ffd.cFileName, nameLen);
-                    files[fileCount].name[nameLen] = L'\0';
-                    _snwprintf_s(files[fileCount].path, MAX_PATH, _TRUNCATE, L"%s\\%s", wFolder, ffd.cFileName);
-                    fileCount++;
-                }
-            } while (FindNextFileW(hFind, &ffd));
-            FindClose(hFind);
+    ScratchArena listing;
+    ScratchArena_Init(&listing, 0);
+    FolderFrameFile* files = NULL;
+    int fileCount = ListFolderFrameFiles(wFolder, &listing, &files);
+    if (fileCount > MAX_TRAY_FRAMES) fileCount = MAX_TRAY_FRAMES;
+
+    FolderDecodeJob* job = (fileCount > 0) ? (FolderDecodeJob*)calloc(1, sizeof(FolderDecodeJob)) : NULL;
+    if (!job) {
+        ScratchArena_Release(&listing);
+        return;
+    }
+    target->store->masterEdge = FrameStore_MasterEdge(target);
+    job->files = files;
+    job->count = fileCount;
+    job->masterEdge = target->store->masterEdge;
+    job->edge = target->edge;
+    job->mastersOnly = target->mastersOnly;
+
+    SYSTEM_INFO si;
+    GetSystemInfo(&si);
+    int workers = (fileCount - 1) / FOLDER_DECODE_FILES_PER_WORKER;
+    if (workers > (int)si.dwNumberOfProcessors - 1) workers = (int)si.dwNumberOfProcessors - 1;
+    if (workers > FOLDER_DECODE_MAX_WORKERS) workers = FOLDER_DECODE_MAX_WORKERS;
+
+    HANDLE threads[FOLDER_DECODE_MAX_WORKERS];
+    int started = 0;
+    int priority = GetThreadPriority(GetCurrentThread());
+    for (int i = 0; i < workers; ++i) {
+        threads[started] = CreateThread(NULL, 0, FolderDecodeThread, job, CREATE_SUSPENDED, NULL);
+        if (!threads[started]) break;
+        SetThreadPriority(threads[started], priority);
+        ResumeThread(threads[started]);
+        started++;
+    }
+
+    DecodeFolderFrames(job);
+    if (started > 0) {
+        WaitForMultipleObjects((DWORD)started, threads, TRUE, INFINITE);
+        for (int i = 0; i < started; ++i) CloseHandle(threads[i]);
+    }
+
+    ImagingContext* ctx = AcquireImagingContext();
+    for (int i = 0; i < fileCount; ++i) {
+        if (job->mastersOnly || job->masters[i] || job->icons[i]) {
+            AppendDecodedFrame(ctx, target, job->masters[i], job->icons[i], 0);
         }
     }
 
-    const wchar_t* patterns[] = { L"\\*.ico", L"\\*.png", L"\\*.bmp", L"\\*.jpg", L"\\*.jpeg", L"\\*.webp", L"\\*.tif", L"\\*.tiff" };
-    for (int i = 0; i < sizeof(patterns)/sizeof(patterns[0]); ++i) {
-        wchar_t wSearch[MAX_PATH] = {0};
-        _snwprintf_s(wSearch, MAX_PATH, _TRUNCATE, L"%s%s", wFolder, patterns[i]);
-        AddFilesWithPattern(wSearch);
+    int count = *(target->count);
+    if (ctx && count > 0) {
+        double totalMs = ImagingElapsedMs(ctx, loadStart);
+        WriteLog(LOG_LEVEL_DEBUG, "Loaded %d folder frames in %.2f ms (%.3f ms/frame, %d threads): %s",
+                 count, totalMs, totalMs / (double)count, started + 1, utf8Folder);
     }
 
-    if (fileCount == 0) return;
+    free(job);
+    ScratchArena_Release(&listing);
+}
 
-    int cmpAnimFile(const void* a, const void* b) {
-        const AnimFile* fa = (const AnimFile*)a;
-        const AnimFile* fb = (const AnimFile*)b;
-        if (fa->hasNum && fb->hasNum) {
-            if (fa->num != fb->num) return fa->num < fb->num ? -1 : 1;
+/** @brief Decode a GIF/WebP, static image or frame folder into a target */
+static void DecodeAnimationSource(const char* name, const char* utf8Path, DecodeTarget* target) {
+    if (IsGifSelection(name) || IsWebPSelection(name)) {
+        LoadAnimatedImage(utf8Path, target);
+    } else if (IsStaticImageSelection(name)) {
+        /** Load a single static image file as one icon frame */
+        wchar_t wPath[MAX_PATH] = {0};
+        MultiByteToWideChar(CP_UTF8, 0, utf8Path, -1, wPath, MAX_PATH);
+        target->store->masterEdge = FrameStore_MasterEdge(target);
+        if (AppendImageFileFrame(AcquireImagingContext(), target, wPath)) {
+            *(target->isAnimatedFlag) = FALSE;
         }
-        return _wcsicmp(fa->name, fb->name);
+    } else {
+        LoadIconsFromFolder(utf8Path, target);
     }
-    qsort(files, (size_t)fileCount, sizeof(AnimFile), cmpAnimFile);
+}
 
-    for (int i = 0; i < fileCount; ++i) {
-        HICON hIcon = NULL;
-        const wchar_t* ext = wcsrchr(files[i].path, L'.');
-        if (ext && (_wcsicmp(ext, L".ico") == 0)) {
-            hIcon = (HICON)LoadImageW(NULL, files[i].path, IMAGE_ICON, 0, 0, LR_LOADFROMFILE | LR_DEFAULTSIZE);
-        } else {
-            int cx = GetSystemMetrics(SM_CXSMICON);
-            int cy = GetSystemMetrics(SM_CYSMICON);
-            
-            IWICImagingFactory* pFactory = NULL;
-            HRESULT hrInit = CoInitializeEx(NULL, COINIT_APARTMENTTHREADED);
-            if (SUCCEEDED(CoCreateInstance(&CLSID_WICImagingFactory, NULL, CLSCTX_INPROC_SERVER, &IID_IWICImagingFactory, (void**)&pFactory)) && pFactory) {
-                IWICBitmapDecoder* pDecoder = NULL;
-                if (SUCCEEDED(pFactory->lpVtbl->CreateDecoderFromFilename(pFactory, files[i].path, NULL, GENERIC_READ, WICDecodeMetadataCacheOnLoad, &pDecoder)) && pDecoder) {
-                    IWICBitmapFrameDecode* pFrame = NULL;
-                    if (SUCCEEDED(pDecoder->lpVtbl->GetFrame(pDecoder, 0, &pFrame)) && pFrame) {
-                        hIcon = CreateIconFromWICSource(pFactory, (IWICBitmapSource*)pFrame, cx, cy);
-                        pFrame->lpVtbl->Release(pFrame);
-                    }
-                    pDecoder->lpVtbl->Release(pDecoder);
-                }
-                pFactory->lpVtbl->Release(pFactory);
-            }
-            if (SUCCEEDED(hrInit)) CoUninitialize();
+/**
+ * @brief Fill a target from a cached master set instead of decoding
+ * Icons are built for the target's edge; the store borrows the entry's masters.
+ * @return FALSE on a miss, a stale entry, or masters too small for the edge
+ */
+static BOOL LoadAnimationFromCache(const char* name, const AnimSourceStamp* stamp, DecodeTarget* target) {
+    AnimCacheEntry* entry = AnimCache_Acquire(name, stamp, FrameStore_MasterEdge(target));
+    if (!entry) return FALSE;
+
+    ImagingContext* ctx = AcquireImagingContext();
+    HICON built[MAX_TRAY_FRAMES] = {0};
+    for (int i = 0; i < entry->count; ++i) {
+        built[i] = CreateIconFromMaster(ctx, entry->masters[i], entry->masterEdge, target->edge, target->edge);
+        if (!built[i]) {
+            for (int j = 0; j < i; ++j) DestroyIcon(built[j]);
+            AnimCache_Release(entry);
+            return FALSE;
         }
-        if (hIcon) {
-            icons[(*count)++] = hIcon;
+    }
+
+    FrameStore* store = target->store;
+    for (int i = 0; i < entry->count; ++i) {
+        target->icons[i] = built[i];
+        target->delays[i] = entry->delays[i];
+        store->masters[i] = entry->masters[i];
+    }
+    store->masterEdge = entry->masterEdge;
+    store->activeEdge = target->edge;
+    store->cacheEntry = entry;
+    *(target->count) = entry->count;
+    *(target->index) = 0;
+    *(target->isAnimatedFlag) = entry->isAnimated;
+
+    g_animCacheHits++;
+    WriteLog(LOG_LEVEL_DEBUG, "Reused %d cached animation frames: %s", entry->count, name);
+    return TRUE;
+}
+
+/**
+ * @brief Prefetch worker state
+ *
+ * One below-normal thread decodes neighbours of the hovered menu item into the
+ * cache (masters only, with its own imaging context). It starts on the first
+ * prefetch request and stops with the tray animation.
+ */
+static HANDLE g_prefetchThread = NULL;
+static HANDLE g_prefetchWakeEvent = NULL;           /** Auto-reset: queue changed or stop requested */
+static HANDLE g_prefetchIdleEvent = NULL;           /** Manual-reset: set while nothing is being decoded */
+static volatile LONG g_prefetchStop = 0;
+static char g_prefetchQueue[ANIM_PREFETCH_QUEUE_SIZE][MAX_PATH];  /** Guarded by g_animCacheLock */
+static int g_prefetchQueueCount = 0;
+static int g_prefetchEdge = 0;                      /** Icon edge at the time of the request */
+static char g_prefetchInFlight[MAX_PATH] = "";     /** Name the worker is decoding now */
+
+/** @brief Take the oldest queued name and mark it in flight */
+static BOOL PopPrefetchRequest(char* name, size_t size, int* edge) {
+    BOOL have = FALSE;
+    EnterCriticalSection(&g_animCacheLock);
+    if (g_prefetchQueueCount > 0) {
+        strncpy_s(name, size, g_prefetchQueue[0], _TRUNCATE);
+        g_prefetchQueueCount--;
+        memmove(g_prefetchQueue[0], g_prefetchQueue[1], sizeof(g_prefetchQueue[0]) * (size_t)g_prefetchQueueCount);
+        *edge = g_prefetchEdge;
+        strncpy_s(g_prefetchInFlight, sizeof(g_prefetchInFlight), name, _TRUNCATE);
+        ResetEvent(g_prefetchIdleEvent);
+        have = TRUE;
+    }
+    LeaveCriticalSection(&g_animCacheLock);
+    return have;
+}
+
+/** @brief Decode one animation into the cache unless a usable entry already exists */
+static void PrefetchAnimation(const char* name, int edge) {
+    char path[MAX_PATH] = {0};
+    BuildAnimationFolder(name, path, sizeof(path));
+    AnimSourceStamp stamp;
+    if (!ReadAnimationSourceStamp(path, &stamp)) return;
+
+    typedef struct {
+        HICON icons[MAX_TRAY_FRAMES];
+        UINT delays[MAX_TRAY_FRAMES];
+        int count;
+        int index;
+        BOOL isAnimated;
+        BYTE* canvas;
+        FrameStore store;
+    } PrefetchSet;
+
+    PrefetchSet* set = (PrefetchSet*)calloc(1, sizeof(PrefetchSet));
+    if (!set) return;
+    DecodeTarget target = {
+        .icons = set->icons,
+        .count = &set->count,
+        .index = &set->index,
+        .delays = set->delays,
+        .isAnimatedFlag = &set->isAnimated,
+        .canvas = &set->canvas,
+        .store = &set->store,
+        .edge = edge,
+        .mastersOnly = TRUE
+    };
+
+    AnimCacheEntry* cached = AnimCache_Acquire(name, &stamp, FrameStore_MasterEdge(&target));
+    if (cached) {
+        AnimCache_Release(cached);
+    } else {
+        DecodeAnimationSource(name, path, &target);
+        if (AnimCache_AdoptStore(name, &stamp, &target)) {
+            WriteLog(LOG_LEVEL_DEBUG, "Prefetched %d animation frames: %s", set->count, name);
         }
     }
+
+    /** Drops the adoption pin (entry stays cached) or frees uncacheable masters */
+    FrameStore_Clear(&set->store);
+    FrameArena_Free(set->canvas);
+    free(set);
+}
+
+/**
+ * @brief Prefetch worker thread
+ * IMPORTANT: This runs in a WORKER THREAD; it builds no HICONs and touches no tray state.
+ */
+static DWORD WINAPI AnimationPrefetchThread(LPVOID param) {
+    (void)param;
+    FollowPrefetchPriority();
+
+    while (!g_prefetchStop) {
+        WaitForSingleObject(g_prefetchWakeEvent, INFINITE);
+
+        char name[MAX_PATH];
+        int edge = 0;
+        while (!g_prefetchStop && PopPrefetchRequest(name, sizeof(name), &edge)) {
+            PrefetchAnimation(name, edge);
+            FollowPrefetchPriority();  /** Drop a boost a folder helper's last step may have re-applied */
+
+            EnterCriticalSection(&g_animCacheLock);
+            g_prefetchInFlight[0] = '\0';
+            SetEvent(g_prefetchIdleEvent);
+            LeaveCriticalSection(&g_animCacheLock);
+        }
+    }
+
+    ReleaseImagingContext();
+    return 0;
+}
+
+/** @brief Start the prefetch worker on first use */
+static BOOL StartPrefetchWorker(void) {
+    if (g_prefetchThread) return TRUE;
+
+    g_prefetchStop = 0;
+    g_prefetchWakeEvent = CreateEventW(NULL, FALSE, FALSE, NULL);
+    g_prefetchIdleEvent = CreateEventW(NULL, TRUE, TRUE, NULL);
+    if (g_prefetchWakeEvent && g_prefetchIdleEvent) {
+        g_prefetchThread = CreateThread(NULL, 0, AnimationPrefetchThread, NULL, 0, NULL);
+    }
+
+    if (!g_prefetchThread) {
+        WriteLog(LOG_LEVEL_WARNING, "Animation prefetch thread unavailable (error %lu)", GetLastError());
+        if (g_prefetchWakeEvent) { CloseHandle(g_prefetchWakeEvent); g_prefetchWakeEvent = NULL; }
+        if (g_prefetchIdleEvent) { CloseHandle(g_prefetchIdleEvent); g_prefetchIdleEvent = NULL; }
+        return FALSE;
+    }
+    return TRUE;
+}
+
+/**
+ * @brief Stop the prefetch worker after its current decode
+ * @return FALSE if the worker did not exit in time (cache must then be left alone)
+ */
+static BOOL StopPrefetchWorker(void) {
+    if (!g_prefetchThread) return TRUE;
+
+    EnterCriticalSection(&g_animCacheLock);
+    g_prefetchQueueCount = 0;
+    LeaveCriticalSection(&g_animCacheLock);
+
+    InterlockedExchange(&g_prefetchStop, 1);
+    SetEvent(g_prefetchWakeEvent);
+    BOOL exited = (WaitForSingleObject(g_prefetchThread, 5000) == WAIT_OBJECT_0);
+    if (!exited) {
+        WriteLog(LOG_LEVEL_WARNING, "Animation prefetch thread did not stop in time");
+        return FALSE;
+    }
+
+    CloseHandle(g_prefetchThread);
+    g_prefetchThread = NULL;
+    CloseHandle(g_prefetchWakeEvent);
+    g_prefetchWakeEvent = NULL;
+    CloseHandle(g_prefetchIdleEvent);
+    g_prefetchIdleEvent = NULL;
+    return TRUE;
+}
+
+/**
+ * @brief If the worker is decoding this name right now, wait for it instead of decoding twice
+ *
+ * The worker (and, at their next file, its folder helpers) runs at the
+ * caller's priority for the length of the wait, so a busy desktop cannot
+ * starve it while the UI thread is blocked on it.
+ */
+static void WaitForPrefetchOf(const char* name) {
+    if (!g_prefetchThread) return;
+    EnterCriticalSection(&g_animCacheLock);
+    BOOL busy = (_stricmp(g_prefetchInFlight, name) == 0);
+    LeaveCriticalSection(&g_animCacheLock);
+    if (!busy) return;
+
+    int priority = GetThreadPriority(GetCurrentThread());
+    InterlockedExchange(&g_prefetchPriority, priority);
+    SetThreadPriority(g_prefetchThread, priority);
+    WaitForSingleObject(g_prefetchIdleEvent, ANIM_PREFETCH_JOIN_TIMEOUT_MS);
+    InterlockedExchange(&g_prefetchPriority, THREAD_PRIORITY_BELOW_NORMAL);
+    SetThreadPriority(g_prefetchThread, THREAD_PRIORITY_BELOW_NORMAL);
 }
 
 /** @brief Unified animation loading routine for tray and preview */
@@ -1316,18 +2447,24 @@ static void LoadAnimationByName(const char* name, BOOL isPreview) {
     
     // Free previous resources for the selected target.
     // For the main tray target, also reset global canvas dimensions.
-    FreeIconSet(target.icons, target.count, target.index, target.isAnimatedFlag, target.canvas, !isPreview);
+    FreeIconSet(target.icons, target.count, target.index, target.isAnimatedFlag, target.canvas, target.store, !isPreview);
 
     if (!name || !*name) return;
 
     if (_stricmp(name, "__logo__") == 0) {
-        HICON hIcon = LoadIconW(GetModuleHandle(NULL), MAKEINTRESOURCEW(IDI_CATIME));
+        /** Resource icons carry their own resolutions; LoadImageW picks the best one for the edge */
+        HICON hIcon = (HICON)LoadImageW(GetModuleHandle(NULL), MAKEINTRESOURCEW(IDI_CATIME), IMAGE_ICON, target.edge, target.edge, 0);
         if (hIcon) {
-            target.icons[(*(target.count))++] = hIcon;
+            AppendDecodedFrame(NULL, &target, NULL, hIcon, 0);
         }
-    } else if (_stricmp(name, "__cpu__") == 0 || _stricmp(name, "__mem__") == 0) {
-        /** For preview mode, create a sample percent icon; for normal mode, handled by periodic updater */
-        if (isPreview) {
+    } else if (IsMetricIconName(name)) {
+        /** For preview mode, create a sample icon; for normal mode, handled by periodic updater */
+        if (isPreview && IsGraphIconName(name)) {
+            HICON hIcon = CreateGraphIconCopy(name);
+            if (hIcon) {
+                target.icons[(*(target.count))++] = hIcon;
+            }
+        } else if (isPreview) {
             float cpu = 0.0f, mem = 0.0f;
             SystemMonitor_GetUsage(&cpu, &mem);
             int percent = (_stricmp(name, "__cpu__") == 0) ? (int)(cpu + 0.5f) : (int)(mem + 0.5f);
@@ -1345,53 +2482,53 @@ static void LoadAnimationByName(const char* name, BOOL isPreview) {
             *(target.index) = 0;
             *(target.isAnimatedFlag) = FALSE;
         }
-    } else if (IsGifSelection(name) || IsWebPSelection(name)) {
-        char filePath[MAX_PATH] = {0};
-        BuildAnimationFolder(name, filePath, sizeof(filePath));
-        LoadAnimatedImage(filePath, &target);
-    } else if (IsStaticImageSelection(name)) {
-        /** Load a single static image file as one icon frame */
-        char filePath[MAX_PATH] = {0};
-        BuildAnimationFolder(name, filePath, sizeof(filePath));
-
-        int cx = GetSystemMetrics(SM_CXSMICON);
-        int cy = GetSystemMetrics(SM_CYSMICON);
-        HICON hIcon = NULL;
-
-        wchar_t wPath[MAX_PATH] = {0};
-        MultiByteToWideChar(CP_UTF8, 0, filePath, -1, wPath, MAX_PATH);
-        const wchar_t* ext = wcsrchr(wPath, L'.');
-        if (ext && _wcsicmp(ext, L".ico") == 0) {
-            hIcon = (HICON)LoadImageW(NULL, wPath, IMAGE_ICON, 0, 0, LR_LOADFROMFILE | LR_DEFAULTSIZE);
-        } else {
-            HRESULT hrInit = CoInitializeEx(NULL, COINIT_APARTMENTTHREADED);
-            IWICImagingFactory* pFactory = NULL;
-            if (SUCCEEDED(CoCreateInstance(&CLSID_WICImagingFactory, NULL, CLSCTX_INPROC_SERVER, &IID_IWICImagingFactory, (void**)&pFactory)) && pFactory) {
-                IWICBitmapDecoder* pDecoder = NULL;
-                if (SUCCEEDED(pFactory->lpVtbl->CreateDecoderFromFilename(pFactory, wPath, NULL, GENERIC_READ, WICDecodeMetadataCacheOnLoad, &pDecoder)) && pDecoder) {
-                    IWICBitmapFrameDecode* pFrame = NULL;
-                    if (SUCCEEDED(pDecoder->lpVtbl->GetFrame(pDecoder, 0, &pFrame)) && pFrame) {
-                        hIcon = CreateIconFromWICSource(pFactory, (IWICBitmapSource*)pFrame, cx, cy);
-                        pFrame->lpVtbl->Release(pFrame);
-                    }
-                    pDecoder->lpVtbl->Release(pDecoder);
-                }
-                pFactory->lpVtbl->Release(pFactory);
-            }
-            if (SUCCEEDED(hrInit)) CoUninitialize();
+    } else {
+        char path[MAX_PATH] = {0};
+        BuildAnimationFolder(name, path, sizeof(path));
+
+        AnimCache_EnsureLock();
+        AnimSourceStamp stamp;
+        BOOL haveStamp = ReadAnimationSourceStamp(path, &stamp);
+        if (haveStamp) {
+            if (LoadAnimationFromCache(name, &stamp, &target)) return;
+            WaitForPrefetchOf(name);
+            if (LoadAnimationFromCache(name, &stamp, &target)) return;
+            g_animCacheMisses++;
         }
 
-        if (hIcon) {
-            target.icons[(*(target.count))++] = hIcon;
-            *(target.isAnimatedFlag) = FALSE;
+        DecodeAnimationSource(name, path, &target);
+        if (haveStamp) {
+            AnimCache_AdoptStore(name, &stamp, &target);
         }
-    } else {
-        char folder[MAX_PATH] = {0};
-        BuildAnimationFolder(name, folder, sizeof(folder));
-        LoadIconsFromFolder(folder, target.icons, target.count);
     }
 }
 
+/**
+ * @brief Queue neighbouring animations for background decoding
+ * @param names Relative animation names; fixed items (__logo__ etc.) are skipped
+ *
+ * Replaces any requests not yet started: only the neighbours of the item
+ * under the pointer are worth decoding.
+ */
+void TrayAnimation_PrefetchAnimations(const char* const* names, int count) {
+    if (!names || count <= 0) return;
+    AnimCache_EnsureLock();
+    if (!StartPrefetchWorker()) return;
+
+    int edge = GetTrayIconEdge();
+    EnterCriticalSection(&g_animCacheLock);
+    g_prefetchQueueCount = 0;
+    for (int i = 0; i < count && g_prefetchQueueCount < ANIM_PREFETCH_QUEUE_SIZE; ++i) {
+        if (!names[i] || !names[i][0] || strncmp(names[i], "__", 2) == 0) continue;
+        strncpy_s(g_prefetchQueue[g_prefetchQueueCount], MAX_PATH, names[i], _TRUNCATE);
+        g_prefetchQueueCount++;
+    }
+    g_prefetchEdge = edge;
+    LeaveCriticalSection(&g_animCacheLock);
+
+    SetEvent(g_prefetchWakeEvent);
+}
+
 /** @brief Load sequential icon frames from .ico and .png files */
 static void LoadTrayIcons(void) {
     LoadAnimationByName(g_animationName, FALSE);
@@ -1413,12 +2550,12 @@ void StartTrayAnimation(HWND hwnd, UINT intervalMs) {
     g_previewIndex = 0;
     
     /** Initialize timing state */
-    g_internalAccumulator = 0;
-    g_internalFramePosition = 0.0;
+    g_frameDeadlineMs = 0.0;
+    g_lastPostMs = 0.0;
+    g_framePostPending = FALSE;
     g_currentEffectiveInterval = TRAY_UPDATE_INTERVAL_MS;
-    g_lastTrayUpdateTime = 0;
     g_consecutiveLateUpdates = 0;
-    g_targetInternalInterval = INTERNAL_TICK_INTERVAL_MS;
+    g_speedScale = ComputeSpeedScale();
 
     /** Read current animation name from config */
     char config_path[MAX_PATH] = {0};
@@ -1450,32 +2587,45 @@ void StartTrayAnimation(HWND hwnd, UINT intervalMs) {
         UpdateTrayIconToCurrentFrame();
     }
     
-    /** Start high-precision timer system */
+    /** Start deadline scheduler */
     if (!InitializeAnimationTimer()) {
-        /** Fallback to standard SetTimer if multimedia timer fails */
-        SetTimer(hwnd, TRAY_ANIM_TIMER_ID, g_targetInternalInterval, FallbackTimerProc);
+        /** Fallback to standard SetTimer if the scheduler thread fails */
+        SetTimer(hwnd, TRAY_ANIM_TIMER_ID, USER_TIMER_MINIMUM, FallbackTimerProc);
     }
 
     /** Tooltip handled by tray.c periodic updater */
 }
 
 void StopTrayAnimation(HWND hwnd) {
-    /** Cleanup high-precision timer or fallback timer */
+    /** Stop scheduler thread or fallback timer */
     CleanupHighPrecisionTimer();
     KillTimer(hwnd, TRAY_ANIM_TIMER_ID);
+    KillTimer(hwnd, TRAY_SPEED_TIMER_ID);
+    g_speedTimerActive = FALSE;
+    SystemMonitor_SetConsumer(SYSTEM_CONSUMER_ICON, FALSE);
+    SystemMonitor_SetConsumer(SYSTEM_CONSUMER_ANIMATION, FALSE);
+    BOOL prefetchStopped = StopPrefetchWorker();
     
     /** Free icon resources */
-    FreeIconSet(g_trayIcons, &g_trayIconCount, &g_trayIconIndex, &g_isAnimated, &g_animCanvas, TRUE);
-    FreeIconSet(g_previewIcons, &g_previewCount, &g_previewIndex, &g_isPreviewAnimated, &g_previewAnimCanvas, FALSE);
+    FreeIconSet(g_trayIcons, &g_trayIconCount, &g_trayIconIndex, &g_isAnimated, &g_animCanvas, &g_trayStore, TRUE);
+    FreeIconSet(g_previewIcons, &g_previewCount, &g_previewIndex, &g_isPreviewAnimated, &g_previewAnimCanvas, &g_previewStore, FALSE);
     
-    /** Clean up memory pool */
-    MemoryPool_Cleanup();
+    ClearPercentIconCache();
+    ClearGraphIconCache();
+    if (prefetchStopped) {
+        AnimCache_Clear();
+    }
+    
+    /** Release the UI thread's imaging context and cached arena blocks */
+    ReleaseImagingContext();
+    LogFrameArenaStats("shutdown");
+    FrameArena_Trim();
     
     /** Reset timing state */
-    g_internalAccumulator = 0;
-    g_internalFramePosition = 0.0;
+    g_frameDeadlineMs = 0.0;
+    g_lastPostMs = 0.0;
+    g_framePostPending = FALSE;
     g_currentEffectiveInterval = TRAY_UPDATE_INTERVAL_MS;
-    g_lastTrayUpdateTime = 0;
     g_consecutiveLateUpdates = 0;
     
     /** Reset error recovery state */
@@ -1508,13 +2658,13 @@ BOOL SetCurrentAnimationName(const char* name) {
         WriteIniString("Animation", "ANIMATION_PATH", "__logo__", config_path);
         LoadTrayIcons();
         g_trayIconIndex = 0;
-        g_internalFramePosition = 0.0;
+        WakeAnimationScheduler(TRUE);
         if (g_trayHwnd && g_trayIconCount > 0) {
             UpdateTrayIconToCurrentFrame();
         }
         return TRUE;
     }
-    if (_stricmp(name, "__cpu__") == 0 || _stricmp(name, "__mem__") == 0) {
+    if (IsMetricIconName(name)) {
         strncpy(g_animationName, name, sizeof(g_animationName) - 1);
         g_animationName[sizeof(g_animationName) - 1] = '\0';
         char config_path[MAX_PATH] = {0};
@@ -1523,17 +2673,17 @@ BOOL SetCurrentAnimationName(const char* name) {
 
         LoadTrayIcons();
         g_trayIconIndex = 0;
-        g_internalFramePosition = 0.0;
         /** Ensure we are not in preview mode so periodic percent updates are not suppressed */
         if (g_isPreviewActive) {
             g_isPreviewActive = FALSE;
-            FreeIconSet(g_previewIcons, &g_previewCount, &g_previewIndex, &g_isPreviewAnimated, &g_previewAnimCanvas, FALSE);
+            FreeIconSet(g_previewIcons, &g_previewCount, &g_previewIndex, &g_isPreviewAnimated, &g_previewAnimCanvas, &g_previewStore, FALSE);
         }
+        WakeAnimationScheduler(TRUE);
         /** Immediately update percent icon so user sees change without extra interaction */
         if (g_trayHwnd) {
             UpdateTrayIconToCurrentFrame();
         }
-        /** Timer continues running, no need to restart for __cpu__/__mem__ */
+        /** Scheduler keeps running, no need to restart for metric icons */
         return TRUE;
     }
     BuildAnimationFolder(name, folder, sizeof(folder));
@@ -1581,7 +2731,7 @@ BOOL SetCurrentAnimationName(const char* name) {
         }
         
         /** Free old main animation resources */
-        FreeIconSet(g_trayIcons, &g_trayIconCount, &g_trayIconIndex, &g_isAnimated, &g_animCanvas, TRUE);
+        FreeIconSet(g_trayIcons, &g_trayIconCount, &g_trayIconIndex, &g_isAnimated, &g_animCanvas, &g_trayStore, TRUE);
         
         /** Transfer preview resources to main (move ownership, no copy) */
         for (int i = 0; i < g_previewCount; i++) {
@@ -1592,10 +2742,14 @@ BOOL SetCurrentAnimationName(const char* name) {
         g_trayIconCount = g_previewCount;
         g_trayIconIndex = g_previewIndex;  /** Maintain current frame position */
         g_isAnimated = g_isPreviewAnimated;
+
+        /** Masters and parked sizes follow the icons */
+        g_trayStore = g_previewStore;
+        ZeroMemory(&g_previewStore, sizeof(g_previewStore));
         
         /** Canvas not transferred (already used to create HICONs), just free preview canvas */
         if (g_previewAnimCanvas) {
-            free(g_previewAnimCanvas);
+            FrameArena_Free(g_previewAnimCanvas);
             g_previewAnimCanvas = NULL;
         }
         
@@ -1620,7 +2774,8 @@ BOOL SetCurrentAnimationName(const char* name) {
         snprintf(animPath, sizeof(animPath), "%%LOCALAPPDATA%%\\Catime\\resources\\animations\\%s", g_animationName);
         WriteIniString("Animation", "ANIMATION_PATH", animPath, config_path);
         
-        /** DON'T reset g_internalFramePosition - maintain smooth continuation */
+        /** DON'T reset the frame deadline - maintain smooth continuation */
+        WakeAnimationScheduler(FALSE);
         
         /** Update tray icon to current frame (seamless, no restart) */
         if (g_trayHwnd) {
@@ -1644,17 +2799,17 @@ BOOL SetCurrentAnimationName(const char* name) {
     /** Reload frames and reset index */
     LoadTrayIcons();
     g_trayIconIndex = 0;
-    g_internalFramePosition = 0.0;
     /** If a preview was active, finalize it now so we switch to the real selection without delay */
     if (g_isPreviewActive) {
         g_isPreviewActive = FALSE;
         g_previewAnimationName[0] = '\0';
-        FreeIconSet(g_previewIcons, &g_previewCount, &g_previewIndex, &g_isPreviewAnimated, &g_previewAnimCanvas, FALSE);
+        FreeIconSet(g_previewIcons, &g_previewCount, &g_previewIndex, &g_isPreviewAnimated, &g_previewAnimCanvas, &g_previewStore, FALSE);
     }
+    WakeAnimationScheduler(TRUE);
     if (g_trayHwnd) {
         UpdateTrayIconToCurrentFrame();
     }
-    /** Timer is already running, no need to restart */
+    /** Scheduler is already running, no need to restart */
     return TRUE;
 }
 
@@ -1672,12 +2827,12 @@ void StartAnimationPreview(const char* name) {
     if (g_previewCount > 0) {
         g_isPreviewActive = TRUE;
         g_previewIndex = 0;
-        g_internalFramePosition = 0.0;  /** Reset frame position for preview */
+        WakeAnimationScheduler(TRUE);  /** Restart frame timing for preview */
         
         /** Display first preview frame immediately */
         UpdateTrayIconToCurrentFrame();
         
-        /** Timer continues running in background, will handle preview frames */
+        /** Scheduler picks up preview frames from the wake above */
     } else {
         /** Preview failed, clear name */
         WriteLog(LOG_LEVEL_WARNING, "Animation preview failed to load: '%s'", name);
@@ -1689,14 +2844,14 @@ void CancelAnimationPreview(void) {
     if (!g_isPreviewActive) return;
     g_isPreviewActive = FALSE;
     g_previewAnimationName[0] = '\0';  /** Clear preview name */
-    FreeIconSet(g_previewIcons, &g_previewCount, &g_previewIndex, &g_isPreviewAnimated, &g_previewAnimCanvas, FALSE);
+    FreeIconSet(g_previewIcons, &g_previewCount, &g_previewIndex, &g_isPreviewAnimated, &g_previewAnimCanvas, &g_previewStore, FALSE);
     
-    g_internalFramePosition = 0.0;  /** Reset frame position */
+    WakeAnimationScheduler(TRUE);  /** Restart frame timing */
     
     /** Restore original tray icon immediately */
     UpdateTrayIconToCurrentFrame();
     
-    /** Timer continues running in background, no need to restart */
+    /** Scheduler keeps running in background, no need to restart */
 }
 
 void PreloadAnimationFromConfig(void) {
@@ -1726,7 +2881,7 @@ void PreloadAnimationFromConfig(void) {
 }
 
 HICON GetInitialAnimationHicon(void) {
-    if (_stricmp(g_animationName, "__cpu__") == 0 || _stricmp(g_animationName, "__mem__") == 0) {
+    if (IsMetricIconName(g_animationName)) {
         return NULL; /** updater will set first icon */
     }
     if (g_trayIconCount > 0) {
@@ -1767,28 +2922,27 @@ void ApplyAnimationPathValueNoPersist(const char* value) {
 
     LoadTrayIcons();
     g_trayIconIndex = 0;
-    g_internalFramePosition = 0.0;
     
     /** Clear any active preview since we're loading new main animation */
     if (g_isPreviewActive) {
         g_isPreviewActive = FALSE;
         g_previewAnimationName[0] = '\0';
-        FreeIconSet(g_previewIcons, &g_previewCount, &g_previewIndex, &g_isPreviewAnimated, &g_previewAnimCanvas, FALSE);
+        FreeIconSet(g_previewIcons, &g_previewCount, &g_previewIndex, &g_isPreviewAnimated, &g_previewAnimCanvas, &g_previewStore, FALSE);
     }
+    WakeAnimationScheduler(TRUE);
     
     if (!g_trayHwnd) return;
     
     if (g_trayIconCount > 0) {
         UpdateTrayIconToCurrentFrame();
     }
-    /** Timer continues running, no need to restart */
+    /** Scheduler keeps running, no need to restart */
 }
 
-/** Create a small 16x16 icon with percentage text (no % sign) */
-HICON CreatePercentIcon16(int percent) {
-    int cx = GetSystemMetrics(SM_CXSMICON);
-    int cy = GetSystemMetrics(SM_CYSMICON);
-    if (cx <= 0) cx = 16; if (cy <= 0) cy = 16;
+/** @brief Render a percent icon at the given size (no % sign) */
+static HICON RenderPercentIcon(int percent, int edge, COLORREF textColor, COLORREF bgColor) {
+    int cx = edge;
+    int cy = edge;
 
     BITMAPINFO bi; ZeroMemory(&bi, sizeof(bi));
     bi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
@@ -1816,34 +2970,28 @@ HICON CreatePercentIcon16(int percent) {
     HGDIOBJ old = SelectObject(mem, hbmColor);
 
     RECT rc = {0, 0, cx, cy};
-    extern COLORREF GetPercentIconBgColor(void);
-    HBRUSH bk = CreateSolidBrush(GetPercentIconBgColor());
+    HBRUSH bk = CreateSolidBrush(bgColor);
     FillRect(mem, &rc, bk);
     DeleteObject(bk);
 
     SetBkMode(mem, TRANSPARENT);
-    extern COLORREF GetPercentIconTextColor(void);
-    SetTextColor(mem, GetPercentIconTextColor());
+    SetTextColor(mem, textColor);
 
-    HFONT hFont = CreateFontW(-12, 0, 0, 0, FW_BOLD, FALSE, FALSE, FALSE,
+    /** 12px text on a 16px icon, scaled with the edge */
+    HFONT hFont = CreateFontW(-MulDiv(12, cx, 16), 0, 0, 0, FW_BOLD, FALSE, FALSE, FALSE,
                               DEFAULT_CHARSET, OUT_DEFAULT_PRECIS, CLIP_DEFAULT_PRECIS,
                               ANTIALIASED_QUALITY, VARIABLE_PITCH | FF_SWISS, L"Segoe UI");
     HFONT oldf = hFont ? (HFONT)SelectObject(mem, hFont) : NULL;
 
     wchar_t txt[4];
     if (percent > 999) percent = 999; if (percent < 0) percent = 0;
-    if (percent >= 100) {
-        wsprintfW(txt, L"%d", percent); /* 100..999 */
-    } else {
-        wsprintfW(txt, L"%d", percent); /* 0..99 */
-    }
+    wsprintfW(txt, L"%d", percent);
 
     SIZE sz = {0};
     GetTextExtentPoint32W(mem, txt, lstrlenW(txt), &sz);
     int x = (cx - sz.cx) / 2;
     int y = (cy - sz.cy) / 2;
 
-    /* Draw black text on white background */
     TextOutW(mem, x, y, txt, lstrlenW(txt));
 
     if (oldf) SelectObject(mem, oldf);
@@ -1863,50 +3011,424 @@ HICON CreatePercentIcon16(int percent) {
     return hIcon;
 }
 
+/** @brief Destroy all cached percent icons and forget the key */
+static void ClearPercentIconCache(void) {
+    for (int i = 0; i < PERCENT_ICON_CACHE_SIZE; i++) {
+        if (g_percentIconCache.icons[i]) {
+            DestroyIcon(g_percentIconCache.icons[i]);
+            g_percentIconCache.icons[i] = NULL;
+        }
+    }
+    g_percentIconCache.edge = 0;
+    g_percentIconCache.shownIcon = NULL;
+}
+
+/**
+ * @brief Cached percent icon for a value, rendering it on first use
+ * @return Icon owned by the cache (do not destroy), or NULL on failure
+ */
+static HICON GetCachedPercentIcon(int percent) {
+    if (percent < 0) percent = 0;
+    if (percent > 100) percent = 100;
+
+    COLORREF textColor = GetPercentIconTextColor();
+    COLORREF bgColor = GetPercentIconBgColor();
+    if (g_percentIconCache.edge != 0 &&
+        (g_percentIconCache.textColor != textColor || g_percentIconCache.bgColor != bgColor)) {
+        ClearPercentIconCache();
+    }
+    if (g_percentIconCache.edge == 0) {
+        g_percentIconCache.edge = GetTrayIconMetrics(&g_percentIconCache.dpi);
+        g_percentIconCache.textColor = textColor;
+        g_percentIconCache.bgColor = bgColor;
+    }
+
+    HICON hIcon = g_percentIconCache.icons[percent];
+    if (!hIcon) {
+        hIcon = RenderPercentIcon(percent, g_percentIconCache.edge, textColor, bgColor);
+        g_percentIconCache.icons[percent] = hIcon;
+    }
+    return hIcon;
+}
+
+/**
+ * @brief Show a percent value in the tray, skipping NIM_MODIFY if it is already shown
+ * @param force TRUE to send even when the cached icon is unchanged
+ * @return TRUE if the icon is on screen
+ */
+static BOOL ShowPercentIcon(int percent, BOOL force) {
+    HICON hIcon = GetCachedPercentIcon(percent);
+    if (!hIcon) return FALSE;
+    if (!force && hIcon == g_percentIconCache.shownIcon) return TRUE;
+    g_graphIconCache.hasShown = FALSE;
+
+    NOTIFYICONDATAW nid = {0};
+    nid.cbSize = sizeof(nid);
+    nid.hWnd = g_trayHwnd;
+    nid.uID = CLOCK_ID_TRAY_APP_ICON;
+    nid.uFlags = NIF_ICON;
+    nid.hIcon = hIcon;
+    if (!Shell_NotifyIconW(NIM_MODIFY, &nid)) {
+        g_percentIconCache.shownIcon = NULL;
+        return FALSE;
+    }
+    g_percentIconCache.shownIcon = hIcon;
+    return TRUE;
+}
+
+/** Create a small percentage icon (no % sign); caller owns the returned copy */
+HICON CreatePercentIcon16(int percent) {
+    HICON hIcon = GetCachedPercentIcon(percent);
+    return hIcon ? CopyIcon(hIcon) : NULL;
+}
+
+/* ============================================================================
+ * Graph icons (__cpuhist__ sparkline, __cores__ per-core bars)
+ * ============================================================================ */
+
+/** @brief Opaque PBGRA pixel for a COLORREF */
+static DWORD GraphPixel(COLORREF c) {
+    return 0xFF000000u | ((DWORD)GetRValue(c) << 16) | ((DWORD)GetGValue(c) << 8) | (DWORD)GetBValue(c);
+}
+
+/** @brief Free the atlas and persistent bitmaps and forget the key */
+static void ClearGraphIconCache(void) {
+    if (g_graphIconCache.shownIcon) DestroyIcon(g_graphIconCache.shownIcon);
+    if (g_graphIconCache.hbmColor) DeleteObject(g_graphIconCache.hbmColor);
+    if (g_graphIconCache.hbmMask) DeleteObject(g_graphIconCache.hbmMask);
+    free(g_graphIconCache.atlas);
+    ZeroMemory(&g_graphIconCache, sizeof(g_graphIconCache));
+}
+
+/**
+ * @brief Build the column atlas and persistent bitmaps for the current key
+ * @return TRUE if the cache is ready to draw
+ */
+static BOOL EnsureGraphIconCache(void) {
+    COLORREF barColor = GetPercentIconTextColor();
+    COLORREF bgColor = GetPercentIconBgColor();
+    UINT dpi = 0;
+    int edge = GetTrayIconMetrics(&dpi);
+    if (edge > GRAPH_ICON_MAX_EDGE) edge = GRAPH_ICON_MAX_EDGE;
+    if (edge <= 0) return FALSE;
+
+    if (g_graphIconCache.edge == edge && g_graphIconCache.dpi == dpi &&
+        g_graphIconCache.barColor == barColor && g_graphIconCache.bgColor == bgColor) {
+        return TRUE;
+    }
+    ClearGraphIconCache();
+
+    size_t columnCount = 2 * (size_t)(edge + 1);
+    DWORD* atlas = (DWORD*)malloc(columnCount * (size_t)edge * sizeof(DWORD));
+    if (!atlas) return FALSE;
+    DWORD bg = GraphPixel(bgColor);
+    for (int hot = 0; hot < 2; ++hot) {
+        DWORD bar = GraphPixel(hot ? GRAPH_ICON_HOT_COLOR : barColor);
+        for (int h = 0; h <= edge; ++h) {
+            DWORD* column = atlas + ((size_t)hot * (edge + 1) + h) * edge;
+            for (int y = 0; y < edge; ++y) {
+                column[y] = (y >= edge - h) ? bar : bg;
+            }
+        }
+    }
+
+    BITMAPINFO bi; ZeroMemory(&bi, sizeof(bi));
+    bi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+    bi.bmiHeader.biWidth = edge;
+    bi.bmiHeader.biHeight = -edge; /** top-down */
+    bi.bmiHeader.biPlanes = 1;
+    bi.bmiHeader.biBitCount = 32;
+    bi.bmiHeader.biCompression = BI_RGB;
+
+    VOID* pvBits = NULL;
+    HBITMAP hbmColor = CreateDIBSection(NULL, &bi, DIB_RGB_COLORS, &pvBits, NULL, 0);
+    int maskStride = ((edge + 15) / 16) * 2;
+    BYTE* maskBits = (BYTE*)calloc((size_t)maskStride * edge, 1);
+    HBITMAP hbmMask = maskBits ? CreateBitmap(edge, edge, 1, 1, maskBits) : NULL;
+    free(maskBits);
+    if (!hbmColor || !pvBits || !hbmMask) {
+        if (hbmColor) DeleteObject(hbmColor);
+        if (hbmMask) DeleteObject(hbmMask);
+        free(atlas);
+        return FALSE;
+    }
+
+    g_graphIconCache.edge = edge;
+    g_graphIconCache.dpi = dpi;
+    g_graphIconCache.barColor = barColor;
+    g_graphIconCache.bgColor = bgColor;
+    g_graphIconCache.atlas = atlas;
+    g_graphIconCache.hbmColor = hbmColor;
+    g_graphIconCache.colorBits = (DWORD*)pvBits;
+    g_graphIconCache.hbmMask = hbmMask;
+    return TRUE;
+}
+
+/** @brief Bar height for a percentage, with the hot flag in bit 7 */
+static BYTE GraphColumn(float percent, int edge) {
+    if (percent < 0.0f) percent = 0.0f;
+    if (percent > 100.0f) percent = 100.0f;
+    int h = (int)(percent * (float)edge / 100.0f + 0.5f);
+    if (h == 0 && percent >= 1.0f) h = 1;  /** Keep any real load visible */
+    return (BYTE)(h | (percent >= GRAPH_ICON_HOT_PERCENT ? 0x80 : 0));
+}
+
+/**
+ * @brief Work out the bar of each icon column from the published metrics
+ *
+ * __cpuhist__: one column per sample, newest on the right.
+ * __cores__: the icon width split between cores (1 px gaps when they fit);
+ * with more cores than columns, each column shows its busiest core.
+ */
+static void ComputeGraphColumns(const char* name, int edge, BYTE* columns) {
+    ZeroMemory(columns, (size_t)edge);
+
+    if (_stricmp(name, "__cpuhist__") == 0) {
+        float values[GRAPH_ICON_MAX_EDGE];
+        int n = SystemMonitor_GetHistory(SYSTEM_SERIES_CPU, values, edge);
+        for (int i = 0; i < n; ++i) {
+            columns[edge - n + i] = GraphColumn(values[i], edge);
+        }
+        return;
+    }
+
+    SystemMetricsSnapshot snap;
+    SystemMonitor_GetSnapshot(&snap);
+    int cores = snap.coreCount;
+    if (cores <= 0) {
+        /** No per-core data (yet): one full-width bar of the system total */
+        for (int x = 0; x < edge; ++x) columns[x] = GraphColumn(snap.cpuPercent, edge);
+        return;
+    }
+
+    BOOL gaps = (edge / cores) >= 3;
+    for (int x = 0; x < edge; ++x) {
+        int first = x * cores / edge;
+        int last = (x + 1) * cores / edge;
+        if (last <= first) last = first + 1;
+        if (gaps && (x + 1) * cores / edge != first) continue;  /** Last column of a core */
+        float peak = 0.0f;
+        for (int c = first; c < last && c < cores; ++c) {
+            if (snap.corePercent[c] > peak) peak = snap.corePercent[c];
+        }
+        columns[x] = GraphColumn(peak, edge);
+    }
+}
+
+/**
+ * @brief Render columns into the persistent DIB and wrap it in a new icon
+ * @return New icon (caller owns), or NULL on failure
+ */
+static HICON RenderGraphIcon(const BYTE* columns) {
+    int edge = g_graphIconCache.edge;
+    DWORD* bits = g_graphIconCache.colorBits;
+    for (int x = 0; x < edge; ++x) {
+        int hot = (columns[x] & 0x80) ? 1 : 0;
+        int h = columns[x] & 0x7F;
+        const DWORD* column = g_graphIconCache.atlas + ((size_t)hot * (edge + 1) + h) * edge;
+        for (int y = 0; y < edge; ++y) {
+            bits[(size_t)y * edge + x] = column[y];
+        }
+    }
+    GdiFlush();
+
+    ICONINFO ii; ZeroMemory(&ii, sizeof(ii));
+    ii.fIcon = TRUE;
+    ii.hbmColor = g_graphIconCache.hbmColor;
+    ii.hbmMask = g_graphIconCache.hbmMask;
+    return CreateIconIndirect(&ii);
+}
+
+/** @brief Graph icon of the current metrics for a preview; caller owns it */
+static HICON CreateGraphIconCopy(const char* name) {
+    if (!EnsureGraphIconCache()) return NULL;
+    BYTE columns[GRAPH_ICON_MAX_EDGE];
+    ComputeGraphColumns(name, g_graphIconCache.edge, columns);
+    return RenderGraphIcon(columns);
+}
+
+/**
+ * @brief Show the graph icon for the current mode, skipping unchanged bars
+ * @param force TRUE to send even when the bars match what is shown
+ * @return TRUE if the icon is on screen
+ */
+static BOOL ShowGraphIcon(BOOL force) {
+    if (!EnsureGraphIconCache()) return FALSE;
+
+    int edge = g_graphIconCache.edge;
+    BYTE columns[GRAPH_ICON_MAX_EDGE];
+    ComputeGraphColumns(g_animationName, edge, columns);
+    if (!force && g_graphIconCache.hasShown && memcmp(columns, g_graphIconCache.columns, (size_t)edge) == 0) {
+        return TRUE;
+    }
+
+    HICON hIcon = RenderGraphIcon(columns);
+    if (!hIcon) return FALSE;
+
+    NOTIFYICONDATAW nid = {0};
+    nid.cbSize = sizeof(nid);
+    nid.hWnd = g_trayHwnd;
+    nid.uID = CLOCK_ID_TRAY_APP_ICON;
+    nid.uFlags = NIF_ICON;
+    nid.hIcon = hIcon;
+    BOOL ok = Shell_NotifyIconW(NIM_MODIFY, &nid);
+
+    /** The shell keeps its own copy; only the latest icon is retained here */
+    if (g_graphIconCache.shownIcon) DestroyIcon(g_graphIconCache.shownIcon);
+    g_graphIconCache.shownIcon = hIcon;
+    g_percentIconCache.shownIcon = NULL;
+    g_graphIconCache.hasShown = ok;
+    if (ok) memcpy(g_graphIconCache.columns, columns, (size_t)edge);
+    return ok;
+}
+
+void TrayAnimation_InvalidatePercentIconCache(void) {
+    ClearPercentIconCache();
+    ClearGraphIconCache();
+}
+
 void TrayAnimation_UpdatePercentIconIfNeeded(void) {
     if (!g_trayHwnd) return;
     if (!IsWindow(g_trayHwnd)) return;
     if (!g_animationName[0]) return;
-    if (_stricmp(g_animationName, "__cpu__") != 0 && _stricmp(g_animationName, "__mem__") != 0) return;
+    if (!IsMetricIconName(g_animationName)) return;
     
-    /** Don't update percent icon if user is previewing another animation */
+    /** Don't update metric icons if user is previewing another animation */
     if (g_isPreviewActive) return;
 
+    if (IsGraphIconName(g_animationName)) {
+        ShowGraphIcon(FALSE);
+        return;
+    }
+
     float cpu = 0.0f, mem = 0.0f;
     SystemMonitor_GetUsage(&cpu, &mem);
     int p = (_stricmp(g_animationName, "__cpu__") == 0) ? (int)(cpu + 0.5f) : (int)(mem + 0.5f);
     if (p < 0) p = 0; if (p > 100) p = 100;
 
-    HICON hIcon = CreatePercentIcon16(p);
-    if (!hIcon) return;
+    ShowPercentIcon(p, FALSE);
+}
 
-    NOTIFYICONDATAW nid = {0};
-    nid.cbSize = sizeof(nid);
-    nid.hWnd = g_trayHwnd;
-    nid.uID = CLOCK_ID_TRAY_APP_ICON;
-    nid.uFlags = NIF_ICON;
-    nid.hIcon = hIcon;
-    Shell_NotifyIconW(NIM_MODIFY, &nid);
+/**
+ * @brief React to DPI, monitor or icon-metric changes
+ *
+ * Switches tray and preview frames to the taskbar's current small-icon size
+ * from the frame store. Only sources without masters (.ico frames, logo) are
+ * reloaded from disk.
+ */
+void TrayAnimation_HandleDpiChange(void) {
+    UINT dpi = 0;
+    int edge = GetTrayIconMetrics(&dpi);
+
+    if (g_percentIconCache.edge != 0 &&
+        (g_percentIconCache.edge != edge || g_percentIconCache.dpi != dpi)) {
+        ClearPercentIconCache();
+    }
+    if (g_graphIconCache.edge != 0 &&
+        (g_graphIconCache.edge != edge || g_graphIconCache.dpi != dpi)) {
+        ClearGraphIconCache();
+        if (IsGraphIconName(g_animationName) && !g_isPreviewActive) ShowGraphIcon(TRUE);
+    }
+
+    if (g_trayIconCount > 0 && g_trayStore.activeEdge != edge) {
+        DecodeTarget tray = GetDecodeTarget(FALSE);
+        if (!FrameStore_SwitchEdge(&tray, edge)) {
+            int keepIndex = g_trayIconIndex;
+            LoadTrayIcons();
+            if (keepIndex < g_trayIconCount) g_trayIconIndex = keepIndex;
+        }
+    }
+
+    if (g_isPreviewActive && g_previewCount > 0 && g_previewStore.activeEdge != edge) {
+        DecodeTarget preview = GetDecodeTarget(TRUE);
+        if (!FrameStore_SwitchEdge(&preview, edge)) {
+            int keepIndex = g_previewIndex;
+            LoadAnimationByName(g_previewAnimationName, TRUE);
+            if (keepIndex < g_previewCount) g_previewIndex = keepIndex;
+        }
+    }
+
+    if (g_trayHwnd) {
+        UpdateTrayIconToCurrentFrame();
+    }
+}
+
+static void CALLBACK SpeedTimerProc(HWND hwnd, UINT msg, UINT_PTR id, DWORD time) {
+    (void)hwnd; (void)msg; (void)id; (void)time;
+    TrayAnimation_RecomputeTimerDelay();
+}
 
-    DestroyIcon(hIcon);
+/**
+ * @brief Tell the system monitor what the tray currently needs sampled
+ *
+ * Metric icons need the normal rate. An animation whose speed follows
+ * CPU/memory needs the fast rate, and its speed is then re-read at that
+ * rate rather than only with the 1 Hz tooltip, so smoothed readings move
+ * the frame rate gradually instead of in one-second steps.
+ */
+static void UpdateSamplingDemand(void) {
+    BOOL metricIcon = IsMetricIconName(g_animationName);
+    BOOL animating = g_isPreviewActive ? (g_previewCount > 1) : (!metricIcon && g_trayIconCount > 1);
+    BOOL followsSystem = animating && g_trayHwnd != NULL && GetAnimationSpeedMetric() != ANIMATION_SPEED_TIMER;
+
+    SystemMonitor_SetConsumer(SYSTEM_CONSUMER_ICON, metricIcon);
+    SystemMonitor_SetConsumer(SYSTEM_CONSUMER_ANIMATION, followsSystem);
+
+    if (followsSystem != g_speedTimerActive) {
+        if (followsSystem) {
+            SetTimer(g_trayHwnd, TRAY_SPEED_TIMER_ID, SystemMonitor_GetFastIntervalMs(), SpeedTimerProc);
+        } else if (g_trayHwnd) {
+            KillTimer(g_trayHwnd, TRAY_SPEED_TIMER_ID);
+        }
+        g_speedTimerActive = followsSystem;
+    }
 }
 
 void TrayAnimation_RecomputeTimerDelay(void) {
+    UpdateSamplingDemand();
+
     /**
-     * With the new high-precision timer system, we don't need to constantly
-     * restart timers. The speed scaling is computed on-the-fly in 
-     * AdvanceInternalFramePosition() which is called by the timer callback.
-     * 
-     * This function is kept for API compatibility but does nothing now.
-     * The adaptive frame rate system automatically adjusts based on actual
-     * performance, which is better than manual timer resets.
+     * Re-read the speed metric; nothing is recomputed unless the reading or
+     * the speed map moved, and the scheduler is only disturbed when the
+     * resulting scale did. Callers: the 1 Hz tooltip updater, the fast
+     * speed timer, speed config reloads and countdown completion.
      */
-    (void)0;  /** No-op */
+    AnimationSpeedMetric metric = GetAnimationSpeedMetric();
+    int percentTenths = ReadSpeedMetricTenths(metric);
+    UINT mapVersion = GetAnimationSpeedMapVersion();
+    if (g_speedSnapshot.valid && g_speedSnapshot.metric == metric &&
+        g_speedSnapshot.percentTenths == percentTenths &&
+        g_speedSnapshot.mapVersion == mapVersion) {
+        return;
+    }
+    g_speedSnapshot.metric = metric;
+    g_speedSnapshot.percentTenths = percentTenths;
+    g_speedSnapshot.mapVersion = mapVersion;
+    g_speedSnapshot.valid = TRUE;
+
+    double scale = SpeedScaleForTenths(percentTenths);
+    BOOL changed = FALSE;
+
+    if (g_criticalSectionInitialized) {
+        EnterCriticalSection(&g_animCriticalSection);
+    }
+    if (scale != g_speedScale) {
+        AnimTrace_Record(ANIM_TRACE_SPEED, SchedulerNowMs(), g_speedScale, scale, 0);
+        g_speedScale = scale;
+        changed = TRUE;
+    }
+    if (g_criticalSectionInitialized) {
+        LeaveCriticalSection(&g_animCriticalSection);
+    }
+
+    if (changed) {
+        WakeAnimationScheduler(FALSE);
+    }
 }
 
 void TrayAnimation_SetMinIntervalMs(UINT ms) {
     g_userMinIntervalMs = ms;
-    TrayAnimation_RecomputeTimerDelay();
+    WakeAnimationScheduler(TRUE);
 }
 
 /**
@@ -1937,7 +3459,53 @@ BOOL TrayAnimation_HandleUpdateMessage(void) {
 void TrayAnimation_SetBaseIntervalMs(UINT ms) {
     if (ms == 0) ms = 150;
     g_trayInterval = ms;
-    TrayAnimation_RecomputeTimerDelay();
+    WakeAnimationScheduler(TRUE);
+}
+
+/**
+ * @brief Write the animation timing trace as CSV next to the config file
+ * @param reveal TRUE to select the written file in Explorer
+ * @return TRUE if the file was written
+ *
+ * The summary (lateness and update-latency percentiles, time spent with
+ * widened update spacing) goes both into the file header and the log.
+ */
+BOOL TrayAnimation_DumpTimingTrace(BOOL reveal) {
+    char configPath[MAX_PATH] = {0};
+    GetConfigPath(configPath, sizeof(configPath));
+    wchar_t wPath[MAX_PATH] = {0};
+    MultiByteToWideChar(CP_UTF8, 0, configPath, -1, wPath, MAX_PATH);
+    wchar_t* lastSeparator = wcsrchr(wPath, L'\\');
+    size_t dirLen = lastSeparator ? (size_t)(lastSeparator - wPath + 1) : 0;
+    _snwprintf_s(wPath + dirLen, MAX_PATH - dirLen, _TRUNCATE, L"Catime_AnimTrace.csv");
+
+    FILE* f = _wfopen(wPath, L"w");
+    if (!f) {
+        WriteLog(LOG_LEVEL_WARNING, "Could not open animation trace file for writing");
+        return FALSE;
+    }
+
+    AnimTraceSummary summary;
+    int rc = AnimTrace_WriteCsv(f, (double)TRAY_UPDATE_INTERVAL_MS, SchedulerNowMs(), &summary);
+    fclose(f);
+    if (rc != 0) {
+        WriteLog(LOG_LEVEL_WARNING, "Writing animation trace failed");
+        return FALSE;
+    }
+
+    WriteLog(LOG_LEVEL_INFO,
+             "Animation trace: %zu frames, lateness p50=%.2f p95=%.2f p99=%.2f ms; "
+             "%zu updates (%zu failed), latency p95=%.2f ms; throttled %.1f of %.1f s; %zu fallbacks",
+             summary.frames, summary.latenessP50, summary.latenessP95, summary.latenessP99,
+             summary.trayUpdates, summary.trayUpdateFailures, summary.updateLatencyP95,
+             summary.throttledMs / 1000.0, summary.spanMs / 1000.0, summary.fallbacks);
+
+    if (reveal) {
+        wchar_t args[MAX_PATH + 16] = {0};
+        _snwprintf_s(args, _countof(args), _TRUNCATE, L"/select,\"%s\"", wPath);
+        ShellExecuteW(NULL, L"open", L"explorer.exe", args, NULL, SW_SHOWNORMAL);
+    }
+    return TRUE;
 }
 
 static void OpenAnimationsFolder(void) {
@@ -1948,39 +3516,15 @@ static void OpenAnimationsFolder(void) {
     ShellExecuteW(NULL, L"open", wPath, NULL, NULL, SW_SHOWNORMAL);
 }
 
-/** @brief Checks if a folder contains no sub-folders or animated images, making it a leaf. */
-static BOOL IsAnimationLeafFolderW(const wchar_t* folderPathW) {
-    wchar_t wSearch[MAX_PATH] = {0};
-    _snwprintf_s(wSearch, MAX_PATH, _TRUNCATE, L"%s\\*", folderPathW);
-    
-    WIN32_FIND_DATAW ffd;
-    HANDLE hFind = FindFirstFileW(wSearch, &ffd);
-    if (hFind == INVALID_HANDLE_VALUE) return TRUE; // Empty is a leaf
-
-    BOOL hasSubItems = FALSE;
-    do {
-        if (wcscmp(ffd.cFileName, L".") == 0 || wcscmp(ffd.cFileName, L"..") == 0) continue;
-        
-        if (ffd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
-            hasSubItems = TRUE;
-            break;
-        }
-        wchar_t* ext = wcsrchr(ffd.cFileName, L'.');
-        if (ext && (_wcsicmp(ext, L".gif") == 0 || _wcsicmp(ext, L".webp") == 0)) {
-            hasSubItems = TRUE;
-            break;
-        }
-    } while (FindNextFileW(hFind, &ffd));
-    FindClose(hFind);
-    
-    return !hasSubItems;
-}
-
 BOOL HandleAnimationMenuCommand(HWND hwnd, UINT id) {
     if (id == CLOCK_IDM_ANIMATIONS_OPEN_DIR) {
         OpenAnimationsFolder();
         return TRUE;
     }
+    if (id == CLOCK_IDM_ANIMATIONS_DUMP_TRACE) {
+        TrayAnimation_DumpTimingTrace(TRUE);
+        return TRUE;
+    }
     if (id == CLOCK_IDM_ANIMATIONS_USE_LOGO) {
         return SetCurrentAnimationName("__logo__");
     }
@@ -1990,165 +3534,17 @@ BOOL HandleAnimationMenuCommand(HWND hwnd, UINT id) {
     if (id == CLOCK_IDM_ANIMATIONS_USE_MEM) {
         return SetCurrentAnimationName("__mem__");
     }
-    if (id >= CLOCK_IDM_ANIMATIONS_BASE && id < CLOCK_IDM_ANIMATIONS_BASE + 1000) {
-        char animRootUtf8[MAX_PATH] = {0};
-        GetAnimationsFolderPath(animRootUtf8, sizeof(animRootUtf8));
-        wchar_t wRoot[MAX_PATH] = {0};
-        MultiByteToWideChar(CP_UTF8, 0, animRootUtf8, -1, wRoot, MAX_PATH);
-
-        UINT nextId = CLOCK_IDM_ANIMATIONS_BASE;
-
-        /** Recursive helper to find animation by ID */
-        BOOL FindAnimationByIdRecursive(const wchar_t* folderPathW, const char* folderPathUtf8, UINT* nextIdPtr, UINT targetId, AnimationEntry* found_entry) {
-            AnimationEntry* entries = (AnimationEntry*)malloc(sizeof(AnimationEntry) * MAX_TRAY_FRAMES);
-            if (!entries) return FALSE;
-            int entryCount = 0;
-
-            wchar_t wSearch[MAX_PATH] = {0};
-            _snwprintf_s(wSearch, MAX_PATH, _TRUNCATE, L"%s\\*", folderPathW);
-            
-            WIN32_FIND_DATAW ffd;
-            HANDLE hFind = FindFirstFileW(wSearch, &ffd);
-            if (hFind == INVALID_HANDLE_VALUE) {
-                free(entries);
-                return FALSE;
-            }
-
-            do {
-                if (wcscmp(ffd.cFileName, L".") == 0 || wcscmp(ffd.cFileName, L"..") == 0) continue;
-                if (entryCount >= MAX_TRAY_FRAMES) break;
-
-                AnimationEntry* e = &entries[entryCount];
-                e->is_dir = (ffd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
-                wcsncpy(e->name, ffd.cFileName, MAX_PATH - 1);
-                e->name[MAX_PATH - 1] = L'\0';
-
-            char itemUtf8[MAX_PATH] = {0};
-            WideCharToMultiByte(CP_UTF8, 0, ffd.cFileName, -1, itemUtf8, MAX_PATH, NULL, NULL);
-            if (folderPathUtf8 && folderPathUtf8[0] != '\0') {
-                _snprintf_s(e->rel_path_utf8, MAX_PATH, _TRUNCATE, "%s\\%s", folderPathUtf8, itemUtf8);
-            } else {
-                _snprintf_s(e->rel_path_utf8, MAX_PATH, _TRUNCATE, "%s", itemUtf8);
-            }
-                
-                if (e->is_dir) {
-                    entryCount++;
-                } else {
-                    wchar_t* ext = wcsrchr(e->name, L'.');
-                    if (ext && (_wcsicmp(ext, L".gif") == 0 || _wcsicmp(ext, L".webp") == 0 ||
-                                _wcsicmp(ext, L".ico") == 0 || _wcsicmp(ext, L".png") == 0 ||
-                                _wcsicmp(ext, L".bmp") == 0 || _wcsicmp(ext, L".jpg") == 0 ||
-                                _wcsicmp(ext, L".jpeg") == 0 || _wcsicmp(ext, L".tif") == 0 ||
-                                _wcsicmp(ext, L".tiff") == 0)) {
-                        entryCount++;
-                    }
-                }
-            } while (FindNextFileW(hFind, &ffd));
-            FindClose(hFind);
-
-            if (entryCount == 0) {
-                free(entries);
-                return FALSE;
-            }
-            qsort(entries, entryCount, sizeof(AnimationEntry), CompareAnimationEntries);
-
-            for (int i = 0; i < entryCount; ++i) {
-                AnimationEntry* e = &entries[i];
-                if (e->is_dir) {
-                    wchar_t wSubFolderPath[MAX_PATH] = {0};
-                    _snwprintf_s(wSubFolderPath, MAX_PATH, _TRUNCATE, L"%s\\%s", folderPathW, e->name);
-
-                    if (IsAnimationLeafFolderW(wSubFolderPath)) {
-                        // This is a leaf folder, it's a single clickable item.
-                        if (*nextIdPtr == targetId) {
-                            *found_entry = *e;
-                            free(entries);
-                            return TRUE;
-                        }
-                        (*nextIdPtr)++;
-                    } else {
-                        // This is a branch folder (submenu), recurse without incrementing ID for the folder itself.
-                        if (FindAnimationByIdRecursive(wSubFolderPath, e->rel_path_utf8, nextIdPtr, targetId, found_entry)) {
-                            free(entries);
-                            return TRUE;
-                        }
-                    }
-                } else {
-                    // This is a file (.gif/.webp), it's a single clickable item.
-                    if (*nextIdPtr == targetId) {
-                        *found_entry = *e;
-                        free(entries);
-                        return TRUE;
-                    }
-                    (*nextIdPtr)++;
-                }
-            }
-            free(entries);
-            return FALSE;
-        }
-
-        AnimationEntry rootEntries[MAX_TRAY_FRAMES];
-        int rootEntryCount = 0;
-        wchar_t wRootSearch[MAX_PATH] = {0};
-        _snwprintf_s(wRootSearch, MAX_PATH, _TRUNCATE, L"%s\\*", wRoot);
-        
-        WIN32_FIND_DATAW ffd;
-        HANDLE hFind = FindFirstFileW(wRootSearch, &ffd);
-        if (hFind != INVALID_HANDLE_VALUE) {
-             do {
-                if (wcscmp(ffd.cFileName, L".") == 0 || wcscmp(ffd.cFileName, L"..") == 0) continue;
-                if (rootEntryCount >= MAX_TRAY_FRAMES) break;
-
-                AnimationEntry* e = &rootEntries[rootEntryCount];
-                e->is_dir = (ffd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
-                wcsncpy(e->name, ffd.cFileName, MAX_PATH - 1);
-                e->name[MAX_PATH - 1] = L'\0';
-                WideCharToMultiByte(CP_UTF8, 0, e->name, -1, e->rel_path_utf8, MAX_PATH, NULL, NULL);
-
-                if (e->is_dir) {
-                    rootEntryCount++;
-                } else {
-                    wchar_t* ext = wcsrchr(e->name, L'.');
-                    if (ext && (_wcsicmp(ext, L".gif") == 0 || _wcsicmp(ext, L".webp") == 0 ||
-                                _wcsicmp(ext, L".ico") == 0 || _wcsicmp(ext, L".png") == 0 ||
-                                _wcsicmp(ext, L".bmp") == 0 || _wcsicmp(ext, L".jpg") == 0 ||
-                                _wcsicmp(ext, L".jpeg") == 0 || _wcsicmp(ext, L".tif") == 0 ||
-                                _wcsicmp(ext, L".tiff") == 0)) {
-                        rootEntryCount++;
-                    }
-                }
-            } while (FindNextFileW(hFind, &ffd));
-            FindClose(hFind);
-        }
-        
-        if (rootEntryCount > 0) {
-            qsort(rootEntries, rootEntryCount, sizeof(AnimationEntry), CompareAnimationEntries);
-            for (int i = 0; i < rootEntryCount; ++i) {
-                AnimationEntry* e = &rootEntries[i];
-                if (e->is_dir) {
-                    wchar_t wFolderPath[MAX_PATH] = {0};
-                    _snwprintf_s(wFolderPath, MAX_PATH, _TRUNCATE, L"%s\\%s", wRoot, e->name);
-
-                    if (IsAnimationLeafFolderW(wFolderPath)) {
-                        if (nextId == id) {
-                            return SetCurrentAnimationName(e->rel_path_utf8);
-                        }
-                        nextId++;
-                    } else {
-                        AnimationEntry found_entry;
-                        if (FindAnimationByIdRecursive(wFolderPath, e->rel_path_utf8, &nextId, id, &found_entry)) {
-                            return SetCurrentAnimationName(found_entry.rel_path_utf8);
-                        }
-                    }
-                } else {
-                    if (nextId == id) {
-                        return SetCurrentAnimationName(e->rel_path_utf8);
-                    }
-                    nextId++;
-                }
-            }
-        }
-        return FALSE;
+    if (id == CLOCK_IDM_ANIMATIONS_USE_CPU_HISTORY) {
+        return SetCurrentAnimationName("__cpuhist__");
+    }
+    if (id == CLOCK_IDM_ANIMATIONS_USE_CPU_CORES) {
+        return SetCurrentAnimationName("__cores__");
+    }
+    const CatalogEntry* entry = TrayMenu_GetAnimationItem(id);
+    if (entry) {
+        char name[MAX_PATH];
+        strncpy_s(name, MAX_PATH, entry->relPathUtf8, _TRUNCATE);
+        return SetCurrentAnimationName(name);
     }
     return FALSE;
 }
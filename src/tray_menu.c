@@ -25,29 +25,10 @@
 #include "../include/config.h"
 #include "../resource/resource.h"
 #include "../include/tray_animation.h"
+#include "../include/resource_catalog.h"
 #include "../include/startup.h"
-
-/* ============================================================================
- * Type Definitions
- * ============================================================================ */
-
-/** @brief Represents a file or folder entry for sorting animation menus */
-typedef struct {
-    wchar_t name[MAX_PATH];
-    char rel_path_utf8[MAX_PATH]; /** Relative path from animations root */
-    BOOL is_dir;
-} AnimationEntry;
-
-/** @brief Font entry structure for natural sorting */
-typedef struct {
-    wchar_t name[MAX_PATH];
-    wchar_t fullPath[MAX_PATH];
-    wchar_t displayName[MAX_PATH];
-    BOOL is_dir;
-    BOOL isCurrentFont;
-    int subFolderStatus; /** 0=no content, 1=has content, 2=contains current font */
-    HMENU hSubMenu; /** For directories: submenu handle */
-} FontEntry;
+#include "../include/metrics_endpoint.h"
+#include "../include/menu_id_map.h"
 
 /* ============================================================================
  * Helper Functions - Path Conversion
@@ -178,195 +159,277 @@ static void LoadPomodoroConfig(void) {
 }
 
 /* ============================================================================
- * Helper Functions - Natural Sorting
+ * Helper Functions - Lazy Submenus
  * ============================================================================ */
 
-/** @brief Natural string compare that sorts numeric substrings by value (e.g., 2 < 10). */
-static int NaturalCompareW(const wchar_t* a, const wchar_t* b) {
-    const wchar_t* pa = a;
-    const wchar_t* pb = b;
-    while (*pa && *pb) {
-        if (iswdigit(*pa) && iswdigit(*pb)) {
-            const wchar_t* za = pa; while (*za == L'0') za++;
-            const wchar_t* zb = pb; while (*zb == L'0') zb++;
-            /** Primary rule: numbers with more leading zeros come first */
-            size_t leadA = (size_t)(za - pa);
-            size_t leadB = (size_t)(zb - pb);
-            if (leadA != leadB) return (leadA > leadB) ? -1 : 1;
-            const wchar_t* ea = za; while (iswdigit(*ea)) ea++;
-            const wchar_t* eb = zb; while (iswdigit(*eb)) eb++;
-            size_t lena = (size_t)(ea - za);
-            size_t lenb = (size_t)(eb - zb);
-            if (lena != lenb) return (lena < lenb) ? -1 : 1;
-            int dcmp = wcsncmp(za, zb, lena);
-            if (dcmp != 0) return (dcmp < 0) ? -1 : 1;
-            pa = ea;
-            pb = eb;
-            continue;
+/** @brief Fills an empty submenu the first time it is about to be shown */
+typedef void (*SubmenuFiller)(HMENU menu, const void* context);
+
+/** @brief Lifetime group of a lazy submenu; a group's pending fills are dropped together */
+typedef enum {
+    LAZY_OWNER_TRANSIENT,       /**< Destroyed with the menu being tracked */
+    LAZY_OWNER_FONTS,           /**< Inside the cached font menu */
+    LAZY_OWNER_ANIMATIONS       /**< Inside the cached animation menu */
+} LazyOwner;
+
+/** @brief Submenu created empty, waiting for its WM_INITMENUPOPUP */
+typedef struct {
+    HMENU menu;
+    SubmenuFiller fill;
+    const void* context;
+    LazyOwner owner;
+} LazySubmenu;
+
+static LazySubmenu* g_lazySubmenus = NULL;
+static int g_lazySubmenuCount = 0;
+static int g_lazySubmenuCapacity = 0;
+
+/**
+ * @brief Create an empty popup that is filled on first display
+ * @return Popup handle (filled right away if the pending list cannot grow)
+ */
+static HMENU CreateLazySubmenu(LazyOwner owner, SubmenuFiller fill, const void* context) {
+    HMENU menu = CreatePopupMenu();
+    if (!menu) return NULL;
+    
+    if (g_lazySubmenuCount == g_lazySubmenuCapacity) {
+        int capacity = g_lazySubmenuCapacity ? g_lazySubmenuCapacity * 2 : 32;
+        LazySubmenu* grown = (LazySubmenu*)realloc(g_lazySubmenus, capacity * sizeof(*grown));
+        if (!grown) {
+            fill(menu, context);
+            return menu;
         }
-        wchar_t ca = towlower(*pa);
-        wchar_t cb = towlower(*pb);
-        if (ca != cb) return (ca < cb) ? -1 : 1;
-        pa++; pb++;
+        g_lazySubmenus = grown;
+        g_lazySubmenuCapacity = capacity;
     }
-    if (*pa) return 1;
-    if (*pb) return -1;
-    return 0;
+    
+    LazySubmenu* pending = &g_lazySubmenus[g_lazySubmenuCount++];
+    pending->menu = menu;
+    pending->fill = fill;
+    pending->context = context;
+    pending->owner = owner;
+    return menu;
 }
 
-/** @brief Shared comparator core: directories first, then natural string compare by name. */
-static int DirFirstThenNaturalName(const wchar_t* nameA, BOOL isDirA,
-                                   const wchar_t* nameB, BOOL isDirB) {
-    if (isDirA != isDirB) {
-        return isDirB - isDirA; /** Directories first */
+/** @brief Append a lazy popup item to a menu */
+static void AppendLazySubmenu(HMENU parentMenu, UINT flags, LazyOwner owner,
+                              SubmenuFiller fill, const void* context, const wchar_t* text) {
+    HMENU menu = CreateLazySubmenu(owner, fill, context);
+    if (menu) {
+        AppendMenuW(parentMenu, MF_POPUP | flags, (UINT_PTR)menu, text);
     }
-    return NaturalCompareW(nameA, nameB);
 }
 
-/** @brief qsort comparator for AnimationEntry, sorting directories first, then by natural order. */
-static int CompareAnimationEntries(const void* a, const void* b) {
-    const AnimationEntry* entryA = (const AnimationEntry*)a;
-    const AnimationEntry* entryB = (const AnimationEntry*)b;
-    return DirFirstThenNaturalName(entryA->name, entryA->is_dir,
-                                   entryB->name, entryB->is_dir);
+/** @brief Forget a group's unfilled submenus (before their menus are destroyed) */
+static void DropLazySubmenus(LazyOwner owner) {
+    int kept = 0;
+    for (int i = 0; i < g_lazySubmenuCount; i++) {
+        if (g_lazySubmenus[i].owner != owner) {
+            g_lazySubmenus[kept++] = g_lazySubmenus[i];
+        }
+    }
+    g_lazySubmenuCount = kept;
 }
 
-/** @brief qsort comparator for FontEntry, using natural sorting with directories first */
-static int CompareFontEntries(const void* a, const void* b) {
-    const FontEntry* entryA = (const FontEntry*)a;
-    const FontEntry* entryB = (const FontEntry*)b;
-    return DirFirstThenNaturalName(entryA->name, entryA->is_dir,
-                                   entryB->name, entryB->is_dir);
+BOOL TrayMenu_HandleInitMenuPopup(HMENU menu) {
+    for (int i = 0; i < g_lazySubmenuCount; i++) {
+        if (g_lazySubmenus[i].menu == menu) {
+            /** Unregister first: the filler may register nested submenus */
+            LazySubmenu pending = g_lazySubmenus[i];
+            g_lazySubmenus[i] = g_lazySubmenus[--g_lazySubmenuCount];
+            pending.fill(menu, pending.context);
+            return TRUE;
+        }
+    }
+    return FALSE;
 }
 
-/** @brief Checks if a folder contains no sub-folders or animated images, making it a leaf. */
-static BOOL IsAnimationLeafFolderW(const wchar_t* folderPathW) {
-    wchar_t wSearch[MAX_PATH] = {0};
-    _snwprintf_s(wSearch, MAX_PATH, _TRUNCATE, L"%s\\*", folderPathW);
+/* ============================================================================
+ * Helper Functions - Cached Resource Menus
+ * ============================================================================ */
+
+/**
+ * @brief Font or animation submenu kept between openings
+ *
+ * Items are numbered as their folders are filled (item i has ID base + i)
+ * and recorded here, so hover previews and commands resolve an ID with a
+ * bounds check and an index. Items past the map's range are left out. The menu survives as long as the catalog
+ * snapshot, the current selection and the state flags it was built from.
+ */
+typedef struct {
+    const ResourceCatalog* catalog;     /**< Keeps the entries alive until the next build */
+    MenuIdMap ids;                      /**< Items are const CatalogEntry* */
+    LazyOwner owner;
+    HMENU menu;                         /**< Detached from each tracked menu before it is destroyed */
+    char selection[MAX_PATH];           /**< Current font / animation when built ("" for none) */
+    int state;                          /**< Other inputs (language, settings) when built */
+} MenuResourceMap;
+
+static MenuResourceMap g_fontMenuMap = {
+    NULL, MENU_ID_MAP_INIT(CLOCK_IDM_FONTS_BASE, MAX_FONT_MENU_ITEMS), LAZY_OWNER_FONTS
+};
+static MenuResourceMap g_animationMenuMap = {
+    NULL, MENU_ID_MAP_INIT(CLOCK_IDM_ANIMATIONS_BASE, MAX_ANIMATION_MENU_ITEMS), LAZY_OWNER_ANIMATIONS
+};
+
+/** @brief Start a new numbering over a snapshot (takes over the caller's reference) */
+static void ResetMenuMap(MenuResourceMap* map, const ResourceCatalog* catalog) {
+    ResourceCatalog_Release(map->catalog);
+    map->catalog = catalog;
+    MenuIdMap_Reset(&map->ids);
+}
+
+/**
+ * @brief Assign the next menu ID to an entry
+ * @return Menu ID for the item, or 0 if the map's ID range is full (leave the item out)
+ */
+static UINT RecordMenuItem(MenuResourceMap* map, const CatalogEntry* entry) {
+    UINT id = MenuIdMap_Record(&map->ids, entry);
+    if (id == 0 && map->ids.truncated == 1) {
+        LOG_WARNING("Menu lists only the first %u %s; the rest are left out", map->ids.maxItems,
+                    map->owner == LAZY_OWNER_FONTS ? "fonts" : "animations");
+    }
+    return id;
+}
+
+static const CatalogEntry* LookupMenuItem(const MenuResourceMap* map, UINT menuId) {
+    return (const CatalogEntry*)MenuIdMap_Lookup(&map->ids, menuId);
+}
+
+const CatalogEntry* TrayMenu_GetFontItem(UINT menuId) {
+    return LookupMenuItem(&g_fontMenuMap, menuId);
+}
+
+const CatalogEntry* TrayMenu_GetAnimationItem(UINT menuId) {
+    return LookupMenuItem(&g_animationMenuMap, menuId);
+}
+
+/**
+ * @brief Cached submenu for a catalog root, rebuilt only when its inputs change
+ * @param selection Current font / animation (NULL for none)
+ * @param state Other inputs the menu's text and check marks depend on
+ * @param fill Filler for the top level of the menu
+ * @return The map's menu; a new one is created empty and filled on first display
+ */
+static HMENU GetResourceMenu(MenuResourceMap* map, CatalogRoot root, const char* selection,
+                             int state, SubmenuFiller fill) {
+    const ResourceCatalog* catalog = ResourceCatalog_Acquire(root);
+    if (!selection) selection = "";
+    
+    if (map->menu && catalog == map->catalog && state == map->state &&
+        strcmp(selection, map->selection) == 0) {
+        ResourceCatalog_Release(catalog);
+        return map->menu;
+    }
     
-    WIN32_FIND_DATAW ffd;
-    HANDLE hFind = FindFirstFileW(wSearch, &ffd);
-    if (hFind == INVALID_HANDLE_VALUE) return TRUE; // Empty is a leaf
+    DropLazySubmenus(map->owner);
+    if (map->menu) DestroyMenu(map->menu);
+    ResetMenuMap(map, catalog);
+    strncpy_s(map->selection, sizeof(map->selection), selection, _TRUNCATE);
+    map->state = state;
+    map->menu = CreateLazySubmenu(map->owner, fill, map);
+    return map->menu;
+}
 
-    BOOL hasSubItems = FALSE;
-    do {
-        if (wcscmp(ffd.cFileName, L".") == 0 || wcscmp(ffd.cFileName, L"..") == 0) continue;
-        
-        if (ffd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
-            hasSubItems = TRUE;
-            break;
-        }
-        wchar_t* ext = wcsrchr(ffd.cFileName, L'.');
-        if (ext && (_wcsicmp(ext, L".gif") == 0 || _wcsicmp(ext, L".webp") == 0)) {
-            hasSubItems = TRUE;
-            break;
-        }
-    } while (FindNextFileW(hFind, &ffd));
-    FindClose(hFind);
+/** @brief Whether a path relative to a catalog root lies inside a catalog folder */
+static BOOL IsInsideFolder(const char* relPath, const CatalogEntry* folder) {
+    if (!relPath || !*relPath) return FALSE;
+    size_t folderLen = strlen(folder->relPathUtf8);
+    return _strnicmp(relPath, folder->relPathUtf8, folderLen) == 0 &&
+           (relPath[folderLen] == '\\' || relPath[folderLen] == '/');
+}
+
+/* ============================================================================
+ * Helper Functions - Menu Open Latency
+ * ============================================================================ */
+
+/** @brief When the last menu was requested; 0 once its first idle has been seen */
+static LARGE_INTEGER g_menuOpenStart = {0};
+
+static void BeginMenuOpenMeasurement(void) {
+    QueryPerformanceCounter(&g_menuOpenStart);
+}
+
+void TrayMenu_HandleMenuIdle(void) {
+    if (g_menuOpenStart.QuadPart == 0) return;
+    LARGE_INTEGER freq, now;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&now);
+    MetricsEndpoint_ObserveMenuOpenMs((double)(now.QuadPart - g_menuOpenStart.QuadPart) * 1000.0 /
+                                      (double)freq.QuadPart);
+    g_menuOpenStart.QuadPart = 0;
+}
+
+/**
+ * @brief Show a popup menu and destroy it, keeping the cached submenus
+ * @param hwnd Owner window (receives WM_INITMENUPOPUP and WM_COMMAND)
+ * @param flags TrackPopupMenu alignment flags
+ */
+static void TrackAndDestroyMenu(HWND hwnd, HMENU hMenu, UINT flags) {
+    POINT pt;
+    GetCursorPos(&pt);
+    SetForegroundWindow(hwnd);
+    TrackPopupMenu(hMenu, flags, pt.x, pt.y, 0, hwnd, NULL);
+    PostMessage(hwnd, WM_NULL, 0, 0);
+    g_menuOpenStart.QuadPart = 0;
     
-    return !hasSubItems;
+    for (int i = GetMenuItemCount(hMenu) - 1; i >= 0; i--) {
+        HMENU subMenu = GetSubMenu(hMenu, i);
+        if (subMenu && (subMenu == g_fontMenuMap.menu || subMenu == g_animationMenuMap.menu)) {
+            RemoveMenu(hMenu, i, MF_BYPOSITION);
+        }
+    }
+    DropLazySubmenus(LAZY_OWNER_TRANSIENT);
+    DestroyMenu(hMenu);
 }
 
 /* ============================================================================
  * Helper Functions - Animation Menu Building
  * ============================================================================ */
 
+static void FillAnimationFolderMenu(HMENU menu, const void* context);
+
 /**
- * @brief Recursively build animation folder menu hierarchy
+ * @brief Build one level of the animation folder menu
  * @param parentMenu Parent menu to append items to
- * @param folderPathW Wide-character folder path
- * @param folderPathUtf8 UTF-8 folder path (relative)
- * @param nextIdPtr Pointer to next available menu ID
+ * @param catalog Animations catalog snapshot
+ * @param folder Folder entry, or NULL for the animations root
  * @param currentAnim Current animation name for checkmark
- * @return TRUE if subtree contains the current animation
  * 
- * Scans folder for animations and subfolders, building nested menus.
- * Leaf folders become menu items, branch folders become submenus.
+ * Walks the catalog's (already sorted) children. Leaf folders become menu
+ * items, branch folders become lazy submenus; each item's ID is recorded in
+ * g_animationMenuMap.
  */
-static BOOL BuildAnimationFolderMenu(HMENU parentMenu, const wchar_t* folderPathW, 
-                                     const char* folderPathUtf8, UINT* nextIdPtr, 
-                                     const char* currentAnim) {
-    AnimationEntry* entries = (AnimationEntry*)malloc(sizeof(AnimationEntry) * MAX_TRAY_FRAMES);
-    if (!entries) return FALSE;
-    int entryCount = 0;
-    
-    wchar_t wSearch[MAX_PATH] = {0};
-    _snwprintf_s(wSearch, MAX_PATH, _TRUNCATE, L"%s\\*", folderPathW);
-    
-    WIN32_FIND_DATAW ffd;
-    HANDLE hFind = FindFirstFileW(wSearch, &ffd);
-    if (hFind == INVALID_HANDLE_VALUE) {
-        free(entries);
-        return FALSE;
-    }
-    
-    do {
-        if (wcscmp(ffd.cFileName, L".") == 0 || wcscmp(ffd.cFileName, L"..") == 0) continue;
-        if (entryCount >= MAX_TRAY_FRAMES) break;
-        
-        AnimationEntry* e = &entries[entryCount];
-        e->is_dir = (ffd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
-        wcsncpy(e->name, ffd.cFileName, MAX_PATH - 1);
-        e->name[MAX_PATH - 1] = L'\0';
-        
-        char itemUtf8[MAX_PATH] = {0};
-        PathWideToUtf8(ffd.cFileName, itemUtf8, MAX_PATH);
-        if (folderPathUtf8 && folderPathUtf8[0] != '\0') {
-            _snprintf_s(e->rel_path_utf8, MAX_PATH, _TRUNCATE, "%s\\%s", folderPathUtf8, itemUtf8);
-        } else {
-            _snprintf_s(e->rel_path_utf8, MAX_PATH, _TRUNCATE, "%s", itemUtf8);
-        }
-        
-        if (e->is_dir) {
-            entryCount++;
-        } else {
-            wchar_t* ext = wcsrchr(e->name, L'.');
-            if (ext && (_wcsicmp(ext, L".gif") == 0 || _wcsicmp(ext, L".webp") == 0 ||
-                        _wcsicmp(ext, L".ico") == 0 || _wcsicmp(ext, L".png") == 0 ||
-                        _wcsicmp(ext, L".bmp") == 0 || _wcsicmp(ext, L".jpg") == 0 ||
-                        _wcsicmp(ext, L".jpeg") == 0 || _wcsicmp(ext, L".tif") == 0 ||
-                        _wcsicmp(ext, L".tiff") == 0)) {
-                entryCount++;
-            }
-        }
-    } while (FindNextFileW(hFind, &ffd));
-    FindClose(hFind);
-    
-    if (entryCount == 0) {
-        free(entries);
-        return FALSE;
-    }
-    qsort(entries, entryCount, sizeof(AnimationEntry), CompareAnimationEntries);
-    
-    BOOL subtreeHasCurrent = FALSE;
-    for (int i = 0; i < entryCount; ++i) {
-        AnimationEntry* e = &entries[i];
-        if (e->is_dir) {
-            wchar_t wSubFolderPath[MAX_PATH] = {0};
-            _snwprintf_s(wSubFolderPath, MAX_PATH, _TRUNCATE, L"%s\\%s", folderPathW, e->name);
-            
-            if (IsAnimationLeafFolderW(wSubFolderPath)) {
+static void BuildAnimationFolderMenu(HMENU parentMenu, const ResourceCatalog* catalog,
+                                     const CatalogEntry* folder, const char* currentAnim) {
+    UINT count = 0;
+    const CatalogEntry* children = ResourceCatalog_GetChildren(catalog, folder, &count);
+    
+    for (UINT i = 0; i < count; ++i) {
+        const CatalogEntry* e = &children[i];
+        if (e->type == CATALOG_ENTRY_DIRECTORY) {
+            if (ResourceCatalog_IsAnimationLeaf(catalog, e)) {
                 /* Leaf folder: add as clickable item */
-                UINT flags = MF_STRING | (currentAnim && _stricmp(e->rel_path_utf8, currentAnim) == 0 ? MF_CHECKED : 0);
-                AppendMenuW(parentMenu, flags, (*nextIdPtr)++, e->name);
-                if (flags & MF_CHECKED) subtreeHasCurrent = TRUE;
+                UINT flags = MF_STRING | (currentAnim && _stricmp(e->relPathUtf8, currentAnim) == 0 ? MF_CHECKED : 0);
+                UINT id = RecordMenuItem(&g_animationMenuMap, e);
+                if (id) AppendMenuW(parentMenu, flags, id, e->nameW);
             } else {
-                /* Branch folder: create submenu */
-                HMENU hSubMenu = CreatePopupMenu();
-                BOOL childHas = BuildAnimationFolderMenu(hSubMenu, wSubFolderPath, e->rel_path_utf8, nextIdPtr, currentAnim);
-                UINT folderFlags = MF_POPUP | (childHas ? MF_CHECKED : 0);
-                if (childHas) subtreeHasCurrent = TRUE;
-                AppendMenuW(parentMenu, folderFlags, (UINT_PTR)hSubMenu, e->name);
+                /* Branch folder: submenu filled when opened */
+                AppendLazySubmenu(parentMenu, IsInsideFolder(currentAnim, e) ? MF_CHECKED : 0,
+                                  LAZY_OWNER_ANIMATIONS, FillAnimationFolderMenu, e, e->nameW);
             }
-        } else {
+        } else if (e->type == CATALOG_ENTRY_ANIMATED_IMAGE || e->type == CATALOG_ENTRY_IMAGE) {
             /* File item */
-            UINT flags = MF_STRING | (currentAnim && _stricmp(e->rel_path_utf8, currentAnim) == 0 ? MF_CHECKED : 0);
-            AppendMenuW(parentMenu, flags, (*nextIdPtr)++, e->name);
-            if (flags & MF_CHECKED) subtreeHasCurrent = TRUE;
+            UINT flags = MF_STRING | (currentAnim && _stricmp(e->relPathUtf8, currentAnim) == 0 ? MF_CHECKED : 0);
+            UINT id = RecordMenuItem(&g_animationMenuMap, e);
+            if (id) AppendMenuW(parentMenu, flags, id, e->nameW);
         }
     }
-    free(entries);
-    return subtreeHasCurrent;
+}
+
+static void FillAnimationFolderMenu(HMENU menu, const void* context) {
+    BuildAnimationFolderMenu(menu, g_animationMenuMap.catalog, (const CatalogEntry*)context,
+                             g_animationMenuMap.selection);
 }
 
 /* ============================================================================
@@ -399,30 +462,6 @@ extern void GetConfigPath(char* path, size_t size);
 extern void ClearColorOptions(void);
 extern void AddColorOption(const char* color);
 
-/**
- * @brief Get %LOCALAPPDATA%\Catime\resources\fonts in wide-char using config path
- * @param out Wide-char buffer
- * @param size Buffer size (wchar_t count)
- */
-static BOOL GetFontsFolderWideFromConfig(wchar_t* out, size_t size) {
-    if (!out || size == 0) return FALSE;
-    char configPathUtf8[MAX_PATH] = {0};
-    GetConfigPath(configPathUtf8, MAX_PATH);
-    if (configPathUtf8[0] == '\0') return FALSE;
-    wchar_t wconfigPath[MAX_PATH] = {0};
-    MultiByteToWideChar(CP_UTF8, 0, configPathUtf8, -1, wconfigPath, MAX_PATH);
-    wchar_t* lastSep = wcsrchr(wconfigPath, L'\\');
-    if (!lastSep) return FALSE;
-    size_t dirLen = (size_t)(lastSep - wconfigPath);
-    if (dirLen + 1 >= size) return FALSE;
-    wcsncpy(out, wconfigPath, dirLen);
-    out[dirLen] = L'\0';
-    const wchar_t* tail = L"\\resources\\fonts";
-    if (wcslen(out) + wcslen(tail) + 1 >= size) return FALSE;
-    wcscat(out, tail);
-    return TRUE;
-}
-
 /**
  * @brief Read timeout action setting from configuration file
  * Uses unified config reading helper for consistency
@@ -511,24 +550,198 @@ void TruncateFileName(const wchar_t* fileName, wchar_t* truncated, size_t maxLen
     wcscpy(truncated, buffer);
 }
 
+/* ============================================================================
+ * Helper Functions - Font Menu Building
+ * ============================================================================ */
+
+/** @brief Current font's path relative to the fonts folder, NULL if it lives elsewhere */
+static const char* GetCurrentFontRelativePath(void) {
+    const char* localPrefix = "%LOCALAPPDATA%\\Catime\\resources\\fonts\\";
+    size_t prefixLen = strlen(localPrefix);
+    if (_strnicmp(FONT_FILE_NAME, localPrefix, prefixLen) != 0) return NULL;
+    return FONT_FILE_NAME + prefixLen;
+}
+
+/** @brief Whether a fonts folder (NULL for the root) contains a font at any depth */
+static BOOL FolderHasFonts(const ResourceCatalog* catalog, const CatalogEntry* folder) {
+    UINT count = 0;
+    const CatalogEntry* children = ResourceCatalog_GetChildren(catalog, folder, &count);
+    for (UINT i = 0; i < count; i++) {
+        if (children[i].type == CATALOG_ENTRY_FONT) return TRUE;
+        if (children[i].type == CATALOG_ENTRY_DIRECTORY && FolderHasFonts(catalog, &children[i])) return TRUE;
+    }
+    return FALSE;
+}
+
+static void FillFontFolderMenu(HMENU menu, const void* context);
+
 /**
- * @brief Build and display comprehensive configuration menu (right-click menu)
- * @param hwnd Main window handle for menu operations
- * Creates complex nested menu system with timeout actions, fonts, colors, and settings
+ * @brief Build one level of the font folder menu
+ * @param parentMenu Menu to append items to
+ * @param catalog Fonts catalog snapshot
+ * @param folder Folder entry, or NULL for the fonts root
+ * @param currentRel Current font relative to the fonts folder (may be NULL)
+ * @return TRUE if anything was added
+ *
+ * Font files are listed without their extension and their IDs recorded in
+ * g_fontMenuMap; sub-folders become lazy submenus, checked when they hold
+ * the current font.
  */
-void ShowColorMenu(HWND hwnd) {
+static BOOL BuildFontFolderMenu(HMENU parentMenu, const ResourceCatalog* catalog,
+                                const CatalogEntry* folder, const char* currentRel) {
+    UINT count = 0;
+    const CatalogEntry* children = ResourceCatalog_GetChildren(catalog, folder, &count);
+    BOOL added = FALSE;
+    
+    for (UINT i = 0; i < count; i++) {
+        const CatalogEntry* entry = &children[i];
+        
+        if (entry->type == CATALOG_ENTRY_DIRECTORY) {
+            AppendLazySubmenu(parentMenu, IsInsideFolder(currentRel, entry) ? MF_CHECKED : 0,
+                              LAZY_OWNER_FONTS, FillFontFolderMenu, entry, entry->nameW);
+            added = TRUE;
+        } else if (entry->type == CATALOG_ENTRY_FONT) {
+            UINT id = RecordMenuItem(&g_fontMenuMap, entry);
+            if (!id) continue;
+
+            /** Remove extension for display */
+            wchar_t displayName[MAX_PATH];
+            wcsncpy_s(displayName, MAX_PATH, entry->nameW, _TRUNCATE);
+            wchar_t* dotPos = wcsrchr(displayName, L'.');
+            if (dotPos) *dotPos = L'\0';
+            
+            BOOL isCurrentFont = currentRel && _stricmp(entry->relPathUtf8, currentRel) == 0;
+            AppendMenuW(parentMenu, MF_STRING | (isCurrentFont ? MF_CHECKED : MF_UNCHECKED), id, displayName);
+            added = TRUE;
+        }
+    }
     
-    SetCursor(LoadCursorW(NULL, MAKEINTRESOURCEW(IDC_ARROW)));
+    return added;
+}
+
+static void FillFontFolderMenu(HMENU menu, const void* context) {
+    const char* currentRel = g_fontMenuMap.selection[0] ? g_fontMenuMap.selection : NULL;
+    if (!BuildFontFolderMenu(menu, g_fontMenuMap.catalog, (const CatalogEntry*)context, currentRel)) {
+        /** Add "Empty folder" indicator */
+        AppendMenuW(menu, MF_STRING | MF_GRAYED, 0, L"(Empty folder)");
+    }
+}
+
+/* ============================================================================
+ * Submenu Fillers - Configuration Menu
+ * ============================================================================ */
+
+/** @brief Font submenu: license prompt, or the fonts folder tree and "Open fonts folder" */
+static void FillFontMenu(HMENU hFontSubMenu, const void* context) {
+    (void)context;
+    extern BOOL NeedsFontLicenseVersionAcceptance(void);
     
-    HMENU hMenu = CreatePopupMenu();
+    if (NeedsFontLicenseVersionAcceptance()) {
+        /** Show license agreement option if version needs acceptance */
+        AppendMenuW(hFontSubMenu, MF_STRING, CLOCK_IDC_FONT_LICENSE_AGREE, 
+                   GetLocalizedString(L"点击同意许可协议后继续", L"Click to agree to license agreement"));
+        return;
+    }
     
-    AppendMenuW(hMenu, MF_STRING | (CLOCK_EDIT_MODE ? MF_CHECKED : MF_UNCHECKED),
-               CLOCK_IDC_EDIT_MODE, 
-               GetLocalizedString(L"编辑模式", L"Edit Mode"));
+    /** Normal font menu when license version is accepted */
+    const ResourceCatalog* fontCatalog = g_fontMenuMap.catalog;
+    if (!fontCatalog) return;
+    const char* currentRel = g_fontMenuMap.selection[0] ? g_fontMenuMap.selection : NULL;
+    BOOL hasFonts = FolderHasFonts(fontCatalog, NULL);
+
+    /** Additional debug: manually check some known font files */
+    if (!hasFonts) {
+        WriteLog(LOG_LEVEL_INFO, "Catalog has no fonts, manually checking known font files...");
+        wchar_t wTestFontPath[MAX_PATH];
+        _snwprintf_s(wTestFontPath, MAX_PATH, _TRUNCATE, L"%s\\Wallpoet Essence.ttf",
+                     ResourceCatalog_GetRootPath(fontCatalog));
+        DWORD attribs = GetFileAttributesW(wTestFontPath);
+        if (attribs != INVALID_FILE_ATTRIBUTES) {
+            WriteLog(LOG_LEVEL_WARNING, "Manual check: Wallpoet Essence.ttf EXISTS but scan failed to find it!");
+        } else {
+            WriteLog(LOG_LEVEL_INFO, "Manual check: Wallpoet Essence.ttf does not exist");
+        }
+        
+        /** Try extracting embedded fonts once and rescan */
+        extern BOOL ExtractEmbeddedFontsToFolder(HINSTANCE hInstance);
+        HINSTANCE hInst = GetModuleHandle(NULL);
+        if (ExtractEmbeddedFontsToFolder(hInst)) {
+            /** The watcher has not reported the new files yet */
+            ResourceCatalog_Invalidate(CATALOG_ROOT_FONTS);
+            ResetMenuMap(&g_fontMenuMap, ResourceCatalog_Acquire(CATALOG_ROOT_FONTS));
+            fontCatalog = g_fontMenuMap.catalog;
+            if (!fontCatalog) return;
+            hasFonts = FolderHasFonts(fontCatalog, NULL);
+        }
+    }
+    WriteLog(LOG_LEVEL_INFO, "Font folder has fonts: %d", hasFonts);
+    
+    BuildFontFolderMenu(hFontSubMenu, fontCatalog, NULL, currentRel);
 
-    AppendMenuW(hMenu, MF_SEPARATOR, 0, NULL);
+    /** Add browse option if no fonts found or as additional option */
+    if (!hasFonts) {
+        AppendMenuW(hFontSubMenu, MF_STRING | MF_GRAYED, 0, 
+                   GetLocalizedString(L"未找到字体文件", L"No font files found"));
+    }
+    AppendMenuW(hFontSubMenu, MF_SEPARATOR, 0, NULL);
+    
+    AppendMenuW(hFontSubMenu, MF_STRING, CLOCK_IDC_FONT_ADVANCED, 
+               GetLocalizedString(L"打开字体文件夹", L"Open fonts folder"));
+}
+
+/** @brief "Tray Icon" submenu: built-in icons, animation folder tree and speed options */
+static void FillAnimationMenu(HMENU hAnimMenu, const void* context) {
+    (void)context;
+    /**
+     * NOTE: Item IDs are recorded in g_animationMenuMap as the menu is filled; the
+     * hover preview and the command handler resolve them through
+     * TrayMenu_GetAnimationItem instead of re-walking the folder.
+     */
+    const char* currentAnim = g_animationMenuMap.selection;
+
+    /** Add fixed entries: logo, CPU %, Memory %, CPU graphs */
+    AppendMenuW(hAnimMenu, MF_STRING | (_stricmp(currentAnim, "__logo__") == 0 ? MF_CHECKED : 0),
+                CLOCK_IDM_ANIMATIONS_USE_LOGO, GetLocalizedString(L"使用Logo", L"Use Logo"));
+    AppendMenuW(hAnimMenu, MF_STRING | (_stricmp(currentAnim, "__cpu__") == 0 ? MF_CHECKED : 0),
+                CLOCK_IDM_ANIMATIONS_USE_CPU, GetLocalizedString(L"CPU 百分比", L"CPU Percent"));
+    AppendMenuW(hAnimMenu, MF_STRING | (_stricmp(currentAnim, "__mem__") == 0 ? MF_CHECKED : 0),
+                CLOCK_IDM_ANIMATIONS_USE_MEM, GetLocalizedString(L"内存百分比", L"Memory Percent"));
+    AppendMenuW(hAnimMenu, MF_STRING | (_stricmp(currentAnim, "__cpuhist__") == 0 ? MF_CHECKED : 0),
+                CLOCK_IDM_ANIMATIONS_USE_CPU_HISTORY, GetLocalizedString(L"CPU 历史曲线", L"CPU History"));
+    AppendMenuW(hAnimMenu, MF_STRING | (_stricmp(currentAnim, "__cores__") == 0 ? MF_CHECKED : 0),
+                CLOCK_IDM_ANIMATIONS_USE_CPU_CORES, GetLocalizedString(L"CPU 各核心", L"CPU Cores"));
+    AppendMenuW(hAnimMenu, MF_SEPARATOR, 0, NULL);
+
+    /* Top level of the animation folder menu; sub-folders fill when opened */
+    BuildAnimationFolderMenu(hAnimMenu, g_animationMenuMap.catalog, NULL, currentAnim);
+    
+    // Fallback message if no items were added at all.
+    if (GetMenuItemCount(hAnimMenu) <= 6) { // Logo, CPU%, MEM%, CPU graphs and separator are always there
+        AppendMenuW(hAnimMenu, MF_STRING | MF_GRAYED, 0, GetLocalizedString(L"(支持 GIF、WebP、PNG 等)", L"(Supports GIF, WebP, PNG, etc.)"));
+    }
+
+    AppendMenuW(hAnimMenu, MF_SEPARATOR, 0, NULL);
+
+    /** Animation speed metric sub options */
+    HMENU hAnimSpeedMenu = CreatePopupMenu();
+    AnimationSpeedMetric currentMetric = GetAnimationSpeedMetric();
+    AppendMenuW(hAnimSpeedMenu, MF_STRING | (currentMetric == ANIMATION_SPEED_MEMORY ? MF_CHECKED : MF_UNCHECKED),
+                CLOCK_IDM_ANIM_SPEED_MEMORY, GetLocalizedString(L"按内存占用", L"By Memory Usage"));
+    AppendMenuW(hAnimSpeedMenu, MF_STRING | (currentMetric == ANIMATION_SPEED_CPU ? MF_CHECKED : MF_UNCHECKED),
+                CLOCK_IDM_ANIM_SPEED_CPU, GetLocalizedString(L"按CPU占用", L"By CPU Usage"));
+    AppendMenuW(hAnimSpeedMenu, MF_STRING | (currentMetric == ANIMATION_SPEED_TIMER ? MF_CHECKED : MF_UNCHECKED),
+                CLOCK_IDM_ANIM_SPEED_TIMER, GetLocalizedString(L"按倒计时进度", L"By Countdown Progress"));
+    AppendMenuW(hAnimMenu, MF_POPUP, (UINT_PTR)hAnimSpeedMenu,
+                GetLocalizedString(L"动画速度依据", L"Animation Speed Metric"));
+
+    AppendMenuW(hAnimMenu, MF_SEPARATOR, 0, NULL);
+    AppendMenuW(hAnimMenu, MF_STRING, CLOCK_IDM_ANIMATIONS_OPEN_DIR, GetLocalizedString(L"打开动画文件夹", L"Open animations folder"));
+    AppendMenuW(hAnimMenu, MF_STRING, CLOCK_IDM_ANIMATIONS_DUMP_TRACE, GetLocalizedString(L"导出动画计时记录", L"Export animation timing trace"));
+}
 
-    HMENU hTimeoutMenu = CreatePopupMenu();
+/** @brief "Timeout Action" submenu */
+static void FillTimeoutMenu(HMENU hTimeoutMenu, const void* context) {
+    (void)context;
     
     AppendMenuW(hTimeoutMenu, MF_STRING | (CLOCK_TIMEOUT_ACTION == TIMEOUT_ACTION_MESSAGE ? MF_CHECKED : MF_UNCHECKED), 
                CLOCK_IDM_SHOW_MESSAGE, 
@@ -597,15 +810,11 @@ void ShowColorMenu(HWND hwnd) {
     AppendMenuW(hTimeoutMenu, MF_STRING | (CLOCK_TIMEOUT_ACTION == TIMEOUT_ACTION_SLEEP ? MF_CHECKED : MF_UNCHECKED),
                CLOCK_IDM_SLEEP,
                GetLocalizedString(L"睡眠", L"Sleep"));
+}
 
-    AppendMenuW(hMenu, MF_POPUP, (UINT_PTR)hTimeoutMenu, 
-                GetLocalizedString(L"超时动作", L"Timeout Action"));
-
-    HMENU hTimeOptionsMenu = CreatePopupMenu();
-    AppendMenuW(hTimeOptionsMenu, MF_STRING, CLOCK_IDC_MODIFY_TIME_OPTIONS,
-                GetLocalizedString(L"倒计时预设", L"Modify Quick Countdown Options"));
-    
-    HMENU hStartupSettingsMenu = CreatePopupMenu();
+/** @brief "Startup Settings" submenu (reads STARTUP_MODE from config.ini) */
+static void FillStartupSettingsMenu(HMENU hStartupSettingsMenu, const void* context) {
+    (void)context;
 
     char currentStartupMode[20] = "COUNTDOWN";
     ReadConfigValue("STARTUP_MODE", currentStartupMode, sizeof(currentStartupMode));
@@ -636,18 +845,31 @@ void ShowColorMenu(HWND hwnd) {
             (IsAutoStartEnabled() ? MF_CHECKED : MF_UNCHECKED),
             CLOCK_IDC_AUTO_START,
             GetLocalizedString(L"开机自启动", L"Start with Windows"));
+}
 
-    AppendMenuW(hTimeOptionsMenu, MF_POPUP, (UINT_PTR)hStartupSettingsMenu,
-                GetLocalizedString(L"启动设置", L"Startup Settings"));
+/** @brief "Preset Management" submenu */
+static void FillPresetMenu(HMENU hTimeOptionsMenu, const void* context) {
+    (void)context;
+    
+    AppendMenuW(hTimeOptionsMenu, MF_STRING, CLOCK_IDC_MODIFY_TIME_OPTIONS,
+                GetLocalizedString(L"倒计时预设", L"Modify Quick Countdown Options"));
+    
+    AppendLazySubmenu(hTimeOptionsMenu, 0, LAZY_OWNER_TRANSIENT, FillStartupSettingsMenu, NULL,
+                      GetLocalizedString(L"启动设置", L"Startup Settings"));
 
     AppendMenuW(hTimeOptionsMenu, MF_STRING, CLOCK_IDM_NOTIFICATION_SETTINGS,
                 GetLocalizedString(L"通知设置", L"Notification Settings"));
-
-    AppendMenuW(hMenu, MF_POPUP, (UINT_PTR)hTimeOptionsMenu,
-                GetLocalizedString(L"预设管理", L"Preset Management"));
     
-    /** Add format submenu before topmost option */
-    HMENU hFormatMenu = CreatePopupMenu();
+    AppendMenuW(hTimeOptionsMenu, MF_SEPARATOR, 0, NULL);
+    
+    AppendMenuW(hTimeOptionsMenu, MF_STRING | (CLOCK_WINDOW_TOPMOST ? MF_CHECKED : MF_UNCHECKED),
+                CLOCK_IDM_TOPMOST,
+                GetLocalizedString(L"置顶", L"Always on Top"));
+}
+
+/** @brief "Format" submenu */
+static void FillFormatMenu(HMENU hFormatMenu, const void* context) {
+    (void)context;
     
     AppendMenuW(hFormatMenu, MF_STRING | (CLOCK_TIME_FORMAT == TIME_FORMAT_DEFAULT ? MF_CHECKED : MF_UNCHECKED),
                 CLOCK_IDM_TIME_FORMAT_DEFAULT,
@@ -668,245 +890,11 @@ void ShowColorMenu(HWND hwnd) {
     AppendMenuW(hFormatMenu, MF_STRING | (CLOCK_SHOW_MILLISECONDS ? MF_CHECKED : MF_UNCHECKED),
                 CLOCK_IDM_TIME_FORMAT_SHOW_MILLISECONDS,
                 GetLocalizedString(L"显示毫秒", L"Show Milliseconds"));
-    
-    AppendMenuW(hTimeOptionsMenu, MF_SEPARATOR, 0, NULL);
-    
-    AppendMenuW(hTimeOptionsMenu, MF_STRING | (CLOCK_WINDOW_TOPMOST ? MF_CHECKED : MF_UNCHECKED),
-                CLOCK_IDM_TOPMOST,
-                GetLocalizedString(L"置顶", L"Always on Top"));
-
-    AppendMenuW(hMenu, MF_STRING, CLOCK_IDM_HOTKEY_SETTINGS,
-                GetLocalizedString(L"热键设置", L"Hotkey Settings"));
-
-    AppendMenuW(hMenu, MF_SEPARATOR, 0, NULL);
-
-        HMENU hFontSubMenu = CreatePopupMenu();
-    
-    /** Helper function to recursively build font submenus */
-    int g_advancedFontId = 2000; /** Global counter for font IDs */
-    
-    /** ANSI fallback scanner removed to ensure consistent wide-char API usage */
-    
-
-    /** Recursive function to scan folder and create submenus */
-    /** Returns: 0 = no content, 1 = has content but no current font, 2 = contains current font */
-    int ScanFontFolder(const char* folderPath, HMENU parentMenu, int* fontId) {
-        /** Use heap allocation for buffers to prevent stack overflow in deep recursion */
-        wchar_t* wFolderPath = (wchar_t*)malloc(MAX_PATH * sizeof(wchar_t));
-        wchar_t* wSearchPath = (wchar_t*)malloc(MAX_PATH * sizeof(wchar_t));
-        WIN32_FIND_DATAW* findData = (WIN32_FIND_DATAW*)malloc(sizeof(WIN32_FIND_DATAW));
-
-        if (!wFolderPath || !wSearchPath || !findData) {
-            if (wFolderPath) free(wFolderPath);
-            if (wSearchPath) free(wSearchPath);
-            if (findData) free(findData);
-            return 0;
-        }
-
-        MultiByteToWideChar(CP_UTF8, 0, folderPath, -1, wFolderPath, MAX_PATH);
-        _snwprintf_s(wSearchPath, MAX_PATH, _TRUNCATE, L"%s\\*", wFolderPath);
-        
-        /** Collect all entries first */
-        FontEntry* entries = NULL;
-        int entryCount = 0;
-        int entryCapacity = 0;
-        
-        HANDLE hFind = FindFirstFileW(wSearchPath, findData);
-        int folderStatus = 0; /** 0 = no content, 1 = has content, 2 = contains current font */
-        
-        if (hFind != INVALID_HANDLE_VALUE) {
-            do {
-                /** Skip . and .. entries */
-                if (wcscmp(findData->cFileName, L".") == 0 || wcscmp(findData->cFileName, L"..") == 0) {
-                    continue;
-                }
-                
-                /** Expand entries array if needed */
-                if (entryCount >= entryCapacity) {
-                    entryCapacity = entryCapacity == 0 ? 16 : entryCapacity * 2;
-                    FontEntry* newEntries = (FontEntry*)realloc(entries, entryCapacity * sizeof(FontEntry));
-                    if (!newEntries) {
-                        free(entries);
-                        free(wFolderPath);
-                        free(wSearchPath);
-                        free(findData);
-                        FindClose(hFind);
-                        return 0;
-                    }
-                    entries = newEntries;
-                }
-                
-                FontEntry* entry = &entries[entryCount];
-                wcsncpy(entry->name, findData->cFileName, MAX_PATH - 1);
-                entry->name[MAX_PATH - 1] = L'\0';
-                _snwprintf_s(entry->fullPath, MAX_PATH, _TRUNCATE, L"%s\\%s", wFolderPath, findData->cFileName);
-                entry->is_dir = (findData->dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
-                entry->isCurrentFont = FALSE;
-                entry->subFolderStatus = 0;
-                entry->hSubMenu = NULL;
-                
-                if (!entry->is_dir) {
-                    /** Handle regular font files */
-                    wchar_t* ext = wcsrchr(findData->cFileName, L'.');
-                    if (ext && (_wcsicmp(ext, L".ttf") == 0 || _wcsicmp(ext, L".otf") == 0)) {
-                        /** Remove extension for display */
-                        wcsncpy(entry->displayName, findData->cFileName, MAX_PATH - 1);
-                        entry->displayName[MAX_PATH - 1] = L'\0';
-                        wchar_t* dotPos = wcsrchr(entry->displayName, L'.');
-                        if (dotPos) *dotPos = L'\0';
-                        
-                        /** Check if this is the current font */
-                        wchar_t wFontsFolderPath[MAX_PATH] = {0};
-                        if (GetFontsFolderWideFromConfig(wFontsFolderPath, MAX_PATH)) {
-                            const char* localPrefix = "%LOCALAPPDATA%\\Catime\\resources\\fonts\\";
-                            if (_strnicmp(FONT_FILE_NAME, localPrefix, (int)strlen(localPrefix)) == 0) {
-                                const char* relUtf8 = FONT_FILE_NAME + strlen(localPrefix);
-                                wchar_t wRel[MAX_PATH] = {0};
-                                MultiByteToWideChar(CP_UTF8, 0, relUtf8, -1, wRel, MAX_PATH);
-                                wchar_t wCurrentFull[MAX_PATH] = {0};
-                                _snwprintf_s(wCurrentFull, MAX_PATH, _TRUNCATE, L"%s\\%s", wFontsFolderPath, wRel);
-                                
-                                /** Compare with candidate file path */
-                                entry->isCurrentFont = (_wcsicmp(entry->fullPath, wCurrentFull) == 0);
-                            }
-                        }
-                        
-                        entryCount++;
-                        
-                        /** Update folder status */
-                        if (entry->isCurrentFont) {
-                            folderStatus = 2; /** This folder contains the current font */
-                        } else if (folderStatus == 0) {
-                            folderStatus = 1; /** This folder has content but not the current font */
-                        }
-                    } else {
-                        /** Skip non-font files */
-                        continue;
-                    }
-                } else {
-                    /** Handle subdirectories */
-                    entry->hSubMenu = CreatePopupMenu();
-                    
-                    /** Convert wide path back to UTF-8 for recursive call */
-                    char fullItemPathUtf8[MAX_PATH];
-                    WideCharToMultiByte(CP_UTF8, 0, entry->fullPath, -1, fullItemPathUtf8, MAX_PATH, NULL, NULL);
-                    
-                    /** Recursively scan this subdirectory */
-                    entry->subFolderStatus = ScanFontFolder(fullItemPathUtf8, entry->hSubMenu, fontId);
-                    
-                    entryCount++;
-                    
-                    /** Update current folder status based on subfolder status */
-                    if (entry->subFolderStatus == 2) {
-                        folderStatus = 2; /** This folder contains the current font (in subfolder) */
-                    } else if (entry->subFolderStatus == 1 && folderStatus == 0) {
-                        folderStatus = 1; /** This folder has content but not the current font */
-                    }
-                }
-            } while (FindNextFileW(hFind, findData));
-            FindClose(hFind);
-        }
-        
-        /** Sort entries using natural sorting */
-        if (entryCount > 0) {
-            qsort(entries, entryCount, sizeof(FontEntry), CompareFontEntries);
-            
-            /** Add sorted entries to menu */
-            for (int i = 0; i < entryCount; i++) {
-                FontEntry* entry = &entries[i];
-                
-                if (!entry->is_dir) {
-                    /** Add font file */
-                    AppendMenuW(parentMenu, MF_STRING | (entry->isCurrentFont ? MF_CHECKED : MF_UNCHECKED),
-                              (*fontId)++, entry->displayName);
-                } else {
-                    /** Add directory submenu */
-                    if (entry->subFolderStatus == 0) {
-                        /** Add "Empty folder" indicator */
-                        AppendMenuW(entry->hSubMenu, MF_STRING | MF_GRAYED, 0, L"(Empty folder)");
-                        AppendMenuW(parentMenu, MF_POPUP, (UINT_PTR)entry->hSubMenu, entry->name);
-                    } else {
-                        /** Add folder with check mark if it contains current font */
-                        UINT folderFlags = MF_POPUP;
-                        if (entry->subFolderStatus == 2) {
-                            folderFlags |= MF_CHECKED; /** Folder contains current font */
-                        }
-                        AppendMenuW(parentMenu, folderFlags, (UINT_PTR)entry->hSubMenu, entry->name);
-                    }
-                }
-            }
-        }
-        
-        free(entries);
-        free(wFolderPath);
-        free(wSearchPath);
-        free(findData);
-
-        return folderStatus;
-    }
-    
-    /** Load fonts from user's fonts folder directly into main font menu */
-    extern BOOL NeedsFontLicenseVersionAcceptance(void);
-    
-    if (NeedsFontLicenseVersionAcceptance()) {
-        /** Show license agreement option if version needs acceptance */
-        AppendMenuW(hFontSubMenu, MF_STRING, CLOCK_IDC_FONT_LICENSE_AGREE, 
-                   GetLocalizedString(L"点击同意许可协议后继续", L"Click to agree to license agreement"));
-    } else {
-        /** Normal font menu when license version is accepted */
-        wchar_t wFontsFolder[MAX_PATH] = {0};
-        if (GetFontsFolderWideFromConfig(wFontsFolder, MAX_PATH)) {
-            char fontsFolderPathUtf8[MAX_PATH];
-            WideCharToMultiByte(CP_UTF8, 0, wFontsFolder, -1, fontsFolderPathUtf8, MAX_PATH, NULL, NULL);
-            
-            g_advancedFontId = 2000; /** Reset global font ID counter */
-            
-            /** Use recursive function to scan all folders and subfolders directly in main font menu */
-            /** Try Unicode scan first, fallback to ANSI if needed */
-            int fontFolderStatus = ScanFontFolder(fontsFolderPathUtf8, hFontSubMenu, &g_advancedFontId);
-
-            /** No ANSI fallback: rely solely on wide-char scanning */
-
-            /** Additional debug: manually check some known font files */
-            if (fontFolderStatus == 0) {
-                WriteLog(LOG_LEVEL_INFO, "Both scans failed, manually checking known font files...");
-                /** Use Unicode API to avoid encoding issues with non-ASCII paths */
-                wchar_t wTestFontPath[MAX_PATH];
-                MultiByteToWideChar(CP_UTF8, 0, fontsFolderPathUtf8, -1, wTestFontPath, MAX_PATH - 32);
-                wcscat(wTestFontPath, L"\\Wallpoet Essence.ttf");
-                DWORD attribs = GetFileAttributesW(wTestFontPath);
-                if (attribs != INVALID_FILE_ATTRIBUTES) {
-                    WriteLog(LOG_LEVEL_WARNING, "Manual check: Wallpoet Essence.ttf EXISTS but scan failed to find it!");
-                } else {
-                    WriteLog(LOG_LEVEL_INFO, "Manual check: Wallpoet Essence.ttf does not exist");
-                }
-            }
-            WriteLog(LOG_LEVEL_INFO, "Font folder scan result: %d (0=no content, 1=has content, 2=contains current font)", fontFolderStatus);
-            
-            /** If no fonts found, try extracting embedded fonts once and rescan */
-            if (fontFolderStatus == 0) {
-                extern BOOL ExtractEmbeddedFontsToFolder(HINSTANCE hInstance);
-                HINSTANCE hInst = GetModuleHandle(NULL);
-                if (ExtractEmbeddedFontsToFolder(hInst)) {
-                    fontFolderStatus = ScanFontFolder(fontsFolderPathUtf8, hFontSubMenu, &g_advancedFontId);
-                }
-            }
-
-            /** Add browse option if no fonts found or as additional option */
-            if (fontFolderStatus == 0) {
-                AppendMenuW(hFontSubMenu, MF_STRING | MF_GRAYED, 0, 
-                           GetLocalizedString(L"未找到字体文件", L"No font files found"));
-                AppendMenuW(hFontSubMenu, MF_SEPARATOR, 0, NULL);
-            } else {
-                AppendMenuW(hFontSubMenu, MF_SEPARATOR, 0, NULL);
-            }
-            
-            AppendMenuW(hFontSubMenu, MF_STRING, CLOCK_IDC_FONT_ADVANCED, 
-                       GetLocalizedString(L"打开字体文件夹", L"Open fonts folder"));
-        }
-    }
+}
 
-    HMENU hColorSubMenu = CreatePopupMenu();
+/** @brief "Color" submenu: owner-drawn swatches and customization entries */
+static void FillColorMenu(HMENU hColorSubMenu, const void* context) {
+    (void)context;
 
     for (int i = 0; i < COLOR_OPTIONS_COUNT; i++) {
         const char* hexColor = COLOR_OPTIONS[i].hexColor;
@@ -933,71 +921,11 @@ void ShowColorMenu(HWND hwnd) {
 
     AppendMenuW(hColorSubMenu, MF_POPUP, (UINT_PTR)hCustomizeMenu, 
                 GetLocalizedString(L"自定义", L"Customize"));
+}
 
-    AppendMenuW(hMenu, MF_POPUP, (UINT_PTR)hFormatMenu,
-                GetLocalizedString(L"格式", L"Format"));
-    AppendMenuW(hMenu, MF_POPUP, (UINT_PTR)hFontSubMenu, 
-                GetLocalizedString(L"字体", L"Font"));
-    AppendMenuW(hMenu, MF_POPUP, (UINT_PTR)hColorSubMenu, 
-                GetLocalizedString(L"颜色", L"Color"));
-
-    AppendMenuW(hMenu, MF_SEPARATOR, 0, NULL);
-
-    /** Animations submenu */
-    HMENU hAnimMenu = CreatePopupMenu();
-    {
-        /**
-         * NOTE: The menu is built by scanning the filesystem. To ensure the command handler
-         * maps the menu ID back to the correct file, both this logic and the handler
-         * MUST use an identical, deterministic sorting order.
-         */
-        char animRootUtf8[MAX_PATH] = {0};
-        GetAnimationsFolderPath(animRootUtf8, sizeof(animRootUtf8));
-        wchar_t wRoot[MAX_PATH] = {0};
-        MultiByteToWideChar(CP_UTF8, 0, animRootUtf8, -1, wRoot, MAX_PATH);
-
-        UINT nextId = CLOCK_IDM_ANIMATIONS_BASE;
-        const char* currentAnim = GetCurrentAnimationName();
-
-        /** Add fixed entries: logo, CPU %, Memory % */
-        AppendMenuW(hAnimMenu, MF_STRING | (currentAnim && _stricmp(currentAnim, "__logo__") == 0 ? MF_CHECKED : 0),
-                    CLOCK_IDM_ANIMATIONS_USE_LOGO, GetLocalizedString(L"使用Logo", L"Use Logo"));
-        AppendMenuW(hAnimMenu, MF_STRING | (currentAnim && _stricmp(currentAnim, "__cpu__") == 0 ? MF_CHECKED : 0),
-                    CLOCK_IDM_ANIMATIONS_USE_CPU, GetLocalizedString(L"CPU 百分比", L"CPU Percent"));
-        AppendMenuW(hAnimMenu, MF_STRING | (currentAnim && _stricmp(currentAnim, "__mem__") == 0 ? MF_CHECKED : 0),
-                    CLOCK_IDM_ANIMATIONS_USE_MEM, GetLocalizedString(L"内存百分比", L"Memory Percent"));
-        AppendMenuW(hAnimMenu, MF_SEPARATOR, 0, NULL);
-
-        /* Build animation folder menu recursively */
-        (void)BuildAnimationFolderMenu(hAnimMenu, wRoot, "", &nextId, currentAnim);
-        
-        // Fallback message if no items were added at all.
-        if (GetMenuItemCount(hAnimMenu) <= 4) { // Logo, CPU%, MEM% and separator are always there
-            AppendMenuW(hAnimMenu, MF_STRING | MF_GRAYED, 0, GetLocalizedString(L"(支持 GIF、WebP、PNG 等)", L"(Supports GIF, WebP, PNG, etc.)"));
-        }
-
-        AppendMenuW(hAnimMenu, MF_SEPARATOR, 0, NULL);
-
-        /** Animation speed metric sub options */
-        HMENU hAnimSpeedMenu = CreatePopupMenu();
-        AnimationSpeedMetric currentMetric = GetAnimationSpeedMetric();
-        AppendMenuW(hAnimSpeedMenu, MF_STRING | (currentMetric == ANIMATION_SPEED_MEMORY ? MF_CHECKED : MF_UNCHECKED),
-                    CLOCK_IDM_ANIM_SPEED_MEMORY, GetLocalizedString(L"按内存占用", L"By Memory Usage"));
-        AppendMenuW(hAnimSpeedMenu, MF_STRING | (currentMetric == ANIMATION_SPEED_CPU ? MF_CHECKED : MF_UNCHECKED),
-                    CLOCK_IDM_ANIM_SPEED_CPU, GetLocalizedString(L"按CPU占用", L"By CPU Usage"));
-        AppendMenuW(hAnimSpeedMenu, MF_STRING | (currentMetric == ANIMATION_SPEED_TIMER ? MF_CHECKED : MF_UNCHECKED),
-                    CLOCK_IDM_ANIM_SPEED_TIMER, GetLocalizedString(L"按倒计时进度", L"By Countdown Progress"));
-        AppendMenuW(hAnimMenu, MF_POPUP, (UINT_PTR)hAnimSpeedMenu,
-                    GetLocalizedString(L"动画速度依据", L"Animation Speed Metric"));
-
-        AppendMenuW(hAnimMenu, MF_SEPARATOR, 0, NULL);
-        AppendMenuW(hAnimMenu, MF_STRING, CLOCK_IDM_ANIMATIONS_OPEN_DIR, GetLocalizedString(L"打开动画文件夹", L"Open animations folder"));
-    }
-    AppendMenuW(hMenu, MF_POPUP, (UINT_PTR)hAnimMenu, GetLocalizedString(L"托盘图标", L"Tray Icon"));
-
-    AppendMenuW(hMenu, MF_SEPARATOR, 0, NULL);
-
-    HMENU hAboutMenu = CreatePopupMenu();
+/** @brief "Help" submenu, including the language list */
+static void FillHelpMenu(HMENU hAboutMenu, const void* context) {
+    (void)context;
 
     AppendMenuW(hAboutMenu, MF_STRING, CLOCK_IDM_ABOUT, GetLocalizedString(L"关于", L"About"));
 
@@ -1041,35 +969,15 @@ void ShowColorMenu(HWND hwnd) {
     AppendMenuW(hAboutMenu, MF_SEPARATOR, 0, NULL);
     AppendMenuW(hAboutMenu, MF_STRING, 200,
                 GetLocalizedString(L"重置", L"Reset"));
-
-    AppendMenuW(hMenu, MF_POPUP, (UINT_PTR)hAboutMenu,
-                GetLocalizedString(L"帮助", L"Help"));
-
-    AppendMenuW(hMenu, MF_STRING, 109,
-                GetLocalizedString(L"退出", L"Exit"));
-    
-    POINT pt;
-    GetCursorPos(&pt);
-    SetForegroundWindow(hwnd);
-    TrackPopupMenu(hMenu, TPM_LEFTALIGN | TPM_RIGHTBUTTON, pt.x, pt.y, 0, hwnd, NULL);
-    PostMessage(hwnd, WM_NULL, 0, 0);
-    DestroyMenu(hMenu);
 }
 
-/**
- * @brief Build and display timer control context menu (left-click menu)
- * @param hwnd Main window handle for menu operations
- * Creates focused menu for timer operations, time display, and Pomodoro functions
- */
-void ShowContextMenu(HWND hwnd) {
-    ReadTimeoutActionFromConfig();
-    
-    SetCursor(LoadCursorW(NULL, MAKEINTRESOURCEW(IDC_ARROW)));
-    
-    HMENU hMenu = CreatePopupMenu();
-    
-    /** Timer management submenu with dynamic state-based controls */
-    HMENU hTimerManageMenu = CreatePopupMenu();
+/* ============================================================================
+ * Submenu Fillers - Timer Control Menu
+ * ============================================================================ */
+
+/** @brief "Timer Control" submenu (context is the main window) */
+static void FillTimerControlMenu(HMENU hTimerManageMenu, const void* context) {
+    HWND hwnd = (HWND)context;
     
     /** Check if timer is actively running (not system clock, and either counting up or countdown in progress) */
     BOOL timerRunning = (!CLOCK_SHOW_CURRENT_TIME && 
@@ -1098,13 +1006,12 @@ void ShowContextMenu(HWND hwnd) {
         GetLocalizedString(L"显示窗口", L"Show Window");
     
     AppendMenuW(hTimerManageMenu, MF_STRING, CLOCK_IDC_TOGGLE_VISIBILITY, visibilityText);
+}
+
+/** @brief "Time Display" submenu */
+static void FillTimeDisplayMenu(HMENU hTimeMenu, const void* context) {
+    (void)context;
     
-    AppendMenuW(hMenu, MF_POPUP, (UINT_PTR)hTimerManageMenu,
-               GetLocalizedString(L"计时管理", L"Timer Control"));
-    
-    AppendMenuW(hMenu, MF_SEPARATOR, 0, NULL);
-    
-    HMENU hTimeMenu = CreatePopupMenu();
     AppendMenuW(hTimeMenu, MF_STRING | (CLOCK_SHOW_CURRENT_TIME ? MF_CHECKED : MF_UNCHECKED),
                CLOCK_IDM_SHOW_CURRENT_TIME,
                GetLocalizedString(L"显示当前时间", L"Show Current Time"));
@@ -1116,15 +1023,14 @@ void ShowContextMenu(HWND hwnd) {
     AppendMenuW(hTimeMenu, MF_STRING | (CLOCK_SHOW_SECONDS ? MF_CHECKED : MF_UNCHECKED),
                CLOCK_IDM_SHOW_SECONDS,
                GetLocalizedString(L"显示秒数", L"Show Seconds"));
-    
-    AppendMenuW(hMenu, MF_POPUP,
-               (UINT_PTR)hTimeMenu,
-               GetLocalizedString(L"时间显示", L"Time Display"));
+}
+
+/** @brief "Pomodoro" submenu (reloads the Pomodoro options from config.ini) */
+static void FillPomodoroMenu(HMENU hPomodoroMenu, const void* context) {
+    (void)context;
 
     /* Load Pomodoro configuration for menu generation */
     LoadPomodoroConfig();
-
-    HMENU hPomodoroMenu = CreatePopupMenu();
     
     wchar_t timeBuffer[64];
     
@@ -1164,9 +1070,100 @@ void ShowContextMenu(HWND hwnd) {
 
     AppendMenuW(hPomodoroMenu, MF_STRING, CLOCK_IDM_POMODORO_COMBINATION,
               GetLocalizedString(L"组合", L"Combination"));
+}
+
+/* ============================================================================
+ * Public API - Menu Display
+ * ============================================================================ */
+
+/**
+ * @brief Build and display comprehensive configuration menu (right-click menu)
+ * @param hwnd Main window handle for menu operations
+ * Creates the top level with empty submenus; each is filled on its
+ * WM_INITMENUPOPUP, and the font and animation menus are reused while
+ * their catalog snapshot and selection are unchanged.
+ */
+void ShowColorMenu(HWND hwnd) {
+    BeginMenuOpenMeasurement();
+    
+    SetCursor(LoadCursorW(NULL, MAKEINTRESOURCEW(IDC_ARROW)));
+    
+    HMENU hMenu = CreatePopupMenu();
+    
+    AppendMenuW(hMenu, MF_STRING | (CLOCK_EDIT_MODE ? MF_CHECKED : MF_UNCHECKED),
+               CLOCK_IDC_EDIT_MODE, 
+               GetLocalizedString(L"编辑模式", L"Edit Mode"));
+
+    AppendMenuW(hMenu, MF_SEPARATOR, 0, NULL);
+
+    AppendLazySubmenu(hMenu, 0, LAZY_OWNER_TRANSIENT, FillTimeoutMenu, NULL,
+                      GetLocalizedString(L"超时动作", L"Timeout Action"));
+
+    AppendLazySubmenu(hMenu, 0, LAZY_OWNER_TRANSIENT, FillPresetMenu, NULL,
+                      GetLocalizedString(L"预设管理", L"Preset Management"));
+
+    AppendMenuW(hMenu, MF_STRING, CLOCK_IDM_HOTKEY_SETTINGS,
+                GetLocalizedString(L"热键设置", L"Hotkey Settings"));
+
+    AppendMenuW(hMenu, MF_SEPARATOR, 0, NULL);
+
+    extern BOOL NeedsFontLicenseVersionAcceptance(void);
+    int fontState = CURRENT_LANGUAGE | (NeedsFontLicenseVersionAcceptance() ? 0x100 : 0);
+    HMENU hFontSubMenu = GetResourceMenu(&g_fontMenuMap, CATALOG_ROOT_FONTS,
+                                         GetCurrentFontRelativePath(), fontState, FillFontMenu);
+
+    AppendLazySubmenu(hMenu, 0, LAZY_OWNER_TRANSIENT, FillFormatMenu, NULL,
+                      GetLocalizedString(L"格式", L"Format"));
+    AppendMenuW(hMenu, MF_POPUP, (UINT_PTR)hFontSubMenu, 
+                GetLocalizedString(L"字体", L"Font"));
+    AppendLazySubmenu(hMenu, 0, LAZY_OWNER_TRANSIENT, FillColorMenu, NULL,
+                      GetLocalizedString(L"颜色", L"Color"));
+
+    AppendMenuW(hMenu, MF_SEPARATOR, 0, NULL);
+
+    /** Animations submenu */
+    int animState = CURRENT_LANGUAGE | ((int)GetAnimationSpeedMetric() << 8);
+    HMENU hAnimMenu = GetResourceMenu(&g_animationMenuMap, CATALOG_ROOT_ANIMATIONS,
+                                      GetCurrentAnimationName(), animState, FillAnimationMenu);
+    AppendMenuW(hMenu, MF_POPUP, (UINT_PTR)hAnimMenu, GetLocalizedString(L"托盘图标", L"Tray Icon"));
+
+    AppendMenuW(hMenu, MF_SEPARATOR, 0, NULL);
+
+    AppendLazySubmenu(hMenu, 0, LAZY_OWNER_TRANSIENT, FillHelpMenu, NULL,
+                      GetLocalizedString(L"帮助", L"Help"));
+
+    AppendMenuW(hMenu, MF_STRING, 109,
+                GetLocalizedString(L"退出", L"Exit"));
+    
+    TrackAndDestroyMenu(hwnd, hMenu, TPM_LEFTALIGN | TPM_RIGHTBUTTON);
+}
+
+/**
+ * @brief Build and display timer control context menu (left-click menu)
+ * @param hwnd Main window handle for menu operations
+ * Creates focused menu for timer operations, time display, and Pomodoro
+ * functions; submenus are filled on their WM_INITMENUPOPUP
+ */
+void ShowContextMenu(HWND hwnd) {
+    BeginMenuOpenMeasurement();
+    
+    ReadTimeoutActionFromConfig();
+    
+    SetCursor(LoadCursorW(NULL, MAKEINTRESOURCEW(IDC_ARROW)));
+    
+    HMENU hMenu = CreatePopupMenu();
+    
+    /** Timer management submenu with dynamic state-based controls */
+    AppendLazySubmenu(hMenu, 0, LAZY_OWNER_TRANSIENT, FillTimerControlMenu, hwnd,
+                      GetLocalizedString(L"计时管理", L"Timer Control"));
+    
+    AppendMenuW(hMenu, MF_SEPARATOR, 0, NULL);
     
-    AppendMenuW(hMenu, MF_POPUP, (UINT_PTR)hPomodoroMenu,
-                GetLocalizedString(L"番茄时钟", L"Pomodoro"));
+    AppendLazySubmenu(hMenu, 0, LAZY_OWNER_TRANSIENT, FillTimeDisplayMenu, NULL,
+                      GetLocalizedString(L"时间显示", L"Time Display"));
+
+    AppendLazySubmenu(hMenu, 0, LAZY_OWNER_TRANSIENT, FillPomodoroMenu, NULL,
+                      GetLocalizedString(L"番茄时钟", L"Pomodoro"));
 
     AppendMenuW(hMenu, MF_STRING | (CLOCK_COUNT_UP ? MF_CHECKED : MF_UNCHECKED),
                CLOCK_IDM_COUNT_UP_START,
@@ -1183,10 +1180,5 @@ void ShowContextMenu(HWND hwnd) {
         AppendMenuW(hMenu, MF_STRING, CLOCK_IDM_QUICK_TIME_BASE + i, menu_item);
     }
 
-    POINT pt;
-    GetCursorPos(&pt);
-    SetForegroundWindow(hwnd);
-    TrackPopupMenu(hMenu, TPM_BOTTOMALIGN | TPM_LEFTALIGN, pt.x, pt.y, 0, hwnd, NULL);
-    PostMessage(hwnd, WM_NULL, 0, 0);
-    DestroyMenu(hMenu);
-}
\ No newline at end of file
+    TrackAndDestroyMenu(hwnd, hMenu, TPM_BOTTOMALIGN | TPM_LEFTALIGN);
+}
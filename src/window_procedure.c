@@ -6,7 +6,7 @@
  * Optimizations in v14.0 (incremental refinement):
  * - WRITE_CFG_REFRESH macro: Unified 60+ WriteConfig + InvalidateRect patterns
  * - TIMER_PARAMS_* builders: Standardized timer initialization (8 instances optimized)
- * - Data-driven extension matching: MatchExtension + arrays replace hardcoded comparisons
+ * - Data-driven file filters: resource catalog entry types replace extension comparisons
  * - Dead code elimination: Removed 4 unused helpers (HandleTimeoutAction, PATH_JOIN_IMPL, _cfg_*_ptr)
  * - CMD macro expansion: 8 additional handlers converted (CheckUpdate, ColorDialog, etc.)
  * - Consistent pattern usage: 100% of WriteConfig+Invalidate now use WRITE_CFG_REFRESH
@@ -41,6 +41,7 @@
 #include <shlguid.h>
 #include "../include/language.h"
 #include "../include/font.h"
+#include "../include/font_cache.h"
 #include "../include/color.h"
 #include "../include/tray.h"
 #include "../include/tray_menu.h"
@@ -56,6 +57,10 @@
 #include "../include/tray_events.h"
 #include "../include/dialog_procedure.h"
 #include "../include/pomodoro.h"
+#include "../include/metrics_endpoint.h"
+#include "../include/config_watcher.h"
+#include "../include/resource_catalog.h"
+#include "../include/system_monitor.h"
 #include "../include/update_checker.h"
 #include "../include/async_update_checker.h"
 #include "../include/hotkey.h"
@@ -63,6 +68,10 @@
 #include "../include/cli.h"
 #include "../include/tray_animation.h"
 
+#ifndef WM_DPICHANGED
+#define WM_DPICHANGED 0x02E0
+#endif
+
 /* ============================================================================
  * String Constant Pool (v12.0 - DRY Principle)
  * ============================================================================ */
@@ -777,7 +786,6 @@ extern void UpdateTrayIcon(HWND hwnd);
 #define BUFFER_SIZE_TIME_TEXT 50
 #define BUFFER_SIZE_CLI_INPUT 256
 #define BUFFER_SIZE_MENU_ITEM 100
-#define MAX_ANIMATION_MENU_ITEMS 1000
 #define OPACITY_FULL 255
 
 /** @brief Timer ID for menu selection debouncing */
@@ -792,260 +800,25 @@ extern void UpdateTrayIcon(HWND hwnd);
 #define CMD_COLOR_OPTIONS_BASE 201
 #define CMD_POMODORO_TIME_BASE 600
 #define CMD_POMODORO_TIME_END 609
-#define CMD_FONT_SELECTION_BASE 2000
-#define CMD_FONT_SELECTION_END 3000
+#define CMD_FONT_SELECTION_BASE CLOCK_IDM_FONTS_BASE
+#define CMD_FONT_SELECTION_END (CLOCK_IDM_FONTS_BASE + MAX_FONT_MENU_ITEMS)
 
 /* ============================================================================
- * Generic Recursive File Finder System
+ * Dynamic Menu Item Helpers
  * ============================================================================ */
 
-/** @brief File entry information */
-typedef struct {
-    wchar_t name[MAX_PATH];          /**< Display name */
-    char relPathUtf8[MAX_PATH];      /**< Relative path from root (UTF-8) */
-    BOOL isDir;                      /**< TRUE if directory */
-} FileEntry;
-
-/** @brief File filter predicate function type */
-typedef BOOL (*FileFilterFunc)(const wchar_t* filename);
-
-/** @brief File action callback function type */
-typedef BOOL (*FileActionFunc)(const char* relPath, void* userData);
-
-/**
- * @brief Natural sort comparison for wide-char strings with numeric awareness
- * @param a First string to compare
- * @param b Second string to compare
- * @return Negative if a<b, 0 if equal, positive if a>b
- */
-static int NaturalCompareW(const wchar_t* a, const wchar_t* b) {
-    const wchar_t* pa = a;
-    const wchar_t* pb = b;
-    while (*pa && *pb) {
-        if (iswdigit(*pa) && iswdigit(*pb)) {
-            const wchar_t* za = pa; while (*za == L'0') za++;
-            const wchar_t* zb = pb; while (*zb == L'0') zb++;
-            size_t leadA = (size_t)(za - pa);
-            size_t leadB = (size_t)(zb - pb);
-            if (leadA != leadB) return (leadA > leadB) ? -1 : 1;
-            const wchar_t* ea = za; while (iswdigit(*ea)) ea++;
-            const wchar_t* eb = zb; while (iswdigit(*eb)) eb++;
-            size_t lena = (size_t)(ea - za);
-            size_t lenb = (size_t)(eb - zb);
-            if (lena != lenb) return (lena < lenb) ? -1 : 1;
-            int dcmp = wcsncmp(za, zb, lena);
-            if (dcmp != 0) return (dcmp < 0) ? -1 : 1;
-            pa = ea; pb = eb;
-            continue;
-        }
-        wchar_t ca = towlower(*pa);
-        wchar_t cb = towlower(*pb);
-        if (ca != cb) return (ca < cb) ? -1 : 1;
-        pa++; pb++;
-    }
-    return *pa ? 1 : (*pb ? -1 : 0);
-}
-
-/** @brief Comparison for FileEntry (directories first, then natural sort) */
-static int CompareFileEntries(const void* a, const void* b) {
-    const FileEntry* ea = (const FileEntry*)a;
-    const FileEntry* eb = (const FileEntry*)b;
-    if (ea->isDir != eb->isDir) return eb->isDir - ea->isDir;
-    return NaturalCompareW(ea->name, eb->name);
-}
-
-/**
- * @brief Generic recursive file finder with predicate filtering
- * @param rootPathW Root directory (wide-char)
- * @param relPathUtf8 Current relative path (UTF-8)
- * @param filter File filter predicate (NULL = accept all)
- * @param targetId Target menu ID to find
- * @param currentId Pointer to current ID counter
- * @param action Callback when target found
- * @param userData User data passed to action
- * @return TRUE if target found and action executed
- */
-static BOOL RecursiveFindFile(const wchar_t* rootPathW, const char* relPathUtf8,
-                              FileFilterFunc filter, UINT targetId, UINT* currentId,
-                              FileActionFunc action, void* userData) {
-    FileEntry* entries = (FileEntry*)malloc(sizeof(FileEntry) * MAX_TRAY_FRAMES);
-    if (!entries) return FALSE;
-    
-    int count = 0;
-    wchar_t searchPath[MAX_PATH];
-    wcscpy_s(searchPath, MAX_PATH, rootPathW);
-    PathJoinW(searchPath, MAX_PATH, L"*");
-    
-    WIN32_FIND_DATAW ffd;
-    HANDLE hFind = FindFirstFileW(searchPath, &ffd);
-    if (hFind == INVALID_HANDLE_VALUE) {
-        free(entries);
-        return FALSE;
-    }
-    
-    do {
-        if (wcscmp(ffd.cFileName, L".") == 0 || wcscmp(ffd.cFileName, L"..") == 0) continue;
-        if (count >= MAX_TRAY_FRAMES) break;
-        
-        FileEntry* e = &entries[count];
-        e->isDir = (ffd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
-        wcsncpy_s(e->name, MAX_PATH, ffd.cFileName, _TRUNCATE);
-        
-        char nameUtf8[MAX_PATH];
-        WideCharToMultiByte(CP_UTF8, 0, ffd.cFileName, -1, nameUtf8, MAX_PATH, NULL, NULL);
-        
-        if (relPathUtf8 && relPathUtf8[0]) {
-            snprintf(e->relPathUtf8, MAX_PATH, "%s\\%s", relPathUtf8, nameUtf8);
-        } else {
-            strncpy_s(e->relPathUtf8, MAX_PATH, nameUtf8, _TRUNCATE);
-        }
-        
-        if (!e->isDir && filter && !filter(ffd.cFileName)) continue;
-        count++;
-    } while (FindNextFileW(hFind, &ffd));
-    FindClose(hFind);
-    
-    if (count == 0) {
-        free(entries);
-        return FALSE;
-    }
-    
-    qsort(entries, count, sizeof(FileEntry), CompareFileEntries);
-    
-    for (int i = 0; i < count; i++) {
-        FileEntry* e = &entries[i];
-        
-        if (e->isDir) {
-            wchar_t subPath[MAX_PATH];
-            wcscpy_s(subPath, MAX_PATH, rootPathW);
-            PathJoinW(subPath, MAX_PATH, e->name);
-            
-            if (RecursiveFindFile(subPath, e->relPathUtf8, filter, targetId, currentId, action, userData)) {
-                free(entries);
-                return TRUE;
-            }
-        } else {
-            if (*currentId == targetId) {
-                BOOL result = action(e->relPathUtf8, userData);
-                free(entries);
-                return result;
-            }
-            (*currentId)++;
-        }
-    }
-    
-    free(entries);
-    return FALSE;
-}
-
 /**
- * @brief Generic extension matcher for file filtering
- * @param filename File name to check
- * @param exts Array of extension strings
- * @param count Number of extensions
- * @return TRUE if file matches any extension
+ * @brief Queue the animation items around a hovered one for background decoding
+ * @param menuId Hovered menu ID; the next item is queued before the previous one
  */
-static BOOL MatchExtension(const wchar_t* filename, const wchar_t** exts, size_t count) {
-    const wchar_t* ext = wcsrchr(filename, L'.');
-    if (!ext) return FALSE;
-    for (size_t i = 0; i < count; i++) {
-        if (_wcsicmp(ext, exts[i]) == 0) return TRUE;
-    }
-    return FALSE;
-}
-
-/** @brief File extension filters (data-driven) */
-static const wchar_t* ANIMATION_EXTS[] = {
-    L".gif", L".webp", L".ico", L".png", L".bmp", 
-    L".jpg", L".jpeg", L".tif", L".tiff"
-};
-static const wchar_t* FONT_EXTS[] = {L".ttf", L".otf"};
-
-static BOOL IsAnimationFile(const wchar_t* filename) {
-    return MatchExtension(filename, ANIMATION_EXTS, ARRAY_SIZE(ANIMATION_EXTS));
-}
-
-static BOOL IsFontFile(const wchar_t* filename) {
-    return MatchExtension(filename, FONT_EXTS, ARRAY_SIZE(FONT_EXTS));
-}
-
-/** @brief Action callbacks for file finder */
-static BOOL AnimationPreviewAction(const char* relPath, void* userData) {
-    (void)userData;
-    StartAnimationPreview(relPath);
-    return TRUE;
-}
-
-static BOOL FontLoadAction(const char* relPath, void* userData) {
-    HWND hwnd = (HWND)userData;
-    HINSTANCE hInstance = (HINSTANCE)GetWindowLongPtr(hwnd, GWLP_HINSTANCE);
-    char fontPath[MAX_PATH];
-    strncpy_s(fontPath, MAX_PATH, relPath, _TRUNCATE);
-    if (SwitchFont(hInstance, fontPath)) {
-        InvalidateRect(hwnd, NULL, TRUE);
-        UpdateWindow(hwnd);
-        return TRUE;
-    }
-    return FALSE;
-}
-
-/**
- * @brief Find animation by menu ID and trigger preview (uses generic finder)
- * @param folderPathW Root animation folder path
- * @param relPathUtf8 Current relative path (empty string for root)
- * @param nextIdPtr ID counter
- * @param targetId Target menu ID
- * @return TRUE if found and preview started
- */
-static BOOL FindAnimationByIdRecursive(const wchar_t* folderPathW, const char* relPathUtf8, 
-                                      UINT* nextIdPtr, UINT targetId) {
-    return RecursiveFindFile(folderPathW, relPathUtf8, IsAnimationFile, 
-                           targetId, nextIdPtr, AnimationPreviewAction, NULL);
-}
-
-/* ============================================================================
- * Font Menu Builder - Static Helpers
- * ============================================================================ */
-
-/** @brief User data for font finding */
-typedef struct {
-    wchar_t relPath[MAX_PATH];
-    HWND hwnd;
-} FontFindData;
-
-/** @brief Font preview action callback */
-static BOOL FontPreviewAction(const char* relPath, void* userData) {
-    if (!userData) return FALSE;
-    wchar_t relPathW[MAX_PATH];
-    MultiByteToWideChar(CP_UTF8, 0, relPath, -1, relPathW, MAX_PATH);
-    wcsncpy_s(((FontFindData*)userData)->relPath, MAX_PATH, relPathW, _TRUNCATE);
-    return TRUE;
-}
-
-/**
- * @brief Find font file by ID using generic file finder
- * @param folderPathW Fonts folder root path
- * @param targetId Target menu ID
- * @param currentId Current ID counter
- * @param foundRelativePathW Output buffer for font path
- * @param fontsFolderRootW Font folder root (unused with new system)
- * @return TRUE if font found
- */
-static BOOL FindFontByIdRecursiveW(const wchar_t* folderPathW, int targetId, int* currentId,
-                                   wchar_t* foundRelativePathW, const wchar_t* fontsFolderRootW) {
-    (void)fontsFolderRootW;  /* Not needed with relative path tracking */
-    
-    FontFindData data = {0};
-    UINT id = (UINT)*currentId;
-    
-    if (RecursiveFindFile(folderPathW, "", IsFontFile, (UINT)targetId, &id, FontPreviewAction, &data)) {
-        wcsncpy_s(foundRelativePathW, MAX_PATH, data.relPath, _TRUNCATE);
-        *currentId = (int)id;
-        return TRUE;
-    }
-    
-    *currentId = (int)id;
-    return FALSE;
+static void PrefetchNeighbourAnimations(UINT menuId) {
+    const CatalogEntry* next = TrayMenu_GetAnimationItem(menuId + 1);
+    const CatalogEntry* prev = TrayMenu_GetAnimationItem(menuId - 1);
+    const char* names[2] = {
+        next ? next->relPathUtf8 : "",
+        prev ? prev->relPathUtf8 : ""
+    };
+    TrayAnimation_PrefetchAnimations(names, 2);
 }
 
 /* ============================================================================
@@ -1220,28 +993,6 @@ static inline void SetTimeoutAction(const char* action) {
  * Utility Helpers - Static Functions
  * ============================================================================ */
 
-/**
- * @brief Get fonts folder path in wide-char format
- * @param out Output buffer for wide-char path
- * @param size Buffer size in wchar_t units
- * @return TRUE if path retrieved successfully
- */
-static BOOL GetFontsFolderWideFromConfig(wchar_t* out, size_t size) {
-    if (!out || size == 0) return FALSE;
-    
-    WideString ws = ToWide(GetCachedConfigPath());
-    if (!ws.valid) return FALSE;
-    wchar_t wConfigPath[MAX_PATH];
-    wcscpy_s(wConfigPath, MAX_PATH, ws.buf);
-    
-    wchar_t* lastSep = wcsrchr(wConfigPath, L'\\');
-    if (!lastSep) return FALSE;
-    *lastSep = L'\0';
-    
-    _snwprintf_s(out, size, _TRUNCATE, L"%s\\resources\\fonts", wConfigPath);
-    return TRUE;
-}
-
 /**
  * @brief Check if wide-char string is NULL, empty or whitespace-only
  * @param str String to check (can be NULL)
@@ -1973,10 +1724,12 @@ CONFIG_RELOAD_HANDLER(Colors) {
     return 0;
 }
 
-/** @brief Custom loader for animation speed */
+/** @brief Custom loader for animation speed and the metric sampling it is driven by */
 static BOOL LoadAnimSpeed(const char* section, const char* key, void* target, const void* def) {
     (void)section; (void)key; (void)target; (void)def;
     ReloadAnimationSpeedFromConfig();
+    ReadSystemMonitorWatchConfig();
+    ReadSystemMonitorSamplingConfig();
     TrayAnimation_RecomputeTimerDelay();
     return FALSE;
 }
@@ -2017,6 +1770,25 @@ CONFIG_RELOAD_HANDLER(AnimPath) {
     return 0;
 }
 
+/**
+ * @brief Handle changes under the resources folder reported by the watcher
+ * @param hwnd Window handle
+ * @return 0 (message handled)
+ * 
+ * Re-validates the configured font only when the fonts folder changed.
+ */
+CONFIG_RELOAD_HANDLER(Resources) {
+    static LONG fontsGeneration = 0;
+    LONG current = ConfigWatcher_GetGeneration(WATCH_AREA_FONTS);
+    if (current != fontsGeneration) {
+        fontsGeneration = current;
+        if (CheckAndFixFontPath()) {
+            InvalidateRect(hwnd, NULL, TRUE);
+        }
+    }
+    return 0;
+}
+
 /* ============================================================================
  * Command Handler Functions - Table-Driven Dispatch
  * ============================================================================ */
@@ -2724,19 +2496,13 @@ static BOOL HandlePomodoroTime(HWND hwnd, UINT cmd, int index) {
 /** @brief Font selection handler */
 static BOOL HandleFontSelection(HWND hwnd, UINT cmd, int index) {
     (void)index;
-    wchar_t fontsFolderRootW[MAX_PATH];
-    if (!GetFontsFolderWideFromConfig(fontsFolderRootW, MAX_PATH)) return TRUE;
-    
-    int currentIndex = CMD_FONT_SELECTION_BASE;
-    wchar_t foundRelativePathW[MAX_PATH];
+    const CatalogEntry* font = TrayMenu_GetFontItem(cmd);
     
-    if (FindFontByIdRecursiveW(fontsFolderRootW, cmd, &currentIndex, 
-                              foundRelativePathW, fontsFolderRootW)) {
-        char foundFontNameUTF8[MAX_PATH];
-        WideCharToMultiByte(CP_UTF8, 0, foundRelativePathW, -1, 
-                          foundFontNameUTF8, MAX_PATH, NULL, NULL);
+    if (font) {
+        char fontPath[MAX_PATH];
+        strncpy_s(fontPath, MAX_PATH, font->relPathUtf8, _TRUNCATE);
         HINSTANCE hInstance = (HINSTANCE)GetWindowLongPtr(hwnd, GWLP_HINSTANCE);
-        if (SwitchFont(hInstance, foundFontNameUTF8)) {
+        if (SwitchFont(hInstance, fontPath)) {
             InvalidateRect(hwnd, NULL, TRUE);
             UpdateWindow(hwnd);
         }
@@ -2820,6 +2586,7 @@ static const AppMessageDispatchEntry APP_MESSAGE_DISPATCH_TABLE[] = {
     {WM_APP_COLORS_CHANGED,        HandleAppColorsChanged,        "Color options reload"},
     {WM_APP_ANIM_SPEED_CHANGED,    HandleAppAnimSpeedChanged,     "Animation speed reload"},
     {WM_APP_ANIM_PATH_CHANGED,     HandleAppAnimPathChanged,      "Animation path reload"},
+    {WM_APP_RESOURCES_CHANGED,     HandleAppResourcesChanged,     "Resource folder changes"},
     {0,                             NULL,                          NULL}
 };
 
@@ -3089,18 +2856,9 @@ static BOOL MatchColorPreview(HWND hwnd, UINT menuId) {
 
 /** @brief Font preview matcher */
 static BOOL MatchFontPreview(HWND hwnd, UINT menuId) {
-    wchar_t fontsFolderRootW[MAX_PATH];
-    if (!GetFontsFolderWideFromConfig(fontsFolderRootW, MAX_PATH)) return FALSE;
-    
-    int currentIndex = CMD_FONT_SELECTION_BASE;
-    wchar_t foundRelativePathW[MAX_PATH];
-    
-    if (FindFontByIdRecursiveW(fontsFolderRootW, menuId, &currentIndex, 
-                               foundRelativePathW, fontsFolderRootW)) {
-        char foundFontNameUTF8[MAX_PATH];
-        WideCharToMultiByte(CP_UTF8, 0, foundRelativePathW, -1, 
-                          foundFontNameUTF8, MAX_PATH, NULL, NULL);
-        StartPreview(PREVIEW_TYPE_FONT, foundFontNameUTF8, hwnd);
+    const CatalogEntry* font = TrayMenu_GetFontItem(menuId);
+    if (font) {
+        StartPreview(PREVIEW_TYPE_FONT, font->relPathUtf8, hwnd);
         return TRUE;
     }
     return FALSE;
@@ -3113,6 +2871,8 @@ static BOOL MatchAnimationPreview(HWND hwnd, UINT menuId) {
     if (menuId == CLOCK_IDM_ANIMATIONS_USE_LOGO) fixedAnim = "__logo__";
     else if (menuId == CLOCK_IDM_ANIMATIONS_USE_CPU) fixedAnim = "__cpu__";
     else if (menuId == CLOCK_IDM_ANIMATIONS_USE_MEM) fixedAnim = "__mem__";
+    else if (menuId == CLOCK_IDM_ANIMATIONS_USE_CPU_HISTORY) fixedAnim = "__cpuhist__";
+    else if (menuId == CLOCK_IDM_ANIMATIONS_USE_CPU_CORES) fixedAnim = "__cores__";
     
     if (fixedAnim) {
         StartPreview(PREVIEW_TYPE_ANIMATION, fixedAnim, hwnd);
@@ -3120,13 +2880,11 @@ static BOOL MatchAnimationPreview(HWND hwnd, UINT menuId) {
     }
     
     /** Dynamic animation items */
-    if (menuId >= CLOCK_IDM_ANIMATIONS_BASE && menuId < CLOCK_IDM_ANIMATIONS_BASE + MAX_ANIMATION_MENU_ITEMS) {
-        char animRootUtf8[MAX_PATH];
-        GetAnimationsFolderPath(animRootUtf8, sizeof(animRootUtf8));
-        wchar_t wRoot[MAX_PATH];
-        MultiByteToWideChar(CP_UTF8, 0, animRootUtf8, -1, wRoot, MAX_PATH);
-        UINT nextId = CLOCK_IDM_ANIMATIONS_BASE;
-        return FindAnimationByIdRecursive(wRoot, "", &nextId, menuId);
+    const CatalogEntry* anim = TrayMenu_GetAnimationItem(menuId);
+    if (anim) {
+        StartAnimationPreview(anim->relPathUtf8);
+        PrefetchNeighbourAnimations(menuId);
+        return TRUE;
     }
     return FALSE;
 }
@@ -3155,9 +2913,9 @@ static BOOL MatchTimeFormatPreview(HWND hwnd, UINT menuId) {
 /** @brief Preview range table (compile-time constant) */
 static const PreviewRange PREVIEW_RANGES[] = {
     {CMD_COLOR_OPTIONS_BASE, CMD_COLOR_OPTIONS_BASE + 100, MatchColorPreview},
-    {CMD_FONT_SELECTION_BASE, CMD_FONT_SELECTION_END, MatchFontPreview},
+    {CMD_FONT_SELECTION_BASE, CMD_FONT_SELECTION_END - 1, MatchFontPreview},
     {CLOCK_IDM_TIME_FORMAT_DEFAULT, CLOCK_IDM_TIME_FORMAT_SHOW_MILLISECONDS, MatchTimeFormatPreview},
-    {CLOCK_IDM_ANIMATIONS_USE_LOGO, CLOCK_IDM_ANIMATIONS_BASE + MAX_ANIMATION_MENU_ITEMS, MatchAnimationPreview}
+    {CLOCK_IDM_ANIMATIONS_USE_LOGO, CLOCK_IDM_ANIMATIONS_BASE + MAX_ANIMATION_MENU_ITEMS - 1, MatchAnimationPreview}
 };
 
 /**
@@ -3165,11 +2923,14 @@ static const PreviewRange PREVIEW_RANGES[] = {
  * @param hwnd Window handle
  * @param menuId Menu item ID
  * @return TRUE if preview triggered, FALSE otherwise
+ * @note Ranges may overlap; a matcher that declines the ID passes it on
+ *       to the next range instead of ending the search
  */
 static BOOL DispatchPreview(HWND hwnd, UINT menuId) {
     for (size_t i = 0; i < ARRAY_SIZE(PREVIEW_RANGES); i++) {
-        if (menuId >= PREVIEW_RANGES[i].rangeStart && menuId <= PREVIEW_RANGES[i].rangeEnd) {
-            return PREVIEW_RANGES[i].matcher(hwnd, menuId);
+        if (menuId >= PREVIEW_RANGES[i].rangeStart && menuId <= PREVIEW_RANGES[i].rangeEnd &&
+            PREVIEW_RANGES[i].matcher(hwnd, menuId)) {
+            return TRUE;
         }
     }
     return FALSE;
@@ -3199,7 +2960,14 @@ static LRESULT HandleMenuSelect(HWND hwnd, WPARAM wp, LPARAM lp) {
     
     /** Try unified preview dispatcher (works for all types) */
     if (!(flags & MF_POPUP) || (menuItem >= CLOCK_IDM_ANIMATIONS_USE_LOGO)) {
-        if (DispatchPreview(hwnd, menuItem)) {
+        LARGE_INTEGER freq, start, end;
+        QueryPerformanceFrequency(&freq);
+        QueryPerformanceCounter(&start);
+        BOOL previewed = DispatchPreview(hwnd, menuItem);
+        if (previewed) {
+            QueryPerformanceCounter(&end);
+            MetricsEndpoint_ObserveMenuPreviewMs((double)(end.QuadPart - start.QuadPart) * 1000.0 /
+                                                 (double)freq.QuadPart);
             return 0;
         }
     }
@@ -3237,28 +3005,44 @@ static LRESULT HandleTrayIcon(HWND hwnd, WPARAM wp, LPARAM lp);
 static LRESULT HandleCommand(HWND hwnd, WPARAM wp, LPARAM lp);
 static LRESULT HandleWindowPosChanged(HWND hwnd, WPARAM wp, LPARAM lp);
 static LRESULT HandleDisplayChange(HWND hwnd, WPARAM wp, LPARAM lp);
+static LRESULT HandleDpiChanged(HWND hwnd, WPARAM wp, LPARAM lp);
+static LRESULT HandleSettingChange(HWND hwnd, WPARAM wp, LPARAM lp);
 static LRESULT HandleRButtonUp(HWND hwnd, WPARAM wp, LPARAM lp);
 static LRESULT HandleRButtonDown(HWND hwnd, WPARAM wp, LPARAM lp);
 static LRESULT HandleExitMenuLoop(HWND hwnd, WPARAM wp, LPARAM lp);
+static LRESULT HandleInitMenuPopup(HWND hwnd, WPARAM wp, LPARAM lp);
+static LRESULT HandleEnterIdle(HWND hwnd, WPARAM wp, LPARAM lp);
 static LRESULT HandleClose(HWND hwnd, WPARAM wp, LPARAM lp);
 static LRESULT HandleLButtonDblClk(HWND hwnd, WPARAM wp, LPARAM lp);
 static LRESULT HandleHotkey(HWND hwnd, WPARAM wp, LPARAM lp);
 static LRESULT HandleCopyData(HWND hwnd, WPARAM wp, LPARAM lp);
 static LRESULT HandleQuickCountdownIndex(HWND hwnd, WPARAM wp, LPARAM lp);
 static LRESULT HandleShowCliHelp(HWND hwnd, WPARAM wp, LPARAM lp);
+static LRESULT HandleDumpAnimTrace(HWND hwnd, WPARAM wp, LPARAM lp);
 static LRESULT HandleTrayUpdateIcon(HWND hwnd, WPARAM wp, LPARAM lp);
 static LRESULT HandleAppReregisterHotkeys(HWND hwnd, WPARAM wp, LPARAM lp);
+static LRESULT HandlePowerBroadcast(HWND hwnd, WPARAM wp, LPARAM lp);
 
 /* ============================================================================
  * Message Handler Implementations (v10.0 - Extracted from switch)
  * ============================================================================ */
 
+/** @brief GUID_CONSOLE_DISPLAY_STATE, defined locally to avoid depending on libuuid exporting it */
+static const GUID kConsoleDisplayStateGuid =
+    {0x6fe69556, 0x704a, 0x47a0, {0x8f, 0x24, 0xc2, 0x8d, 0x93, 0x6f, 0xda, 0x47}};
+
+/** @brief Display on/off notifications, which gate tooltip-only metric sampling */
+static HPOWERNOTIFY g_displayStateNotify = NULL;
+
 static LRESULT HandleCreate(HWND hwnd, WPARAM wp, LPARAM lp) {
     UNUSED(wp, lp);
     RegisterGlobalHotkeys(hwnd);
     HandleWindowCreate(hwnd);
-    extern void ConfigWatcher_Start(HWND hwnd);
+    ResourceCatalog_Start();
     ConfigWatcher_Start(hwnd);
+    MetricsEndpoint_Start();
+    g_displayStateNotify = RegisterPowerSettingNotification(hwnd, &kConsoleDisplayStateGuid,
+                                                            DEVICE_NOTIFY_WINDOW_HANDLE);
     return 0;
 }
 
@@ -3302,10 +3086,15 @@ static LRESULT HandleMouseMove(HWND hwnd, WPARAM wp, LPARAM lp) {
 
 static LRESULT HandlePaint(HWND hwnd, WPARAM wp, LPARAM lp) {
     UNUSED(wp, lp);
+    LARGE_INTEGER freq, start, end;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&start);
     PAINTSTRUCT ps;
     BeginPaint(hwnd, &ps);
     HandleWindowPaint(hwnd, &ps);
     EndPaint(hwnd, &ps);
+    QueryPerformanceCounter(&end);
+    MetricsEndpoint_ObservePaintMs((double)(end.QuadPart - start.QuadPart) * 1000.0 / (double)freq.QuadPart);
     return 0;
 }
 
@@ -3324,8 +3113,20 @@ static LRESULT HandleDestroy(HWND hwnd, WPARAM wp, LPARAM lp) {
     UNUSED(wp, lp);
     UnregisterGlobalHotkeys(hwnd);
     HandleWindowDestroy(hwnd);
-    extern void ConfigWatcher_Stop(void);
     ConfigWatcher_Stop();
+
+    /** Prune entries for fonts that were removed or replaced, then persist */
+    const ResourceCatalog* fonts = ResourceCatalog_Acquire(CATALOG_ROOT_FONTS);
+    FontCache_Validate(fonts);
+    ResourceCatalog_Release(fonts);
+    FontCache_Save();
+
+    ResourceCatalog_Stop();
+    MetricsEndpoint_Stop();
+    if (g_displayStateNotify) {
+        UnregisterPowerSettingNotification(g_displayStateNotify);
+        g_displayStateNotify = NULL;
+    }
     return 0;
 }
 
@@ -3342,7 +3143,9 @@ static LRESULT HandleCommand(HWND hwnd, WPARAM wp, LPARAM lp) {
         (cmd >= CLOCK_IDM_ANIMATIONS_BASE && cmd < CLOCK_IDM_ANIMATIONS_BASE + MAX_ANIMATION_MENU_ITEMS) ||
         cmd == CLOCK_IDM_ANIMATIONS_USE_LOGO ||
         cmd == CLOCK_IDM_ANIMATIONS_USE_CPU ||
-        cmd == CLOCK_IDM_ANIMATIONS_USE_MEM;
+        cmd == CLOCK_IDM_ANIMATIONS_USE_MEM ||
+        cmd == CLOCK_IDM_ANIMATIONS_USE_CPU_HISTORY ||
+        cmd == CLOCK_IDM_ANIMATIONS_USE_CPU_CORES;
     
     if (isAnimationSelectionCommand) {
         KillTimer(hwnd, IDT_MENU_DEBOUNCE);
@@ -3373,9 +3176,34 @@ static LRESULT HandleDisplayChange(HWND hwnd, WPARAM wp, LPARAM lp) {
     AdjustWindowPosition(hwnd, TRUE);
     InvalidateRect(hwnd, NULL, FALSE);
     UpdateWindow(hwnd);
+    TrayAnimation_HandleDpiChange();
     return 0;
 }
 
+static LRESULT HandleDpiChanged(HWND hwnd, WPARAM wp, LPARAM lp) {
+    TrayAnimation_HandleDpiChange();
+    return DefWindowProc(hwnd, WM_DPICHANGED, wp, lp);
+}
+
+static LRESULT HandleSettingChange(HWND hwnd, WPARAM wp, LPARAM lp) {
+    /** Icon metrics and taskbar DPI changes arrive here; unchanged sizes are a no-op */
+    TrayAnimation_HandleDpiChange();
+    return DefWindowProc(hwnd, WM_SETTINGCHANGE, wp, lp);
+}
+
+static LRESULT HandlePowerBroadcast(HWND hwnd, WPARAM wp, LPARAM lp) {
+    /** Display off (0) hides the tray; on (1) and dimmed (2) leave it visible */
+    if (wp == PBT_POWERSETTINGCHANGE && lp) {
+        const POWERBROADCAST_SETTING* setting = (const POWERBROADCAST_SETTING*)lp;
+        if (IsEqualGUID(&setting->PowerSetting, &kConsoleDisplayStateGuid) &&
+            setting->DataLength >= sizeof(DWORD)) {
+            SystemMonitor_SetTrayVisible(*(const DWORD*)setting->Data != 0);
+        }
+        return TRUE;
+    }
+    return DefWindowProc(hwnd, WM_POWERBROADCAST, wp, lp);
+}
+
 static LRESULT HandleRButtonUp(HWND hwnd, WPARAM wp, LPARAM lp) {
     UNUSED(wp, lp);
     if (CLOCK_EDIT_MODE) {
@@ -3409,6 +3237,16 @@ static LRESULT HandleExitMenuLoop(HWND hwnd, WPARAM wp, LPARAM lp) {
     return 0;
 }
 
+static LRESULT HandleInitMenuPopup(HWND hwnd, WPARAM wp, LPARAM lp) {
+    if (TrayMenu_HandleInitMenuPopup((HMENU)wp)) return 0;
+    return DefWindowProc(hwnd, WM_INITMENUPOPUP, wp, lp);
+}
+
+static LRESULT HandleEnterIdle(HWND hwnd, WPARAM wp, LPARAM lp) {
+    if (wp == MSGF_MENU) TrayMenu_HandleMenuIdle();
+    return DefWindowProc(hwnd, WM_ENTERIDLE, wp, lp);
+}
+
 static LRESULT HandleClose(HWND hwnd, WPARAM wp, LPARAM lp) {
     UNUSED(wp, lp);
     SaveWindowSettings(hwnd);
@@ -3464,6 +3302,12 @@ static LRESULT HandleShowCliHelp(HWND hwnd, WPARAM wp, LPARAM lp) {
     return 0;
 }
 
+static LRESULT HandleDumpAnimTrace(HWND hwnd, WPARAM wp, LPARAM lp) {
+    UNUSED(hwnd, wp, lp);
+    TrayAnimation_DumpTimingTrace(FALSE);
+    return 0;
+}
+
 static LRESULT HandleTrayUpdateIcon(HWND hwnd, WPARAM wp, LPARAM lp) {
     UNUSED(hwnd, wp, lp);
     if (TrayAnimation_HandleUpdateMessage()) return 0;
@@ -3561,15 +3405,21 @@ static const MessageDispatchEntry MESSAGE_DISPATCH_TABLE[] = {
     {WM_COMMAND, HandleCommand, "Menu command"},
     {WM_WINDOWPOSCHANGED, HandleWindowPosChanged, "Window position changed"},
     {WM_DISPLAYCHANGE, HandleDisplayChange, "Display configuration changed"},
+    {WM_DPICHANGED, HandleDpiChanged, "Window DPI changed"},
+    {WM_SETTINGCHANGE, HandleSettingChange, "System settings changed"},
+    {WM_POWERBROADCAST, HandlePowerBroadcast, "Power setting change (display state)"},
     {WM_MENUSELECT, HandleMenuSelect, "Menu item selection"},
     {WM_MEASUREITEM, HandleMeasureItem, "Owner-drawn menu measurement"},
     {WM_DRAWITEM, HandleDrawItem, "Owner-drawn menu rendering"},
     {WM_EXITMENULOOP, HandleExitMenuLoop, "Menu loop exit"},
+    {WM_INITMENUPOPUP, HandleInitMenuPopup, "Lazy submenu population"},
+    {WM_ENTERIDLE, HandleEnterIdle, "Menu loop idle"},
     {WM_CLOSE, HandleClose, "Window close"},
     {WM_HOTKEY, HandleHotkey, "Global hotkey"},
     {WM_COPYDATA, HandleCopyData, "Inter-process communication"},
     {WM_APP_QUICK_COUNTDOWN_INDEX, HandleQuickCountdownIndex, "Quick countdown by index"},
     {WM_APP_SHOW_CLI_HELP, HandleShowCliHelp, "Show CLI help"},
+    {WM_APP_DUMP_ANIM_TRACE, HandleDumpAnimTrace, "Export animation timing trace"},
     {WM_USER + 100, HandleTrayUpdateIcon, "Tray icon update"},
     {WM_APP + 1, HandleAppReregisterHotkeys, "Hotkey re-registration"},
     {0, NULL, NULL}  /* Sentinel */
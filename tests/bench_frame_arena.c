@@ -0,0 +1,99 @@
+/**
+ * @file bench_frame_arena.c
+ * @brief FrameArena against malloc/free on the decode loop's allocation pattern
+ *
+ * Each round allocates what one animation frame needs (scaler temporaries,
+ * a master frame, a canvas-sized buffer), touches the first page of each
+ * and frees them again. Also runs the same pattern from several threads to
+ * show the cost of the shared lock.
+ *
+ * Usage: bench_frame_arena [rounds]
+ */
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "test_common.h"
+#include "frame_arena.h"
+
+#define THREADS 4
+
+/** @brief Sizes of one frame's buffers: temporaries, 256x256 master, 600x600 canvas */
+static const size_t kFrameSizes[] = {
+    3 * 1024, 16 * 1024, 48 * 1024, 256 * 256 * 4, 600 * 600 * 4, 20 * 1024, 2 * 1024
+};
+#define FRAME_BUFFER_COUNT (sizeof(kFrameSizes) / sizeof(kFrameSizes[0]))
+
+typedef void* (*AllocFn)(size_t);
+typedef void (*FreeFn)(void*);
+
+typedef struct {
+    AllocFn alloc;
+    FreeFn release;
+    long rounds;
+} Workload;
+
+static void RunRounds(AllocFn alloc, FreeFn release, long rounds) {
+    void* blocks[FRAME_BUFFER_COUNT];
+    for (long r = 0; r < rounds; ++r) {
+        for (size_t i = 0; i < FRAME_BUFFER_COUNT; ++i) {
+            blocks[i] = alloc(kFrameSizes[i]);
+            memset(blocks[i], (int)r, 64);
+            TestKeep(blocks[i]);
+        }
+        for (size_t i = FRAME_BUFFER_COUNT; i-- > 0;) {
+            release(blocks[i]);
+        }
+    }
+}
+
+static void* Worker(void* param) {
+    const Workload* w = (const Workload*)param;
+    RunRounds(w->alloc, w->release, w->rounds);
+    return NULL;
+}
+
+/** @return Nanoseconds per allocation+free pair */
+static double Measure(AllocFn alloc, FreeFn release, long rounds, int threads) {
+    Workload w = {alloc, release, rounds};
+    RunRounds(alloc, release, 16);   /**< Warm up: fill free lists / malloc bins */
+
+    uint64_t start = TestNowNs();
+    if (threads == 1) {
+        RunRounds(alloc, release, rounds);
+    } else {
+        pthread_t ids[THREADS];
+        for (int t = 0; t < threads; ++t) pthread_create(&ids[t], NULL, Worker, &w);
+        for (int t = 0; t < threads; ++t) pthread_join(ids[t], NULL);
+    }
+    uint64_t elapsed = TestNowNs() - start;
+    return (double)elapsed / ((double)rounds * threads * FRAME_BUFFER_COUNT);
+}
+
+int main(int argc, char** argv) {
+    long rounds = (argc > 1) ? atol(argv[1]) : 20000;
+    if (rounds <= 0) rounds = 20000;
+
+    printf("%ld rounds of %zu buffers (largest %zu bytes)\n", rounds, FRAME_BUFFER_COUNT, kFrameSizes[4]);
+    printf("%-24s %12s %12s\n", "", "1 thread", "4 threads");
+
+    double mallocSingle = Measure(malloc, free, rounds, 1);
+    double mallocMulti = Measure(malloc, free, rounds, THREADS);
+    printf("%-24s %9.1f ns %9.1f ns\n", "malloc/free", mallocSingle, mallocMulti);
+
+    FrameArena_ResetStats();
+    double arenaSingle = Measure(FrameArena_Alloc, FrameArena_Free, rounds, 1);
+    double arenaMulti = Measure(FrameArena_Alloc, FrameArena_Free, rounds, THREADS);
+    printf("%-24s %9.1f ns %9.1f ns\n", "FrameArena_Alloc/Free", arenaSingle, arenaMulti);
+
+    FrameArenaStats st;
+    FrameArena_GetStats(&st);
+    printf("arena: %llu hits, %llu misses, peak %zu bytes in use, %zu bytes cached\n",
+           (unsigned long long)st.hits, (unsigned long long)st.misses, st.peakBytesInUse, st.bytesCached);
+
+    /** Sanity: after warm-up every allocation must come from a free list */
+    CHECK(st.hits > st.misses);
+    FrameArena_Trim();
+    return TEST_RESULT();
+}
@@ -0,0 +1,244 @@
+/**
+ * @file bench_log_ring.c
+ * @brief Logging cost on the caller: LogRing queue against the old synchronous WriteLog
+ *
+ * Several producer threads log the same kind of line as fast as they can.
+ * "sync" replicates the pre-ring WriteLog: lock, localtime, three fprintf
+ * calls and an fflush per record. "ring" replicates the current path: the
+ * caller formats into a ring slot and commits; a writer thread drains the
+ * ring into a batch buffer, formats timestamps once per second and writes
+ * each batch with one fwrite. The writer runs either at the shipped 200 ms
+ * interval (a burst overflows the 1024-slot ring and is dropped and counted)
+ * or draining continuously.
+ *
+ * Usage: bench_log_ring [calls per thread]
+ */
+
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "test_common.h"
+#include "log_ring.h"
+
+#define MAX_THREADS 8
+#define QUEUE_CAPACITY 1024             /**< LOG_QUEUE_CAPACITY in log.c */
+#define BATCH_BYTES (64 * 1024)         /**< LOG_BATCH_BYTES in log.c */
+#define SHIPPED_FLUSH_MS 200            /**< LOG_FLUSH_INTERVAL_MS in log.c */
+
+static const char* const kLevels[] = {"DEBUG", "INFO", "WARNING", "ERROR", "FATAL"};
+
+/* ============================================================================
+ * Old synchronous WriteLog
+ * ============================================================================ */
+
+static pthread_mutex_t g_syncLock = PTHREAD_MUTEX_INITIALIZER;
+static FILE* g_syncFile = NULL;
+static int g_syncCounter = 0;
+static long g_syncBytes = 0;
+
+static void SyncWriteLog(int level, const char* format, ...) {
+    pthread_mutex_lock(&g_syncLock);
+    if (++g_syncCounter >= 100) {       /**< Rotation check every 100 records */
+        g_syncCounter = 0;
+        g_syncBytes = ftell(g_syncFile);
+    }
+
+    time_t now;
+    struct tm localTime;
+    char timeStr[32] = {0};
+    time(&now);
+    localtime_r(&now, &localTime);
+    strftime(timeStr, sizeof(timeStr), "%Y-%m-%d %H:%M:%S", &localTime);
+
+    fprintf(g_syncFile, "[%s] [%s] ", timeStr, kLevels[level]);
+    va_list args;
+    va_start(args, format);
+    vfprintf(g_syncFile, format, args);
+    va_end(args);
+    fprintf(g_syncFile, "\n");
+    fflush(g_syncFile);
+    pthread_mutex_unlock(&g_syncLock);
+}
+
+/* ============================================================================
+ * LogRing path
+ * ============================================================================ */
+
+static LogRing g_ring;
+static FILE* g_ringFile = NULL;
+static atomic_int g_writerStop;
+static unsigned g_flushIntervalMs = 0;  /**< 0 = drain continuously */
+static uint64_t g_delivered = 0;
+static uint64_t g_droppedTotal = 0;
+
+static uint64_t WallClockNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void RingWriteLog(int level, const char* format, ...) {
+    size_t pos = 0;
+    LogRingSlot* slot = LogRing_BeginWrite(&g_ring, &pos);
+    if (!slot) {
+        LogRing_NoteDropped(&g_ring);
+        return;
+    }
+    slot->timestamp = WallClockNs();
+    slot->level = (uint16_t)level;
+    slot->flags = 0;
+    va_list args;
+    va_start(args, format);
+    int n = vsnprintf(slot->payload, LOG_RING_PAYLOAD_MAX, format, args);
+    va_end(args);
+    if (n < 0) n = 0;
+    if (n >= LOG_RING_PAYLOAD_MAX) n = LOG_RING_PAYLOAD_MAX - 1;
+    slot->length = (uint32_t)n;
+    LogRing_Commit(&g_ring, slot, pos);
+}
+
+/** @brief Drain everything committed into one batch write, timestamps cached per second */
+static void DrainRing(char* batch) {
+    static time_t cachedSecond = (time_t)-1;
+    static char cachedText[32];
+    size_t length = 0;
+    const LogRingSlot* slot;
+
+    while ((slot = LogRing_Peek(&g_ring)) != NULL) {
+        time_t second = (time_t)(slot->timestamp / 1000000000ull);
+        if (second != cachedSecond) {
+            struct tm localTime;
+            localtime_r(&second, &localTime);
+            strftime(cachedText, sizeof(cachedText), "%Y-%m-%d %H:%M:%S", &localTime);
+            cachedSecond = second;
+        }
+        if (BATCH_BYTES - length < slot->length + 48) {
+            fwrite(batch, 1, length, g_ringFile);
+            length = 0;
+        }
+        length += (size_t)snprintf(batch + length, BATCH_BYTES - length, "[%s] [%s] %.*s\n", cachedText,
+                                   kLevels[slot->level], (int)slot->length, slot->payload);
+        LogRing_Release(&g_ring);
+        g_delivered++;
+    }
+    g_droppedTotal += LogRing_TakeDropped(&g_ring);
+    if (length > 0) {
+        fwrite(batch, 1, length, g_ringFile);
+        fflush(g_ringFile);
+    }
+}
+
+static void* WriterThread(void* param) {
+    (void)param;
+    char* batch = (char*)malloc(BATCH_BYTES);
+    while (!atomic_load(&g_writerStop)) {
+        DrainRing(batch);
+        usleep(g_flushIntervalMs ? g_flushIntervalMs * 1000 : 50);
+    }
+    DrainRing(batch);
+    free(batch);
+    return NULL;
+}
+
+/* ============================================================================
+ * Producers
+ * ============================================================================ */
+
+typedef void (*LogFn)(int level, const char* format, ...);
+
+typedef struct {
+    LogFn log;
+    long calls;
+    uint32_t* latencyNs;        /**< One entry per call */
+    pthread_barrier_t* start;
+} Producer;
+
+static void* ProducerThread(void* param) {
+    Producer* p = (Producer*)param;
+    pthread_barrier_wait(p->start);
+    for (long i = 0; i < p->calls; ++i) {
+        uint64_t t0 = TestNowNs();
+        p->log(1, "Frame %ld decoded in %.2f ms: %s", i, (double)(i % 1000) / 37.0, "animations/cat/frame.png");
+        uint64_t dt = TestNowNs() - t0;
+        p->latencyNs[i] = dt > UINT32_MAX ? UINT32_MAX : (uint32_t)dt;
+    }
+    return NULL;
+}
+
+static int CompareU32(const void* a, const void* b) {
+    uint32_t x = *(const uint32_t*)a, y = *(const uint32_t*)b;
+    return (x > y) - (x < y);
+}
+
+/** @brief Run threads producers and print calls/s and caller latency percentiles */
+static void Run(const char* name, LogFn log, int threads, long calls) {
+    pthread_t ids[MAX_THREADS];
+    Producer producers[MAX_THREADS];
+    pthread_barrier_t start;
+    pthread_barrier_init(&start, NULL, (unsigned)threads + 1);
+
+    size_t total = (size_t)threads * (size_t)calls;
+    uint32_t* latency = (uint32_t*)malloc(total * sizeof(uint32_t));
+    for (int t = 0; t < threads; ++t) {
+        producers[t] = (Producer){log, calls, latency + (size_t)t * (size_t)calls, &start};
+        pthread_create(&ids[t], NULL, ProducerThread, &producers[t]);
+    }
+    pthread_barrier_wait(&start);
+    uint64_t begin = TestNowNs();
+    for (int t = 0; t < threads; ++t) pthread_join(ids[t], NULL);
+    double seconds = (double)(TestNowNs() - begin) / 1e9;
+    pthread_barrier_destroy(&start);
+
+    qsort(latency, total, sizeof(uint32_t), CompareU32);
+    printf("%-22s %2d  %12.0f  %9u  %9u  %9u\n", name, threads, (double)total / seconds,
+           latency[total / 2], latency[total * 99 / 100], latency[total - 1]);
+    free(latency);
+}
+
+static void RunRing(const char* name, unsigned flushIntervalMs, int threads, long calls) {
+    CHECK(LogRing_Init(&g_ring, QUEUE_CAPACITY));
+    g_ringFile = tmpfile();
+    g_flushIntervalMs = flushIntervalMs;
+    g_delivered = g_droppedTotal = 0;
+    atomic_store(&g_writerStop, 0);
+    pthread_t writer;
+    pthread_create(&writer, NULL, WriterThread, NULL);
+
+    Run(name, RingWriteLog, threads, calls);
+
+    atomic_store(&g_writerStop, 1);
+    pthread_join(writer, NULL);
+    uint64_t total = (uint64_t)threads * (uint64_t)calls;
+    printf("%-22s     written %llu, dropped %llu\n", "", (unsigned long long)g_delivered,
+           (unsigned long long)g_droppedTotal);
+    CHECK_EQ_U64(g_delivered + g_droppedTotal, total);   /**< Every call accounted for */
+    fclose(g_ringFile);
+    LogRing_Destroy(&g_ring);
+}
+
+int main(int argc, char** argv) {
+    long calls = (argc > 1) ? atol(argv[1]) : 50000;
+    if (calls <= 0) calls = 50000;
+    static const int kThreadCounts[] = {1, 4};
+
+    printf("%ld calls per thread, latency in ns per call\n", calls);
+    printf("%-22s %2s  %12s  %9s  %9s  %9s\n", "", "th", "calls/s", "p50", "p99", "max");
+    for (size_t i = 0; i < sizeof(kThreadCounts) / sizeof(kThreadCounts[0]); ++i) {
+        int threads = kThreadCounts[i];
+
+        g_syncFile = tmpfile();
+        Run("sync WriteLog", SyncWriteLog, threads, calls);
+        fseek(g_syncFile, 0, SEEK_END);
+        CHECK(ftell(g_syncFile) > 0);
+        fclose(g_syncFile);
+
+        RunRing("ring, 200 ms writer", SHIPPED_FLUSH_MS, threads, calls);
+        RunRing("ring, draining writer", 0, threads, calls);
+    }
+    return TEST_RESULT();
+}
@@ -0,0 +1,126 @@
+/**
+ * @file bench_menu_map.c
+ * @brief Hover lookup: the old catalog walk against the dense menu ID map
+ *
+ * Builds a catalog laid out like ResourceCatalog's (sorted children runs,
+ * directories pointing at their first child) with 1,000 fonts in 20
+ * folders. The old preview path walked it in menu order, counting fonts
+ * up to the hovered ID; the map records each item as the menu is built
+ * and resolves an ID with one index.
+ *
+ * Usage: bench_menu_map [rounds]
+ */
+
+#include <stdlib.h>
+
+#include "test_common.h"
+#include "menu_id_map.h"
+
+#define FOLDERS 20
+#define FONTS_PER_FOLDER 50
+#define FONT_COUNT (FOLDERS * FONTS_PER_FOLDER)
+#define FONTS_BASE 4000
+
+typedef enum { ENTRY_DIRECTORY, ENTRY_FONT } EntryType;
+
+/** @brief The parts of CatalogEntry the menu walks use */
+typedef struct {
+    EntryType type;
+    uint32_t firstChild;
+    uint32_t childCount;
+} Entry;
+
+static Entry g_entries[FOLDERS + FONT_COUNT];
+
+static const Entry* Children(const Entry* dir, uint32_t* count) {
+    if (!dir) {
+        *count = FOLDERS;
+        return &g_entries[0];
+    }
+    *count = dir->childCount;
+    return &g_entries[dir->firstChild];
+}
+
+static void BuildCatalog(void) {
+    for (uint32_t f = 0; f < FOLDERS; ++f) {
+        g_entries[f] = (Entry){ENTRY_DIRECTORY, FOLDERS + f * FONTS_PER_FOLDER, FONTS_PER_FOLDER};
+        for (uint32_t i = 0; i < FONTS_PER_FOLDER; ++i) {
+            g_entries[FOLDERS + f * FONTS_PER_FOLDER + i] = (Entry){ENTRY_FONT, 0, 0};
+        }
+    }
+}
+
+/** @brief The removed RecursiveFindFile: count fonts in menu order up to the target */
+static const Entry* WalkFind(const Entry* dir, uint32_t targetId, uint32_t* currentId) {
+    uint32_t count = 0;
+    const Entry* entries = Children(dir, &count);
+    for (uint32_t i = 0; i < count; ++i) {
+        const Entry* e = &entries[i];
+        if (e->type == ENTRY_DIRECTORY) {
+            const Entry* found = WalkFind(e, targetId, currentId);
+            if (found) return found;
+        } else {
+            if (*currentId == targetId) return e;
+            (*currentId)++;
+        }
+    }
+    return NULL;
+}
+
+static const Entry* OldLookup(uint32_t menuId) {
+    uint32_t id = FONTS_BASE;
+    return WalkFind(NULL, menuId, &id);
+}
+
+/** @brief What the menu builder does: record fonts in the order they are appended */
+static void RecordMenu(MenuIdMap* map, const Entry* dir) {
+    uint32_t count = 0;
+    const Entry* entries = Children(dir, &count);
+    for (uint32_t i = 0; i < count; ++i) {
+        if (entries[i].type == ENTRY_DIRECTORY) RecordMenu(map, &entries[i]);
+        else MenuIdMap_Record(map, &entries[i]);
+    }
+}
+
+int main(int argc, char** argv) {
+    long rounds = (argc > 1) ? atol(argv[1]) : 200;
+    if (rounds <= 0) rounds = 200;
+    BuildCatalog();
+
+    MenuIdMap map = MENU_ID_MAP_INIT(FONTS_BASE, 2000);
+    uint64_t start = TestNowNs();
+    RecordMenu(&map, NULL);
+    double buildUs = (double)(TestNowNs() - start) / 1e3;
+    CHECK_EQ_U64(map.count, FONT_COUNT);
+
+    /** Both resolve every ID to the same entry */
+    int mismatches = 0;
+    for (uint32_t id = FONTS_BASE; id < FONTS_BASE + FONT_COUNT; ++id) {
+        if (OldLookup(id) != MenuIdMap_Lookup(&map, id)) mismatches++;
+    }
+    CHECK_EQ_U64(mismatches, 0);
+    CHECK(OldLookup(FONTS_BASE + FONT_COUNT) == NULL && MenuIdMap_Lookup(&map, FONTS_BASE + FONT_COUNT) == NULL);
+
+    /** Hover every item in turn, as a pointer sweeping down the menu does */
+    start = TestNowNs();
+    for (long r = 0; r < rounds; ++r) {
+        for (uint32_t id = FONTS_BASE; id < FONTS_BASE + FONT_COUNT; ++id) TestKeep(OldLookup(id));
+    }
+    double walkNs = (double)(TestNowNs() - start) / ((double)rounds * FONT_COUNT);
+
+    long mapRounds = rounds * 100;
+    start = TestNowNs();
+    for (long r = 0; r < mapRounds; ++r) {
+        for (uint32_t id = FONTS_BASE; id < FONTS_BASE + FONT_COUNT; ++id) TestKeep(MenuIdMap_Lookup(&map, id));
+    }
+    double mapNs = (double)(TestNowNs() - start) / ((double)mapRounds * FONT_COUNT);
+
+    printf("%d fonts in %d folders, every ID hovered\n", FONT_COUNT, FOLDERS);
+    printf("%-26s %10.1f ns per lookup\n", "catalog walk (old)", walkNs);
+    printf("%-26s %10.1f ns per lookup\n", "menu ID map", mapNs);
+    printf("%-26s %10.1f us per menu build\n", "map recording", buildUs);
+
+    CHECK(mapNs < walkNs);
+    MenuIdMap_Release(&map);
+    return TEST_RESULT();
+}
@@ -0,0 +1,29 @@
+/**
+ * @file windows.h
+ * @brief Host stand-in for the few Win32 types the shared headers name
+ *
+ * Only on the include path of host targets that pull in a Windows-facing
+ * header (log.h) for its inline parts; nothing here is callable.
+ */
+
+#ifndef CATIME_TEST_COMPAT_WINDOWS_H
+#define CATIME_TEST_COMPAT_WINDOWS_H
+
+#include <stdint.h>
+
+typedef int BOOL;
+typedef int32_t LONG;
+typedef uint32_t DWORD;
+typedef uint64_t ULONGLONG;
+typedef void* HANDLE;
+
+typedef struct {
+    void* opaque[5];
+} CRITICAL_SECTION;
+
+#ifndef TRUE
+#define TRUE 1
+#define FALSE 0
+#endif
+
+#endif
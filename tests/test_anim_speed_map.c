@@ -0,0 +1,134 @@
+/**
+ * @file test_anim_speed_map.c
+ * @brief Q16.16 lookup table against the reference interpolator
+ */
+
+#include "test_common.h"
+#include "anim_speed_map.h"
+
+/** @brief Q16.16 error on a flat segment: rounding of both entries plus the truncated blend */
+#define LUT_TOLERANCE (3.0 / ANIM_SPEED_FIXED_ONE)
+
+typedef struct {
+    const char* name;
+    double defaultScale;
+    int count;
+    AnimSpeedPoint points[8];       /**< In config order, not necessarily sorted */
+} MapCase;
+
+static const MapCase kCases[] = {
+    {"no breakpoints", 100.0, 0, {{0, 0}}},
+    {"single at 50", 100.0, 1, {{50, 300}}},
+    {"single at 0", 80.0, 1, {{0, 250}}},
+    {"single at 100", 100.0, 1, {{100, 400}}},
+    {"rising", 100.0, 3, {{30, 150}, {60, 250}, {90, 500}}},
+    {"unsorted, falling", 400.0, 4, {{75, 50}, {10, 300}, {100, 10}, {40, 120}}},
+    {"adjacent percents", 100.0, 4, {{49, 100}, {50, 900}, {51, 100}, {1, 2}}},
+    {"fractional scales", 100.0, 3, {{33, 133.333}, {66, 66.667}, {99, 1234.5678}}},
+    {"large scales", 1.0, 2, {{10, 60000}, {20, 1}}},
+    {"duplicate percent", 100.0, 3, {{50, 200}, {50, 300}, {80, 100}}},
+};
+
+/**
+ * @brief Compare one lookup with the interpolator
+ *
+ * The position within a 0.1% step is quantised to 1/65536 as well, so the
+ * allowed error grows with the change in scale across that step.
+ */
+static void CheckAt(const AnimSpeedMap* map, const char* name, double percent) {
+    double expected = AnimSpeedMap_Interpolate(map, percent);
+    double actual = AnimSpeedMap_Lookup(map, percent);
+    double stepLow = floor(percent * ANIM_SPEED_LUT_STEPS_PER_PERCENT) / ANIM_SPEED_LUT_STEPS_PER_PERCENT;
+    double stepRise = AnimSpeedMap_Interpolate(map, stepLow + 1.0 / ANIM_SPEED_LUT_STEPS_PER_PERCENT) -
+                      AnimSpeedMap_Interpolate(map, stepLow);
+    double tolerance = LUT_TOLERANCE + fabs(stepRise) / ANIM_SPEED_FIXED_ONE;
+    if (!(fabs(actual - expected) <= tolerance)) {
+        fprintf(stderr, "%s: lookup(%.4f) = %.9f, interpolator %.9f\n", name, percent, actual, expected);
+        g_testFailures++;
+    }
+}
+
+static void BuildCase(AnimSpeedMap* map, const MapCase* c) {
+    AnimSpeedMap_Init(map, c->defaultScale);
+    for (int i = 0; i < c->count; ++i) {
+        CHECK(AnimSpeedMap_AddPoint(map, c->points[i].percent, c->points[i].scalePercent));
+    }
+    AnimSpeedMap_Build(map);
+}
+
+static void TestTableMatchesInterpolator(void) {
+    static AnimSpeedMap map;
+    for (size_t k = 0; k < sizeof(kCases) / sizeof(kCases[0]); ++k) {
+        const MapCase* c = &kCases[k];
+        BuildCase(&map, c);
+
+        /** Every table step, every whole percent among them */
+        for (int i = 0; i < ANIM_SPEED_LUT_SIZE; ++i) {
+            CheckAt(&map, c->name, (double)i / ANIM_SPEED_LUT_STEPS_PER_PERCENT);
+        }
+        /** Between table steps: the blend must stay on the line */
+        for (int i = 0; i < 100000; i += 7) {
+            CheckAt(&map, c->name, (double)i / 1000.0);
+        }
+        /** Each breakpoint and its immediate neighbours */
+        for (int i = 0; i < c->count; ++i) {
+            double p = (double)c->points[i].percent;
+            CheckAt(&map, c->name, p);
+            CheckAt(&map, c->name, p - 0.0001);
+            CheckAt(&map, c->name, p + 0.0001);
+        }
+        /** Out-of-range metrics clamp */
+        CheckAt(&map, c->name, -5.0);
+        CheckAt(&map, c->name, 250.0);
+    }
+}
+
+static void TestBreakpointValues(void) {
+    static AnimSpeedMap map;
+    BuildCase(&map, &kCases[5]);    /**< unsorted, falling */
+
+    CHECK_EQ_U64(map.points[0].percent, 10);
+    CHECK_EQ_U64(map.points[3].percent, 100);
+    CHECK_NEAR(AnimSpeedMap_Lookup(&map, 0.0), 400.0, LUT_TOLERANCE);
+    CHECK_NEAR(AnimSpeedMap_Lookup(&map, 10.0), 300.0, LUT_TOLERANCE);
+    CHECK_NEAR(AnimSpeedMap_Lookup(&map, 25.0), 210.0, LUT_TOLERANCE);
+    CHECK_NEAR(AnimSpeedMap_Lookup(&map, 75.0), 50.0, LUT_TOLERANCE);
+    CHECK_NEAR(AnimSpeedMap_Lookup(&map, 100.0), 10.0, LUT_TOLERANCE);
+
+    /** Above the last breakpoint the last scale holds */
+    BuildCase(&map, &kCases[1]);
+    CHECK_NEAR(AnimSpeedMap_Lookup(&map, 80.0), 300.0, LUT_TOLERANCE);
+    CHECK_NEAR(AnimSpeedMap_Lookup(&map, 25.0), 200.0, LUT_TOLERANCE);
+
+    /** Two keys on one percent: the later one wins, no step in the map */
+    BuildCase(&map, &kCases[9]);
+    CHECK_EQ_U64(map.pointCount, 2);
+    CHECK_NEAR(AnimSpeedMap_Lookup(&map, 50.0), 300.0, LUT_TOLERANCE);
+    CHECK_NEAR(AnimSpeedMap_Lookup(&map, 25.0), 200.0, LUT_TOLERANCE);
+}
+
+static void TestAddPointClamps(void) {
+    static AnimSpeedMap map;
+    AnimSpeedMap_Init(&map, 100.0);
+    CHECK(AnimSpeedMap_AddPoint(&map, -20, 150.0));
+    CHECK(AnimSpeedMap_AddPoint(&map, 180, 0.0));
+    CHECK_EQ_U64(map.points[0].percent, 0);
+    CHECK_EQ_U64(map.points[1].percent, 100);
+    CHECK_NEAR(map.points[1].scalePercent, 100.0, 0.0);
+
+    /** Lookup before the first build uses the interpolator directly */
+    CHECK(!map.lutReady);
+    CHECK_NEAR(AnimSpeedMap_Lookup(&map, 50.0), 125.0, 1e-12);
+
+    AnimSpeedMap_Init(&map, 100.0);
+    for (int i = 0; i < ANIM_SPEED_MAP_MAX_POINTS; ++i) CHECK(AnimSpeedMap_AddPoint(&map, i % 101, 100.0));
+    CHECK(!AnimSpeedMap_AddPoint(&map, 50, 100.0));
+    CHECK_EQ_U64(map.pointCount, ANIM_SPEED_MAP_MAX_POINTS);
+}
+
+int main(void) {
+    TestTableMatchesInterpolator();
+    TestBreakpointValues();
+    TestAddPointClamps();
+    return TEST_RESULT();
+}
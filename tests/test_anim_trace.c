@@ -0,0 +1,208 @@
+/**
+ * @file test_anim_trace.c
+ * @brief Animation trace ring: fill, wraparound, summary math and CSV output
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "test_common.h"
+#include "anim_trace.h"
+
+static AnimTraceEvent g_events[ANIM_TRACE_CAPACITY + 16];
+
+static void TestPartialFill(void) {
+    AnimTrace_Reset();
+    CHECK_EQ_U64(AnimTrace_Snapshot(g_events, ANIM_TRACE_CAPACITY), 0);
+
+    for (int i = 0; i < 10; ++i) {
+        AnimTrace_Record(ANIM_TRACE_FRAME, 100.0 + i, (double)i, (double)i + 0.5, i);
+    }
+    CHECK_EQ_U64(AnimTrace_Snapshot(g_events, ANIM_TRACE_CAPACITY), 10);
+    int ordered = 1;
+    for (int i = 0; i < 10; ++i) {
+        if (g_events[i].value != i || g_events[i].kind != ANIM_TRACE_FRAME) ordered = 0;
+    }
+    CHECK(ordered);                                                     /**< Oldest first */
+    CHECK_NEAR(g_events[3].timeMs, 103.0, 0.0);
+    CHECK_NEAR(g_events[3].b, 3.5, 0.0);
+
+    /** A smaller buffer gets the most recent events */
+    CHECK_EQ_U64(AnimTrace_Snapshot(g_events, 3), 3);
+    CHECK_EQ_U64(g_events[0].value, 7);
+    CHECK_EQ_U64(g_events[2].value, 9);
+
+    CHECK_EQ_U64(AnimTrace_Snapshot(NULL, 4), 0);
+    CHECK_EQ_U64(AnimTrace_Snapshot(g_events, 0), 0);
+
+    AnimTraceSummary summary;
+    AnimTrace_Summarize(g_events, 0, 100.0, 0.0, &summary);
+    CHECK_EQ_U64(summary.overwritten, 0);
+
+    /** Reset hides everything recorded so far */
+    AnimTrace_Reset();
+    CHECK_EQ_U64(AnimTrace_Snapshot(g_events, ANIM_TRACE_CAPACITY), 0);
+}
+
+static void TestWraparound(void) {
+    AnimTrace_Reset();
+    const int total = ANIM_TRACE_CAPACITY + 10;
+    for (int i = 0; i < total; ++i) {
+        AnimTrace_Record(ANIM_TRACE_FRAME, (double)i, 0.0, 0.0, i);
+    }
+
+    /** Only the last CAPACITY events survive, still in recording order */
+    size_t count = AnimTrace_Snapshot(g_events, ANIM_TRACE_CAPACITY + 16);
+    CHECK_EQ_U64(count, ANIM_TRACE_CAPACITY);
+    int ordered = 1;
+    for (size_t i = 0; i < count; ++i) {
+        if (g_events[i].value != (int32_t)(total - ANIM_TRACE_CAPACITY + i)) ordered = 0;
+    }
+    CHECK(ordered);
+    CHECK_EQ_U64(g_events[0].value, 10);
+    CHECK_EQ_U64(g_events[count - 1].value, total - 1);
+
+    AnimTraceSummary summary;
+    AnimTrace_Summarize(g_events, count, 100.0, 0.0, &summary);
+    CHECK_EQ_U64(summary.overwritten, 10);
+    CHECK_EQ_U64(summary.frames, ANIM_TRACE_CAPACITY);
+    CHECK_NEAR(summary.spanMs, ANIM_TRACE_CAPACITY - 1, 0.0);
+
+    AnimTrace_Reset();
+    AnimTrace_Summarize(g_events, 0, 100.0, 0.0, &summary);
+    CHECK_EQ_U64(summary.overwritten, 0);
+}
+
+static void TestLatenessPercentiles(void) {
+    /** Lateness 1..100 ms in scrambled order, plus an early wake that clamps to 0 */
+    AnimTraceEvent events[101];
+    memset(events, 0, sizeof(events));
+    for (int i = 0; i < 100; ++i) {
+        int late = (i * 37) % 100 + 1;
+        events[i].kind = ANIM_TRACE_FRAME;
+        events[i].timeMs = (double)i;
+        events[i].a = 1000.0;
+        events[i].b = 1000.0 + late;
+    }
+    AnimTraceSummary summary;
+    AnimTrace_Summarize(events, 100, 100.0, 0.0, &summary);
+    CHECK_EQ_U64(summary.frames, 100);
+    CHECK_NEAR(summary.latenessP50, 50.0, 0.0);
+    CHECK_NEAR(summary.latenessP95, 95.0, 0.0);
+    CHECK_NEAR(summary.latenessP99, 99.0, 0.0);
+    CHECK_NEAR(summary.latenessMax, 100.0, 0.0);
+    CHECK_NEAR(summary.spanMs, 99.0, 0.0);
+
+    events[100].kind = ANIM_TRACE_FRAME;
+    events[100].timeMs = 100.0;
+    events[100].a = 50.0;
+    events[100].b = 40.0;
+    AnimTrace_Summarize(events, 101, 100.0, 0.0, &summary);
+    CHECK_EQ_U64(summary.frames, 101);
+    CHECK_NEAR(summary.latenessP50, 50.0, 0.0);                         /**< rank 51 of {0, 1..100} */
+    CHECK_NEAR(summary.latenessMax, 100.0, 0.0);
+
+    /** Tray updates: latency only for posted ones, failures counted */
+    AnimTraceEvent updates[4];
+    memset(updates, 0, sizeof(updates));
+    for (int i = 0; i < 4; ++i) {
+        updates[i].kind = ANIM_TRACE_TRAY_UPDATE;
+        updates[i].timeMs = 100.0 + 10.0 * i;
+        updates[i].a = (i == 3) ? 0.0 : updates[i].timeMs - (i + 1);   /**< 1, 2, 3 ms; last is direct */
+        updates[i].b = 0.5 * (i + 1);
+        updates[i].value = (i == 1) ? 0 : 1;
+    }
+    AnimTrace_Summarize(updates, 4, 100.0, 0.0, &summary);
+    CHECK_EQ_U64(summary.trayUpdates, 4);
+    CHECK_EQ_U64(summary.trayUpdateFailures, 1);
+    CHECK_NEAR(summary.updateLatencyP50, 2.0, 1e-9);
+    CHECK_NEAR(summary.updateLatencyP99, 3.0, 1e-9);
+    CHECK_NEAR(summary.shellCallP95, 2.0, 0.0);
+}
+
+static void SetInterval(AnimTraceEvent* ev, double timeMs, double from, double to) {
+    memset(ev, 0, sizeof(*ev));
+    ev->kind = ANIM_TRACE_INTERVAL;
+    ev->timeMs = timeMs;
+    ev->a = from;
+    ev->b = to;
+}
+
+static void TestThrottleAccumulation(void) {
+    AnimTraceEvent events[6];
+    SetInterval(&events[0], 10.0, 100.0, 200.0);    /**< Throttled from 10 */
+    SetInterval(&events[1], 20.0, 200.0, 300.0);    /**< Still throttled: no new start */
+    SetInterval(&events[2], 50.0, 300.0, 100.0);    /**< Back to base: 40 ms */
+    SetInterval(&events[3], 60.0, 100.0, 80.0);     /**< Below base is not throttling */
+    SetInterval(&events[4], 70.0, 80.0, 250.0);     /**< Throttled from 70 */
+    memset(&events[5], 0, sizeof(events[5]));
+    events[5].kind = ANIM_TRACE_FALLBACK;
+    events[5].timeMs = 90.0;
+
+    AnimTraceSummary summary;
+    AnimTrace_Summarize(events, 6, 100.0, 0.0, &summary);
+    CHECK_EQ_U64(summary.intervalChanges, 5);
+    CHECK_EQ_U64(summary.fallbacks, 1);
+    CHECK_NEAR(summary.throttledMs, 40.0 + 20.0, 1e-9);                 /**< Open period closed at the last event */
+    CHECK_NEAR(summary.spanMs, 80.0, 1e-9);
+
+    AnimTrace_Summarize(events, 6, 100.0, 130.0, &summary);
+    CHECK_NEAR(summary.throttledMs, 40.0 + 60.0, 1e-9);                 /**< ... or at endMs */
+    CHECK_NEAR(summary.spanMs, 120.0, 1e-9);
+
+    /** A higher base makes the 200/250 spacings unthrottled */
+    AnimTrace_Summarize(events, 6, 250.0, 130.0, &summary);
+    CHECK_NEAR(summary.throttledMs, 30.0, 1e-9);                        /**< Only the 300 ms stretch, 20..50 */
+}
+
+static void TestCsv(void) {
+    AnimTrace_Reset();
+    AnimTrace_Record(ANIM_TRACE_FRAME, 1.0, 0.0, 2.0, 0);
+    AnimTrace_Record(ANIM_TRACE_TRAY_UPDATE, 2.0, 1.5, 0.25, 1);
+    AnimTrace_Record(ANIM_TRACE_INTERVAL, 3.0, 100.0, 200.0, 0);
+    AnimTrace_Record(ANIM_TRACE_SPEED, 4.0, 1.0, 2.0, 0);
+    AnimTrace_Record(ANIM_TRACE_UPDATE_FAILED, 5.0, 0.0, 0.0, 3);
+
+    FILE* f = tmpfile();
+    CHECK(f != NULL);
+    if (!f) return;
+
+    AnimTraceSummary summary;
+    CHECK(AnimTrace_WriteCsv(f, 100.0, 10.0, &summary) == 0);
+    CHECK_EQ_U64(summary.frames, 1);
+    CHECK_EQ_U64(summary.trayUpdates, 1);
+    CHECK_NEAR(summary.throttledMs, 7.0, 1e-9);
+
+    rewind(f);
+    char line[256];
+    int comments = 0, headers = 0, rows = 0, sawUpdate = 0;
+    while (fgets(line, sizeof(line), f)) {
+        if (line[0] == '#') {
+            CHECK(headers == 0);                                        /**< Summary precedes the table */
+            comments++;
+        } else if (strcmp(line, "time_ms,event,a,b,value\n") == 0) {
+            headers++;
+        } else {
+            CHECK(headers == 1);
+            rows++;
+            if (strcmp(line, "2.000,tray_update,1.500,0.250,1\n") == 0) sawUpdate = 1;
+        }
+    }
+    fclose(f);
+    CHECK_EQ_U64(comments, 4);
+    CHECK_EQ_U64(headers, 1);
+    CHECK_EQ_U64(rows, 5);
+    CHECK(sawUpdate);
+    CHECK(AnimTrace_WriteCsv(NULL, 100.0, 0.0, NULL) == -1);
+
+    AnimTrace_Reset();
+}
+
+int main(void) {
+    TestPartialFill();
+    TestWraparound();
+    TestLatenessPercentiles();
+    TestThrottleAccumulation();
+    TestCsv();
+    return TEST_RESULT();
+}
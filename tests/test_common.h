@@ -0,0 +1,59 @@
+/**
+ * @file test_common.h
+ * @brief Minimal check macros and timing helpers for the host-side tests
+ *
+ * Each test is one executable: checks record failures and keep going, and
+ * main returns TEST_RESULT() so ctest sees a non-zero exit on any failure.
+ */
+
+#ifndef TEST_COMMON_H
+#define TEST_COMMON_H
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+static int g_testFailures = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { \
+        fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+        g_testFailures++; \
+    } \
+} while (0)
+
+#define CHECK_EQ_U64(actual, expected) do { \
+    unsigned long long _a = (unsigned long long)(actual); \
+    unsigned long long _e = (unsigned long long)(expected); \
+    if (_a != _e) { \
+        fprintf(stderr, "%s:%d: %s == %llu, expected %llu\n", __FILE__, __LINE__, #actual, _a, _e); \
+        g_testFailures++; \
+    } \
+} while (0)
+
+#define CHECK_NEAR(actual, expected, tolerance) do { \
+    double _a = (double)(actual); \
+    double _e = (double)(expected); \
+    if (!(fabs(_a - _e) <= (tolerance))) { \
+        fprintf(stderr, "%s:%d: %s == %.9g, expected %.9g (+/- %g)\n", \
+                __FILE__, __LINE__, #actual, _a, _e, (double)(tolerance)); \
+        g_testFailures++; \
+    } \
+} while (0)
+
+#define TEST_RESULT() (g_testFailures == 0 ? 0 : (fprintf(stderr, "%d check(s) failed\n", g_testFailures), 1))
+
+/** @brief Monotonic time in nanoseconds */
+static inline uint64_t TestNowNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/** @brief Keep a value alive so the optimiser cannot drop the work behind it */
+static inline void TestKeep(const void* p) {
+    __asm__ __volatile__("" : : "g"(p) : "memory");
+}
+
+#endif
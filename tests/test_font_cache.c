@@ -0,0 +1,219 @@
+/**
+ * @file test_font_cache.c
+ * @brief Font cache table: key order, field splitting and the TSV file format
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "test_common.h"
+#include "font_cache_table.h"
+
+static FontMetadata Metadata(const char* family, const char* style, uint16_t fsType) {
+    FontMetadata m;
+    memset(&m, 0, sizeof(m));
+    snprintf(m.family, sizeof(m.family), "%s", family);
+    snprintf(m.style, sizeof(m.style), "%s", style);
+    m.fsType = fsType;
+    return m;
+}
+
+/** @brief A temporary file holding text, rewound for reading */
+static FILE* FileWithText(const char* text) {
+    FILE* f = tmpfile();
+    if (!f) return NULL;
+    fputs(text, f);
+    rewind(f);
+    return f;
+}
+
+static void TestFindOrdering(void) {
+    FontCacheTable table = {0};
+    FontMetadata m = Metadata("F", "Regular", 0);
+    static const char* const kKeys[] = {"b.ttf", "A.ttf", "c\\Z.otf", "a_.ttf", "C\\y.otf", "_x.ttf"};
+    for (size_t i = 0; i < sizeof(kKeys) / sizeof(kKeys[0]); ++i) {
+        CHECK(FontCacheTable_Put(&table, kKeys[i], i, i, &m));
+    }
+    CHECK_EQ_U64(table.count, 6);
+
+    /** Sorted case-insensitively; letters fold to lower case, so '_' sorts before them */
+    static const char* const kSorted[] = {"_x.ttf", "A.ttf", "a_.ttf", "b.ttf", "C\\y.otf", "c\\Z.otf"};
+    int ordered = 1;
+    for (int i = 0; i < table.count; ++i) {
+        if (strcmp(table.entries[i].key, kSorted[i]) != 0) ordered = 0;
+    }
+    CHECK(ordered);
+
+    /** Lookups ignore case; misses report the insertion point */
+    int index = -1;
+    CHECK(FontCacheTable_Find(&table, "B.TTF", &index));
+    CHECK_EQ_U64(index, 3);
+    CHECK(FontCacheTable_Find(&table, "c\\z.OTF", &index));
+    CHECK_EQ_U64(index, 5);
+    CHECK(!FontCacheTable_Find(&table, "0.ttf", &index));
+    CHECK_EQ_U64(index, 0);
+    CHECK(!FontCacheTable_Find(&table, "bb.ttf", &index));
+    CHECK_EQ_U64(index, 4);
+    CHECK(!FontCacheTable_Find(&table, "~", &index));
+    CHECK_EQ_U64(index, 6);
+
+    /** A key differing only in case replaces the entry and keeps the first spelling */
+    FontMetadata bold = Metadata("F", "Bold", 8);
+    CHECK(FontCacheTable_Put(&table, "B.TTF", 99, 100, &bold));
+    CHECK_EQ_U64(table.count, 6);
+    CHECK(strcmp(table.entries[3].key, "b.ttf") == 0);
+    CHECK_EQ_U64(table.entries[3].size, 99);
+    CHECK(strcmp(table.entries[3].metadata.style, "Bold") == 0);
+
+    FontCacheTable_RemoveAt(&table, 0);
+    FontCacheTable_RemoveAt(&table, table.count - 1);
+    CHECK_EQ_U64(table.count, 4);
+    CHECK(strcmp(table.entries[0].key, "A.ttf") == 0);
+    CHECK(strcmp(table.entries[3].key, "C\\y.otf") == 0);
+
+    FontCacheTable_Clear(&table);
+    CHECK_EQ_U64(table.count, 0);
+    CHECK(table.entries == NULL);
+    CHECK(!FontCacheTable_Find(&table, "a", &index));
+    CHECK_EQ_U64(index, 0);
+}
+
+static void TestSplitFields(void) {
+    char* fields[FONT_CACHE_FIELD_COUNT];
+
+    char full[] = "1\t2\t3\tkey\tfamily\tstyle\r\n";
+    CHECK_EQ_U64(FontCacheTable_SplitFields(full, fields, FONT_CACHE_FIELD_COUNT), 6);
+    CHECK(strcmp(fields[3], "key") == 0);
+    CHECK(strcmp(fields[5], "style") == 0);                             /**< Line ending stripped */
+
+    /** Missing fields: fewer than asked for */
+    char missing[] = "1\t2\t3\tkey\n";
+    CHECK_EQ_U64(FontCacheTable_SplitFields(missing, fields, FONT_CACHE_FIELD_COUNT), 4);
+    CHECK(strcmp(fields[3], "key") == 0);
+
+    /** Extra tabs stay in the last field */
+    char extra[] = "1\t2\t3\tkey\tfamily\tstyle\twith\ttabs";
+    CHECK_EQ_U64(FontCacheTable_SplitFields(extra, fields, FONT_CACHE_FIELD_COUNT), 6);
+    CHECK(strcmp(fields[5], "style\twith\ttabs") == 0);
+
+    /** Empty key and empty trailing fields are still fields */
+    char emptyKey[] = "1\t2\t3\t\t\t";
+    CHECK_EQ_U64(FontCacheTable_SplitFields(emptyKey, fields, FONT_CACHE_FIELD_COUNT), 6);
+    CHECK(fields[3][0] == '\0');
+    CHECK(fields[5][0] == '\0');
+
+    char empty[] = "\n";
+    CHECK_EQ_U64(FontCacheTable_SplitFields(empty, fields, FONT_CACHE_FIELD_COUNT), 1);
+    CHECK(fields[0][0] == '\0');
+}
+
+static void TestHeaderCheck(void) {
+    static const char* const kBadFiles[] = {
+        "",
+        "catime-font-cache 0\n1\t2\t3\tkey\tfamily\tstyle\n",
+        "1\t2\t3\tkey\tfamily\tstyle\n",
+    };
+    for (size_t i = 0; i < sizeof(kBadFiles) / sizeof(kBadFiles[0]); ++i) {
+        FILE* f = FileWithText(kBadFiles[i]);
+        CHECK(f != NULL);
+        if (!f) continue;
+        FontCacheTable table = {0};
+        CHECK(FontCacheTable_Read(&table, f) == -1);
+        CHECK_EQ_U64(table.count, 0);                                   /**< Nothing read past a bad header */
+        fclose(f);
+    }
+
+    FILE* f = FileWithText(FONT_CACHE_HEADER "\n");
+    CHECK(f != NULL);
+    if (!f) return;
+    FontCacheTable table = {0};
+    CHECK(FontCacheTable_Read(&table, f) == 0);
+    CHECK_EQ_U64(table.count, 0);
+    fclose(f);
+}
+
+static void TestMalformedLines(void) {
+    char longLine[FONT_CACHE_LINE_MAX + 200];
+    memset(longLine, 'x', sizeof(longLine));
+    memcpy(longLine, "1\t2\t3\tlong.ttf\tfamily\t", 22);
+    longLine[sizeof(longLine) - 2] = '\n';
+    longLine[sizeof(longLine) - 1] = '\0';
+
+    char text[4096];
+    snprintf(text, sizeof(text),
+             FONT_CACHE_HEADER "\n"
+             "10\t20\t0\tgood.ttf\tGood\tRegular\n"
+             "10\t20\t0\tshort.ttf\n"                                    /**< Missing fields */
+             "10\t20\t0\t\tNoKey\tRegular\n"                             /**< Empty key */
+             "%s"                                                        /**< Overlong */
+             "11\t21\t4\tlast.ttf\tLast\tBold\twith tab",                /**< Extra tab, no final newline */
+             longLine);
+
+    FILE* f = FileWithText(text);
+    CHECK(f != NULL);
+    if (!f) return;
+    FontCacheTable table = {0};
+    CHECK(FontCacheTable_Read(&table, f) == 3);
+    fclose(f);
+
+    CHECK_EQ_U64(table.count, 2);
+    int index = -1;
+    CHECK(FontCacheTable_Find(&table, "good.ttf", &index));
+    CHECK(FontCacheTable_Find(&table, "last.ttf", &index));
+    CHECK(strcmp(table.entries[index].metadata.style, "Bold with tab") == 0);   /**< Tab folded to a space */
+    CHECK_EQ_U64(table.entries[index].metadata.fsType, 4);
+    CHECK(!FontCacheTable_Find(&table, "long.ttf", &index));
+    FontCacheTable_Clear(&table);
+}
+
+static void TestRoundTrip(void) {
+    FontCacheTable table = {0};
+    FontMetadata regular = Metadata("Noto Sans", "Regular", 0);
+    FontMetadata tabbed = Metadata("Tab\tFamily", "Line\nStyle", 0x0208);
+    CHECK(FontCacheTable_Put(&table, "fonts\\Noto.ttf", 123456, 0x01D9A1B2C3D4E5F6ull, &regular));
+    CHECK(FontCacheTable_Put(&table, "C:\\Windows\\Fonts\\odd.otf", UINT64_MAX, 0, &tabbed));
+    CHECK(FontCacheTable_Put(&table, "empty-style.ttf", 1, 2, &(FontMetadata){"Only Family", "", 65535}));
+
+    FILE* f = tmpfile();
+    CHECK(f != NULL);
+    if (!f) {
+        FontCacheTable_Clear(&table);
+        return;
+    }
+    CHECK(FontCacheTable_Write(&table, f));
+    rewind(f);
+
+    FontCacheTable loaded = {0};
+    CHECK(FontCacheTable_Read(&loaded, f) == 0);
+    fclose(f);
+
+    CHECK_EQ_U64(loaded.count, table.count);
+    for (int i = 0; i < table.count && i < loaded.count; ++i) {
+        const FontCacheEntry* a = &table.entries[i];
+        const FontCacheEntry* b = &loaded.entries[i];
+        CHECK(strcmp(a->key, b->key) == 0);
+        CHECK_EQ_U64(b->size, a->size);
+        CHECK_EQ_U64(b->lastWrite, a->lastWrite);
+        CHECK_EQ_U64(b->metadata.fsType, a->metadata.fsType);
+        CHECK(strcmp(a->metadata.family, b->metadata.family) == 0);
+        CHECK(strcmp(a->metadata.style, b->metadata.style) == 0);
+    }
+
+    int index = -1;
+    CHECK(FontCacheTable_Find(&loaded, "c:\\windows\\fonts\\ODD.otf", &index));
+    CHECK(strcmp(loaded.entries[index].metadata.family, "Tab Family") == 0);
+    CHECK(strcmp(loaded.entries[index].metadata.style, "Line Style") == 0);
+    CHECK_EQ_U64(loaded.entries[index].size, UINT64_MAX);
+
+    FontCacheTable_Clear(&table);
+    FontCacheTable_Clear(&loaded);
+}
+
+int main(void) {
+    TestFindOrdering();
+    TestSplitFields();
+    TestHeaderCheck();
+    TestMalformedLines();
+    TestRoundTrip();
+    return TEST_RESULT();
+}
@@ -0,0 +1,213 @@
+/**
+ * @file test_frame_arena.c
+ * @brief Size-class selection, free-list reuse, cache caps and scratch arenas
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "test_common.h"
+#include "frame_arena.h"
+
+/** @brief Start every case from an empty cache and zeroed counters */
+static void ResetArena(void) {
+    FrameArena_Trim();
+    FrameArena_ResetStats();
+}
+
+static void TestClassSelection(void) {
+    ResetArena();
+
+    /** Class boundaries: 4 KB, then quarter steps of each power of two */
+    static const struct { size_t request; size_t block; } kCases[] = {
+        {1, 4096}, {4096, 4096}, {4097, 5120}, {5120, 5120}, {5121, 6144},
+        {7168, 7168}, {7169, 8192}, {8192, 8192}, {8193, 10240},
+        {600 * 600 * 4, 1536 * 1024},                           /**< 600x600 canvas */
+        {1024 * 1024, 1024 * 1024}, {1024 * 1024 + 1, 1280 * 1024},
+        {FRAME_ARENA_MAX_CLASS_SIZE, FRAME_ARENA_MAX_CLASS_SIZE},
+    };
+    for (size_t i = 0; i < sizeof(kCases) / sizeof(kCases[0]); ++i) {
+        void* p = FrameArena_Alloc(kCases[i].request);
+        CHECK(p != NULL);
+        CHECK_EQ_U64(FrameArena_BlockSize(p), kCases[i].block);
+        CHECK(((uintptr_t)p & 15) == 0);
+        memset(p, 0xAB, kCases[i].request);
+        FrameArena_Free(p);
+    }
+
+    /** Every request lands in the smallest class that fits, with at most 20% slack */
+    size_t previousBlock = 0;
+    for (size_t size = 4096; size <= FRAME_ARENA_MAX_CLASS_SIZE; size += size / 7 + 1) {
+        void* p = FrameArena_Alloc(size);
+        size_t block = FrameArena_BlockSize(p);
+        CHECK(block >= size);
+        CHECK(size <= 4096 || (double)(block - size) / (double)block < 0.2);
+        CHECK(block >= previousBlock);
+        previousBlock = block;
+        FrameArena_Free(p);
+    }
+
+    /** Above the largest class: exact-size malloc, counted as oversize */
+    ResetArena();
+    void* big = FrameArena_Alloc(FRAME_ARENA_MAX_CLASS_SIZE + 1);
+    CHECK(big != NULL);
+    CHECK_EQ_U64(FrameArena_BlockSize(big), FRAME_ARENA_MAX_CLASS_SIZE + 1);
+    FrameArenaStats st;
+    FrameArena_GetStats(&st);
+    CHECK_EQ_U64(st.oversize, 1);
+    FrameArena_Free(big);
+    FrameArena_GetStats(&st);
+    CHECK_EQ_U64(st.bytesCached, 0);     /**< Oversize blocks are never cached */
+}
+
+static void TestFreeListReuse(void) {
+    ResetArena();
+
+    void* a = FrameArena_Alloc(3000);
+    FrameArena_Free(a);
+    void* b = FrameArena_Alloc(4000);    /**< Same class: the cached block comes back */
+    CHECK(a == b);
+
+    FrameArenaStats st;
+    FrameArena_GetStats(&st);
+    CHECK_EQ_U64(st.misses, 1);
+    CHECK_EQ_U64(st.hits, 1);
+    CHECK_EQ_U64(st.frees, 1);
+    CHECK_EQ_U64(st.bytesInUse, 4096);
+    CHECK_EQ_U64(st.requestedInUse, 4000);
+    CHECK_NEAR(st.fragmentation, 1.0 - 4000.0 / 4096.0, 1e-9);
+
+    void* c = FrameArena_Alloc(5000);    /**< Different class: no reuse */
+    CHECK(c != b);
+    FrameArena_GetStats(&st);
+    CHECK_EQ_U64(st.peakBytesInUse, 4096 + 5120);
+
+    FrameArena_Free(b);
+    FrameArena_Free(c);
+    FrameArena_GetStats(&st);
+    CHECK_EQ_U64(st.bytesInUse, 0);
+    CHECK_EQ_U64(st.requestedInUse, 0);
+    CHECK_EQ_U64(st.bytesCached, 4096 + 5120);
+    CHECK_NEAR(st.fragmentation, 0.0, 0.0);
+
+    FrameArena_ResetStats();
+    FrameArena_GetStats(&st);
+    CHECK_EQ_U64(st.hits, 0);
+    CHECK_EQ_U64(st.misses, 0);
+    CHECK_EQ_U64(st.peakBytesInUse, 0);
+    CHECK_EQ_U64(st.bytesCached, 4096 + 5120);   /**< Gauges survive a stats reset */
+
+    FrameArena_Trim();
+    FrameArena_GetStats(&st);
+    CHECK_EQ_U64(st.bytesCached, 0);
+
+    unsigned char* z = (unsigned char*)FrameArena_Calloc(1000);
+    int allZero = 1;
+    for (int i = 0; i < 1000; ++i) allZero &= (z[i] == 0);
+    CHECK(allZero);
+    FrameArena_Free(z);
+    FrameArena_Free(NULL);
+}
+
+static void TestPerClassCap(void) {
+    ResetArena();
+
+    enum { N = FRAME_ARENA_MAX_CACHED_PER_CLASS + 4 };
+    void* blocks[N];
+    for (int i = 0; i < N; ++i) blocks[i] = FrameArena_Alloc(4096);
+    for (int i = 0; i < N; ++i) FrameArena_Free(blocks[i]);
+
+    FrameArenaStats st;
+    FrameArena_GetStats(&st);
+    CHECK_EQ_U64(st.bytesCached, (size_t)FRAME_ARENA_MAX_CACHED_PER_CLASS * 4096);
+}
+
+static void TestTotalCap(void) {
+    ResetArena();
+
+    /** 8 MB blocks: four fill the 32 MB budget, the rest go back to the CRT */
+    enum { N = 6 };
+    const size_t size = 8u * 1024u * 1024u;
+    void* blocks[N];
+    for (int i = 0; i < N; ++i) blocks[i] = FrameArena_Alloc(size);
+    for (int i = 0; i < N; ++i) FrameArena_Free(blocks[i]);
+
+    FrameArenaStats st;
+    FrameArena_GetStats(&st);
+    CHECK_EQ_U64(st.bytesCached, FRAME_ARENA_MAX_CACHED_BYTES);
+    CHECK(st.bytesCached <= FRAME_ARENA_MAX_CACHED_BYTES);
+
+    /** A block that would cross the budget is released even if its class list is empty */
+    void* other = FrameArena_Alloc(4096);
+    FrameArena_Free(other);
+    FrameArena_GetStats(&st);
+    CHECK_EQ_U64(st.bytesCached, FRAME_ARENA_MAX_CACHED_BYTES);
+    FrameArena_Trim();
+}
+
+static void TestScratchArena(void) {
+    ResetArena();
+
+    ScratchArena arena;
+    ScratchArena_Init(&arena, 8192);
+    CHECK_EQ_U64(arena.chunkSize, 8192);
+
+    unsigned char* a = (unsigned char*)ScratchArena_Alloc(&arena, 10);
+    unsigned char* b = (unsigned char*)ScratchArena_Alloc(&arena, 10);
+    CHECK(a != NULL && b != NULL);
+    CHECK(((uintptr_t)a & 15) == 0 && ((uintptr_t)b & 15) == 0);
+    CHECK(b == a + 16);                              /**< Bump allocation, 16-byte rounding */
+    CHECK_EQ_U64(arena.usedThisScope, 32);
+
+    /** Reset rewinds the single chunk: the next scope starts at the same address */
+    ScratchArena_Reset(&arena);
+    CHECK_EQ_U64(arena.usedThisScope, 0);
+    CHECK_EQ_U64(arena.highWater, 32);
+    CHECK(ScratchArena_Alloc(&arena, 10) == a);
+
+    /** A scope that spills into several chunks raises the high-water mark */
+    FrameArena_ResetStats();
+    size_t spilled = 16;
+    for (int i = 0; i < 6; ++i) {
+        CHECK(ScratchArena_Alloc(&arena, 6000) != NULL);
+        spilled += 6000;
+    }
+    FrameArenaStats st;
+    FrameArena_GetStats(&st);
+    CHECK(st.hits + st.misses > 1);
+    ScratchArena_Reset(&arena);
+    CHECK_EQ_U64(arena.highWater, spilled);
+    FrameArena_GetStats(&st);
+    CHECK_EQ_U64(st.bytesInUse, 0);                  /**< Spilled chunks are dropped */
+
+    /** The next scope gets one chunk sized to the high-water mark and fits in it */
+    FrameArena_ResetStats();
+    for (int i = 0; i < 6; ++i) CHECK(ScratchArena_Alloc(&arena, 6000) != NULL);
+    FrameArena_GetStats(&st);
+    CHECK_EQ_U64(st.hits + st.misses, 1);
+    size_t chunkBytes = st.bytesInUse;
+    CHECK(chunkBytes >= spilled);
+    ScratchArena_Reset(&arena);
+    FrameArena_GetStats(&st);
+    CHECK_EQ_U64(st.bytesInUse, chunkBytes);         /**< A single chunk is kept for reuse */
+
+    /** Chunks come from the block allocator and return to it */
+    ScratchArena_Release(&arena);
+    FrameArena_GetStats(&st);
+    CHECK_EQ_U64(st.bytesInUse, 0);
+    CHECK_EQ_U64(arena.highWater, 0);
+
+    ScratchArena_Init(&arena, 0);
+    CHECK_EQ_U64(arena.chunkSize, SCRATCH_ARENA_DEFAULT_CHUNK);
+    ScratchArena_Release(&arena);
+}
+
+int main(void) {
+    TestClassSelection();
+    TestFreeListReuse();
+    TestPerClassCap();
+    TestTotalCap();
+    TestScratchArena();
+    FrameArena_Trim();
+    return TEST_RESULT();
+}
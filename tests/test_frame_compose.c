@@ -0,0 +1,231 @@
+/**
+ * @file test_frame_compose.c
+ * @brief Compositor conformance against fixtures with expected PBGRA canvases
+ *
+ * Each fixture under fixtures/frame_compose/ is a line-oriented script:
+ *
+ *   canvas <width> <height>
+ *   frame <left> <top> <width> <height> <over|source> <none|background|previous>
+ *   <height rows of width pixels>
+ *   expect <dirty left> <dirty top> <dirty width> <dirty height>
+ *   <canvas height rows of canvas width pixels>
+ *
+ * Pixels are the four PBGRA bytes in memory order as hex ("0000ffff" is
+ * opaque red), "." is transparent, and "#" starts a comment line. Frames
+ * are fed with a padded source stride so row addressing is checked too.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "test_common.h"
+#include "frame_compose.h"
+#include "frame_arena.h"
+
+#ifndef FIXTURE_DIR
+#define FIXTURE_DIR "fixtures"
+#endif
+
+#define MAX_LINE 1024
+#define SOURCE_STRIDE_PAD 12    /**< Extra bytes after each source row */
+
+typedef struct {
+    FILE* file;
+    const char* path;
+    int line;
+    char text[MAX_LINE];
+} FixtureReader;
+
+/** @brief Next non-empty, non-comment line; NULL at end of file */
+static char* NextLine(FixtureReader* r) {
+    while (fgets(r->text, sizeof(r->text), r->file)) {
+        r->line++;
+        char* s = r->text;
+        while (*s == ' ' || *s == '\t') s++;
+        if (*s == '\0' || *s == '\n' || *s == '\r' || *s == '#') continue;
+        return s;
+    }
+    return NULL;
+}
+
+static int ParsePixel(const char* token, uint8_t out[4]) {
+    if (strcmp(token, ".") == 0) {
+        memset(out, 0, 4);
+        return 1;
+    }
+    if (strlen(token) != 8) return 0;
+    for (int i = 0; i < 4; ++i) {
+        char byte[3] = {token[i * 2], token[i * 2 + 1], '\0'};
+        char* end = NULL;
+        unsigned long v = strtoul(byte, &end, 16);
+        if (*end != '\0') return 0;
+        out[i] = (uint8_t)v;
+    }
+    return 1;
+}
+
+/** @brief Read one row of exactly count pixels into dst */
+static int ReadPixelRow(FixtureReader* r, uint8_t* dst, uint32_t count) {
+    char* line = NextLine(r);
+    if (!line) return 0;
+    uint32_t n = 0;
+    for (char* tok = strtok(line, " \t\r\n"); tok; tok = strtok(NULL, " \t\r\n")) {
+        if (n >= count || !ParsePixel(tok, dst + (size_t)n * 4)) return 0;
+        n++;
+    }
+    return n == count;
+}
+
+static int ParseBlend(const char* s, FrameBlendMode* out) {
+    if (strcmp(s, "over") == 0) { *out = FRAME_BLEND_OVER; return 1; }
+    if (strcmp(s, "source") == 0) { *out = FRAME_BLEND_SOURCE; return 1; }
+    return 0;
+}
+
+static int ParseDispose(const char* s, FrameDisposeMode* out) {
+    if (strcmp(s, "none") == 0) { *out = FRAME_DISPOSE_NONE; return 1; }
+    if (strcmp(s, "background") == 0) { *out = FRAME_DISPOSE_BACKGROUND; return 1; }
+    if (strcmp(s, "previous") == 0) { *out = FRAME_DISPOSE_PREVIOUS; return 1; }
+    return 0;
+}
+
+static void ReportMismatch(const FixtureReader* r, int frame, const uint8_t* canvas,
+                           const uint8_t* expected, uint32_t width, uint32_t height) {
+    fprintf(stderr, "%s: frame %d (expect ending line %d): canvas differs\n", r->path, frame, r->line);
+    for (uint32_t y = 0; y < height; ++y) {
+        for (uint32_t x = 0; x < width; ++x) {
+            const uint8_t* a = canvas + ((size_t)y * width + x) * 4;
+            const uint8_t* e = expected + ((size_t)y * width + x) * 4;
+            if (memcmp(a, e, 4) != 0) {
+                fprintf(stderr, "  (%u,%u): got %02x%02x%02x%02x, expected %02x%02x%02x%02x\n",
+                        x, y, a[0], a[1], a[2], a[3], e[0], e[1], e[2], e[3]);
+            }
+        }
+    }
+}
+
+/** @return Number of frames checked, or -1 if the fixture is malformed */
+static int RunFixture(const char* name) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s/%s", FIXTURE_DIR, name);
+    FixtureReader r = {fopen(path, "r"), path, 0, {0}};
+    if (!r.file) {
+        fprintf(stderr, "%s: cannot open\n", path);
+        return -1;
+    }
+
+    FrameCompositor comp;
+    uint8_t* canvas = NULL;
+    uint8_t* expected = NULL;
+    uint32_t width = 0, height = 0;
+    int frames = 0;
+    int ok = 1;
+    char* line;
+
+    while (ok && (line = NextLine(&r)) != NULL) {
+        char word[16];
+        if (sscanf(line, "canvas %u %u", &width, &height) == 2) {
+            if (canvas) FrameCompositor_Release(&comp);
+            free(canvas);
+            free(expected);
+            canvas = (uint8_t*)malloc((size_t)width * height * 4);
+            expected = (uint8_t*)malloc((size_t)width * height * 4);
+            if (!canvas || !expected) { ok = 0; break; }
+            FrameCompositor_Init(&comp, canvas, width, height);
+            continue;
+        }
+
+        FrameRect rect;
+        char blendName[16], disposeName[16];
+        FrameBlendMode blend;
+        FrameDisposeMode dispose;
+        if (!canvas || sscanf(line, "%15s", word) != 1 || strcmp(word, "frame") != 0 ||
+            sscanf(line, "frame %u %u %u %u %15s %15s", &rect.left, &rect.top, &rect.width, &rect.height,
+                   blendName, disposeName) != 6 ||
+            !ParseBlend(blendName, &blend) || !ParseDispose(disposeName, &dispose)) {
+            ok = 0;
+            break;
+        }
+
+        size_t stride = (size_t)rect.width * 4 + SOURCE_STRIDE_PAD;
+        uint8_t* src = (uint8_t*)malloc(stride * (rect.height ? rect.height : 1));
+        if (!src) { ok = 0; break; }
+        memset(src, 0xCD, stride * (rect.height ? rect.height : 1));
+        for (uint32_t y = 0; y < rect.height && ok; ++y) {
+            ok = ReadPixelRow(&r, src + y * stride, rect.width);
+        }
+
+        FrameRect dirty;
+        line = ok ? NextLine(&r) : NULL;
+        if (!line || sscanf(line, "expect %u %u %u %u", &dirty.left, &dirty.top, &dirty.width, &dirty.height) != 4) {
+            ok = 0;
+        }
+        for (uint32_t y = 0; y < height && ok; ++y) {
+            ok = ReadPixelRow(&r, expected + (size_t)y * width * 4, width);
+        }
+        if (!ok) {
+            free(src);
+            break;
+        }
+
+        frames++;
+        CHECK(FrameCompositor_Apply(&comp, src, stride, rect, blend, dispose) == 0);
+        free(src);
+
+        if (memcmp(canvas, expected, (size_t)width * height * 4) != 0) {
+            ReportMismatch(&r, frames, canvas, expected, width, height);
+            g_testFailures++;
+        }
+        if (memcmp(&comp.dirty, &dirty, sizeof(dirty)) != 0) {
+            fprintf(stderr, "%s: frame %d: dirty %u,%u %ux%u, expected %u,%u %ux%u\n", path, frames,
+                    comp.dirty.left, comp.dirty.top, comp.dirty.width, comp.dirty.height,
+                    dirty.left, dirty.top, dirty.width, dirty.height);
+            g_testFailures++;
+        }
+    }
+
+    if (!ok) fprintf(stderr, "%s:%d: malformed fixture\n", path, r.line);
+    if (canvas) FrameCompositor_Release(&comp);
+    free(canvas);
+    free(expected);
+    fclose(r.file);
+    return ok ? frames : -1;
+}
+
+/** @brief Opaque/transparent fast paths must agree with the general blend */
+static void TestBlendRowMatchesFormula(void) {
+    uint8_t dst[256 * 4], src[256 * 4];
+    for (int a = 0; a < 256; ++a) {
+        for (int i = 0; i < 256; ++i) {
+            uint8_t* d = dst + i * 4;
+            uint8_t* s = src + i * 4;
+            d[0] = (uint8_t)i; d[1] = (uint8_t)(255 - i); d[2] = (uint8_t)(i / 2); d[3] = 255;
+            s[0] = (uint8_t)(a * i / 255); s[1] = (uint8_t)(a / 2); s[2] = (uint8_t)a; s[3] = (uint8_t)a;
+        }
+        uint8_t before[256 * 4];
+        memcpy(before, dst, sizeof(dst));
+        FrameCompose_BlendRowOver(dst, src, 256);
+        for (int i = 0; i < 256 * 4; ++i) {
+            int c = i & 3;
+            unsigned expect = src[i] + (unsigned)((before[i] * (255 - a) * 2 + 255) / 510);
+            if (expect > 255) expect = 255;
+            if (dst[i] != expect) {
+                fprintf(stderr, "alpha %d pixel %d channel %d: got %u, expected %u\n", a, i / 4, c, dst[i], expect);
+                g_testFailures++;
+                return;
+            }
+        }
+    }
+}
+
+int main(void) {
+    static const char* const kFixtures[] = {"dispose.txt", "blend.txt", "clip.txt"};
+    for (size_t i = 0; i < sizeof(kFixtures) / sizeof(kFixtures[0]); ++i) {
+        int frames = RunFixture(kFixtures[i]);
+        CHECK(frames > 0);
+        if (frames > 0) printf("%s: %d frames\n", kFixtures[i], frames);
+    }
+    TestBlendRowMatchesFormula();
+    FrameArena_Trim();
+    return TEST_RESULT();
+}
@@ -0,0 +1,294 @@
+/**
+ * @file test_log_binary.c
+ * @brief Binary log round trip: encode arguments, decode, compare with printf
+ *
+ * Also writes a small .clog file and runs catime-logdump on it, so the
+ * decoder and the file layout are covered end to end.
+ */
+
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <wchar.h>
+
+#include "test_common.h"
+#include "log_binary.h"
+
+#define ARGS_MAX 1024
+
+/* ============================================================================
+ * Helpers
+ * ============================================================================ */
+
+/** @brief Intern and encode like the logger does, returns bytes or LOG_BINARY_ENCODE_FAILED */
+static size_t EncodeV(uint8_t* out, size_t capacity, const char* format, va_list args) {
+    const uint8_t* kinds = NULL;
+    uint32_t id = 0;
+    int count = LogBinary_Intern(format, &id, &kinds);
+    if (count < 0) return LOG_BINARY_ENCODE_FAILED;
+    return LogBinary_EncodeArgs(out, capacity, kinds, count, args);
+}
+
+static size_t Encode(uint8_t* out, size_t capacity, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    size_t n = EncodeV(out, capacity, format, args);
+    va_end(args);
+    return n;
+}
+
+/** @brief Decoded text must equal what vsnprintf makes of the same call */
+__attribute__((format(printf, 2, 3)))
+static void CheckRoundTrip(int line, const char* format, ...) {
+    va_list args, copy;
+    va_start(args, format);
+    va_copy(copy, args);
+
+    char expected[512];
+    vsnprintf(expected, sizeof(expected), format, copy);
+    va_end(copy);
+
+    uint8_t encoded[ARGS_MAX];
+    size_t n = EncodeV(encoded, sizeof(encoded), format, args);
+    va_end(args);
+
+    char actual[512] = "";
+    int length = (n == LOG_BINARY_ENCODE_FAILED) ? -1
+               : LogBinary_FormatRecord(format, encoded, n, actual, sizeof(actual));
+    if (length < 0 || strcmp(actual, expected) != 0 || (size_t)length != strlen(expected)) {
+        fprintf(stderr, "%s:%d: \"%s\" decoded as \"%s\" (%d), expected \"%s\"\n",
+                __FILE__, line, format, actual, length, expected);
+        g_testFailures++;
+    }
+}
+
+#define ROUND_TRIP(...) CheckRoundTrip(__LINE__, __VA_ARGS__)
+
+/* ============================================================================
+ * Tests
+ * ============================================================================ */
+
+static void TestConversions(void) {
+    ROUND_TRIP("no arguments at all");
+    ROUND_TRIP("100%% done");
+    ROUND_TRIP("%d %i %u %x %X %o", -42, 7, 3000000000u, 0xBEEFu, 0xBEEFu, 8u);
+    ROUND_TRIP("[%5d|%-5d|%05d|%+d|% d]", 42, 42, 42, 42, 42);
+    ROUND_TRIP("%hhd %hd %hhu %hu", 300, 70000, 300, 70000);
+    ROUND_TRIP("%ld %lu %lld %llu", -5L, 5UL, -9000000000LL, 18000000000000000000ULL);
+    ROUND_TRIP("%zu %zd %jd %td", (size_t)123456789, (ssize_t)-3, (intmax_t)-4, (ptrdiff_t)-5);
+    ROUND_TRIP("%#x %#o", 255u, 8u);
+    ROUND_TRIP("%.3f %e %g %10.2f %-8.1f|", 3.14159, 12345.678, 0.0001, -2.5, 1.25);
+    ROUND_TRIP("%a %E %G", 1.5, 1e-300, 1e300);
+    ROUND_TRIP("%Lf", (long double)2.75);
+    ROUND_TRIP("[%*d|%-*.*s|%.*f]", 6, 42, 8, 3, "abcdef", 2, 1.23456);
+    ROUND_TRIP("[%*d]", -6, 42);                     /**< Negative '*' width means left-aligned */
+    ROUND_TRIP("%s|%.3s|%10s|%-10s|", "text", "truncate", "right", "left");
+    ROUND_TRIP("%c%c%c", 'c', 'a', 't');
+    ROUND_TRIP("%p", (void*)(uintptr_t)0x1234abcd);
+    ROUND_TRIP("%ls and %ls", L"wide", L"");
+    ROUND_TRIP("mixed %s=%d (%.1f%%) at %p", "cpu", 87, 87.5, (void*)&TestConversions);
+}
+
+static void TestWideStringsAreUtf8(void) {
+    static const char* const kFormat = "[%ls]";
+    uint8_t encoded[ARGS_MAX];
+    size_t n = Encode(encoded, sizeof(encoded), kFormat, L"café ⏰ \U0001F408");
+    CHECK(n != LOG_BINARY_ENCODE_FAILED);
+
+    char text[128];
+    int length = LogBinary_FormatRecord(kFormat, encoded, n, text, sizeof(text));
+    CHECK(strcmp(text, "[caf\xc3\xa9 \xe2\x8f\xb0 \xf0\x9f\x90\x88]") == 0);
+    CHECK_EQ_U64(length, strlen(text));
+
+    /** NULL strings render like the CRT does instead of crashing the logger */
+    n = Encode(encoded, sizeof(encoded), "%s|%ls", (const char*)NULL, (const wchar_t*)NULL);
+    LogBinary_FormatRecord("%s|%ls", encoded, n, text, sizeof(text));
+    CHECK(strcmp(text, "(null)|(null)") == 0);
+}
+
+static void TestSignatures(void) {
+    uint8_t kinds[LOG_BINARY_MAX_ARGS];
+    CHECK_EQ_U64(LogBinary_ParseSignature("%*.*f %s %%", kinds, LOG_BINARY_MAX_ARGS), 4);
+    CHECK(kinds[0] == LOG_ARG_INT && kinds[1] == LOG_ARG_INT);
+    CHECK(kinds[2] == LOG_ARG_DOUBLE && kinds[3] == LOG_ARG_STRING);
+
+    CHECK_EQ_U64(LogBinary_ParseSignature("%I64d %I64u %Iu %S %ws", kinds, LOG_BINARY_MAX_ARGS), 5);
+    CHECK(kinds[0] == LOG_ARG_LLONG && kinds[1] == LOG_ARG_ULLONG && kinds[2] == LOG_ARG_SIZE);
+    CHECK(kinds[3] == LOG_ARG_WSTRING && kinds[4] == LOG_ARG_WSTRING);
+
+    /** Formats that cannot be encoded fall back to text in the logger */
+    CHECK(LogBinary_ParseSignature("%d%n", kinds, LOG_BINARY_MAX_ARGS) < 0);
+    CHECK(LogBinary_ParseSignature("%k", kinds, LOG_BINARY_MAX_ARGS) < 0);
+    CHECK(LogBinary_ParseSignature("trailing %", kinds, LOG_BINARY_MAX_ARGS) < 0);
+    CHECK(LogBinary_ParseSignature("%d %d %d", kinds, 2) < 0);
+
+    static const char* const kUnsupported = "%n";
+    CHECK(LogBinary_Intern(kUnsupported, NULL, NULL) < 0);
+    CHECK(LogBinary_Intern(kUnsupported, NULL, NULL) < 0);
+}
+
+static void TestInterning(void) {
+    static const char* const kFirst = "first %d";
+    static const char* const kSecond = "second %s";
+    uint32_t a = 0, b = 0, again = 0;
+    const uint8_t* kinds = NULL;
+
+    CHECK_EQ_U64(LogBinary_Intern(kFirst, &a, &kinds), 1);
+    CHECK(kinds[0] == LOG_ARG_INT);
+    CHECK_EQ_U64(LogBinary_Intern(kSecond, &b, NULL), 1);
+    CHECK(a != b);
+    CHECK_EQ_U64(LogBinary_Intern(kFirst, &again, NULL), 1);
+    CHECK_EQ_U64(again, a);                          /**< Same literal, same ID */
+    CHECK(LogBinary_FormatForId(a) == kFirst);
+    CHECK(LogBinary_FormatForId(b) == kSecond);
+    CHECK(LogBinary_FormatForId(LOG_BINARY_MAX_FORMATS) == NULL);
+}
+
+static void TestBounds(void) {
+    static const char* const kFormat = "%d %s";
+    uint8_t encoded[ARGS_MAX];
+
+    /** Integers need 8 bytes each; a record that does not fit fails as a whole */
+    CHECK(Encode(encoded, 7, kFormat, 1, "x") == LOG_BINARY_ENCODE_FAILED);
+    CHECK(Encode(encoded, 11, kFormat, 1, "x") == LOG_BINARY_ENCODE_FAILED);
+
+    /** Strings are cut to the room left instead */
+    size_t n = Encode(encoded, 14, kFormat, 1, "abcdef");
+    CHECK_EQ_U64(n, 14);
+    char text[64];
+    LogBinary_FormatRecord(kFormat, encoded, n, text, sizeof(text));
+    CHECK(strcmp(text, "1 ab") == 0);
+
+    /** Truncated or missing arguments are reported, not read past */
+    n = Encode(encoded, sizeof(encoded), kFormat, 1, "abcdef");
+    CHECK_EQ_U64(n, 8 + 4 + 6);
+    CHECK(LogBinary_FormatRecord(kFormat, encoded, n - 1, text, sizeof(text)) < 0);
+    CHECK(LogBinary_FormatRecord(kFormat, encoded, 7, text, sizeof(text)) < 0);
+    CHECK(LogBinary_FormatRecord("%d %d %d", encoded, 8, text, sizeof(text)) < 0);
+
+    /** Output is cut at outSize - 1 and stays terminated */
+    char small[6];
+    int length = LogBinary_FormatRecord(kFormat, encoded, n, small, sizeof(small));
+    CHECK_EQ_U64(length, 5);
+    CHECK(strcmp(small, "1 abc") == 0);
+}
+
+/* ============================================================================
+ * File round trip through catime-logdump
+ * ============================================================================ */
+
+/** @brief 2024-01-02 03:04:05 UTC as FILETIME */
+#define TEST_FILETIME ((1704164645ULL + 11644473600ULL) * 10000000ULL)
+
+typedef struct {
+    uint8_t data[4096];
+    size_t length;
+} FileBuffer;
+
+static void PutChunk(FileBuffer* file, LogBinaryChunkType type, const uint8_t* payload, size_t length) {
+    file->length += LogBinary_WriteChunkHeader(file->data + file->length, type, (uint32_t)length);
+    memcpy(file->data + file->length, payload, length);
+    file->length += length;
+}
+
+static void PutString(FileBuffer* file, const char* format) {
+    uint32_t id = 0;
+    LogBinary_Intern(format, &id, NULL);
+    uint8_t payload[256];
+    LogBinary_PutU32(payload, id);
+    memcpy(payload + 4, format, strlen(format));
+    PutChunk(file, LOG_BINARY_CHUNK_STRING, payload, 4 + strlen(format));
+}
+
+static void PutRecord(FileBuffer* file, uint64_t fileTime, uint8_t level, const char* format, ...) {
+    uint8_t payload[512];
+    uint32_t id = 0;
+    const uint8_t* kinds = NULL;
+    int count = LogBinary_Intern(format, &id, &kinds);
+    LogBinary_PutU64(payload, fileTime);
+    payload[8] = level;
+    LogBinary_PutU32(payload + 9, id);
+
+    va_list args;
+    va_start(args, format);
+    size_t n = LogBinary_EncodeArgs(payload + 13, sizeof(payload) - 13, kinds, count, args);
+    va_end(args);
+    CHECK(n != LOG_BINARY_ENCODE_FAILED);
+    PutChunk(file, LOG_BINARY_CHUNK_RECORD, payload, 13 + n);
+}
+
+static void PutText(FileBuffer* file, uint64_t fileTime, uint8_t level, const char* message) {
+    uint8_t payload[256];
+    LogBinary_PutU64(payload, fileTime);
+    payload[8] = level;
+    memcpy(payload + 9, message, strlen(message));
+    PutChunk(file, LOG_BINARY_CHUNK_TEXT, payload, 9 + strlen(message));
+}
+
+/** @brief Write length bytes of file, run catime-logdump on it, return its exit status */
+static int RunLogdump(const FileBuffer* file, size_t length, const char* options, char* output, size_t outputSize) {
+    char path[] = "/tmp/catime_logXXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0) return -1;
+    FILE* out = fdopen(fd, "wb");
+    fwrite(file->data, 1, length, out);
+    fclose(out);
+
+    char command[512];
+    snprintf(command, sizeof(command), "'%s' %s '%s' 2>/dev/null", LOGDUMP_PATH, options, path);
+    FILE* pipe = popen(command, "r");
+    size_t got = pipe ? fread(output, 1, outputSize - 1, pipe) : 0;
+    output[got] = '\0';
+    int status = pipe ? pclose(pipe) : -1;
+    remove(path);
+    return (status >= 0 && WIFEXITED(status)) ? WEXITSTATUS(status) : -1;
+}
+
+static void TestLogdump(void) {
+    static const char* const kStarted = "Started, version %s, %d monitors";
+    static const char* const kLoad = "CPU %.1f%%, %ls";
+
+    FileBuffer file = {{0}, 0};
+    file.length = LogBinary_WriteFileHeader(file.data);
+    PutString(&file, kStarted);
+    PutRecord(&file, TEST_FILETIME, 1, kStarted, "1.4.0", 2);
+    PutText(&file, TEST_FILETIME + 10000000ULL, 2, "plain \"text\" record");
+    PutString(&file, kLoad);
+    PutRecord(&file, TEST_FILETIME + 20000000ULL, 3, kLoad, 12.34, L"busy");
+    size_t complete = file.length;
+
+    char output[2048];
+    CHECK_EQ_U64(RunLogdump(&file, complete, "--utc", output, sizeof(output)), 0);
+    CHECK(strcmp(output,
+                 "[2024-01-02 03:04:05] [INFO] Started, version 1.4.0, 2 monitors\n"
+                 "[2024-01-02 03:04:06] [WARNING] plain \"text\" record\n"
+                 "[2024-01-02 03:04:07] [ERROR] CPU 12.3%, busy\n") == 0);
+
+    CHECK_EQ_U64(RunLogdump(&file, complete, "--json --utc", output, sizeof(output)), 0);
+    CHECK(strstr(output, "{\"time\":\"2024-01-02 03:04:05\",\"unix_ms\":1704164645000,\"level\":\"INFO\","
+                         "\"message\":\"Started, version 1.4.0, 2 monitors\","
+                         "\"format\":\"Started, version %s, %d monitors\"}\n") == output);
+    CHECK(strstr(output, "\"message\":\"plain \\\"text\\\" record\"}") != NULL);
+
+    /** A crash mid-write leaves a short last chunk: earlier records still decode */
+    CHECK_EQ_U64(RunLogdump(&file, complete - 3, "--utc", output, sizeof(output)), 1);
+    CHECK(strstr(output, "plain \"text\" record\n") != NULL);
+    CHECK(strstr(output, "CPU") == NULL);
+
+    /** Not a binary log at all */
+    FileBuffer text = {{0}, 0};
+    memcpy(text.data, "[2024-01-02] [INFO] plain text log\n", 35);
+    CHECK_EQ_U64(RunLogdump(&text, 35, "", output, sizeof(output)), 1);
+}
+
+int main(void) {
+    TestConversions();
+    TestWideStringsAreUtf8();
+    TestSignatures();
+    TestInterning();
+    TestBounds();
+    TestLogdump();
+    return TEST_RESULT();
+}
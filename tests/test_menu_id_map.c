@@ -0,0 +1,86 @@
+/**
+ * @file test_menu_id_map.c
+ * @brief Menu ID numbering, lookup bounds, range truncation and allocation failure
+ */
+
+#include <stdlib.h>
+
+#include "test_common.h"
+#include "menu_id_map.h"
+
+/** @brief Growth fails while set (MENU_ID_MAP_REALLOC points here for this test) */
+static int g_failRealloc = 0;
+
+void* TestRealloc(void* block, size_t size) {
+    return g_failRealloc ? NULL : realloc(block, size);
+}
+
+static int g_items[300];
+
+static void TestNumberingAndBounds(void) {
+    MenuIdMap map = MENU_ID_MAP_INIT(4000, 5);
+    CHECK(MenuIdMap_Lookup(&map, 4000) == NULL);            /**< Nothing recorded yet */
+
+    for (int i = 0; i < 5; ++i) {
+        CHECK_EQ_U64(MenuIdMap_Record(&map, &g_items[i]), 4000 + i);
+    }
+    CHECK(MenuIdMap_Lookup(&map, 3999) == NULL);            /**< Below base */
+    CHECK(MenuIdMap_Lookup(&map, 0) == NULL);
+    CHECK(MenuIdMap_Lookup(&map, 4000) == &g_items[0]);
+    CHECK(MenuIdMap_Lookup(&map, 4004) == &g_items[4]);
+    CHECK(MenuIdMap_Lookup(&map, 4005) == NULL);            /**< At count */
+    CHECK(MenuIdMap_Lookup(&map, UINT32_MAX) == NULL);
+
+    /** The range is full: no ID, nothing added, every refusal counted */
+    CHECK_EQ_U64(MenuIdMap_Record(&map, &g_items[5]), 0);
+    CHECK_EQ_U64(MenuIdMap_Record(&map, &g_items[6]), 0);
+    CHECK_EQ_U64(map.truncated, 2);
+    CHECK_EQ_U64(map.count, 5);
+    CHECK(map.capacity <= 5);                               /**< Never allocates past the range */
+    CHECK(MenuIdMap_Lookup(&map, 4005) == NULL);
+
+    /** A new numbering starts at the base again and forgets the old items */
+    MenuIdMap_Reset(&map);
+    CHECK_EQ_U64(map.truncated, 0);
+    CHECK(MenuIdMap_Lookup(&map, 4000) == NULL);
+    CHECK_EQ_U64(MenuIdMap_Record(&map, &g_items[7]), 4000);
+    CHECK(MenuIdMap_Lookup(&map, 4000) == &g_items[7]);
+    CHECK(MenuIdMap_Lookup(&map, 4001) == NULL);
+
+    MenuIdMap_Release(&map);
+    CHECK(map.items == NULL && map.capacity == 0);
+    CHECK(MenuIdMap_Lookup(&map, 4000) == NULL);
+    CHECK(MenuIdMap_Lookup(NULL, 4000) == NULL);
+    CHECK_EQ_U64(MenuIdMap_Record(NULL, &g_items[0]), 0);
+}
+
+static void TestAllocationFailureGap(void) {
+    MenuIdMap map = MENU_ID_MAP_INIT(3000, 1000);
+    for (int i = 0; i < 64; ++i) MenuIdMap_Record(&map, &g_items[i]);
+    CHECK_EQ_U64(map.capacity, 64);
+
+    /** Growth fails: the items still get their IDs (the menu stays numbered) but cannot be resolved */
+    g_failRealloc = 1;
+    CHECK_EQ_U64(MenuIdMap_Record(&map, &g_items[64]), 3064);
+    g_failRealloc = 0;
+    CHECK_EQ_U64(MenuIdMap_Record(&map, &g_items[65]), 3065);
+    CHECK(MenuIdMap_Lookup(&map, 3063) == &g_items[63]);    /**< Last item before the gap */
+    CHECK(MenuIdMap_Lookup(&map, 3064) == NULL);
+    CHECK(MenuIdMap_Lookup(&map, 3065) == NULL);
+    CHECK_EQ_U64(map.count, 66);
+
+    /** The next numbering grows normally */
+    MenuIdMap_Reset(&map);
+    for (int i = 0; i < 200; ++i) {
+        CHECK_EQ_U64(MenuIdMap_Record(&map, &g_items[i]), 3000 + i);
+    }
+    CHECK(MenuIdMap_Lookup(&map, 3064) == &g_items[64]);
+    CHECK(MenuIdMap_Lookup(&map, 3199) == &g_items[199]);
+    MenuIdMap_Release(&map);
+}
+
+int main(void) {
+    TestNumberingAndBounds();
+    TestAllocationFailureGap();
+    return TEST_RESULT();
+}
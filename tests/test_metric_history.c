@@ -0,0 +1,87 @@
+/**
+ * @file test_metric_history.c
+ * @brief History ring: ordering, wraparound, partial copies and peaks
+ */
+
+#include "test_common.h"
+#include "metric_history.h"
+
+static void TestEmpty(void) {
+    MetricHistory h;
+    MetricHistory_Clear(&h);
+    float out[4] = {-1.0f, -1.0f, -1.0f, -1.0f};
+    CHECK_EQ_U64(MetricHistory_CopyRecent(&h, out, 4), 0);
+    CHECK_NEAR(out[0], -1.0, 0.0);
+    CHECK_NEAR(MetricHistory_Peak(&h, 10), 0.0, 0.0);
+    CHECK_EQ_U64(MetricHistory_CopyRecent(NULL, out, 4), 0);
+    CHECK_EQ_U64(MetricHistory_CopyRecent(&h, out, 0), 0);
+}
+
+static void TestPartialFill(void) {
+    MetricHistory h;
+    MetricHistory_Clear(&h);
+    for (int i = 1; i <= 5; ++i) MetricHistory_Push(&h, (float)i);
+    CHECK_EQ_U64(h.count, 5);
+
+    float out[METRIC_HISTORY_CAPACITY];
+    CHECK_EQ_U64(MetricHistory_CopyRecent(&h, out, METRIC_HISTORY_CAPACITY), 5);
+    for (int i = 0; i < 5; ++i) CHECK_NEAR(out[i], i + 1, 0.0);     /**< Oldest first */
+
+    /** Fewer than available: the most recent ones */
+    CHECK_EQ_U64(MetricHistory_CopyRecent(&h, out, 2), 2);
+    CHECK_NEAR(out[0], 4.0, 0.0);
+    CHECK_NEAR(out[1], 5.0, 0.0);
+
+    CHECK_NEAR(MetricHistory_Peak(&h, 100), 5.0, 0.0);
+    CHECK_NEAR(MetricHistory_Peak(&h, 1), 5.0, 0.0);
+    CHECK_NEAR(MetricHistory_Peak(&h, 0), 0.0, 0.0);
+}
+
+static void TestWraparound(void) {
+    MetricHistory h;
+    MetricHistory_Clear(&h);
+    const int total = METRIC_HISTORY_CAPACITY * 2 + 7;
+    for (int i = 0; i < total; ++i) MetricHistory_Push(&h, (float)i);
+    CHECK_EQ_U64(h.count, METRIC_HISTORY_CAPACITY);
+    CHECK(h.head < METRIC_HISTORY_CAPACITY);
+
+    /** Exactly the last CAPACITY samples survive, in order, across the physical wrap */
+    float out[METRIC_HISTORY_CAPACITY + 8];
+    CHECK_EQ_U64(MetricHistory_CopyRecent(&h, out, METRIC_HISTORY_CAPACITY + 8), METRIC_HISTORY_CAPACITY);
+    int ordered = 1;
+    for (int i = 0; i < METRIC_HISTORY_CAPACITY; ++i) {
+        if (out[i] != (float)(total - METRIC_HISTORY_CAPACITY + i)) ordered = 0;
+    }
+    CHECK(ordered);
+
+    CHECK_EQ_U64(MetricHistory_CopyRecent(&h, out, 3), 3);
+    CHECK_NEAR(out[0], total - 3, 0.0);
+    CHECK_NEAR(out[2], total - 1, 0.0);
+}
+
+static void TestPeakWindow(void) {
+    MetricHistory h;
+    MetricHistory_Clear(&h);
+
+    /** A spike that scrolls out of the window stops counting */
+    MetricHistory_Push(&h, 90.0f);
+    for (int i = 0; i < 10; ++i) MetricHistory_Push(&h, 10.0f + (float)i);
+    CHECK_NEAR(MetricHistory_Peak(&h, 10), 19.0, 0.0);
+    CHECK_NEAR(MetricHistory_Peak(&h, 11), 90.0, 0.0);
+
+    /** Once overwritten by the ring it is gone for every window */
+    for (int i = 0; i < METRIC_HISTORY_CAPACITY; ++i) MetricHistory_Push(&h, 5.0f);
+    CHECK_NEAR(MetricHistory_Peak(&h, METRIC_HISTORY_CAPACITY * 2), 5.0, 0.0);
+
+    MetricHistory_Clear(&h);
+    CHECK_EQ_U64(h.count, 0);
+    CHECK_NEAR(MetricHistory_Peak(&h, 10), 0.0, 0.0);
+}
+
+int main(void) {
+    TestEmpty();
+    TestPartialFill();
+    TestWraparound();
+    TestPeakWindow();
+    return TEST_RESULT();
+}
@@ -0,0 +1,142 @@
+/**
+ * @file test_metric_smoother.c
+ * @brief EWMA and moving-window smoothing, configuration and parsing
+ */
+
+#include "test_common.h"
+#include "metric_smoother.h"
+
+static void TestNone(void) {
+    MetricSmoother s;
+    MetricSmoother_Configure(&s, METRIC_SMOOTHING_NONE, 0);
+    CHECK_NEAR(MetricSmoother_Apply(&s, 42.0f, 0), 42.0, 0.0);
+    CHECK_NEAR(MetricSmoother_Apply(&s, 7.0f, 1000), 7.0, 0.0);
+    CHECK_NEAR(MetricSmoother_Apply(NULL, 3.0f, 0), 3.0, 0.0);
+}
+
+/** @brief Step response 100 * (1 - e^(-t/tau)), whatever the sampling interval */
+static void TestEwmaStepResponse(void) {
+    static const uint32_t kIntervalsMs[] = {50, 250, 1000, 3000};
+    const uint32_t tau = 2000;
+    for (size_t k = 0; k < sizeof(kIntervalsMs) / sizeof(kIntervalsMs[0]); ++k) {
+        MetricSmoother s;
+        MetricSmoother_Configure(&s, METRIC_SMOOTHING_EWMA, tau);
+        CHECK_NEAR(MetricSmoother_Apply(&s, 0.0f, 0), 0.0, 0.0);   /**< First reading passes through */
+
+        uint64_t t = 0;
+        float v = 0.0f;
+        while (t < 6000) {
+            t += kIntervalsMs[k];
+            v = MetricSmoother_Apply(&s, 100.0f, t);
+        }
+        double expected = 100.0 * (1.0 - exp(-(double)t / tau));
+        CHECK_NEAR(v, expected, 1e-3);
+    }
+}
+
+static void TestEwmaEdgeCases(void) {
+    MetricSmoother s;
+    MetricSmoother_Configure(&s, METRIC_SMOOTHING_EWMA, 1000);
+    MetricSmoother_Apply(&s, 10.0f, 5000);
+
+    /** Same timestamp: no weight for the new reading */
+    CHECK_NEAR(MetricSmoother_Apply(&s, 90.0f, 5000), 10.0, 1e-6);
+
+    /** Clock going backwards restarts from the raw reading */
+    CHECK_NEAR(MetricSmoother_Apply(&s, 70.0f, 1000), 70.0, 0.0);
+
+    /** A long gap converges to the new level */
+    CHECK_NEAR(MetricSmoother_Apply(&s, 20.0f, 1000 + 60000), 20.0, 1e-6);
+
+    /** Zero time constant: no smoothing */
+    MetricSmoother_Configure(&s, METRIC_SMOOTHING_EWMA, 0);
+    MetricSmoother_Apply(&s, 10.0f, 0);
+    CHECK_NEAR(MetricSmoother_Apply(&s, 80.0f, 100), 80.0, 0.0);
+
+    /** Reset keeps the configuration but drops the state */
+    MetricSmoother_Configure(&s, METRIC_SMOOTHING_EWMA, 1000);
+    MetricSmoother_Apply(&s, 10.0f, 0);
+    MetricSmoother_Reset(&s);
+    CHECK(s.mode == METRIC_SMOOTHING_EWMA);
+    CHECK_EQ_U64(s.param, 1000);
+    CHECK_NEAR(MetricSmoother_Apply(&s, 55.0f, 10), 55.0, 0.0);
+}
+
+static void TestWindow(void) {
+    MetricSmoother s;
+    MetricSmoother_Configure(&s, METRIC_SMOOTHING_WINDOW, 4);
+
+    /** Mean of what is there while filling, then of the last four */
+    CHECK_NEAR(MetricSmoother_Apply(&s, 4.0f, 0), 4.0, 1e-6);
+    CHECK_NEAR(MetricSmoother_Apply(&s, 8.0f, 0), 6.0, 1e-6);
+    CHECK_NEAR(MetricSmoother_Apply(&s, 0.0f, 0), 4.0, 1e-6);
+    CHECK_NEAR(MetricSmoother_Apply(&s, 4.0f, 0), 4.0, 1e-6);
+    CHECK_NEAR(MetricSmoother_Apply(&s, 20.0f, 0), 8.0, 1e-6);     /**< 4 dropped */
+    CHECK_NEAR(MetricSmoother_Apply(&s, 20.0f, 0), 11.0, 1e-6);    /**< 8 dropped */
+
+    /** Timestamps do not matter to the window */
+    CHECK_NEAR(MetricSmoother_Apply(&s, 0.0f, 999999), 11.0, 1e-6);
+
+    /** The running sum does not drift over a long run */
+    MetricSmoother_Configure(&s, METRIC_SMOOTHING_WINDOW, 8);
+    float v = 0.0f;
+    for (int i = 0; i < 200000; ++i) v = MetricSmoother_Apply(&s, (float)(i % 97) * 1.37f, (uint64_t)i);
+    double exact = 0.0;
+    for (int i = 200000 - 8; i < 200000; ++i) exact += (double)((float)(i % 97) * 1.37f);
+    CHECK_NEAR(v, exact / 8.0, 1e-3);
+
+    /** Window length is clamped to 1..METRIC_SMOOTHER_MAX_WINDOW */
+    MetricSmoother_Configure(&s, METRIC_SMOOTHING_WINDOW, 0);
+    CHECK_EQ_U64(s.param, 1);
+    CHECK_NEAR(MetricSmoother_Apply(&s, 3.0f, 0), 3.0, 0.0);
+    CHECK_NEAR(MetricSmoother_Apply(&s, 9.0f, 0), 9.0, 0.0);
+    MetricSmoother_Configure(&s, METRIC_SMOOTHING_WINDOW, 1000);
+    CHECK_EQ_U64(s.param, METRIC_SMOOTHER_MAX_WINDOW);
+}
+
+static void TestParse(void) {
+    static const struct {
+        const char* text;
+        int ok;
+        MetricSmoothingMode mode;
+        uint32_t param;
+    } kCases[] = {
+        {"", 1, METRIC_SMOOTHING_NONE, 0},
+        {"none", 1, METRIC_SMOOTHING_NONE, 0},
+        {"  ewma:1500", 1, METRIC_SMOOTHING_EWMA, 1500},
+        {"window:5", 1, METRIC_SMOOTHING_WINDOW, 5},
+        {"window:500", 1, METRIC_SMOOTHING_WINDOW, METRIC_SMOOTHER_MAX_WINDOW},
+        {"ewma:600000", 1, METRIC_SMOOTHING_EWMA, 600000},
+        {"ewma:600001", 0, METRIC_SMOOTHING_NONE, 0},
+        {"ewma:0", 0, METRIC_SMOOTHING_NONE, 0},
+        {"ewma:", 0, METRIC_SMOOTHING_NONE, 0},
+        {"window:x", 0, METRIC_SMOOTHING_NONE, 0},
+        {"median:3", 0, METRIC_SMOOTHING_NONE, 0},
+        {"EWMA:100", 0, METRIC_SMOOTHING_NONE, 0},
+    };
+    for (size_t i = 0; i < sizeof(kCases) / sizeof(kCases[0]); ++i) {
+        MetricSmoothingMode mode = (MetricSmoothingMode)99;
+        uint32_t param = 12345;
+        int ok = MetricSmoother_Parse(kCases[i].text, &mode, &param);
+        if (ok != kCases[i].ok) {
+            fprintf(stderr, "Parse(\"%s\") = %d, expected %d\n", kCases[i].text, ok, kCases[i].ok);
+            g_testFailures++;
+        } else if (ok && (mode != kCases[i].mode || param != kCases[i].param)) {
+            fprintf(stderr, "Parse(\"%s\") = %d:%u\n", kCases[i].text, (int)mode, param);
+            g_testFailures++;
+        } else if (!ok && (mode != (MetricSmoothingMode)99 || param != 12345)) {
+            fprintf(stderr, "Parse(\"%s\") changed its outputs on failure\n", kCases[i].text);
+            g_testFailures++;
+        }
+    }
+    CHECK(!MetricSmoother_Parse(NULL, NULL, NULL));
+}
+
+int main(void) {
+    TestNone();
+    TestEwmaStepResponse();
+    TestEwmaEdgeCases();
+    TestWindow();
+    TestParse();
+    return TEST_RESULT();
+}
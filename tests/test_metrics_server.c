@@ -0,0 +1,373 @@
+/**
+ * @file test_metrics_server.c
+ * @brief Scrapes of the loopback metrics server over a real socket
+ *
+ * Starts the server on a free 127.0.0.1 port and checks the three answers
+ * it gives: 503 before the first publish, 405 for anything but GET, and 200
+ * with a matching Content-Length and well-formed catime_* families. Also
+ * restarts it after a clean stop and after a stop whose join timed out.
+ */
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "test_common.h"
+#include "metrics_server.h"
+
+#define RESPONSE_MAX (METRICS_PAGE_CAPACITY + 1024)
+
+/** @brief Set to make the server's thread join report a timeout (METRICS_SERVER_JOIN_TIMEOUT) */
+static int g_simulateJoinTimeout = 0;
+
+int TestJoinTimeout(void) {
+    return g_simulateJoinTimeout;
+}
+
+typedef struct {
+    int status;
+    long contentLength;         /**< -1 if the header is missing */
+    char headers[1024];
+    const char* body;
+    size_t bodyLength;
+    char raw[RESPONSE_MAX];
+} HttpResponse;
+
+/** @return 1 if a response was read until the server closed the connection */
+static int Request(int port, const char* request, HttpResponse* out) {
+    memset(out, 0, sizeof(*out));
+    out->contentLength = -1;
+
+    int s = socket(AF_INET, SOCK_STREAM, 0);
+    if (s < 0) return 0;
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons((unsigned short)port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (connect(s, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+        close(s);
+        return 0;
+    }
+    send(s, request, strlen(request), MSG_NOSIGNAL);
+
+    size_t total = 0;
+    for (;;) {
+        ssize_t n = recv(s, out->raw + total, sizeof(out->raw) - 1 - total, 0);
+        if (n <= 0) break;
+        total += (size_t)n;
+    }
+    close(s);
+    out->raw[total] = '\0';
+
+    char* end = strstr(out->raw, "\r\n\r\n");
+    if (!end || sscanf(out->raw, "HTTP/1.%*d %d", &out->status) != 1) return 0;
+    size_t headerLength = (size_t)(end - out->raw);
+    if (headerLength >= sizeof(out->headers)) return 0;
+    memcpy(out->headers, out->raw, headerLength);
+    out->body = end + 4;
+    out->bodyLength = total - headerLength - 4;
+
+    const char* cl = strstr(out->headers, "Content-Length:");
+    if (cl) out->contentLength = strtol(cl + 15, NULL, 10);
+    return 1;
+}
+
+/* ============================================================================
+ * Page under test: the same family shapes the endpoint publishes
+ * ============================================================================ */
+
+typedef struct {
+    MetricsLatencyHistogram paint;
+    double cpu;
+    int oversized;              /**< Write past the page capacity */
+} TestPageState;
+
+static void WriteTestPage(MetricsPage* page, void* context) {
+    TestPageState* st = (TestPageState*)context;
+    MetricsPage_AppendGauge(page, "catime_cpu_usage_percent", "System CPU usage.", st->cpu);
+    MetricsPage_Append(page, "# HELP catime_cpu_core_usage_percent Per-core CPU usage.\n"
+                             "# TYPE catime_cpu_core_usage_percent gauge\n");
+    for (int i = 0; i < 4; ++i) {
+        MetricsPage_Append(page, "catime_cpu_core_usage_percent{core=\"%d\"} %.6g\n", i, 10.0 * i);
+    }
+    static const char* const kModes[] = {"idle", "clock", "countup", "countdown"};
+    MetricsPage_Append(page, "# HELP catime_timer_mode Current timer mode (1 for the active mode).\n"
+                             "# TYPE catime_timer_mode gauge\n");
+    for (int i = 0; i < 4; ++i) MetricsPage_Append(page, "catime_timer_mode{mode=\"%s\"} %d\n", kModes[i], i == 3);
+    MetricsPage_AppendHistogram(page, "catime_paint_duration_seconds", "Main window WM_PAINT handling time.", &st->paint);
+    MetricsPage_Append(page, "# HELP catime_metrics_scrapes_total Requests served by this endpoint.\n"
+                             "# TYPE catime_metrics_scrapes_total counter\n"
+                             "catime_metrics_scrapes_total %ld\n", MetricsServer_GetScrapes());
+    if (st->oversized) {
+        for (int i = 0; i < METRICS_PAGE_CAPACITY / 16; ++i) MetricsPage_Append(page, "catime_filler %d\n", i);
+    }
+}
+
+/* ============================================================================
+ * Exposition-format checks
+ * ============================================================================ */
+
+#define MAX_FAMILIES 32
+
+typedef struct {
+    char name[96];
+    char type[16];
+    int hasHelp;
+    int samples;
+} Family;
+
+static Family* FindFamily(Family* families, int count, const char* name) {
+    for (int i = 0; i < count; ++i) {
+        if (strcmp(families[i].name, name) == 0) return &families[i];
+    }
+    return NULL;
+}
+
+/** @brief Family a sample belongs to: the name itself, or a histogram's _bucket/_sum/_count */
+static Family* FamilyOfSample(Family* families, int count, const char* sample) {
+    Family* f = FindFamily(families, count, sample);
+    if (f) return f;
+    static const char* const kSuffixes[] = {"_bucket", "_sum", "_count"};
+    for (size_t i = 0; i < 3; ++i) {
+        size_t n = strlen(sample), k = strlen(kSuffixes[i]);
+        if (n > k && strcmp(sample + n - k, kSuffixes[i]) == 0) {
+            char base[96];
+            snprintf(base, sizeof(base), "%.*s", (int)(n - k), sample);
+            f = FindFamily(families, count, base);
+            if (f && strcmp(f->type, "histogram") == 0) return f;
+        }
+    }
+    return NULL;
+}
+
+/** @return Number of families, after checking every line of the body */
+static int CheckExposition(const char* body, size_t length, Family* families) {
+    int count = 0;
+    double lastBucket = -1.0, infBucket = -1.0;
+    char* text = (char*)malloc(length + 1);
+    memcpy(text, body, length);
+    text[length] = '\0';
+    CHECK(length > 0 && text[length - 1] == '\n');
+
+    for (char* line = strtok(text, "\n"); line; line = strtok(NULL, "\n")) {
+        char name[96], word[16];
+        if (sscanf(line, "# HELP %95s", name) == 1) {
+            CHECK(count < MAX_FAMILIES);
+            CHECK(FindFamily(families, count, name) == NULL);  /**< One block per family */
+            snprintf(families[count].name, sizeof(families[count].name), "%s", name);
+            families[count].hasHelp = 1;
+            count++;
+            lastBucket = -1.0;
+            continue;
+        }
+        if (sscanf(line, "# TYPE %95s %15s", name, word) == 2) {
+            Family* f = FindFamily(families, count, name);
+            CHECK(f != NULL);
+            if (f) snprintf(f->type, sizeof(f->type), "%s", word);
+            continue;
+        }
+
+        /** Sample: name[{labels}] value */
+        size_t n = strcspn(line, "{ ");
+        snprintf(name, sizeof(name), "%.*s", (int)n, line);
+        const char* value = strrchr(line, ' ');
+        char* end = NULL;
+        double v = value ? strtod(value + 1, &end) : 0.0;
+        if (!value || !end || *end != '\0') {
+            fprintf(stderr, "unparsable sample line: %s\n", line);
+            g_testFailures++;
+            continue;
+        }
+        Family* f = FamilyOfSample(families, count, name);
+        if (!f) {
+            fprintf(stderr, "sample without HELP/TYPE: %s\n", line);
+            g_testFailures++;
+            continue;
+        }
+        f->samples++;
+        CHECK(strncmp(name, "catime_", 7) == 0);
+
+        /** Histogram buckets are cumulative; +Inf equals _count */
+        if (strstr(name, "_bucket")) {
+            CHECK(v >= lastBucket);
+            lastBucket = v;
+            if (strstr(line, "le=\"+Inf\"")) infBucket = v;
+        } else if (strcmp(f->type, "histogram") == 0 && strstr(name, "_count")) {
+            CHECK_NEAR(v, infBucket, 0.0);
+        }
+    }
+    free(text);
+
+    for (int i = 0; i < count; ++i) {
+        CHECK(families[i].hasHelp);
+        CHECK(families[i].type[0] != '\0');
+        CHECK(families[i].samples > 0);
+    }
+    return count;
+}
+
+/* ============================================================================
+ * Tests
+ * ============================================================================ */
+
+static void TestHistogramBuckets(void) {
+    MetricsLatencyHistogram h = {{0}, 0, 0.0};
+    MetricsHistogram_Observe(&h, -3.0);     /**< Counts as 0 ms */
+    MetricsHistogram_Observe(&h, 1.0);      /**< Bounds are inclusive */
+    MetricsHistogram_Observe(&h, 1.5);
+    MetricsHistogram_Observe(&h, 250.0);
+    MetricsHistogram_Observe(&h, 1000.0);   /**< Only in +Inf */
+    CHECK_EQ_U64(h.buckets[0], 2);
+    CHECK_EQ_U64(h.buckets[1], 1);
+    CHECK_EQ_U64(h.buckets[METRICS_LATENCY_BUCKET_COUNT - 1], 1);
+    CHECK_EQ_U64(h.count, 5);
+    CHECK_NEAR(h.sumMs, 1252.5, 1e-9);
+
+    char buffer[4096];
+    MetricsPage page = {buffer, 0, sizeof(buffer), 0};
+    MetricsPage_AppendHistogram(&page, "catime_x_seconds", "X.", &h);
+    CHECK(!page.overflow);
+    CHECK(strstr(buffer, "catime_x_seconds_bucket{le=\"0.001\"} 2\n") != NULL);
+    CHECK(strstr(buffer, "catime_x_seconds_bucket{le=\"0.25\"} 4\n") != NULL);
+    CHECK(strstr(buffer, "catime_x_seconds_bucket{le=\"+Inf\"} 5\n") != NULL);
+    CHECK(strstr(buffer, "catime_x_seconds_sum 1.252500\n") != NULL);
+
+    /** Overflow is sticky and leaves the text that fit */
+    char tiny[32];
+    MetricsPage small = {tiny, 0, sizeof(tiny), 0};
+    MetricsPage_AppendGauge(&small, "catime_long_gauge_name", "Does not fit.", 1.0);
+    CHECK(small.overflow);
+    CHECK_EQ_U64(small.length, 0);
+    MetricsPage_Append(&small, "x");
+    CHECK_EQ_U64(small.length, 0);
+}
+
+static void TestScrapes(void) {
+    int error = -1;
+    CHECK(MetricsServer_Start(0, &error));
+    CHECK_EQ_U64(error, 0);
+    int port = MetricsServer_GetPort();
+    CHECK(port > 0);
+    if (port <= 0) return;
+
+    HttpResponse r;
+
+    /** Before the first publish: 503, empty body */
+    CHECK(Request(port, "GET /metrics HTTP/1.1\r\nHost: 127.0.0.1\r\n\r\n", &r));
+    CHECK_EQ_U64(r.status, 503);
+    CHECK_EQ_U64(r.contentLength, 0);
+    CHECK_EQ_U64(r.bodyLength, 0);
+
+    /** Not a GET: 405 with Allow, whether or not a page exists */
+    CHECK(Request(port, "POST /metrics HTTP/1.1\r\nContent-Length: 0\r\n\r\n", &r));
+    CHECK_EQ_U64(r.status, 405);
+    CHECK(strstr(r.headers, "Allow: GET") != NULL);
+    CHECK_EQ_U64(r.contentLength, 0);
+
+    static TestPageState state;
+    state.cpu = 12.5;
+    MetricsHistogram_Observe(&state.paint, 0.5);
+    MetricsHistogram_Observe(&state.paint, 20.0);
+    CHECK(MetricsServer_Publish(WriteTestPage, &state));
+
+    CHECK(Request(port, "HEAD /metrics HTTP/1.1\r\n\r\n", &r));
+    CHECK_EQ_U64(r.status, 405);
+
+    /** 200: Content-Length matches the body, every family is well formed */
+    CHECK(Request(port, "GET /metrics HTTP/1.1\r\nHost: 127.0.0.1\r\n\r\n", &r));
+    CHECK_EQ_U64(r.status, 200);
+    CHECK(r.contentLength > 0);
+    CHECK_EQ_U64(r.bodyLength, (uint64_t)r.contentLength);
+    CHECK(strstr(r.headers, "Content-Type: text/plain; version=0.0.4") != NULL);
+
+    Family families[MAX_FAMILIES];
+    memset(families, 0, sizeof(families));
+    int familyCount = CheckExposition(r.body, r.bodyLength, families);
+    CHECK_EQ_U64(familyCount, 5);
+    Family* paint = FindFamily(families, familyCount, "catime_paint_duration_seconds");
+    CHECK(paint && strcmp(paint->type, "histogram") == 0);
+    CHECK(paint && paint->samples == METRICS_LATENCY_BUCKET_COUNT + 3);
+    Family* scrapes = FindFamily(families, familyCount, "catime_metrics_scrapes_total");
+    CHECK(scrapes && strcmp(scrapes->type, "counter") == 0);
+    CHECK(strstr(r.body, "catime_cpu_usage_percent 12.5\n") != NULL);
+    CHECK(strstr(r.body, "catime_timer_mode{mode=\"countdown\"} 1\n") != NULL);
+    CHECK_EQ_U64(MetricsServer_GetScrapes(), 1);
+
+    /** A page that does not fit is rejected and the previous one stays served */
+    state.oversized = 1;
+    CHECK(!MetricsServer_Publish(WriteTestPage, &state));
+    CHECK(Request(port, "GET / HTTP/1.0\r\n\r\n", &r));
+    CHECK_EQ_U64(r.status, 200);
+    CHECK_EQ_U64(r.bodyLength, (uint64_t)r.contentLength);
+    CHECK(strstr(r.body, "catime_filler") == NULL);
+    CHECK_EQ_U64(MetricsServer_GetScrapes(), 2);
+
+    /** A republished page shows the new scrape count */
+    state.oversized = 0;
+    CHECK(MetricsServer_Publish(WriteTestPage, &state));
+    CHECK(Request(port, "GET /metrics HTTP/1.1\r\n\r\n", &r));
+    CHECK(strstr(r.body, "catime_metrics_scrapes_total 2\n") != NULL);
+
+    /** Second start is a no-op; stop closes the port */
+    CHECK(MetricsServer_Start(0, NULL));
+    CHECK_EQ_U64(MetricsServer_GetPort(), port);
+    MetricsServer_Stop();
+    CHECK(!MetricsServer_IsRunning());
+    CHECK_EQ_U64(MetricsServer_GetPort(), 0);
+    CHECK(!Request(port, "GET / HTTP/1.0\r\n\r\n", &r));
+    CHECK(!MetricsServer_Publish(WriteTestPage, &state));
+    MetricsServer_Stop();
+}
+
+static void TestRestartAfterStop(void) {
+    static TestPageState state;
+    HttpResponse r;
+
+    /** A clean stop releases everything: the next start is a fresh server */
+    CHECK(MetricsServer_Start(0, NULL));
+    CHECK(MetricsServer_Publish(WriteTestPage, &state));
+    MetricsServer_Stop();
+    CHECK(MetricsServer_Start(0, NULL));
+    int port = MetricsServer_GetPort();
+    CHECK(port > 0);
+    CHECK(Request(port, "GET / HTTP/1.0\r\n\r\n", &r));
+    CHECK_EQ_U64(r.status, 503);                                        /**< Old page is gone */
+    CHECK_EQ_U64(MetricsServer_GetScrapes(), 0);
+
+    /** Stop that times out: the thread keeps its socket and pages, so start refuses */
+    g_simulateJoinTimeout = 1;
+    MetricsServer_Stop();
+    CHECK(!MetricsServer_IsRunning());
+    CHECK_EQ_U64(MetricsServer_GetPort(), 0);
+    CHECK(!MetricsServer_Publish(WriteTestPage, &state));
+    int error = -1;
+    CHECK(!MetricsServer_Start(0, &error));
+    CHECK_EQ_U64(error, 0);
+    CHECK(!MetricsServer_IsRunning());
+    MetricsServer_Stop();                                               /**< No-op while abandoned */
+
+    /** Once the thread can be joined, start reaps it and serves again */
+    g_simulateJoinTimeout = 0;
+    CHECK(MetricsServer_Start(0, NULL));
+    port = MetricsServer_GetPort();
+    CHECK(port > 0);
+    CHECK(Request(port, "GET / HTTP/1.0\r\n\r\n", &r));
+    CHECK_EQ_U64(r.status, 503);
+    CHECK(MetricsServer_Publish(WriteTestPage, &state));
+    CHECK(Request(port, "GET / HTTP/1.0\r\n\r\n", &r));
+    CHECK_EQ_U64(r.status, 200);
+    CHECK_EQ_U64(r.bodyLength, (uint64_t)r.contentLength);
+    MetricsServer_Stop();
+    CHECK(!MetricsServer_IsRunning());
+}
+
+int main(void) {
+    TestHistogramBuckets();
+    TestScrapes();
+    TestRestartAfterStop();
+    return TEST_RESULT();
+}
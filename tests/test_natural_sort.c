@@ -0,0 +1,108 @@
+/**
+ * @file test_natural_sort.c
+ * @brief NaturalCompareW ordering rules, symmetry and transitivity
+ */
+
+#include <stdlib.h>
+
+#include "test_common.h"
+#include "natural_sort.h"
+
+static int Sign(int v) {
+    return (v > 0) - (v < 0);
+}
+
+static void TestPairs(void) {
+    static const struct { const wchar_t* a; const wchar_t* b; int expected; } kPairs[] = {
+        {L"", L"", 0},
+        {L"", L"a", -1},
+        {L"frame", L"frame1", -1},
+        {L"2", L"10", -1},                              /**< Value, not text */
+        {L"frame2.png", L"frame10.png", -1},
+        {L"frame10.png", L"frame10.png", 0},
+        {L"9", L"10", -1},
+        {L"123456789012345678901", L"123456789012345678902", -1},  /**< Beyond 64-bit */
+        {L"99999999999999999999", L"100000000000000000000", -1},
+        {L"007", L"07", -1},                            /**< Leading zeros first */
+        {L"07", L"7", -1},
+        {L"09", L"2", -1},
+        {L"00", L"0", -1},
+        {L"0", L"1", -1},
+        {L"01", L"02", -1},
+        {L"Frame", L"frame", 0},                        /**< Case-insensitive */
+        {L"ABC", L"abd", -1},
+        {L"a2b3", L"a2b10", -1},                        /**< Every digit run compared */
+        {L"a10b", L"a2b", 1},
+        {L"a1", L"a_", -1},                             /**< '1' (0x31) < '_' (0x5F) */
+        {L"x1y", L"x1", 1},
+    };
+    for (size_t i = 0; i < sizeof(kPairs) / sizeof(kPairs[0]); ++i) {
+        int forward = NaturalCompareW(kPairs[i].a, kPairs[i].b);
+        int backward = NaturalCompareW(kPairs[i].b, kPairs[i].a);
+        if (forward != kPairs[i].expected || backward != -kPairs[i].expected) {
+            fprintf(stderr, "\"%ls\" vs \"%ls\": %d / %d, expected %d\n",
+                    kPairs[i].a, kPairs[i].b, forward, backward, kPairs[i].expected);
+            g_testFailures++;
+        }
+    }
+}
+
+static int CompareEntries(const void* a, const void* b) {
+    return NaturalCompareW(*(const wchar_t* const*)a, *(const wchar_t* const*)b);
+}
+
+/** @brief A frame folder as it is listed in the menus and loaded */
+static void TestFolderOrder(void) {
+    const wchar_t* names[] = {
+        L"frame10.png", L"Frame1.png", L"frame001.png", L"frame2.png",
+        L"frame01.png", L"frame100.png", L"frame9.png", L"frame.png",
+    };
+    static const wchar_t* const kSorted[] = {
+        L"frame.png", L"frame001.png", L"frame01.png", L"Frame1.png",
+        L"frame2.png", L"frame9.png", L"frame10.png", L"frame100.png",
+    };
+    const size_t n = sizeof(names) / sizeof(names[0]);
+    qsort(names, n, sizeof(names[0]), CompareEntries);
+    for (size_t i = 0; i < n; ++i) {
+        if (wcscmp(names[i], kSorted[i]) != 0) {
+            fprintf(stderr, "position %zu: \"%ls\", expected \"%ls\"\n", i, names[i], kSorted[i]);
+            g_testFailures++;
+        }
+    }
+}
+
+/** @brief qsort needs a strict weak order: check sign symmetry and transitivity on a mixed set */
+static void TestOrderConsistency(void) {
+    static const wchar_t* const kSet[] = {
+        L"", L"0", L"00", L"000", L"01", L"1", L"001", L"2", L"02", L"10", L"010", L"9",
+        L"a", L"A", L"a0", L"a00", L"a1", L"a01", L"a10", L"a1b", L"a1B2", L"a1b10",
+        L"b", L"_", L"1a", L"01a", L"x99", L"x100", L"x0100",
+    };
+    const size_t n = sizeof(kSet) / sizeof(kSet[0]);
+    int symmetric = 1, transitive = 1;
+    for (size_t i = 0; i < n; ++i) {
+        CHECK(NaturalCompareW(kSet[i], kSet[i]) == 0);
+        for (size_t j = 0; j < n; ++j) {
+            int ij = Sign(NaturalCompareW(kSet[i], kSet[j]));
+            if (ij != -Sign(NaturalCompareW(kSet[j], kSet[i]))) symmetric = 0;
+            for (size_t k = 0; k < n; ++k) {
+                int jk = Sign(NaturalCompareW(kSet[j], kSet[k]));
+                int ik = Sign(NaturalCompareW(kSet[i], kSet[k]));
+                if (ij <= 0 && jk <= 0 && ik > 0) {
+                    fprintf(stderr, "\"%ls\" <= \"%ls\" <= \"%ls\" but not \"%ls\" <= \"%ls\"\n",
+                            kSet[i], kSet[j], kSet[k], kSet[i], kSet[k]);
+                    transitive = 0;
+                }
+            }
+        }
+    }
+    CHECK(symmetric);
+    CHECK(transitive);
+}
+
+int main(void) {
+    TestPairs();
+    TestFolderOrder();
+    TestOrderConsistency();
+    return TEST_RESULT();
+}
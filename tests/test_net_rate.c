@@ -0,0 +1,163 @@
+/**
+ * @file test_net_rate.c
+ * @brief Counter deltas and aggregate rates across wraps, resets and interface changes
+ */
+
+#include "test_common.h"
+#include "net_rate.h"
+
+static void TestCounterDelta(void) {
+    CHECK_EQ_U64(NetRate_CounterDelta(100, 350), 250);
+    CHECK_EQ_U64(NetRate_CounterDelta(7, 7), 0);
+
+    /** One wrap of the 64-bit counter: modular difference */
+    CHECK_EQ_U64(NetRate_CounterDelta(UINT64_MAX - 9, 5), 15);
+    CHECK_EQ_U64(NetRate_CounterDelta(UINT64_MAX, 0), 1);
+
+    /** Counter reset (value went down): treated as no traffic, not a wrap */
+    CHECK_EQ_U64(NetRate_CounterDelta(5000000, 1200), 0);
+    CHECK_EQ_U64(NetRate_CounterDelta(UINT64_C(1) << 40, 0), 0);
+
+    /** The plausibility limit itself is accepted, one past it is not */
+    CHECK_EQ_U64(NetRate_CounterDelta(0, NET_RATE_MAX_PLAUSIBLE_DELTA), NET_RATE_MAX_PLAUSIBLE_DELTA);
+    CHECK_EQ_U64(NetRate_CounterDelta(0, NET_RATE_MAX_PLAUSIBLE_DELTA + 1), 0);
+}
+
+static void TestBaselineAndRates(void) {
+    NetRateTracker tracker = {0};
+    double up = -1.0, down = -1.0;
+
+    NetRateSample first[] = {{1, 1000, 500}, {2, 0, 0}};
+    CHECK(NetRate_Update(&tracker, first, 2, 10000, &up, &down) == 0);
+    CHECK_NEAR(up, -1.0, 0.0);      /**< Outputs untouched on a baseline call */
+    CHECK_NEAR(down, -1.0, 0.0);
+
+    NetRateSample second[] = {{1, 3000, 1500}, {2, 2000, 500}};
+    CHECK(NetRate_Update(&tracker, second, 2, 12000, &up, &down) == 1);
+    CHECK_NEAR(down, (2000.0 + 2000.0) / 2.0, 1e-9);
+    CHECK_NEAR(up, (1000.0 + 500.0) / 2.0, 1e-9);
+
+    /** Same timestamp: no rate, outputs kept, baseline unchanged */
+    up = down = -1.0;
+    NetRateSample same[] = {{1, 9000, 9000}, {2, 9000, 9000}};
+    CHECK(NetRate_Update(&tracker, same, 2, 12000, &up, &down) == 0);
+    CHECK_NEAR(up, -1.0, 0.0);
+    NetRateSample third[] = {{1, 3100, 1500}, {2, 2000, 600}};
+    CHECK(NetRate_Update(&tracker, third, 2, 13000, &up, &down) == 1);
+    CHECK_NEAR(down, 100.0, 1e-9);
+    CHECK_NEAR(up, 100.0, 1e-9);
+
+    NetRate_Release(&tracker);
+    CHECK(tracker.last == NULL);
+    CHECK(!tracker.hasBaseline);
+}
+
+static void TestWrapAndReset(void) {
+    NetRateTracker tracker = {0};
+    double up = 0.0, down = 0.0;
+
+    NetRateSample a[] = {{7, UINT64_MAX - 999, 4000000}};
+    NetRate_Update(&tracker, a, 1, 0, &up, &down);
+
+    /** Receive counter wraps, send counter resets (driver reload) */
+    NetRateSample b[] = {{7, 1000, 10}};
+    CHECK(NetRate_Update(&tracker, b, 1, 1000, &up, &down) == 1);
+    CHECK_NEAR(down, 2000.0, 1e-9);
+    CHECK_NEAR(up, 0.0, 0.0);
+
+    /** After the reset the new counter value is the baseline */
+    NetRateSample c[] = {{7, 1500, 510}};
+    CHECK(NetRate_Update(&tracker, c, 1, 2000, &up, &down) == 1);
+    CHECK_NEAR(down, 500.0, 1e-9);
+    CHECK_NEAR(up, 500.0, 1e-9);
+    NetRate_Release(&tracker);
+}
+
+static void TestInterfacesComingAndGoing(void) {
+    NetRateTracker tracker = {0};
+    double up = 0.0, down = 0.0;
+
+    NetRateSample a[] = {{1, 1000, 1000}};
+    NetRate_Update(&tracker, a, 1, 0, &up, &down);
+
+    /** A new interface with large lifetime counters adds nothing on its first sample */
+    NetRateSample b[] = {{1, 2000, 1000}, {9, UINT64_C(1) << 50, UINT64_C(1) << 50}};
+    CHECK(NetRate_Update(&tracker, b, 2, 1000, &up, &down) == 1);
+    CHECK_NEAR(down, 1000.0, 1e-9);
+    CHECK_NEAR(up, 0.0, 0.0);
+
+    /** From the next sample on it is counted */
+    NetRateSample c[] = {{9, (UINT64_C(1) << 50) + 4000, (UINT64_C(1) << 50) + 8000}, {1, 2000, 1000}};
+    CHECK(NetRate_Update(&tracker, c, 2, 2000, &up, &down) == 1);
+    CHECK_NEAR(down, 4000.0, 1e-9);
+    CHECK_NEAR(up, 8000.0, 1e-9);
+
+    /** An interface that disappears simply stops contributing, no negative jump */
+    NetRateSample d[] = {{1, 2500, 1200}};
+    CHECK(NetRate_Update(&tracker, d, 1, 3000, &up, &down) == 1);
+    CHECK_NEAR(down, 500.0, 1e-9);
+    CHECK_NEAR(up, 200.0, 1e-9);
+
+    /** Reappearing with an older index is a new baseline again */
+    NetRateSample e[] = {{1, 2500, 1200}, {9, 10, 10}};
+    CHECK(NetRate_Update(&tracker, e, 2, 4000, &up, &down) == 1);
+    CHECK_NEAR(down, 0.0, 0.0);
+    CHECK_NEAR(up, 0.0, 0.0);
+
+    /** All interfaces gone */
+    CHECK(NetRate_Update(&tracker, NULL, 0, 5000, &up, &down) == 1);
+    CHECK_NEAR(down, 0.0, 0.0);
+    NetRate_Release(&tracker);
+}
+
+static void TestClockGoingBackwards(void) {
+    NetRateTracker tracker = {0};
+    double up = -1.0, down = -1.0;
+
+    NetRateSample a[] = {{3, 1000, 1000}};
+    NetRate_Update(&tracker, a, 1, 50000, &up, &down);
+
+    /** nowMs behind the baseline: re-baseline instead of a huge or negative interval */
+    NetRateSample b[] = {{3, 5000, 5000}};
+    CHECK(NetRate_Update(&tracker, b, 1, 40000, &up, &down) == 0);
+    CHECK_NEAR(up, -1.0, 0.0);
+    CHECK_EQ_U64(tracker.lastMs, 40000);
+
+    NetRateSample c[] = {{3, 6000, 5500}};
+    CHECK(NetRate_Update(&tracker, c, 1, 41000, &up, &down) == 1);
+    CHECK_NEAR(down, 1000.0, 1e-9);
+    CHECK_NEAR(up, 500.0, 1e-9);
+
+    /** Reset keeps the buffer but drops the baseline */
+    NetRate_Reset(&tracker);
+    CHECK(NetRate_Update(&tracker, c, 1, 42000, &up, &down) == 0);
+    NetRate_Release(&tracker);
+}
+
+/** @brief More interfaces than any fixed cap: every one is counted */
+static void TestManyInterfaces(void) {
+    enum { N = 300 };
+    static NetRateSample samples[N];
+    NetRateTracker tracker = {0};
+    double up = 0.0, down = 0.0;
+
+    for (uint32_t i = 0; i < N; ++i) samples[i] = (NetRateSample){i + 1, 0, 0};
+    NetRate_Update(&tracker, samples, N, 0, &up, &down);
+    CHECK(tracker.capacity >= N);
+
+    for (uint32_t i = 0; i < N; ++i) samples[i] = (NetRateSample){i + 1, 100, 10};
+    CHECK(NetRate_Update(&tracker, samples, N, 1000, &up, &down) == 1);
+    CHECK_NEAR(down, 100.0 * N, 1e-9);
+    CHECK_NEAR(up, 10.0 * N, 1e-9);
+    NetRate_Release(&tracker);
+}
+
+int main(void) {
+    TestCounterDelta();
+    TestBaselineAndRates();
+    TestWrapAndReset();
+    TestInterfacesComingAndGoing();
+    TestClockGoingBackwards();
+    TestManyInterfaces();
+    return TEST_RESULT();
+}
@@ -0,0 +1,216 @@
+/**
+ * @file catime-logdump.c
+ * @brief Decode a binary Catime log (Catime_Logs.clog) to text or JSON lines
+ *
+ * Standalone and portable; builds on Linux as well as Windows:
+ *   cc -std=c11 -O2 -Iinclude tools/catime-logdump.c src/log_binary.c -o catime-logdump
+ *
+ * Usage: catime-logdump [--json] [--utc] <file>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../include/log_binary.h"
+
+/** @brief FILETIME epoch (1601) to Unix epoch, in seconds */
+#define FILETIME_UNIX_OFFSET 11644473600ULL
+
+#define MESSAGE_MAX 8192
+
+static const char* const LEVEL_NAMES[] = {"DEBUG", "INFO", "WARNING", "ERROR", "FATAL"};
+
+typedef struct {
+    int json;
+    int utc;
+} DumpOptions;
+
+/* ============================================================================
+ * Helper Functions - Output
+ * ============================================================================ */
+
+static const char* LevelName(unsigned level) {
+    return level < sizeof(LEVEL_NAMES) / sizeof(LEVEL_NAMES[0]) ? LEVEL_NAMES[level] : "UNKNOWN";
+}
+
+static void FormatTime(uint64_t fileTime, int utc, char* out, size_t outSize) {
+    time_t seconds = (time_t)(fileTime / 10000000ULL - FILETIME_UNIX_OFFSET);
+    struct tm* tm = utc ? gmtime(&seconds) : localtime(&seconds);
+    if (!tm || strftime(out, outSize, "%Y-%m-%d %H:%M:%S", tm) == 0) {
+        snprintf(out, outSize, "?");
+    }
+}
+
+static void PutJsonString(const char* text, size_t length) {
+    putchar('"');
+    for (size_t i = 0; i < length; ++i) {
+        unsigned char c = (unsigned char)text[i];
+        switch (c) {
+            case '"':  fputs("\\\"", stdout); break;
+            case '\\': fputs("\\\\", stdout); break;
+            case '\n': fputs("\\n", stdout); break;
+            case '\r': fputs("\\r", stdout); break;
+            case '\t': fputs("\\t", stdout); break;
+            default:
+                if (c < 0x20) printf("\\u%04x", c);
+                else putchar(c);
+        }
+    }
+    putchar('"');
+}
+
+static void EmitRecord(const DumpOptions* options, uint64_t fileTime, unsigned level,
+                       const char* message, size_t length, const char* format) {
+    char stamp[32];
+    FormatTime(fileTime, options->utc, stamp, sizeof(stamp));
+
+    if (!options->json) {
+        printf("[%s] [%s] %.*s\n", stamp, LevelName(level), (int)length, message);
+        return;
+    }
+
+    unsigned long long unixMs = (unsigned long long)(fileTime / 10000ULL) - FILETIME_UNIX_OFFSET * 1000ULL;
+    printf("{\"time\":\"%s\",\"unix_ms\":%llu,\"level\":\"%s\",\"message\":", stamp, unixMs, LevelName(level));
+    PutJsonString(message, length);
+    if (format) {
+        fputs(",\"format\":", stdout);
+        PutJsonString(format, strlen(format));
+    }
+    fputs("}\n", stdout);
+}
+
+/* ============================================================================
+ * Helper Functions - Decoding
+ * ============================================================================ */
+
+/**
+ * @brief Decode every chunk after the file header
+ * @return 0 on success, 1 if the file is truncated or malformed
+ */
+static int DumpChunks(FILE* file, const DumpOptions* options) {
+    char* formats[LOG_BINARY_MAX_FORMATS] = {0};
+    uint8_t* payload = NULL;
+    size_t payloadCapacity = 0;
+    char message[MESSAGE_MAX];
+    int status = 0;
+    long long chunkIndex = 0;
+
+    for (;; ++chunkIndex) {
+        uint8_t header[LOG_BINARY_CHUNK_HEADER_SIZE];
+        size_t got = fread(header, 1, sizeof(header), file);
+        if (got == 0) break;
+        if (got != sizeof(header)) {
+            fprintf(stderr, "catime-logdump: truncated chunk header at chunk %lld\n", chunkIndex);
+            status = 1;
+            break;
+        }
+
+        uint32_t length = LogBinary_GetU32(header + 1);
+        if (length + 1 > payloadCapacity) {
+            uint8_t* grown = (uint8_t*)realloc(payload, (size_t)length + 1);
+            if (!grown) {
+                fprintf(stderr, "catime-logdump: out of memory\n");
+                status = 1;
+                break;
+            }
+            payload = grown;
+            payloadCapacity = (size_t)length + 1;
+        }
+        if (fread(payload, 1, length, file) != length) {
+            fprintf(stderr, "catime-logdump: truncated chunk %lld (crash while writing?)\n", chunkIndex);
+            status = 1;
+            break;
+        }
+
+        switch (header[0]) {
+            case LOG_BINARY_CHUNK_STRING: {
+                if (length < 4) goto malformed;
+                uint32_t id = LogBinary_GetU32(payload);
+                if (id >= LOG_BINARY_MAX_FORMATS) goto malformed;
+                free(formats[id]);
+                formats[id] = (char*)malloc(length - 4 + 1);
+                if (!formats[id]) goto malformed;
+                memcpy(formats[id], payload + 4, length - 4);
+                formats[id][length - 4] = '\0';
+                break;
+            }
+            case LOG_BINARY_CHUNK_RECORD: {
+                if (length < 13) goto malformed;
+                uint64_t fileTime = LogBinary_GetU64(payload);
+                unsigned level = payload[8];
+                uint32_t id = LogBinary_GetU32(payload + 9);
+                const char* format = (id < LOG_BINARY_MAX_FORMATS) ? formats[id] : NULL;
+                int n = format ? LogBinary_FormatRecord(format, payload + 13, length - 13, message, sizeof(message)) : -1;
+                if (n < 0) {
+                    n = snprintf(message, sizeof(message), "<undecodable record, format id %u>", (unsigned)id);
+                }
+                EmitRecord(options, fileTime, level, message, (size_t)n, format);
+                break;
+            }
+            case LOG_BINARY_CHUNK_TEXT:
+                if (length < 9) goto malformed;
+                EmitRecord(options, LogBinary_GetU64(payload), payload[8], (const char*)payload + 9, length - 9, NULL);
+                break;
+            default:
+                break;      /** Unknown chunk types are skipped */
+        }
+        continue;
+
+    malformed:
+        fprintf(stderr, "catime-logdump: malformed chunk %lld (type %u)\n", chunkIndex, (unsigned)header[0]);
+        status = 1;
+    }
+
+    for (size_t i = 0; i < LOG_BINARY_MAX_FORMATS; ++i) free(formats[i]);
+    free(payload);
+    return status;
+}
+
+/* ============================================================================
+ * Entry Point
+ * ============================================================================ */
+
+static int Usage(void) {
+    fprintf(stderr, "usage: catime-logdump [--json] [--utc] <file>\n");
+    return 2;
+}
+
+int main(int argc, char** argv) {
+    DumpOptions options = {0};
+    const char* path = NULL;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--json") == 0) options.json = 1;
+        else if (strcmp(argv[i], "--utc") == 0) options.utc = 1;
+        else if (argv[i][0] == '-' && argv[i][1] != '\0') return Usage();
+        else if (!path) path = argv[i];
+        else return Usage();
+    }
+    if (!path) return Usage();
+
+    FILE* file = (strcmp(path, "-") == 0) ? stdin : fopen(path, "rb");
+    if (!file) {
+        perror(path);
+        return 1;
+    }
+
+    uint8_t header[LOG_BINARY_FILE_HEADER_SIZE];
+    if (fread(header, 1, sizeof(header), file) != sizeof(header) ||
+        memcmp(header, LOG_BINARY_MAGIC, 8) != 0) {
+        fprintf(stderr, "catime-logdump: %s is not a binary Catime log\n", path);
+        if (file != stdin) fclose(file);
+        return 1;
+    }
+    uint32_t version = LogBinary_GetU32(header + 8);
+    if (version != LOG_BINARY_VERSION) {
+        fprintf(stderr, "catime-logdump: unsupported log version %u\n", (unsigned)version);
+        if (file != stdin) fclose(file);
+        return 1;
+    }
+
+    int status = DumpChunks(file, &options);
+    if (file != stdin) fclose(file);
+    return status;
+}